@@ -6,6 +6,24 @@
 
 namespace http2 {
 
+void Http2FrameDecoderListener::OnDataFrame(const Http2FrameHeader& header,
+                                            const char* data,
+                                            size_t len) {
+  OnDataStart(header);
+  size_t pad_length = 0;
+  if (header.IsPadded()) {
+    pad_length = header.payload_length - len - 1;
+    OnPadLength(pad_length);
+  }
+  if (len > 0) {
+    OnDataPayload(data, len);
+  }
+  if (pad_length > 0) {
+    OnPadding(data + len, pad_length);
+  }
+  OnDataEnd();
+}
+
 bool Http2FrameDecoderNoOpListener::OnFrameHeader(
     const Http2FrameHeader& header) {
   return true;
@@ -81,6 +81,18 @@ class Http2FrameDecoderListener {
   // If header.IsEndStream() == true, this is the last data for the stream.
   virtual void OnDataEnd() = 0;
 
+  // Called instead of the OnDataStart, OnPadLength, OnDataPayload, OnPadding
+  // and OnDataEnd sequence when the entire payload of a DATA frame is in the
+  // decode buffer.
+  // |data| The start of the |len| bytes of the non-padding portion of the
+  //        payload. If the frame is padded, the padding immediately follows
+  //        it and has been checked to be all zeroes; its length is
+  //        header.payload_length - len - 1.
+  // The default implementation makes the individual calls.
+  virtual void OnDataFrame(const Http2FrameHeader& header,
+                           const char* data,
+                           size_t len);
+
   // Called once the common frame header has been decoded for a HEADERS frame,
   // before examining the frame's payload, after which:
   //   OnPadLength will be called if header.IsPadded() is true, i.e. if the
@@ -277,6 +289,12 @@ class Http2FrameDecoderListener {
   virtual void OnPaddingTooLong(const Http2FrameHeader& header,
                                 size_t missing_length) = 0;
 
+  // The padding of a DATA frame contains a byte that is not zero.
+  // From RFC Section 6.1, DATA:
+  //     A receiver is not obligated to verify padding but MAY treat non-zero
+  //     padding as a connection error (Section 5.4.1) of type PROTOCOL_ERROR.
+  virtual void OnPaddingNotZero(const Http2FrameHeader& header) = 0;
+
   // Frame size error. Depending upon the effected frame, this may or may not
   // require terminating the connection, though that is probably the best thing
   // to do.
@@ -305,6 +323,9 @@ class Http2FrameDecoderNoOpListener : public Http2FrameDecoderListener {
   void OnDataStart(const Http2FrameHeader& header) override {}
   void OnDataPayload(const char* data, size_t len) override {}
   void OnDataEnd() override {}
+  void OnDataFrame(const Http2FrameHeader& header,
+                   const char* data,
+                   size_t len) override {}
   void OnHeadersStart(const Http2FrameHeader& header) override {}
   void OnHeadersPriority(const Http2PriorityFields& priority) override {}
   void OnHpackFragment(const char* data, size_t len) override {}
@@ -346,6 +367,7 @@ class Http2FrameDecoderNoOpListener : public Http2FrameDecoderListener {
   void OnUnknownEnd() override {}
   void OnPaddingTooLong(const Http2FrameHeader& header,
                         size_t missing_length) override {}
+  void OnPaddingNotZero(const Http2FrameHeader& header) override {}
   void OnFrameSizeError(const Http2FrameHeader& header) override {}
 };
 
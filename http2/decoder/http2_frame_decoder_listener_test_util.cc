@@ -189,6 +189,11 @@ void FailingHttp2FrameDecoderListener::OnPaddingTooLong(
          << "; missing_length: " << missing_length;
 }
 
+void FailingHttp2FrameDecoderListener::OnPaddingNotZero(
+    const Http2FrameHeader& header) {
+  FAIL() << "OnPaddingNotZero: " << header;
+}
+
 void FailingHttp2FrameDecoderListener::OnFrameSizeError(
     const Http2FrameHeader& header) {
   FAIL() << "OnFrameSizeError: " << header;
@@ -477,6 +482,14 @@ void LoggingHttp2FrameDecoderListener::OnPaddingTooLong(
   }
 }
 
+void LoggingHttp2FrameDecoderListener::OnPaddingNotZero(
+    const Http2FrameHeader& header) {
+  VLOG(1) << "OnPaddingNotZero: " << header;
+  if (wrapped_ != nullptr) {
+    wrapped_->OnPaddingNotZero(header);
+  }
+}
+
 void LoggingHttp2FrameDecoderListener::OnFrameSizeError(
     const Http2FrameHeader& header) {
   VLOG(1) << "OnFrameSizeError: " << header;
@@ -69,6 +69,7 @@ class FailingHttp2FrameDecoderListener : public Http2FrameDecoderListener {
   void OnUnknownEnd() override;
   void OnPaddingTooLong(const Http2FrameHeader& header,
                         size_t missing_length) override;
+  void OnPaddingNotZero(const Http2FrameHeader& header) override;
   void OnFrameSizeError(const Http2FrameHeader& header) override;
 
  private:
@@ -130,6 +131,7 @@ class LoggingHttp2FrameDecoderListener : public Http2FrameDecoderListener {
   void OnUnknownEnd() override;
   void OnPaddingTooLong(const Http2FrameHeader& header,
                         size_t missing_length) override;
+  void OnPaddingNotZero(const Http2FrameHeader& header) override;
   void OnFrameSizeError(const Http2FrameHeader& header) override;
 
  private:
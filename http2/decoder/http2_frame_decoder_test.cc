@@ -18,6 +18,7 @@
 #include "net/third_party/quiche/src/http2/test_tools/frame_parts.h"
 #include "net/third_party/quiche/src/http2/test_tools/frame_parts_collector_listener.h"
 #include "net/third_party/quiche/src/http2/test_tools/http2_random.h"
+#include "net/third_party/quiche/src/http2/tools/http2_frame_builder.h"
 #include "net/third_party/quiche/src/http2/tools/random_decoder_test.h"
 
 using ::testing::AssertionResult;
@@ -585,6 +586,130 @@ TEST_F(Http2FrameDecoderTest, DataPayloadAndPadding) {
   EXPECT_TRUE(DecodePayloadAndValidateSeveralWays(kFrameData, expected));
 }
 
+// Complete DATA frames which are back-to-back in the input are each decoded
+// by a single call to DecodeFrame.
+TEST_F(Http2FrameDecoderTest, BackToBackDataFrames) {
+  const char kFrameData[] = {
+      '\x00', '\x00', '\x07',          // Payload length: 7
+      '\x00',                          // DATA
+      '\x08',                          // Flags: PADDED
+      '\x00', '\x00', '\x00', '\x02',  // Stream ID: 2
+      '\x03',                          // Pad Len
+      'a',    'b',    'c',             // Data
+      '\x00', '\x00', '\x00',          // Padding
+      '\x00', '\x00', '\x03',          // Payload length: 3
+      '\x00',                          // DATA
+      '\x01',                          // Flags: END_STREAM
+      '\x00', '\x00', '\x00', '\x02',  // Stream ID: 2
+      'd',    'e',    'f',             // Data
+  };
+  collector_.Reset();
+  PrepareDecoder();
+  DecodeBuffer db(kFrameData, sizeof(kFrameData));
+  EXPECT_EQ(DecodeStatus::kDecodeDone, decoder_.DecodeFrame(&db));
+  EXPECT_EQ(16u, db.Offset());
+  EXPECT_EQ(DecodeStatus::kDecodeDone, decoder_.DecodeFrame(&db));
+  EXPECT_TRUE(db.Empty());
+
+  ASSERT_EQ(2u, collector_.size());
+  Http2FrameHeader header1(7, Http2FrameType::DATA, Http2FrameFlag::PADDED, 2);
+  FrameParts expected1(header1, "abc", 4);
+  EXPECT_TRUE(expected1.VerifyEquals(*collector_.frame(0)));
+  Http2FrameHeader header2(3, Http2FrameType::DATA, Http2FrameFlag::END_STREAM,
+                           2);
+  FrameParts expected2(header2, "def");
+  EXPECT_TRUE(expected2.VerifyEquals(*collector_.frame(1)));
+}
+
+// A DATA frame whose whole payload is in the decode buffer reaches the
+// listener through a single OnDataFrame call.
+TEST_F(Http2FrameDecoderTest, CompleteDataFramesUseSingleCallback) {
+  class DataFrameListener : public Http2FrameDecoderNoOpListener {
+   public:
+    void OnDataStart(const Http2FrameHeader& header) override {
+      ++data_start_count;
+    }
+    void OnDataFrame(const Http2FrameHeader& header,
+                     const char* data,
+                     size_t len) override {
+      payloads.push_back(Http2String(data, len));
+    }
+
+    size_t data_start_count = 0;
+    std::vector<Http2String> payloads;
+  };
+
+  // 1MB of back-to-back 16KB DATA frames, every other one padded.
+  const size_t kNumFrames = 64;
+  const uint32_t kPayloadLength = 16384;
+  Http2FrameBuilder fb;
+  for (size_t i = 0; i < kNumFrames; ++i) {
+    if (i % 2 == 0) {
+      fb.Append(Http2FrameHeader(kPayloadLength, Http2FrameType::DATA, 0, 1));
+      fb.Append(Http2String(kPayloadLength, 'a'));
+    } else {
+      fb.Append(Http2FrameHeader(kPayloadLength, Http2FrameType::DATA,
+                                 Http2FrameFlag::PADDED, 1));
+      fb.AppendUInt8(255);
+      fb.Append(Http2String(kPayloadLength - 256, 'b'));
+      fb.AppendZeroes(255);
+    }
+  }
+
+  DataFrameListener listener;
+  Http2FrameDecoder decoder(&listener);
+  DecodeBuffer db(fb.buffer());
+  for (size_t i = 0; i < kNumFrames; ++i) {
+    ASSERT_EQ(DecodeStatus::kDecodeDone, decoder.DecodeFrame(&db));
+  }
+  EXPECT_TRUE(db.Empty());
+  EXPECT_EQ(0u, listener.data_start_count);
+  ASSERT_EQ(kNumFrames, listener.payloads.size());
+  EXPECT_EQ(Http2String(kPayloadLength, 'a'), listener.payloads[0]);
+  EXPECT_EQ(Http2String(kPayloadLength - 256, 'b'), listener.payloads[1]);
+
+  // A frame split across decode buffers goes through the state machine.
+  const Http2String frame = fb.buffer().substr(0, 9 + kPayloadLength);
+  DecodeBuffer first_part(frame.data(), 100);
+  EXPECT_EQ(DecodeStatus::kDecodeInProgress, decoder.DecodeFrame(&first_part));
+  DecodeBuffer second_part(frame.data() + 100, frame.size() - 100);
+  EXPECT_EQ(DecodeStatus::kDecodeDone, decoder.DecodeFrame(&second_part));
+  EXPECT_EQ(1u, listener.data_start_count);
+  EXPECT_EQ(kNumFrames, listener.payloads.size());
+}
+
+// Padding which is not all zeroes is reported whether or not the frame is
+// split across decode buffers.
+TEST_F(Http2FrameDecoderTest, DataPaddingNotZero) {
+  const char kFrameData[] = {
+      '\x00', '\x00', '\x07',          // Payload length: 7
+      '\x00',                          // DATA
+      '\x08',                          // Flags: PADDED
+      '\x00', '\x00', '\x00', '\x02',  // Stream ID: 2
+      '\x03',                          // Pad Len
+      'a',    'b',    'c',             // Data
+      '\x00', '\x01', '\x00',          // Padding
+  };
+  Http2FrameHeader header(7, Http2FrameType::DATA, Http2FrameFlag::PADDED, 2);
+
+  collector_.Reset();
+  PrepareDecoder();
+  DecodeBuffer db(kFrameData, sizeof(kFrameData));
+  EXPECT_EQ(DecodeStatus::kDecodeError, decoder_.DecodeFrame(&db));
+  ASSERT_EQ(1u, collector_.size());
+  EXPECT_EQ(header, collector_.frame(0)->GetFrameHeader());
+  EXPECT_TRUE(collector_.frame(0)->GetHasPaddingNotZero());
+
+  collector_.Reset();
+  PrepareDecoder();
+  DecodeBuffer first_part(kFrameData, 14);
+  EXPECT_EQ(DecodeStatus::kDecodeInProgress, decoder_.DecodeFrame(&first_part));
+  DecodeBuffer second_part(kFrameData + 14, sizeof(kFrameData) - 14);
+  EXPECT_EQ(DecodeStatus::kDecodeError, decoder_.DecodeFrame(&second_part));
+  ASSERT_EQ(1u, collector_.size());
+  EXPECT_TRUE(collector_.frame(0)->GetHasPaddingNotZero());
+}
+
 TEST_F(Http2FrameDecoderTest, HeadersPayloadAndPadding) {
   const char kFrameData[] = {
       '\x00', '\x00', '\x07',          // Payload length: 7
@@ -5,6 +5,8 @@
 #include "net/third_party/quiche/src/http2/decoder/payload_decoders/data_payload_decoder.h"
 
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 
 #include "base/logging.h"
 #include "base/macros.h"
@@ -16,6 +18,25 @@
 #include "net/third_party/quiche/src/http2/platform/api/http2_macros.h"
 
 namespace http2 {
+namespace {
+
+// Returns true if the |len| bytes starting at |data| are all zero. Padding is
+// at most 255 bytes, so it is checked a word at a time, which compilers turn
+// into vector instructions where the target has them.
+bool IsAllZeroes(const char* data, size_t len) {
+  uint64_t bits = 0;
+  for (; len >= sizeof(bits); data += sizeof(bits), len -= sizeof(bits)) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    bits |= word;
+  }
+  for (; len > 0; ++data, --len) {
+    bits |= static_cast<uint8_t>(*data);
+  }
+  return bits == 0;
+}
+
+}  // namespace
 
 std::ostream& operator<<(std::ostream& out,
                          DataPayloadDecoder::PayloadState v) {
@@ -45,31 +66,37 @@ DecodeStatus DataPayloadDecoder::StartDecodingPayload(FrameDecoderState* state,
   DCHECK_EQ(0, frame_header.flags &
                    ~(Http2FrameFlag::END_STREAM | Http2FrameFlag::PADDED));
 
-  // Special case for the hoped for common case: unpadded and fits fully into
-  // the decode buffer. TO BE SEEN if that is true. It certainly requires that
-  // the transport buffers be large (e.g. >> 16KB typically).
+  // Special case for the hoped for common case: the whole frame is in the
+  // decode buffer (e.g. when the transport buffers are >> 16KB), so it can be
+  // handed to the listener with a single OnDataFrame call rather than going
+  // through the payload state machine. A Pad Length field which is too large
+  // is left to ReadPadLength to report.
   // TODO(jamessynge) Add counters.
   DVLOG(2) << "StartDecodingPayload total_length=" << total_length;
-  if (!frame_header.IsPadded()) {
-    DVLOG(2) << "StartDecodingPayload !IsPadded";
-    if (db->Remaining() == total_length) {
-      DVLOG(2) << "StartDecodingPayload all present";
-      // Note that we don't cache the listener field so that the callee can
-      // replace it if the frame is bad.
-      // If this case is common enough, consider combining the 3 callbacks
-      // into one.
-      state->listener()->OnDataStart(frame_header);
-      if (total_length > 0) {
-        state->listener()->OnDataPayload(db->cursor(), total_length);
-        db->AdvanceCursor(total_length);
+  if (db->Remaining() == total_length &&
+      (!frame_header.IsPadded() ||
+       (total_length > 0 &&
+        static_cast<uint8_t>(db->cursor()[0]) < total_length))) {
+    DVLOG(2) << "StartDecodingPayload all present";
+    const char* data = db->cursor();
+    uint32_t data_length = total_length;
+    if (frame_header.IsPadded()) {
+      const uint32_t pad_length = static_cast<uint8_t>(data[0]);
+      ++data;
+      data_length = total_length - 1 - pad_length;
+      if (!IsAllZeroes(data + data_length, pad_length)) {
+        state->listener()->OnPaddingNotZero(frame_header);
+        return DecodeStatus::kDecodeError;
       }
-      state->listener()->OnDataEnd();
-      return DecodeStatus::kDecodeDone;
     }
-    payload_state_ = PayloadState::kReadPayload;
-  } else {
-    payload_state_ = PayloadState::kReadPadLength;
+    db->AdvanceCursor(total_length);
+    // Note that we don't cache the listener field so that the callee can
+    // replace it if the frame is bad.
+    state->listener()->OnDataFrame(frame_header, data, data_length);
+    return DecodeStatus::kDecodeDone;
   }
+  payload_state_ = frame_header.IsPadded() ? PayloadState::kReadPadLength
+                                           : PayloadState::kReadPayload;
   state->InitializeRemainders();
   state->listener()->OnDataStart(frame_header);
   return ResumeDecodingPayload(state, db);
@@ -112,6 +139,10 @@ DecodeStatus DataPayloadDecoder::ResumeDecodingPayload(FrameDecoderState* state,
       HTTP2_FALLTHROUGH;
 
     case PayloadState::kSkipPadding:
+      if (!IsAllZeroes(db->cursor(), state->AvailablePadding(db))) {
+        state->listener()->OnPaddingNotZero(frame_header);
+        return DecodeStatus::kDecodeError;
+      }
       // SkipPadding handles the OnPadding callback.
       if (state->SkipPadding(db)) {
         state->listener()->OnDataEnd();
@@ -28,6 +28,9 @@ DecodeStatus HpackVarintDecoder::Start(uint8_t prefix_value,
   }
 
   offset_ = 0;
+  if (DecodeExtensionBytesFast(db)) {
+    return DecodeStatus::kDecodeDone;
+  }
   return Resume(db);
 }
 
@@ -38,6 +41,9 @@ DecodeStatus HpackVarintDecoder::StartExtended(uint8_t prefix_length,
 
   value_ = (1 << prefix_length) - 1;
   offset_ = 0;
+  if (DecodeExtensionBytesFast(db)) {
+    return DecodeStatus::kDecodeDone;
+  }
   return Resume(db);
 }
 
@@ -109,6 +115,51 @@ DecodeStatus HpackVarintDecoder::Resume(DecodeBuffer* db) {
   return DecodeStatus::kDecodeError;
 }
 
+bool HpackVarintDecoder::DecodeExtensionBytesFast(DecodeBuffer* db) {
+  DCHECK_EQ(0u, offset_);
+  if (db->Remaining() < 8) {
+    return false;
+  }
+
+  // Load the next eight bytes with the first one in the least significant
+  // position.  Compilers turn this into a single load on little-endian
+  // platforms.
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(db->cursor());
+  uint64_t word = 0;
+  for (int i = 7; i >= 0; --i) {
+    word = (word << 8) | p[i];
+  }
+
+  // The high bit of each byte is the continuation flag.  The encoding ends at
+  // the first byte with the flag cleared.
+  const uint64_t stop_bits = ~word & 0x8080808080808080;
+  if (stop_bits == 0) {
+    // More than eight extension bytes, let Resume() handle it.
+    return false;
+  }
+
+  // |mask| covers every byte up to and including the last extension byte.
+  const uint64_t lowest_stop_bit = stop_bits & (0 - stop_bits);
+  const uint64_t mask = (lowest_stop_bit << 1) - 1;
+  const size_t bytes_consumed =
+      ((mask & 0x0101010101010101) * 0x0101010101010101) >> 56;
+
+  // Drop continuation flags and bytes beyond the end of the varint, then
+  // pack the 7-bit groups together: first pairs of bytes, then pairs of
+  // 14-bit groups, then pairs of 28-bit groups.
+  uint64_t x = word & mask & 0x7f7f7f7f7f7f7f7f;
+  x = ((x & 0x7f007f007f007f00) >> 1) | (x & 0x007f007f007f007f);
+  x = ((x & 0x3fff00003fff0000) >> 2) | (x & 0x00003fff00003fff);
+  x = ((x & 0x0fffffff00000000) >> 4) | (x & 0x000000000fffffff);
+
+  // |x| is less than 2^56 and |value_| is at most 255, so this cannot
+  // overflow.
+  value_ += x;
+  db->AdvanceCursor(bytes_consumed);
+  MarkDone();
+  return true;
+}
+
 uint64_t HpackVarintDecoder::value() const {
   CheckDone();
   return value_;
@@ -94,6 +94,14 @@ class HTTP2_EXPORT_PRIVATE HpackVarintDecoder {
   DecodeStatus ResumeForTest(DecodeBuffer* db);
 
  private:
+  // Decodes all extension bytes at once if at least eight bytes are available
+  // in |db| and the encoding ends within them.  Returns true and consumes the
+  // extension bytes on success.  Returns false without consuming anything
+  // otherwise, in which case the caller should fall back to Resume().
+  // Must only be called right after |value_| is set to the prefix and
+  // |offset_| to zero.
+  bool DecodeExtensionBytesFast(DecodeBuffer* db);
+
   // Protection in case Resume is called when it shouldn't be.
   void MarkDone() {
 #ifndef NDEBUG
@@ -112,8 +112,15 @@ INSTANTIATE_TEST_SUITE_P(
     ::testing::Combine(
         // Bits of the first byte not part of the prefix should be ignored.
         ::testing::Values(0b00000000, 0b11111111, 0b10101010),
-        // Extra bytes appended to the input should be ignored.
-        ::testing::Values("", "00", "666f6f")));
+        // Extra bytes appended to the input should be ignored.  Long suffixes
+        // make at least eight bytes available after the prefix, so that the
+        // fast path is exercised both with and without continuation flags set
+        // in the bytes following the encoded integer.
+        ::testing::Values("",
+                          "00",
+                          "666f6f",
+                          "0000000000000000",
+                          "ffffffffffffffff")));
 
 struct {
   const char* data;
@@ -402,6 +402,17 @@ void FrameParts::OnPaddingTooLong(const Http2FrameHeader& header,
   got_end_callback_ = true;
 }
 
+void FrameParts::OnPaddingNotZero(const Http2FrameHeader& header) {
+  VLOG(1) << "OnPaddingNotZero: " << header;
+  ASSERT_EQ(frame_header_, header);
+  ASSERT_FALSE(got_end_callback_);
+  ASSERT_TRUE(FrameIsPadded(header));
+  ASSERT_FALSE(has_padding_not_zero_);
+  has_padding_not_zero_ = true;
+  got_start_callback_ = true;
+  got_end_callback_ = true;
+}
+
 void FrameParts::OnFrameSizeError(const Http2FrameHeader& header) {
   VLOG(1) << "OnFrameSizeError: " << header;
   ASSERT_EQ(frame_header_, header);
@@ -461,6 +472,9 @@ void FrameParts::OutputTo(std::ostream& out) const {
   if (has_frame_size_error_) {
     out << "  has_frame_size_error\n";
   }
+  if (has_padding_not_zero_) {
+    out << "  has_padding_not_zero\n";
+  }
   if (got_start_callback_) {
     out << "  got_start_callback\n";
   }
@@ -106,6 +106,7 @@ class FrameParts : public Http2FrameDecoderListener {
   void OnUnknownEnd() override;
   void OnPaddingTooLong(const Http2FrameHeader& header,
                         size_t missing_length) override;
+  void OnPaddingNotZero(const Http2FrameHeader& header) override;
   void OnFrameSizeError(const Http2FrameHeader& header) override;
 
   void AppendSetting(const Http2SettingFields& setting_fields) {
@@ -142,6 +143,7 @@ class FrameParts : public Http2FrameDecoderListener {
     return opt_window_update_increment_;
   }
   bool GetHasFrameSizeError() const { return has_frame_size_error_; }
+  bool GetHasPaddingNotZero() const { return has_padding_not_zero_; }
 
   void SetOptPriority(Http2Optional<Http2PriorityFields> opt_priority) {
     opt_priority_ = opt_priority;
@@ -233,6 +235,7 @@ class FrameParts : public Http2FrameDecoderListener {
   Http2Optional<size_t> opt_window_update_increment_;
 
   bool has_frame_size_error_ = false;
+  bool has_padding_not_zero_ = false;
 
   std::vector<Http2SettingFields> settings_;
 
@@ -220,6 +220,12 @@ void FramePartsCollectorListener::OnPaddingTooLong(
   EndFrame()->OnPaddingTooLong(header, missing_length);
 }
 
+void FramePartsCollectorListener::OnPaddingNotZero(
+    const Http2FrameHeader& header) {
+  VLOG(1) << "OnPaddingNotZero: " << header;
+  FrameError(header)->OnPaddingNotZero(header);
+}
+
 void FramePartsCollectorListener::OnFrameSizeError(
     const Http2FrameHeader& header) {
   VLOG(1) << "OnFrameSizeError: " << header;
@@ -76,6 +76,7 @@ class FramePartsCollectorListener : public FramePartsCollector {
   void OnUnknownEnd() override;
   void OnPaddingTooLong(const Http2FrameHeader& header,
                         size_t missing_length) override;
+  void OnPaddingNotZero(const Http2FrameHeader& header) override;
   void OnFrameSizeError(const Http2FrameHeader& header) override;
 };
 
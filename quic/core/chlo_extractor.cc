@@ -44,6 +44,7 @@ class ChloFramerVisitor : public QuicFramerVisitorInterface,
   bool OnCryptoFrame(const QuicCryptoFrame& frame) override;
   bool OnAckFrameStart(QuicPacketNumber largest_acked,
                        QuicTime::Delta ack_delay_time) override;
+  bool OnAckEcnCounts(const QuicEcnCounts& ecn_counts) override;
   bool OnAckRange(QuicPacketNumber start, QuicPacketNumber end) override;
   bool OnAckTimestamp(QuicPacketNumber packet_number,
                       QuicTime timestamp) override;
@@ -67,6 +68,7 @@ class ChloFramerVisitor : public QuicFramerVisitorInterface,
   bool OnBlockedFrame(const QuicBlockedFrame& frame) override;
   bool OnPaddingFrame(const QuicPaddingFrame& frame) override;
   bool OnMessageFrame(const QuicMessageFrame& frame) override;
+  bool OnFecFrame(const QuicFecFrame& frame) override;
   void OnPacketComplete() override {}
   bool IsValidStatelessResetToken(QuicUint128 token) const override;
   void OnAuthenticatedIetfStatelessResetPacket(
@@ -180,6 +182,10 @@ bool ChloFramerVisitor::OnAckFrameStart(QuicPacketNumber /*largest_acked*/,
   return true;
 }
 
+bool ChloFramerVisitor::OnAckEcnCounts(const QuicEcnCounts& /*ecn_counts*/) {
+  return true;
+}
+
 bool ChloFramerVisitor::OnAckRange(QuicPacketNumber /*start*/,
                                    QuicPacketNumber /*end*/) {
   return true;
@@ -265,6 +271,10 @@ bool ChloFramerVisitor::OnMessageFrame(const QuicMessageFrame& frame) {
   return true;
 }
 
+bool ChloFramerVisitor::OnFecFrame(const QuicFecFrame& frame) {
+  return true;
+}
+
 bool ChloFramerVisitor::IsValidStatelessResetToken(QuicUint128 token) const {
   return false;
 }
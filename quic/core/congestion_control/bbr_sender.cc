@@ -122,6 +122,7 @@ BbrSender::BbrSender(const RttStats* rtt_stats,
       recovery_state_(NOT_IN_RECOVERY),
       recovery_window_(max_congestion_window_),
       is_app_limited_recovery_(false),
+      ecn_ce_marked_(false),
       slower_startup_(false),
       rate_based_startup_(false),
       startup_rate_reduction_multiplier_(0),
@@ -350,6 +351,9 @@ void BbrSender::OnCongestionEvent(bool /*rtt_updated*/,
   bool min_rtt_expired = false;
 
   DiscardLostPackets(lost_packets);
+  // CE marks reduce the sending rate in the same way as losses.
+  const bool has_congestion_signal = !lost_packets.empty() || ecn_ce_marked_;
+  ecn_ce_marked_ = false;
 
   // Input the new data into the BBR model of the connection.
   QuicByteCount excess_acked = 0;
@@ -357,7 +361,7 @@ void BbrSender::OnCongestionEvent(bool /*rtt_updated*/,
     QuicPacketNumber last_acked_packet = acked_packets.rbegin()->packet_number;
     is_round_start = UpdateRoundTripCounter(last_acked_packet);
     min_rtt_expired = UpdateBandwidthAndMinRtt(event_time, acked_packets);
-    UpdateRecoveryState(last_acked_packet, !lost_packets.empty(),
+    UpdateRecoveryState(last_acked_packet, has_congestion_signal,
                         is_round_start);
 
     const QuicByteCount bytes_acked =
@@ -368,7 +372,7 @@ void BbrSender::OnCongestionEvent(bool /*rtt_updated*/,
 
   // Handle logic specific to PROBE_BW mode.
   if (mode_ == PROBE_BW) {
-    UpdateGainCyclePhase(event_time, prior_in_flight, !lost_packets.empty());
+    UpdateGainCyclePhase(event_time, prior_in_flight, has_congestion_signal);
   }
 
   // Handle logic specific to STARTUP and DRAIN modes.
@@ -398,6 +402,12 @@ void BbrSender::OnCongestionEvent(bool /*rtt_updated*/,
   sampler_.RemoveObsoletePackets(unacked_packets_->GetLeastUnacked());
 }
 
+void BbrSender::OnEcnCongestionEvent(QuicTime /*event_time*/,
+                                     QuicPacketNumber /*largest_acked*/,
+                                     QuicByteCount /*prior_in_flight*/) {
+  ecn_ce_marked_ = true;
+}
+
 CongestionControlType BbrSender::GetCongestionControlType() const {
   return kBBR;
 }
@@ -121,6 +121,9 @@ class QUIC_EXPORT_PRIVATE BbrSender : public SendAlgorithmInterface {
                     QuicPacketNumber packet_number,
                     QuicByteCount bytes,
                     HasRetransmittableData is_retransmittable) override;
+  void OnEcnCongestionEvent(QuicTime event_time,
+                            QuicPacketNumber largest_acked,
+                            QuicByteCount prior_in_flight) override;
   void OnRetransmissionTimeout(bool packets_retransmitted) override {}
   void OnConnectionMigration() override {}
   bool CanSend(QuicByteCount bytes_in_flight) override;
@@ -362,6 +365,9 @@ class QUIC_EXPORT_PRIVATE BbrSender : public SendAlgorithmInterface {
   QuicByteCount recovery_window_;
   // If true, consider all samples in recovery app-limited.
   bool is_app_limited_recovery_;
+  // True if the peer reported new CE marks since the last congestion event,
+  // which is then handled like a loss.
+  bool ecn_ce_marked_;
 
   // When true, pace at 1.5x and disable packet conservation in STARTUP.
   bool slower_startup_;
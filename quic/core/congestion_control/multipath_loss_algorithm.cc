@@ -0,0 +1,107 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/congestion_control/multipath_loss_algorithm.h"
+
+#include <algorithm>
+
+#include "net/third_party/quiche/src/quic/core/congestion_control/rtt_stats.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+namespace {
+
+// The minimum delay before a packet will be considered lost, regardless of
+// the RTT of its path.
+const int64_t kMinLossDelayMs = 5;
+
+// Fraction of a path's RTT the algorithm waits beyond the RTT before declaring
+// a packet lost.
+const int kLossDelayShift = 2;
+
+}  // namespace
+
+MultipathLossAlgorithm::MultipathLossAlgorithm()
+    : loss_detection_timeout_(QuicTime::Zero()), path_rtt_stats_() {}
+
+MultipathLossAlgorithm::~MultipathLossAlgorithm() {}
+
+void MultipathLossAlgorithm::SetPathRttStats(QuicPathId path_id,
+                                             const RttStats* rtt_stats) {
+  DCHECK_LT(path_id, kMaxNumPaths);
+  path_rtt_stats_[path_id] = rtt_stats;
+}
+
+LossDetectionType MultipathLossAlgorithm::GetLossDetectionType() const {
+  return kTime;
+}
+
+void MultipathLossAlgorithm::DetectLosses(
+    const QuicUnackedPacketMap& unacked_packets,
+    QuicTime time,
+    const RttStats& rtt_stats,
+    QuicPacketNumber /*largest_newly_acked*/,
+    const AckedPacketVector& packets_acked,
+    LostPacketVector* packets_lost) {
+  loss_detection_timeout_ = QuicTime::Zero();
+  for (const AckedPacket& acked : packets_acked) {
+    const QuicPathId path_id =
+        unacked_packets.GetTransmissionInfo(acked.packet_number).path_id;
+    if (!largest_acked_[path_id].IsInitialized() ||
+        largest_acked_[path_id] < acked.packet_number) {
+      largest_acked_[path_id] = acked.packet_number;
+    }
+  }
+  QuicPacketNumber largest_acked;
+  for (size_t i = 0; i < kMaxNumPaths; ++i) {
+    if (largest_acked_[i].IsInitialized() &&
+        (!largest_acked.IsInitialized() || largest_acked < largest_acked_[i])) {
+      largest_acked = largest_acked_[i];
+    }
+  }
+  if (!largest_acked.IsInitialized()) {
+    return;
+  }
+
+  QuicPacketNumber packet_number = unacked_packets.GetLeastUnacked();
+  for (auto it = unacked_packets.begin();
+       it != unacked_packets.end() && packet_number < largest_acked;
+       ++it, ++packet_number) {
+    if (!it->in_flight) {
+      continue;
+    }
+    const QuicPacketNumber path_largest_acked = largest_acked_[it->path_id];
+    if (!path_largest_acked.IsInitialized() ||
+        packet_number >= path_largest_acked) {
+      // No later packet on the same path has been acked yet.
+      continue;
+    }
+    const RttStats& path_rtt_stats = path_rtt_stats_[it->path_id] != nullptr
+                                         ? *path_rtt_stats_[it->path_id]
+                                         : rtt_stats;
+    const QuicTime::Delta max_rtt =
+        std::max(path_rtt_stats.previous_srtt(), path_rtt_stats.latest_rtt());
+    const QuicTime::Delta loss_delay =
+        std::max(QuicTime::Delta::FromMilliseconds(kMinLossDelayMs),
+                 max_rtt + (max_rtt >> kLossDelayShift));
+    const QuicTime when_lost = it->sent_time + loss_delay;
+    if (time < when_lost) {
+      if (!loss_detection_timeout_.IsInitialized() ||
+          when_lost < loss_detection_timeout_) {
+        loss_detection_timeout_ = when_lost;
+      }
+      continue;
+    }
+    QUIC_DVLOG(1) << "Packet " << packet_number << " on path "
+                  << static_cast<int>(it->path_id) << " is lost";
+    packets_lost->push_back(LostPacket(packet_number, it->bytes_sent));
+  }
+}
+
+QuicTime MultipathLossAlgorithm::GetLossTimeout() const {
+  return loss_detection_timeout_;
+}
+
+}  // namespace quic
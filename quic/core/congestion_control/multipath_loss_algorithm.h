@@ -0,0 +1,63 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_CONGESTION_CONTROL_MULTIPATH_LOSS_ALGORITHM_H_
+#define QUICHE_QUIC_CORE_CONGESTION_CONTROL_MULTIPATH_LOSS_ALGORITHM_H_
+
+#include "net/third_party/quiche/src/quic/core/congestion_control/loss_detection_interface.h"
+#include "net/third_party/quiche/src/quic/core/quic_constants.h"
+#include "net/third_party/quiche/src/quic/core/quic_packets.h"
+#include "net/third_party/quiche/src/quic/core/quic_time.h"
+#include "net/third_party/quiche/src/quic/core/quic_unacked_packet_map.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+
+namespace quic {
+
+// Time based loss detection for connections which send on several paths at
+// once from a single packet number space.  A packet is only declared lost once
+// a later packet on the same path has been acked and a fraction of that path's
+// RTT has passed, so packets on a slow path are not declared lost because the
+// packets of a faster path get acked first.
+class QUIC_EXPORT_PRIVATE MultipathLossAlgorithm
+    : public LossDetectionInterface {
+ public:
+  MultipathLossAlgorithm();
+  MultipathLossAlgorithm(const MultipathLossAlgorithm&) = delete;
+  MultipathLossAlgorithm& operator=(const MultipathLossAlgorithm&) = delete;
+  ~MultipathLossAlgorithm() override;
+
+  // Uses the RTT estimates in |rtt_stats|, which must outlive the algorithm,
+  // for packets sent on |path_id|.  Paths without their own estimates use the
+  // RttStats passed to DetectLosses.
+  void SetPathRttStats(QuicPathId path_id, const RttStats* rtt_stats);
+
+  LossDetectionType GetLossDetectionType() const override;
+
+  void DetectLosses(const QuicUnackedPacketMap& unacked_packets,
+                    QuicTime time,
+                    const RttStats& rtt_stats,
+                    QuicPacketNumber largest_newly_acked,
+                    const AckedPacketVector& packets_acked,
+                    LostPacketVector* packets_lost) override;
+
+  QuicTime GetLossTimeout() const override;
+
+  // The reordering threshold is fixed, so spurious retransmits are ignored.
+  void SpuriousRetransmitDetected(
+      const QuicUnackedPacketMap& unacked_packets,
+      QuicTime time,
+      const RttStats& rtt_stats,
+      QuicPacketNumber spurious_retransmission) override {}
+
+ private:
+  QuicTime loss_detection_timeout_;
+  // Not owned.  Null for paths which use the RttStats passed to DetectLosses.
+  const RttStats* path_rtt_stats_[kMaxNumPaths];
+  // Largest packet acked on each path.
+  QuicPacketNumber largest_acked_[kMaxNumPaths];
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_CONGESTION_CONTROL_MULTIPATH_LOSS_ALGORITHM_H_
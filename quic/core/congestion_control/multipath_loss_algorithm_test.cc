@@ -0,0 +1,115 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/congestion_control/multipath_loss_algorithm.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/core/congestion_control/rtt_stats.h"
+#include "net/third_party/quiche/src/quic/core/quic_unacked_packet_map.h"
+#include "net/third_party/quiche/src/quic/core/quic_utils.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+#include "net/third_party/quiche/src/quic/test_tools/mock_clock.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+// Default packet length.
+const uint32_t kDefaultLength = 1000;
+
+class MultipathLossAlgorithmTest : public QuicTest {
+ protected:
+  MultipathLossAlgorithmTest() : unacked_packets_(Perspective::IS_CLIENT) {
+    rtt_stats_.UpdateRtt(QuicTime::Delta::FromMilliseconds(20),
+                         QuicTime::Delta::Zero(), clock_.Now());
+    alternative_path_rtt_stats_.UpdateRtt(
+        QuicTime::Delta::FromMilliseconds(200), QuicTime::Delta::Zero(),
+        clock_.Now());
+    loss_algorithm_.SetPathRttStats(kAlternativePathId,
+                                    &alternative_path_rtt_stats_);
+  }
+
+  void SendDataPacket(uint64_t packet_number, QuicPathId path_id) {
+    QuicStreamFrame frame;
+    frame.stream_id = QuicUtils::GetHeadersStreamId(
+        CurrentSupportedVersions()[0].transport_version);
+    SerializedPacket packet(QuicPacketNumber(packet_number),
+                            PACKET_1BYTE_PACKET_NUMBER, nullptr, kDefaultLength,
+                            false, false);
+    packet.retransmittable_frames.push_back(QuicFrame(frame));
+    packet.path_id = path_id;
+    unacked_packets_.AddSentPacket(&packet, QuicPacketNumber(),
+                                   NOT_RETRANSMISSION, clock_.Now(), true);
+  }
+
+  void AckPacket(uint64_t packet_number) {
+    unacked_packets_.RemoveFromInFlight(QuicPacketNumber(packet_number));
+    packets_acked_.push_back(AckedPacket(QuicPacketNumber(packet_number),
+                                         kDefaultLength, QuicTime::Zero()));
+  }
+
+  void VerifyLosses(const std::vector<uint64_t>& losses_expected) {
+    LostPacketVector lost_packets;
+    loss_algorithm_.DetectLosses(unacked_packets_, clock_.Now(), rtt_stats_,
+                                 QuicPacketNumber(), packets_acked_,
+                                 &lost_packets);
+    packets_acked_.clear();
+    ASSERT_EQ(losses_expected.size(), lost_packets.size());
+    for (size_t i = 0; i < losses_expected.size(); ++i) {
+      EXPECT_EQ(QuicPacketNumber(losses_expected[i]),
+                lost_packets[i].packet_number);
+      unacked_packets_.RemoveFromInFlight(lost_packets[i].packet_number);
+    }
+  }
+
+  QuicUnackedPacketMap unacked_packets_;
+  MultipathLossAlgorithm loss_algorithm_;
+  RttStats rtt_stats_;
+  RttStats alternative_path_rtt_stats_;
+  AckedPacketVector packets_acked_;
+  MockClock clock_;
+};
+
+TEST_F(MultipathLossAlgorithmTest, FastPathAcksDoNotDeclareSlowPathLosses) {
+  SendDataPacket(1, kAlternativePathId);
+  for (uint64_t i = 2; i <= 5; ++i) {
+    SendDataPacket(i, kDefaultPathId);
+  }
+  EXPECT_EQ(kDefaultLength,
+            unacked_packets_.GetBytesInFlightOnPath(kAlternativePathId));
+  EXPECT_EQ(4 * kDefaultLength,
+            unacked_packets_.GetBytesInFlightOnPath(kDefaultPathId));
+
+  // Acks of the fast path say nothing about the slow path's packet.
+  clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(100));
+  AckPacket(3);
+  AckPacket(4);
+  AckPacket(5);
+  // Packet 2 was sent more than 1.25 fast path RTTs ago.
+  VerifyLosses({2});
+  EXPECT_EQ(QuicTime::Zero(), loss_algorithm_.GetLossTimeout());
+  EXPECT_EQ(kDefaultLength,
+            unacked_packets_.GetBytesInFlightOnPath(kAlternativePathId));
+}
+
+TEST_F(MultipathLossAlgorithmTest, LossDelayFollowsPathRtt) {
+  SendDataPacket(1, kAlternativePathId);
+  SendDataPacket(2, kAlternativePathId);
+  clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(200));
+  AckPacket(2);
+  // The slow path waits for 1.25 of its own RTT.
+  VerifyLosses({});
+  EXPECT_EQ(clock_.Now() + QuicTime::Delta::FromMilliseconds(50),
+            loss_algorithm_.GetLossTimeout());
+
+  clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(50));
+  VerifyLosses({1});
+  EXPECT_EQ(QuicTime::Zero(), loss_algorithm_.GetLossTimeout());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -51,6 +51,8 @@ class QUIC_EXPORT_PRIVATE PacingSender {
 
   QuicBandwidth max_pacing_rate() const { return max_pacing_rate_; }
 
+  QuicTime::Delta alarm_granularity() const { return alarm_granularity_; }
+
   void OnCongestionEvent(bool rtt_updated,
                          QuicByteCount bytes_in_flight,
                          QuicTime event_time,
@@ -100,4 +100,15 @@ void RttStats::OnConnectionMigration() {
   max_ack_delay_ = QuicTime::Delta::Zero();
 }
 
+void RttStats::CloneFrom(const RttStats& stats) {
+  latest_rtt_ = stats.latest_rtt_;
+  min_rtt_ = stats.min_rtt_;
+  smoothed_rtt_ = stats.smoothed_rtt_;
+  previous_srtt_ = stats.previous_srtt_;
+  mean_deviation_ = stats.mean_deviation_;
+  initial_rtt_ = stats.initial_rtt_;
+  max_ack_delay_ = stats.max_ack_delay_;
+  ignore_max_ack_delay_ = stats.ignore_max_ack_delay_;
+}
+
 }  // namespace quic
@@ -42,6 +42,10 @@ class QUIC_EXPORT_PRIVATE RttStats {
   // Called when connection migrates and rtt measurement needs to be reset.
   void OnConnectionMigration();
 
+  // Copies every estimate of |stats|.  Used to swap the estimates of different
+  // network paths in and out of the RttStats the send algorithm observes.
+  void CloneFrom(const RttStats& stats);
+
   // Returns the EWMA smoothed RTT for the connection.
   // May return Zero if no valid updates have occurred.
   QuicTime::Delta smoothed_rtt() const { return smoothed_rtt_; }
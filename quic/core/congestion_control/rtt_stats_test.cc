@@ -226,5 +226,26 @@ TEST_F(RttStatsTest, ResetAfterConnectionMigrations) {
   EXPECT_EQ(QuicTime::Delta::Zero(), rtt_stats_.max_ack_delay());
 }
 
+TEST_F(RttStatsTest, CloneFrom) {
+  rtt_stats_.UpdateRtt(QuicTime::Delta::FromMilliseconds(200),
+                       QuicTime::Delta::FromMilliseconds(10),
+                       QuicTime::Zero());
+  rtt_stats_.UpdateRtt(QuicTime::Delta::FromMilliseconds(300),
+                       QuicTime::Delta::Zero(), QuicTime::Zero());
+
+  RttStats clone;
+  clone.CloneFrom(rtt_stats_);
+  EXPECT_EQ(rtt_stats_.latest_rtt(), clone.latest_rtt());
+  EXPECT_EQ(rtt_stats_.min_rtt(), clone.min_rtt());
+  EXPECT_EQ(rtt_stats_.smoothed_rtt(), clone.smoothed_rtt());
+  EXPECT_EQ(rtt_stats_.previous_srtt(), clone.previous_srtt());
+  EXPECT_EQ(rtt_stats_.mean_deviation(), clone.mean_deviation());
+  EXPECT_EQ(rtt_stats_.max_ack_delay(), clone.max_ack_delay());
+
+  // The clone is independent of the original.
+  rtt_stats_.OnConnectionMigration();
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(200), clone.min_rtt());
+}
+
 }  // namespace test
 }  // namespace quic
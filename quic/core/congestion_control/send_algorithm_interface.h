@@ -74,6 +74,13 @@ class QUIC_EXPORT_PRIVATE SendAlgorithmInterface {
                             QuicByteCount bytes,
                             HasRetransmittableData is_retransmittable) = 0;
 
+  // Called when the peer reports that packets up to |largest_acked| arrived
+  // with the ECN-CE codepoint, which is to be treated like a loss.  Called at
+  // most once per ack frame, before OnCongestionEvent.
+  virtual void OnEcnCongestionEvent(QuicTime event_time,
+                                    QuicPacketNumber largest_acked,
+                                    QuicByteCount prior_in_flight) = 0;
+
   // Called when the retransmission timeout fires.  Neither OnPacketAbandoned
   // nor OnPacketLost will be called for these packets.
   virtual void OnRetransmissionTimeout(bool packets_retransmitted) = 0;
@@ -251,6 +251,19 @@ bool TcpCubicSenderBytes::ShouldSendProbingPacket() const {
   return false;
 }
 
+void TcpCubicSenderBytes::OnEcnCongestionEvent(
+    QuicTime /*event_time*/,
+    QuicPacketNumber largest_acked,
+    QuicByteCount prior_in_flight) {
+  // RFC 3168 responds to CE like a loss, once per window of data.  CE marks
+  // are counted in ecn_ce_events, so the loss stats are left alone.
+  if (largest_sent_at_last_cutback_.IsInitialized() &&
+      largest_acked <= largest_sent_at_last_cutback_) {
+    return;
+  }
+  ReduceCongestionWindow(prior_in_flight);
+}
+
 void TcpCubicSenderBytes::OnRetransmissionTimeout(bool packets_retransmitted) {
   largest_sent_at_last_cutback_.Clear();
   if (!packets_retransmitted) {
@@ -318,11 +331,15 @@ void TcpCubicSenderBytes::OnPacketLost(QuicPacketNumber packet_number,
     return;
   }
   ++stats_->tcp_loss_events;
-  last_cutback_exited_slowstart_ = InSlowStart();
   if (InSlowStart()) {
     ++stats_->slowstart_packets_lost;
   }
+  ReduceCongestionWindow(prior_in_flight);
+}
 
+void TcpCubicSenderBytes::ReduceCongestionWindow(
+    QuicByteCount prior_in_flight) {
+  last_cutback_exited_slowstart_ = InSlowStart();
   if (!no_prr_) {
     prr_.OnPacketLost(prior_in_flight);
   }
@@ -348,7 +365,8 @@ void TcpCubicSenderBytes::OnPacketLost(QuicPacketNumber packet_number,
   // Reset packet count from congestion avoidance mode. We start counting again
   // when we're out of recovery.
   num_acked_packets_ = 0;
-  QUIC_DVLOG(1) << "Incoming loss; congestion window: " << congestion_window_
+  QUIC_DVLOG(1) << "Congestion window cutback; congestion window: "
+                << congestion_window_
                 << " slowstart threshold: " << slowstart_threshold_;
 }
 
@@ -63,6 +63,9 @@ class QUIC_EXPORT_PRIVATE TcpCubicSenderBytes : public SendAlgorithmInterface {
                     QuicPacketNumber packet_number,
                     QuicByteCount bytes,
                     HasRetransmittableData is_retransmittable) override;
+  void OnEcnCongestionEvent(QuicTime event_time,
+                            QuicPacketNumber largest_acked,
+                            QuicByteCount prior_in_flight) override;
   void OnRetransmissionTimeout(bool packets_retransmitted) override;
   bool CanSend(QuicByteCount bytes_in_flight) override;
   QuicBandwidth PacingRate(QuicByteCount bytes_in_flight) const override;
@@ -97,6 +100,9 @@ class QUIC_EXPORT_PRIVATE TcpCubicSenderBytes : public SendAlgorithmInterface {
   void OnPacketLost(QuicPacketNumber largest_loss,
                     QuicByteCount lost_bytes,
                     QuicByteCount prior_in_flight);
+  // Cuts the window back once for a congestion event, without touching the
+  // loss stats.
+  void ReduceCongestionWindow(QuicByteCount prior_in_flight);
   void MaybeIncreaseCwnd(QuicPacketNumber acked_packet_number,
                          QuicByteCount acked_bytes,
                          QuicByteCount prior_in_flight,
@@ -531,6 +531,29 @@ TEST_F(TcpCubicSenderBytesTest, TcpCubicResetEpochOnQuiescence) {
   EXPECT_GT(kMaxCongestionWindowBytes, sender_->GetCongestionWindow());
 }
 
+TEST_F(TcpCubicSenderBytesTest, EcnCongestionEventIsNotALoss) {
+  sender_->SetNumEmulatedConnections(1);
+  SendAvailableSendWindow();
+  AckNPackets(2);
+  SendAvailableSendWindow();
+  const QuicByteCount initial_window = sender_->GetCongestionWindow();
+
+  // A CE mark cuts the window back like a loss, but is not counted as one.
+  sender_->OnEcnCongestionEvent(clock_.Now(),
+                                QuicPacketNumber(acked_packet_number_ + 1),
+                                bytes_in_flight_);
+  EXPECT_EQ(initial_window * kRenoBeta, sender_->GetCongestionWindow());
+  EXPECT_FALSE(sender_->InSlowStart());
+  EXPECT_EQ(0u, sender_->stats_.tcp_loss_events);
+  EXPECT_EQ(0u, sender_->stats_.slowstart_packets_lost);
+
+  // Further marks on packets sent before the cutback are ignored.
+  sender_->OnEcnCongestionEvent(clock_.Now(),
+                                QuicPacketNumber(packet_number_ - 1),
+                                bytes_in_flight_);
+  EXPECT_EQ(initial_window * kRenoBeta, sender_->GetCongestionWindow());
+}
+
 TEST_F(TcpCubicSenderBytesTest, MultipleLossesInOneWindow) {
   SendAvailableSendWindow();
   const QuicByteCount initial_window = sender_->GetCongestionWindow();
@@ -418,7 +418,12 @@ class ScopedZLib {
     DEFLATE,
   };
 
-  explicit ScopedZLib(Type type) : z_(nullptr), type_(type) {}
+  explicit ScopedZLib(Type type) : ScopedZLib(type, nullptr) {}
+
+  // If |pool| is not null, the context is returned to it instead of being
+  // destroyed.
+  ScopedZLib(Type type, CertCompressor::ZlibStreamPool* pool)
+      : z_(nullptr), type_(type), pool_(pool) {}
 
   void reset(z_stream* z) {
     Clear();
@@ -433,7 +438,13 @@ class ScopedZLib {
       return;
     }
 
-    if (type_ == DEFLATE) {
+    if (pool_ != nullptr) {
+      if (type_ == DEFLATE) {
+        pool_->ReleaseDeflateStream(z_);
+      } else {
+        pool_->ReleaseInflateStream(z_);
+      }
+    } else if (type_ == DEFLATE) {
       deflateEnd(z_);
     } else {
       inflateEnd(z_);
@@ -443,16 +454,123 @@ class ScopedZLib {
 
   z_stream* z_;
   const Type type_;
+  CertCompressor::ZlibStreamPool* const pool_;
 };
 
 }  // anonymous namespace
 
+CertCompressor::ZlibStreamPool::ZlibStreamPool(size_t max_idle_streams)
+    : max_idle_streams_(max_idle_streams),
+      num_reused_(0),
+      num_initialized_(0) {}
+
+CertCompressor::ZlibStreamPool::~ZlibStreamPool() {
+  for (z_stream* z : idle_deflate_streams_) {
+    deflateEnd(z);
+    delete z;
+  }
+  for (z_stream* z : idle_inflate_streams_) {
+    inflateEnd(z);
+    delete z;
+  }
+}
+
+z_stream* CertCompressor::ZlibStreamPool::AcquireDeflateStream() {
+  {
+    QuicMutexLock locked(&lock_);
+    if (!idle_deflate_streams_.empty()) {
+      z_stream* z = idle_deflate_streams_.back();
+      idle_deflate_streams_.pop_back();
+      ++num_reused_;
+      return z;
+    }
+  }
+
+  auto z = QuicMakeUnique<z_stream>();
+  memset(z.get(), 0, sizeof(*z));
+  if (deflateInit(z.get(), Z_DEFAULT_COMPRESSION) != Z_OK) {
+    return nullptr;
+  }
+  QuicMutexLock locked(&lock_);
+  ++num_initialized_;
+  return z.release();
+}
+
+void CertCompressor::ZlibStreamPool::ReleaseDeflateStream(z_stream* z) {
+  // deflateReset keeps the allocated window and hash tables, but discards the
+  // dictionary and any pending output.
+  if (deflateReset(z) == Z_OK) {
+    QuicMutexLock locked(&lock_);
+    if (idle_deflate_streams_.size() < max_idle_streams_) {
+      idle_deflate_streams_.push_back(z);
+      return;
+    }
+  }
+  deflateEnd(z);
+  delete z;
+}
+
+z_stream* CertCompressor::ZlibStreamPool::AcquireInflateStream() {
+  {
+    QuicMutexLock locked(&lock_);
+    if (!idle_inflate_streams_.empty()) {
+      z_stream* z = idle_inflate_streams_.back();
+      idle_inflate_streams_.pop_back();
+      ++num_reused_;
+      return z;
+    }
+  }
+
+  auto z = QuicMakeUnique<z_stream>();
+  memset(z.get(), 0, sizeof(*z));
+  if (inflateInit(z.get()) != Z_OK) {
+    return nullptr;
+  }
+  QuicMutexLock locked(&lock_);
+  ++num_initialized_;
+  return z.release();
+}
+
+void CertCompressor::ZlibStreamPool::ReleaseInflateStream(z_stream* z) {
+  if (inflateReset(z) == Z_OK) {
+    QuicMutexLock locked(&lock_);
+    if (idle_inflate_streams_.size() < max_idle_streams_) {
+      idle_inflate_streams_.push_back(z);
+      return;
+    }
+  }
+  inflateEnd(z);
+  delete z;
+}
+
+size_t CertCompressor::ZlibStreamPool::num_reused() const {
+  QuicMutexLock locked(&lock_);
+  return num_reused_;
+}
+
+size_t CertCompressor::ZlibStreamPool::num_initialized() const {
+  QuicMutexLock locked(&lock_);
+  return num_initialized_;
+}
+
 // static
 QuicString CertCompressor::CompressChain(
     const std::vector<QuicString>& certs,
     QuicStringPiece client_common_set_hashes,
     QuicStringPiece client_cached_cert_hashes,
     const CommonCertSets* common_sets) {
+  return CompressChain(certs, client_common_set_hashes,
+                       client_cached_cert_hashes, common_sets,
+                       /*stream_pool=*/nullptr);
+}
+
+// static
+QuicString CertCompressor::CompressChain(
+    const std::vector<QuicString>& certs,
+    QuicStringPiece client_common_set_hashes,
+    QuicStringPiece client_cached_cert_hashes,
+    const CommonCertSets* common_sets,
+    ZlibStreamPool* stream_pool) {
   const std::vector<CertEntry> entries = MatchCerts(
       certs, client_common_set_hashes, client_cached_cert_hashes, common_sets);
   DCHECK_EQ(entries.size(), certs.size());
@@ -465,28 +583,37 @@ QuicString CertCompressor::CompressChain(
   }
 
   size_t compressed_size = 0;
-  z_stream z;
-  ScopedZLib scoped_z(ScopedZLib::DEFLATE);
+  z_stream local_z;
+  z_stream* z = &local_z;
+  ScopedZLib scoped_z(ScopedZLib::DEFLATE, stream_pool);
 
   if (uncompressed_size > 0) {
-    memset(&z, 0, sizeof(z));
-    int rv = deflateInit(&z, Z_DEFAULT_COMPRESSION);
-    DCHECK_EQ(Z_OK, rv);
-    if (rv != Z_OK) {
-      return "";
+    if (stream_pool != nullptr) {
+      z = stream_pool->AcquireDeflateStream();
+      DCHECK(z != nullptr);
+      if (z == nullptr) {
+        return "";
+      }
+    } else {
+      memset(z, 0, sizeof(*z));
+      int rv = deflateInit(z, Z_DEFAULT_COMPRESSION);
+      DCHECK_EQ(Z_OK, rv);
+      if (rv != Z_OK) {
+        return "";
+      }
     }
-    scoped_z.reset(&z);
+    scoped_z.reset(z);
 
     QuicString zlib_dict = ZlibDictForEntries(entries, certs);
 
-    rv = deflateSetDictionary(
-        &z, reinterpret_cast<const uint8_t*>(&zlib_dict[0]), zlib_dict.size());
+    int rv = deflateSetDictionary(
+        z, reinterpret_cast<const uint8_t*>(&zlib_dict[0]), zlib_dict.size());
     DCHECK_EQ(Z_OK, rv);
     if (rv != Z_OK) {
       return "";
     }
 
-    compressed_size = deflateBound(&z, uncompressed_size);
+    compressed_size = deflateBound(z, uncompressed_size);
   }
 
   const size_t entries_size = CertEntriesSize(entries);
@@ -509,8 +636,8 @@ QuicString CertCompressor::CompressChain(
 
   int rv;
 
-  z.next_out = j;
-  z.avail_out = compressed_size;
+  z->next_out = j;
+  z->avail_out = compressed_size;
 
   for (size_t i = 0; i < certs.size(); i++) {
     if (entries[i].type != CertEntry::COMPRESSED) {
@@ -518,34 +645,34 @@ QuicString CertCompressor::CompressChain(
     }
 
     uint32_t length32 = certs[i].size();
-    z.next_in = reinterpret_cast<uint8_t*>(&length32);
-    z.avail_in = sizeof(length32);
-    rv = deflate(&z, Z_NO_FLUSH);
+    z->next_in = reinterpret_cast<uint8_t*>(&length32);
+    z->avail_in = sizeof(length32);
+    rv = deflate(z, Z_NO_FLUSH);
     DCHECK_EQ(Z_OK, rv);
-    DCHECK_EQ(0u, z.avail_in);
-    if (rv != Z_OK || z.avail_in) {
+    DCHECK_EQ(0u, z->avail_in);
+    if (rv != Z_OK || z->avail_in) {
       return "";
     }
 
-    z.next_in =
+    z->next_in =
         const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(certs[i].data()));
-    z.avail_in = certs[i].size();
-    rv = deflate(&z, Z_NO_FLUSH);
+    z->avail_in = certs[i].size();
+    rv = deflate(z, Z_NO_FLUSH);
     DCHECK_EQ(Z_OK, rv);
-    DCHECK_EQ(0u, z.avail_in);
-    if (rv != Z_OK || z.avail_in) {
+    DCHECK_EQ(0u, z->avail_in);
+    if (rv != Z_OK || z->avail_in) {
       return "";
     }
   }
 
-  z.avail_in = 0;
-  rv = deflate(&z, Z_FINISH);
+  z->avail_in = 0;
+  rv = deflate(z, Z_FINISH);
   DCHECK_EQ(Z_STREAM_END, rv);
   if (rv != Z_STREAM_END) {
     return "";
   }
 
-  result.resize(result.size() - z.avail_out);
+  result.resize(result.size() - z->avail_out);
   return result;
 }
 
@@ -555,6 +682,17 @@ bool CertCompressor::DecompressChain(
     const std::vector<QuicString>& cached_certs,
     const CommonCertSets* common_sets,
     std::vector<QuicString>* out_certs) {
+  return DecompressChain(in, cached_certs, common_sets,
+                         /*stream_pool=*/nullptr, out_certs);
+}
+
+// static
+bool CertCompressor::DecompressChain(
+    QuicStringPiece in,
+    const std::vector<QuicString>& cached_certs,
+    const CommonCertSets* common_sets,
+    ZlibStreamPool* stream_pool,
+    std::vector<QuicString>* out_certs) {
   std::vector<CertEntry> entries;
   if (!ParseEntries(&in, cached_certs, common_sets, &entries, out_certs)) {
     return false;
@@ -578,32 +716,40 @@ bool CertCompressor::DecompressChain(
     }
 
     uncompressed_data = QuicMakeUnique<uint8_t[]>(uncompressed_size);
-    z_stream z;
-    ScopedZLib scoped_z(ScopedZLib::INFLATE);
-
-    memset(&z, 0, sizeof(z));
-    z.next_out = uncompressed_data.get();
-    z.avail_out = uncompressed_size;
-    z.next_in =
-        const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(in.data()));
-    z.avail_in = in.size();
+    z_stream local_z;
+    z_stream* z = &local_z;
+    ScopedZLib scoped_z(ScopedZLib::INFLATE, stream_pool);
 
-    if (Z_OK != inflateInit(&z)) {
-      return false;
+    if (stream_pool != nullptr) {
+      z = stream_pool->AcquireInflateStream();
+      if (z == nullptr) {
+        return false;
+      }
+    } else {
+      memset(z, 0, sizeof(*z));
+      if (Z_OK != inflateInit(z)) {
+        return false;
+      }
     }
-    scoped_z.reset(&z);
+    scoped_z.reset(z);
+
+    z->next_out = uncompressed_data.get();
+    z->avail_out = uncompressed_size;
+    z->next_in =
+        const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(in.data()));
+    z->avail_in = in.size();
 
-    int rv = inflate(&z, Z_FINISH);
+    int rv = inflate(z, Z_FINISH);
     if (rv == Z_NEED_DICT) {
       QuicString zlib_dict = ZlibDictForEntries(entries, *out_certs);
       const uint8_t* dict = reinterpret_cast<const uint8_t*>(zlib_dict.data());
-      if (Z_OK != inflateSetDictionary(&z, dict, zlib_dict.size())) {
+      if (Z_OK != inflateSetDictionary(z, dict, zlib_dict.size())) {
         return false;
       }
-      rv = inflate(&z, Z_FINISH);
+      rv = inflate(z, Z_FINISH);
     }
 
-    if (Z_STREAM_END != rv || z.avail_out > 0 || z.avail_in > 0) {
+    if (Z_STREAM_END != rv || z->avail_out > 0 || z->avail_in > 0) {
       return false;
     }
 
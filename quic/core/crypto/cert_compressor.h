@@ -5,15 +5,19 @@
 #ifndef QUICHE_QUIC_CORE_CRYPTO_CERT_COMPRESSOR_H_
 #define QUICHE_QUIC_CORE_CRYPTO_CERT_COMPRESSOR_H_
 
+#include <cstddef>
 #include <vector>
 
 #include "base/macros.h"
 #include "net/third_party/quiche/src/quic/core/crypto/common_cert_set.h"
 #include "net/third_party/quiche/src/quic/core/crypto/crypto_protocol.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_mutex.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
 
+struct z_stream_s;
+
 namespace quic {
 
 // CertCompressor provides functions for compressing and decompressing
@@ -32,6 +36,44 @@ class QUIC_EXPORT_PRIVATE CertCompressor {
  public:
   CertCompressor() = delete;
 
+  // ZlibStreamPool keeps idle zlib streams so that compressing or
+  // decompressing a chain resets one with deflateReset/inflateReset instead of
+  // allocating and initializing a new stream.  The dictionary is still loaded
+  // for each chain, since resetting a stream discards it, so an idle stream
+  // can be used with any dictionary.  It is thread-safe.
+  class QUIC_EXPORT_PRIVATE ZlibStreamPool {
+   public:
+    // Keeps up to |max_idle_streams| deflate streams and |max_idle_streams|
+    // inflate streams.
+    explicit ZlibStreamPool(size_t max_idle_streams);
+    ZlibStreamPool(const ZlibStreamPool&) = delete;
+    ZlibStreamPool& operator=(const ZlibStreamPool&) = delete;
+    ~ZlibStreamPool();
+
+    // Returns an idle deflate stream, or a newly initialized one if there is
+    // none.  Returns nullptr if a stream cannot be initialized.  The stream
+    // must be passed to ReleaseDeflateStream.
+    z_stream_s* AcquireDeflateStream();
+    // Resets |z| and keeps it for reuse, or ends it if the pool is full.
+    void ReleaseDeflateStream(z_stream_s* z);
+
+    // As above, for inflate streams.
+    z_stream_s* AcquireInflateStream();
+    void ReleaseInflateStream(z_stream_s* z);
+
+    // The number of streams which were reused and which were initialized.
+    size_t num_reused() const;
+    size_t num_initialized() const;
+
+   private:
+    const size_t max_idle_streams_;
+    mutable QuicMutex lock_;
+    std::vector<z_stream_s*> idle_deflate_streams_ GUARDED_BY(lock_);
+    std::vector<z_stream_s*> idle_inflate_streams_ GUARDED_BY(lock_);
+    size_t num_reused_ GUARDED_BY(lock_);
+    size_t num_initialized_ GUARDED_BY(lock_);
+  };
+
   // CompressChain compresses the certificates in |certs| and returns a
   // compressed representation. |common_sets| contains the common certificate
   // sets known locally and |client_common_set_hashes| contains the hashes of
@@ -42,6 +84,14 @@ class QUIC_EXPORT_PRIVATE CertCompressor {
                                   QuicStringPiece client_cached_cert_hashes,
                                   const CommonCertSets* common_sets);
 
+  // As above, but if |stream_pool| is not null, takes the deflate stream from
+  // it.  The output is identical.
+  static QuicString CompressChain(const std::vector<QuicString>& certs,
+                                  QuicStringPiece client_common_set_hashes,
+                                  QuicStringPiece client_cached_cert_hashes,
+                                  const CommonCertSets* common_sets,
+                                  ZlibStreamPool* stream_pool);
+
   // DecompressChain decompresses the result of |CompressChain|, given in |in|,
   // into a series of certificates that are written to |out_certs|.
   // |cached_certs| contains certificates that the peer may have omitted and
@@ -50,6 +100,14 @@ class QUIC_EXPORT_PRIVATE CertCompressor {
                               const std::vector<QuicString>& cached_certs,
                               const CommonCertSets* common_sets,
                               std::vector<QuicString>* out_certs);
+
+  // As above, but if |stream_pool| is not null, takes the inflate stream from
+  // it.
+  static bool DecompressChain(QuicStringPiece in,
+                              const std::vector<QuicString>& cached_certs,
+                              const CommonCertSets* common_sets,
+                              ZlibStreamPool* stream_pool,
+                              std::vector<QuicString>* out_certs);
 };
 
 }  // namespace quic
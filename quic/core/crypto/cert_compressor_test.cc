@@ -89,6 +89,56 @@ TEST_F(CertCompressorTest, Cached) {
   EXPECT_EQ(chain[0], chain2[0]);
 }
 
+TEST_F(CertCompressorTest, StreamPool) {
+  std::vector<QuicString> chain;
+  chain.push_back("cachedcert");
+  chain.push_back("testcert");
+  uint64_t hash = QuicUtils::FNV1a_64_Hash(chain[0]);
+  QuicStringPiece hash_bytes(reinterpret_cast<char*>(&hash), sizeof(hash));
+  std::vector<QuicString> cached_certs;
+  cached_certs.push_back(chain[0]);
+
+  CertCompressor::ZlibStreamPool pool(1);
+  // The second chain needs another dictionary, so a reused stream must not
+  // keep the first one.
+  std::vector<std::vector<QuicString>> chains = {chain, chain, {"othercert"}};
+  for (const std::vector<QuicString>& c : chains) {
+    const QuicString expected = CertCompressor::CompressChain(
+        c, QuicStringPiece(), hash_bytes, nullptr);
+    const QuicString compressed = CertCompressor::CompressChain(
+        c, QuicStringPiece(), hash_bytes, nullptr, &pool);
+    EXPECT_EQ(expected, compressed);
+
+    // The output of a reused stream decompresses with a fresh inflater.
+    std::vector<QuicString> chain2;
+    ASSERT_TRUE(CertCompressor::DecompressChain(compressed, cached_certs,
+                                                nullptr, &chain2));
+    EXPECT_EQ(c, chain2);
+
+    chain2.clear();
+    ASSERT_TRUE(CertCompressor::DecompressChain(compressed, cached_certs,
+                                                nullptr, &pool, &chain2));
+    EXPECT_EQ(c, chain2);
+  }
+  // One deflate stream and one inflate stream were initialized, then reused.
+  EXPECT_EQ(2u, pool.num_initialized());
+  EXPECT_EQ(4u, pool.num_reused());
+
+  // A stream which failed to decompress is reset before it is reused.
+  std::vector<QuicString> chain2;
+  EXPECT_FALSE(CertCompressor::DecompressChain(
+      QuicTextUtils::HexDecode("0100"     /* compressed, end of list */
+                               "08000000" /* uncompressed size 8 */
+                               "ffffffff" /* not zlib */),
+      cached_certs, nullptr, &pool, &chain2));
+  chain2.clear();
+  const QuicString compressed = CertCompressor::CompressChain(
+      chain, QuicStringPiece(), hash_bytes, nullptr, &pool);
+  ASSERT_TRUE(CertCompressor::DecompressChain(compressed, cached_certs,
+                                              nullptr, &pool, &chain2));
+  EXPECT_EQ(chain, chain2);
+}
+
 TEST_F(CertCompressorTest, BadInputs) {
   std::vector<QuicString> cached_certs, chain;
 
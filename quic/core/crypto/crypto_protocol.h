@@ -178,6 +178,10 @@ const QuicTag kTCID = TAG('T', 'C', 'I', 'D');   // Connection ID truncation.
 // Multipath option.
 const QuicTag kMPTH = TAG('M', 'P', 'T', 'H');   // Enable multipath.
 
+// Forward error correction option.
+const QuicTag kFECT = TAG('F', 'E', 'C', 'T');   // Send FEC repair packets
+                                                 // after the tail of a flight.
+
 const QuicTag kNCMR = TAG('N', 'C', 'M', 'R');   // Do not attempt connection
                                                  // migration.
 
@@ -0,0 +1,132 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/crypto/crypto_worker_pool.h"
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_thread.h"
+
+namespace quic {
+
+class CryptoWorkerPool::Worker : public QuicThread {
+ public:
+  explicit Worker(CryptoWorkerPool* pool)
+      : QuicThread("crypto_worker"), pool_(pool) {}
+  Worker(const Worker&) = delete;
+  Worker& operator=(const Worker&) = delete;
+
+  void Run() override { pool_->RunWorker(this); }
+
+  // Notified when a task is posted while this worker is idle, or when the
+  // pool stops.  Replaced each time the worker becomes idle.
+  std::unique_ptr<QuicNotification> wake_up;
+
+ private:
+  CryptoWorkerPool* pool_;  // Not owned.
+};
+
+CryptoWorkerPool::CryptoWorkerPool(size_t num_threads,
+                                   size_t max_pending_tasks)
+    : max_pending_tasks_(max_pending_tasks), stopping_(false) {
+  DCHECK_GT(num_threads, 0u);
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.push_back(QuicMakeUnique<Worker>(this));
+    workers_.back()->Start();
+  }
+}
+
+CryptoWorkerPool::~CryptoWorkerPool() {
+  {
+    QuicWriterMutexLock lock(&lock_);
+    stopping_ = true;
+    for (Worker* worker : idle_workers_) {
+      worker->wake_up->Notify();
+    }
+    idle_workers_.clear();
+  }
+  for (const auto& worker : workers_) {
+    worker->Join();
+  }
+}
+
+void CryptoWorkerPool::set_completion_notifier(
+    std::function<void()> completion_notifier) {
+  QuicWriterMutexLock lock(&lock_);
+  completion_notifier_ = std::move(completion_notifier);
+}
+
+bool CryptoWorkerPool::Post(std::unique_ptr<Task> task) {
+  {
+    QuicWriterMutexLock lock(&lock_);
+    if (!stopping_ && pending_tasks_.size() < max_pending_tasks_) {
+      pending_tasks_.push_back(std::move(task));
+      if (!idle_workers_.empty()) {
+        idle_workers_.back()->wake_up->Notify();
+        idle_workers_.pop_back();
+      }
+      return true;
+    }
+  }
+  QUIC_DVLOG(1) << "Crypto worker pool is full, running task synchronously.";
+  task->Run();
+  task->OnComplete();
+  return false;
+}
+
+void CryptoWorkerPool::RunCompletions() {
+  QuicDeque<std::unique_ptr<Task>> completed_tasks;
+  {
+    QuicWriterMutexLock lock(&lock_);
+    completed_tasks.swap(completed_tasks_);
+  }
+  while (!completed_tasks.empty()) {
+    completed_tasks.front()->OnComplete();
+    completed_tasks.pop_front();
+  }
+}
+
+size_t CryptoWorkerPool::num_pending_tasks() const {
+  QuicReaderMutexLock lock(&lock_);
+  return pending_tasks_.size();
+}
+
+void CryptoWorkerPool::RunWorker(Worker* worker) {
+  while (true) {
+    std::unique_ptr<Task> task;
+    QuicNotification* wake_up = nullptr;
+    {
+      QuicWriterMutexLock lock(&lock_);
+      if (stopping_) {
+        return;
+      }
+      if (pending_tasks_.empty()) {
+        worker->wake_up = QuicMakeUnique<QuicNotification>();
+        wake_up = worker->wake_up.get();
+        idle_workers_.push_back(worker);
+      } else {
+        task = std::move(pending_tasks_.front());
+        pending_tasks_.pop_front();
+      }
+    }
+    if (task == nullptr) {
+      wake_up->WaitForNotification();
+      continue;
+    }
+
+    task->Run();
+
+    std::function<void()> completion_notifier;
+    {
+      QuicWriterMutexLock lock(&lock_);
+      completed_tasks_.push_back(std::move(task));
+      completion_notifier = completion_notifier_;
+    }
+    if (completion_notifier) {
+      completion_notifier();
+    }
+  }
+}
+
+}  // namespace quic
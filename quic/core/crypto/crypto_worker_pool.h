@@ -0,0 +1,85 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_CRYPTO_CRYPTO_WORKER_POOL_H_
+#define QUICHE_QUIC_CORE_CRYPTO_CRYPTO_WORKER_POOL_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_containers.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_mutex.h"
+
+namespace quic {
+
+// CryptoWorkerPool runs expensive crypto operations, such as signatures, on a
+// fixed number of worker threads, so that they do not block the thread which
+// owns the pool, typically an event loop.  Completions are run on the owner
+// thread by RunCompletions().
+class QUIC_EXPORT_PRIVATE CryptoWorkerPool {
+ public:
+  // An operation to be run on a worker thread.
+  class QUIC_EXPORT_PRIVATE Task {
+   public:
+    virtual ~Task() {}
+
+    // Runs the operation.  Called on a worker thread.
+    virtual void Run() = 0;
+
+    // Delivers the result of Run().  Called on the owner thread.
+    virtual void OnComplete() = 0;
+  };
+
+  // Starts |num_threads| worker threads.  At most |max_pending_tasks| tasks
+  // wait for a worker thread at any time.
+  CryptoWorkerPool(size_t num_threads, size_t max_pending_tasks);
+  CryptoWorkerPool(const CryptoWorkerPool&) = delete;
+  CryptoWorkerPool& operator=(const CryptoWorkerPool&) = delete;
+
+  // Waits for running tasks to finish and stops the worker threads.  Tasks
+  // which have not started or completed are deleted without being completed.
+  ~CryptoWorkerPool();
+
+  // Sets a function which is called on a worker thread each time a task has
+  // run.  It should wake up the owner thread, so that it calls
+  // RunCompletions().
+  void set_completion_notifier(std::function<void()> completion_notifier);
+
+  // Runs |task| on a worker thread, and completes it in a later call to
+  // RunCompletions().  If |max_pending_tasks| tasks are already waiting, runs
+  // and completes |task| synchronously instead.  Returns true if |task| was
+  // handed to a worker thread.
+  bool Post(std::unique_ptr<Task> task);
+
+  // Completes the tasks which have run on a worker thread.
+  void RunCompletions();
+
+  // The number of tasks waiting for a worker thread.
+  size_t num_pending_tasks() const;
+
+ private:
+  class Worker;
+
+  // The loop run by each worker thread.
+  void RunWorker(Worker* worker);
+
+  const size_t max_pending_tasks_;
+
+  mutable QuicMutex lock_;
+  QuicDeque<std::unique_ptr<Task>> pending_tasks_ GUARDED_BY(lock_);
+  QuicDeque<std::unique_ptr<Task>> completed_tasks_ GUARDED_BY(lock_);
+  // Worker threads waiting for a task.
+  std::vector<Worker*> idle_workers_ GUARDED_BY(lock_);
+  std::function<void()> completion_notifier_ GUARDED_BY(lock_);
+  bool stopping_ GUARDED_BY(lock_);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_CRYPTO_CRYPTO_WORKER_POOL_H_
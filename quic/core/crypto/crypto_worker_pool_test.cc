@@ -0,0 +1,97 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/crypto/crypto_worker_pool.h"
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_mutex.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+class TestTask : public CryptoWorkerPool::Task {
+ public:
+  TestTask(QuicNotification* started,
+           QuicNotification* unblock,
+           bool* ran,
+           bool* completed)
+      : started_(started), unblock_(unblock), ran_(ran), completed_(completed) {}
+
+  void Run() override {
+    if (started_ != nullptr) {
+      started_->Notify();
+    }
+    if (unblock_ != nullptr) {
+      unblock_->WaitForNotification();
+    }
+    *ran_ = true;
+  }
+
+  void OnComplete() override {
+    EXPECT_TRUE(*ran_);
+    *completed_ = true;
+  }
+
+ private:
+  QuicNotification* started_;
+  QuicNotification* unblock_;
+  bool* ran_;
+  bool* completed_;
+};
+
+class CryptoWorkerPoolTest : public QuicTest {};
+
+TEST_F(CryptoWorkerPoolTest, CompletesOnOwnerThread) {
+  CryptoWorkerPool pool(2, 10);
+  QuicNotification task_done;
+  pool.set_completion_notifier([&task_done]() { task_done.Notify(); });
+
+  bool ran = false;
+  bool completed = false;
+  EXPECT_TRUE(pool.Post(
+      QuicMakeUnique<TestTask>(nullptr, nullptr, &ran, &completed)));
+  task_done.WaitForNotification();
+  EXPECT_TRUE(ran);
+  EXPECT_FALSE(completed);
+
+  pool.RunCompletions();
+  EXPECT_TRUE(completed);
+}
+
+TEST_F(CryptoWorkerPoolTest, RunsSynchronouslyWhenFull) {
+  CryptoWorkerPool pool(1, 1);
+
+  // Keep the only worker busy.
+  QuicNotification started;
+  QuicNotification unblock;
+  bool blocking_ran = false;
+  bool blocking_completed = false;
+  EXPECT_TRUE(pool.Post(QuicMakeUnique<TestTask>(
+      &started, &unblock, &blocking_ran, &blocking_completed)));
+  started.WaitForNotification();
+
+  // Fill the queue.
+  bool queued_ran = false;
+  bool queued_completed = false;
+  EXPECT_TRUE(pool.Post(QuicMakeUnique<TestTask>(
+      nullptr, nullptr, &queued_ran, &queued_completed)));
+  EXPECT_EQ(1u, pool.num_pending_tasks());
+
+  // The next task does not fit, and is run and completed inline.
+  bool inline_ran = false;
+  bool inline_completed = false;
+  EXPECT_FALSE(pool.Post(QuicMakeUnique<TestTask>(
+      nullptr, nullptr, &inline_ran, &inline_completed)));
+  EXPECT_TRUE(inline_ran);
+  EXPECT_TRUE(inline_completed);
+  EXPECT_EQ(1u, pool.num_pending_tasks());
+
+  unblock.Notify();
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -0,0 +1,74 @@
+// Copyright (c) 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/crypto/early_data_fallback_decrypter.h"
+
+#include <utility>
+
+namespace quic {
+
+EarlyDataFallbackDecrypter::EarlyDataFallbackDecrypter(
+    std::unique_ptr<QuicDecrypter> handshake_decrypter,
+    std::unique_ptr<QuicDecrypter> early_data_decrypter)
+    : handshake_decrypter_(std::move(handshake_decrypter)),
+      early_data_decrypter_(std::move(early_data_decrypter)) {}
+
+EarlyDataFallbackDecrypter::~EarlyDataFallbackDecrypter() {}
+
+bool EarlyDataFallbackDecrypter::SetKey(QuicStringPiece key) {
+  return false;
+}
+
+bool EarlyDataFallbackDecrypter::SetNoncePrefix(QuicStringPiece nonce_prefix) {
+  return false;
+}
+
+bool EarlyDataFallbackDecrypter::SetIV(QuicStringPiece iv) {
+  return false;
+}
+
+size_t EarlyDataFallbackDecrypter::GetKeySize() const {
+  return handshake_decrypter_->GetKeySize();
+}
+
+size_t EarlyDataFallbackDecrypter::GetIVSize() const {
+  return handshake_decrypter_->GetIVSize();
+}
+
+bool EarlyDataFallbackDecrypter::SetPreliminaryKey(QuicStringPiece key) {
+  return false;
+}
+
+bool EarlyDataFallbackDecrypter::SetDiversificationNonce(
+    const DiversificationNonce& nonce) {
+  return true;
+}
+
+bool EarlyDataFallbackDecrypter::DecryptPacket(uint64_t packet_number,
+                                               QuicStringPiece associated_data,
+                                               QuicStringPiece ciphertext,
+                                               char* output,
+                                               size_t* output_length,
+                                               size_t max_output_length) {
+  return handshake_decrypter_->DecryptPacket(packet_number, associated_data,
+                                             ciphertext, output, output_length,
+                                             max_output_length) ||
+         early_data_decrypter_->DecryptPacket(packet_number, associated_data,
+                                              ciphertext, output,
+                                              output_length, max_output_length);
+}
+
+uint32_t EarlyDataFallbackDecrypter::cipher_id() const {
+  return handshake_decrypter_->cipher_id();
+}
+
+QuicStringPiece EarlyDataFallbackDecrypter::GetKey() const {
+  return handshake_decrypter_->GetKey();
+}
+
+QuicStringPiece EarlyDataFallbackDecrypter::GetNoncePrefix() const {
+  return handshake_decrypter_->GetNoncePrefix();
+}
+
+}  // namespace quic
@@ -0,0 +1,61 @@
+// Copyright (c) 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_CRYPTO_EARLY_DATA_FALLBACK_DECRYPTER_H_
+#define QUICHE_QUIC_CORE_CRYPTO_EARLY_DATA_FALLBACK_DECRYPTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "net/third_party/quiche/src/quic/core/crypto/quic_decrypter.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
+
+namespace quic {
+
+// EarlyDataFallbackDecrypter decrypts packets at ENCRYPTION_ZERO_RTT on the
+// server once the handshake read key is available.  QUIC uses that level for
+// both 0-RTT packets and handshake packets, but the framer only keeps a single
+// decrypter for it, so packets that fail to decrypt with the handshake key are
+// retried with the early data key.  The decrypter is dropped when the framer
+// latches on to the forward-secure decrypter.
+class QUIC_EXPORT_PRIVATE EarlyDataFallbackDecrypter : public QuicDecrypter {
+ public:
+  EarlyDataFallbackDecrypter(
+      std::unique_ptr<QuicDecrypter> handshake_decrypter,
+      std::unique_ptr<QuicDecrypter> early_data_decrypter);
+  EarlyDataFallbackDecrypter(const EarlyDataFallbackDecrypter&) = delete;
+  EarlyDataFallbackDecrypter& operator=(const EarlyDataFallbackDecrypter&) =
+      delete;
+  ~EarlyDataFallbackDecrypter() override;
+
+  // QuicCrypter implementation.  Both decrypters are keyed on construction.
+  bool SetKey(QuicStringPiece key) override;
+  bool SetNoncePrefix(QuicStringPiece nonce_prefix) override;
+  bool SetIV(QuicStringPiece iv) override;
+  size_t GetKeySize() const override;
+  size_t GetIVSize() const override;
+
+  // QuicDecrypter implementation.
+  bool SetPreliminaryKey(QuicStringPiece key) override;
+  bool SetDiversificationNonce(const DiversificationNonce& nonce) override;
+  bool DecryptPacket(uint64_t packet_number,
+                     QuicStringPiece associated_data,
+                     QuicStringPiece ciphertext,
+                     char* output,
+                     size_t* output_length,
+                     size_t max_output_length) override;
+  uint32_t cipher_id() const override;
+  QuicStringPiece GetKey() const override;
+  QuicStringPiece GetNoncePrefix() const override;
+
+ private:
+  std::unique_ptr<QuicDecrypter> handshake_decrypter_;
+  std::unique_ptr<QuicDecrypter> early_data_decrypter_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_CRYPTO_EARLY_DATA_FALLBACK_DECRYPTER_H_
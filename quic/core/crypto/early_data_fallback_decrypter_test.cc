@@ -0,0 +1,89 @@
+// Copyright (c) 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/crypto/early_data_fallback_decrypter.h"
+
+#include <memory>
+#include <utility>
+
+#include "net/third_party/quiche/src/quic/core/crypto/aes_128_gcm_decrypter.h"
+#include "net/third_party/quiche/src/quic/core/crypto/aes_128_gcm_encrypter.h"
+#include "net/third_party/quiche/src/quic/core/quic_constants.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+const char kAssociatedData[] = "header";
+const char kPlaintext[] = "payload";
+
+class EarlyDataFallbackDecrypterTest : public QuicTest {
+ protected:
+  EarlyDataFallbackDecrypterTest()
+      : decrypter_(CreateDecrypter('h'), CreateDecrypter('e')) {}
+
+  // Returns a decrypter for the key and IV made of |key_byte|.
+  static std::unique_ptr<QuicDecrypter> CreateDecrypter(char key_byte) {
+    auto decrypter = QuicMakeUnique<Aes128GcmDecrypter>();
+    EXPECT_TRUE(
+        decrypter->SetKey(QuicString(decrypter->GetKeySize(), key_byte)));
+    EXPECT_TRUE(
+        decrypter->SetIV(QuicString(decrypter->GetIVSize(), key_byte)));
+    return std::move(decrypter);
+  }
+
+  // Encrypts packet |packet_number| with the key and IV made of |key_byte|.
+  static QuicString Encrypt(char key_byte, uint64_t packet_number) {
+    Aes128GcmEncrypter encrypter;
+    EXPECT_TRUE(encrypter.SetKey(QuicString(encrypter.GetKeySize(), key_byte)));
+    EXPECT_TRUE(encrypter.SetIV(QuicString(encrypter.GetIVSize(), key_byte)));
+    char buffer[kMaxPacketSize];
+    size_t length = 0;
+    EXPECT_TRUE(encrypter.EncryptPacket(packet_number, kAssociatedData,
+                                        kPlaintext, buffer, &length,
+                                        sizeof(buffer)));
+    return QuicString(buffer, length);
+  }
+
+  // Returns true if |ciphertext| decrypts back to kPlaintext.
+  bool Decrypt(uint64_t packet_number, const QuicString& ciphertext) {
+    char buffer[kMaxPacketSize];
+    size_t length = 0;
+    if (!decrypter_.DecryptPacket(packet_number, kAssociatedData, ciphertext,
+                                  buffer, &length, sizeof(buffer))) {
+      return false;
+    }
+    EXPECT_EQ(kPlaintext, QuicString(buffer, length));
+    return true;
+  }
+
+  EarlyDataFallbackDecrypter decrypter_;
+};
+
+TEST_F(EarlyDataFallbackDecrypterTest, DecryptsHandshakePackets) {
+  EXPECT_TRUE(Decrypt(1, Encrypt('h', 1)));
+}
+
+TEST_F(EarlyDataFallbackDecrypterTest, FallsBackToEarlyDataKey) {
+  EXPECT_TRUE(Decrypt(2, Encrypt('e', 2)));
+}
+
+TEST_F(EarlyDataFallbackDecrypterTest, RejectsPacketsUnderOtherKeys) {
+  EXPECT_FALSE(Decrypt(3, Encrypt('x', 3)));
+  // The packet number is part of the nonce.
+  EXPECT_FALSE(Decrypt(4, Encrypt('e', 3)));
+}
+
+TEST_F(EarlyDataFallbackDecrypterTest, CannotBeRekeyed) {
+  EXPECT_FALSE(decrypter_.SetKey(QuicString(decrypter_.GetKeySize(), 'x')));
+  EXPECT_FALSE(decrypter_.SetIV(QuicString(decrypter_.GetIVSize(), 'x')));
+  EXPECT_EQ(QuicString(decrypter_.GetKeySize(), 'h'), decrypter_.GetKey());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
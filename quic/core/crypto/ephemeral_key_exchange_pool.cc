@@ -0,0 +1,161 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/crypto/ephemeral_key_exchange_pool.h"
+
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_server_stats.h"
+
+namespace quic {
+
+class EphemeralKeyExchangePool::RefillTask : public CryptoWorkerPool::Task {
+ public:
+  RefillTask(EphemeralKeyExchangePool* pool, QuicRandom* rand)
+      : pool_(pool), rand_(rand) {}
+
+  void Run() override { pool_->Refill(rand_); }
+
+  void OnComplete() override { pool_->OnRefillComplete(); }
+
+ private:
+  EphemeralKeyExchangePool* pool_;  // Not owned.
+  QuicRandom* rand_;                // Not owned.
+};
+
+EphemeralKeyExchangePool::KeyPool::KeyPool(const KeyExchange::Factory* factory)
+    : factory(factory) {}
+
+EphemeralKeyExchangePool::KeyPool::KeyPool(KeyPool&& other) = default;
+
+EphemeralKeyExchangePool::KeyPool::~KeyPool() {}
+
+EphemeralKeyExchangePool::EphemeralKeyExchangePool(
+    size_t max_depth,
+    CryptoWorkerPool* worker_pool)
+    : max_depth_(max_depth),
+      worker_pool_(worker_pool),
+      refill_pending_(false),
+      num_hits_(0),
+      num_misses_(0) {}
+
+EphemeralKeyExchangePool::~EphemeralKeyExchangePool() {}
+
+std::unique_ptr<KeyExchange> EphemeralKeyExchangePool::Take(
+    const KeyExchange::Factory& factory,
+    QuicRandom* rand) {
+  std::unique_ptr<KeyExchange> key_exchange;
+  bool needs_refill;
+  {
+    QuicWriterMutexLock lock(&lock_);
+    auto it = key_pools_.find(factory.tag());
+    if (it == key_pools_.end()) {
+      it = key_pools_.emplace(factory.tag(), KeyPool(&factory)).first;
+    }
+    QuicDeque<std::unique_ptr<KeyExchange>>* keys = &it->second.keys;
+    if (!keys->empty()) {
+      key_exchange = std::move(keys->front());
+      keys->pop_front();
+      ++num_hits_;
+    } else {
+      ++num_misses_;
+    }
+    needs_refill = keys->size() < (max_depth_ + 1) / 2;
+  }
+  QUIC_SERVER_HISTOGRAM_BOOL(
+      "EphemeralKeyExchangePool.Hit", key_exchange != nullptr,
+      "Whether a forward-secure key pair was taken from the pool, rather than "
+      "generated during the handshake.");
+
+  if (needs_refill) {
+    MaybePostRefill(rand);
+  }
+  if (key_exchange == nullptr) {
+    key_exchange = factory.Create(rand);
+  }
+  return key_exchange;
+}
+
+void EphemeralKeyExchangePool::Refill(QuicRandom* rand) {
+  struct Shortfall {
+    QuicTag tag;
+    const KeyExchange::Factory* factory;
+    size_t count;
+  };
+  std::vector<Shortfall> shortfalls;
+  {
+    QuicReaderMutexLock lock(&lock_);
+    for (const auto& key_pool : key_pools_) {
+      size_t size = key_pool.second.keys.size();
+      if (size < max_depth_) {
+        shortfalls.push_back(
+            {key_pool.first, key_pool.second.factory, max_depth_ - size});
+      }
+    }
+  }
+
+  // Generate keys without holding the lock, so that Take() is not blocked.
+  for (const Shortfall& shortfall : shortfalls) {
+    std::vector<std::unique_ptr<KeyExchange>> keys;
+    for (size_t i = 0; i < shortfall.count; ++i) {
+      keys.push_back(shortfall.factory->Create(rand));
+    }
+
+    QuicWriterMutexLock lock(&lock_);
+    QuicDeque<std::unique_ptr<KeyExchange>>* pool =
+        &key_pools_.find(shortfall.tag)->second.keys;
+    for (auto& key : keys) {
+      if (pool->size() >= max_depth_) {
+        break;
+      }
+      pool->push_back(std::move(key));
+    }
+  }
+}
+
+size_t EphemeralKeyExchangePool::depth(QuicTag tag) const {
+  QuicReaderMutexLock lock(&lock_);
+  auto it = key_pools_.find(tag);
+  if (it == key_pools_.end()) {
+    return 0;
+  }
+  return it->second.keys.size();
+}
+
+uint64_t EphemeralKeyExchangePool::num_hits() const {
+  QuicReaderMutexLock lock(&lock_);
+  return num_hits_;
+}
+
+uint64_t EphemeralKeyExchangePool::num_misses() const {
+  QuicReaderMutexLock lock(&lock_);
+  return num_misses_;
+}
+
+void EphemeralKeyExchangePool::MaybePostRefill(QuicRandom* rand) {
+  if (worker_pool_ == nullptr) {
+    return;
+  }
+  // Do not let a refill delay handshakes which are already waiting for a
+  // worker, nor run it inline because the worker pool is full.
+  if (worker_pool_->num_pending_tasks() > 0) {
+    return;
+  }
+  {
+    QuicWriterMutexLock lock(&lock_);
+    if (refill_pending_) {
+      return;
+    }
+    refill_pending_ = true;
+  }
+  worker_pool_->Post(QuicMakeUnique<RefillTask>(this, rand));
+}
+
+void EphemeralKeyExchangePool::OnRefillComplete() {
+  QuicWriterMutexLock lock(&lock_);
+  refill_pending_ = false;
+}
+
+}  // namespace quic
@@ -0,0 +1,87 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_CRYPTO_EPHEMERAL_KEY_EXCHANGE_POOL_H_
+#define QUICHE_QUIC_CORE_CRYPTO_EPHEMERAL_KEY_EXCHANGE_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+
+#include "net/third_party/quiche/src/quic/core/crypto/crypto_protocol.h"
+#include "net/third_party/quiche/src/quic/core/crypto/crypto_worker_pool.h"
+#include "net/third_party/quiche/src/quic/core/crypto/key_exchange.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_containers.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_mutex.h"
+
+namespace quic {
+
+class QuicRandom;
+
+// EphemeralKeyExchangePool keeps key pairs generated ahead of time for each
+// type of KeyExchange that it has been asked for, so that a handshake which
+// needs a forward-secure key does not wait for a key to be generated.
+class QUIC_EXPORT_PRIVATE EphemeralKeyExchangePool {
+ public:
+  // Keeps up to |max_depth| key pairs of each type.  If |worker_pool| is not
+  // null, the pool is refilled on it whenever it drops below half of
+  // |max_depth|, and |worker_pool| must be destroyed before this object.
+  // Otherwise, Refill() must be called by the owner, for example from an
+  // alarm.
+  EphemeralKeyExchangePool(size_t max_depth, CryptoWorkerPool* worker_pool);
+  EphemeralKeyExchangePool(const EphemeralKeyExchangePool&) = delete;
+  EphemeralKeyExchangePool& operator=(const EphemeralKeyExchangePool&) =
+      delete;
+  ~EphemeralKeyExchangePool();
+
+  // Returns a key pair created by |factory|.  It is taken from the pool if
+  // one is available, and generated with |rand| otherwise.
+  std::unique_ptr<KeyExchange> Take(const KeyExchange::Factory& factory,
+                                    QuicRandom* rand);
+
+  // Generates key pairs with |rand| until the pool of each type which has been
+  // taken from is full.  May be called on any thread.
+  void Refill(QuicRandom* rand);
+
+  // Returns the number of key pairs available for |tag|.
+  size_t depth(QuicTag tag) const;
+
+  // The number of calls to Take() which were served from the pool, and which
+  // had to generate a key pair.
+  uint64_t num_hits() const;
+  uint64_t num_misses() const;
+
+ private:
+  class RefillTask;
+
+  struct KeyPool {
+    explicit KeyPool(const KeyExchange::Factory* factory);
+    KeyPool(KeyPool&& other);
+    ~KeyPool();
+
+    const KeyExchange::Factory* factory;  // Not owned.
+    QuicDeque<std::unique_ptr<KeyExchange>> keys;
+  };
+
+  // Posts a RefillTask to |worker_pool_| unless one is already pending.
+  void MaybePostRefill(QuicRandom* rand);
+
+  // Called by RefillTask on completion.
+  void OnRefillComplete();
+
+  const size_t max_depth_;
+  CryptoWorkerPool* worker_pool_;  // Not owned.
+
+  mutable QuicMutex lock_;
+  std::map<QuicTag, KeyPool> key_pools_ GUARDED_BY(lock_);
+  bool refill_pending_ GUARDED_BY(lock_);
+  uint64_t num_hits_ GUARDED_BY(lock_);
+  uint64_t num_misses_ GUARDED_BY(lock_);
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_CRYPTO_EPHEMERAL_KEY_EXCHANGE_POOL_H_
@@ -0,0 +1,73 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/crypto/ephemeral_key_exchange_pool.h"
+
+#include "net/third_party/quiche/src/quic/core/crypto/curve25519_key_exchange.h"
+#include "net/third_party/quiche/src/quic/core/crypto/quic_random.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_mutex.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+class EphemeralKeyExchangePoolTest : public QuicTest {
+ public:
+  EphemeralKeyExchangePoolTest()
+      : rand_(QuicRandom::GetInstance()),
+        factory_(Curve25519KeyExchange::New(
+                     Curve25519KeyExchange::NewPrivateKey(rand_))
+                     ->GetFactory()) {}
+
+ protected:
+  QuicRandom* rand_;
+  const KeyExchange::Factory& factory_;
+};
+
+TEST_F(EphemeralKeyExchangePoolTest, GeneratesWhenEmpty) {
+  EphemeralKeyExchangePool pool(4, nullptr);
+  std::unique_ptr<KeyExchange> key_exchange = pool.Take(factory_, rand_);
+  ASSERT_NE(nullptr, key_exchange);
+  EXPECT_EQ(kC255, key_exchange->GetFactory().tag());
+  EXPECT_EQ(0u, pool.num_hits());
+  EXPECT_EQ(1u, pool.num_misses());
+  EXPECT_EQ(0u, pool.depth(kC255));
+}
+
+TEST_F(EphemeralKeyExchangePoolTest, TakesFromPool) {
+  EphemeralKeyExchangePool pool(4, nullptr);
+  // The first Take() registers the type of key exchange with the pool.
+  pool.Take(factory_, rand_);
+  pool.Refill(rand_);
+  EXPECT_EQ(4u, pool.depth(kC255));
+
+  std::unique_ptr<KeyExchange> first = pool.Take(factory_, rand_);
+  std::unique_ptr<KeyExchange> second = pool.Take(factory_, rand_);
+  EXPECT_NE(first->public_value(), second->public_value());
+  EXPECT_EQ(2u, pool.depth(kC255));
+  EXPECT_EQ(2u, pool.num_hits());
+  EXPECT_EQ(1u, pool.num_misses());
+
+  // A second refill tops up the pool, and does not overfill it.
+  pool.Refill(rand_);
+  pool.Refill(rand_);
+  EXPECT_EQ(4u, pool.depth(kC255));
+}
+
+TEST_F(EphemeralKeyExchangePoolTest, RefillsOnWorkerPool) {
+  CryptoWorkerPool worker_pool(1, 10);
+  QuicNotification refilled;
+  worker_pool.set_completion_notifier([&refilled]() { refilled.Notify(); });
+  EphemeralKeyExchangePool pool(4, &worker_pool);
+
+  pool.Take(factory_, rand_);
+  refilled.WaitForNotification();
+  worker_pool.RunCompletions();
+  EXPECT_EQ(4u, pool.depth(kC255));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -0,0 +1,181 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/crypto/offloading_proof_source.h"
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_bug_tracker.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
+
+namespace quic {
+
+// Calls GetProof() on the wrapped ProofSource on a worker thread, and runs the
+// caller's callback with the result on the owner thread.
+class OffloadingProofSource::GetProofTask : public CryptoWorkerPool::Task {
+ public:
+  GetProofTask(ProofSource* proof_source,
+               const QuicSocketAddress& server_address,
+               const QuicString& hostname,
+               const QuicString& server_config,
+               QuicTransportVersion transport_version,
+               QuicStringPiece chlo_hash,
+               std::unique_ptr<Callback> callback)
+      : proof_source_(proof_source),
+        server_address_(server_address),
+        hostname_(hostname),
+        server_config_(server_config),
+        transport_version_(transport_version),
+        chlo_hash_(chlo_hash),
+        callback_(std::move(callback)),
+        done_(false),
+        ok_(false) {}
+
+  void Run() override {
+    proof_source_->GetProof(server_address_, hostname_, server_config_,
+                            transport_version_, chlo_hash_,
+                            QuicMakeUnique<ResultCallback>(this));
+  }
+
+  void OnComplete() override {
+    if (!done_) {
+      QUIC_BUG << "Offloaded GetProof did not complete synchronously.";
+      callback_->Run(false, chain_, proof_, nullptr);
+      return;
+    }
+    callback_->Run(ok_, chain_, proof_, std::move(details_));
+  }
+
+ private:
+  class ResultCallback : public Callback {
+   public:
+    explicit ResultCallback(GetProofTask* task) : task_(task) {}
+
+    void Run(bool ok,
+             const QuicReferenceCountedPointer<Chain>& chain,
+             const QuicCryptoProof& proof,
+             std::unique_ptr<Details> details) override {
+      task_->done_ = true;
+      task_->ok_ = ok;
+      task_->chain_ = chain;
+      task_->proof_ = proof;
+      task_->details_ = std::move(details);
+    }
+
+   private:
+    GetProofTask* task_;  // Not owned.
+  };
+
+  ProofSource* proof_source_;  // Not owned.
+  const QuicSocketAddress server_address_;
+  const QuicString hostname_;
+  const QuicString server_config_;
+  const QuicTransportVersion transport_version_;
+  const QuicString chlo_hash_;
+  std::unique_ptr<Callback> callback_;
+
+  bool done_;
+  bool ok_;
+  QuicReferenceCountedPointer<Chain> chain_;
+  QuicCryptoProof proof_;
+  std::unique_ptr<Details> details_;
+};
+
+// Calls ComputeTlsSignature() on the wrapped ProofSource on a worker thread,
+// and runs the caller's callback with the result on the owner thread.
+class OffloadingProofSource::ComputeTlsSignatureTask
+    : public CryptoWorkerPool::Task {
+ public:
+  ComputeTlsSignatureTask(ProofSource* proof_source,
+                          const QuicSocketAddress& server_address,
+                          const QuicString& hostname,
+                          uint16_t signature_algorithm,
+                          QuicStringPiece in,
+                          std::unique_ptr<SignatureCallback> callback)
+      : proof_source_(proof_source),
+        server_address_(server_address),
+        hostname_(hostname),
+        signature_algorithm_(signature_algorithm),
+        in_(in),
+        callback_(std::move(callback)),
+        done_(false),
+        ok_(false) {}
+
+  void Run() override {
+    proof_source_->ComputeTlsSignature(server_address_, hostname_,
+                                       signature_algorithm_, in_,
+                                       QuicMakeUnique<ResultCallback>(this));
+  }
+
+  void OnComplete() override {
+    if (!done_) {
+      QUIC_BUG << "Offloaded ComputeTlsSignature did not complete "
+                  "synchronously.";
+      callback_->Run(false, QuicString());
+      return;
+    }
+    callback_->Run(ok_, std::move(signature_));
+  }
+
+ private:
+  class ResultCallback : public SignatureCallback {
+   public:
+    explicit ResultCallback(ComputeTlsSignatureTask* task) : task_(task) {}
+
+    void Run(bool ok, QuicString signature) override {
+      task_->done_ = true;
+      task_->ok_ = ok;
+      task_->signature_ = std::move(signature);
+    }
+
+   private:
+    ComputeTlsSignatureTask* task_;  // Not owned.
+  };
+
+  ProofSource* proof_source_;  // Not owned.
+  const QuicSocketAddress server_address_;
+  const QuicString hostname_;
+  const uint16_t signature_algorithm_;
+  const QuicString in_;
+  std::unique_ptr<SignatureCallback> callback_;
+
+  bool done_;
+  bool ok_;
+  QuicString signature_;
+};
+
+OffloadingProofSource::OffloadingProofSource(
+    std::unique_ptr<ProofSource> proof_source,
+    CryptoWorkerPool* pool)
+    : proof_source_(std::move(proof_source)), pool_(pool) {}
+
+OffloadingProofSource::~OffloadingProofSource() {}
+
+void OffloadingProofSource::GetProof(const QuicSocketAddress& server_address,
+                                     const QuicString& hostname,
+                                     const QuicString& server_config,
+                                     QuicTransportVersion transport_version,
+                                     QuicStringPiece chlo_hash,
+                                     std::unique_ptr<Callback> callback) {
+  pool_->Post(QuicMakeUnique<GetProofTask>(
+      proof_source_.get(), server_address, hostname, server_config,
+      transport_version, chlo_hash, std::move(callback)));
+}
+
+QuicReferenceCountedPointer<ProofSource::Chain>
+OffloadingProofSource::GetCertChain(const QuicSocketAddress& server_address,
+                                    const QuicString& hostname) {
+  return proof_source_->GetCertChain(server_address, hostname);
+}
+
+void OffloadingProofSource::ComputeTlsSignature(
+    const QuicSocketAddress& server_address,
+    const QuicString& hostname,
+    uint16_t signature_algorithm,
+    QuicStringPiece in,
+    std::unique_ptr<SignatureCallback> callback) {
+  pool_->Post(QuicMakeUnique<ComputeTlsSignatureTask>(
+      proof_source_.get(), server_address, hostname, signature_algorithm, in,
+      std::move(callback)));
+}
+
+}  // namespace quic
@@ -0,0 +1,61 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_CRYPTO_OFFLOADING_PROOF_SOURCE_H_
+#define QUICHE_QUIC_CORE_CRYPTO_OFFLOADING_PROOF_SOURCE_H_
+
+#include <memory>
+
+#include "net/third_party/quiche/src/quic/core/crypto/crypto_worker_pool.h"
+#include "net/third_party/quiche/src/quic/core/crypto/proof_source.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+
+namespace quic {
+
+// OffloadingProofSource computes the signatures of another ProofSource on the
+// worker threads of a CryptoWorkerPool, so that a handshake does not block the
+// thread which owns the pool while it waits for a signature.  Callbacks are run
+// on the owner thread, from CryptoWorkerPool::RunCompletions().  If the pool is
+// full, the signature is computed and the callback is run synchronously.
+//
+// The wrapped ProofSource must run its callbacks synchronously, and must
+// support concurrent calls.
+class QUIC_EXPORT_PRIVATE OffloadingProofSource : public ProofSource {
+ public:
+  // |pool| must be destroyed before this object, so that no task uses
+  // |proof_source| after it is deleted.
+  OffloadingProofSource(std::unique_ptr<ProofSource> proof_source,
+                        CryptoWorkerPool* pool);
+  OffloadingProofSource(const OffloadingProofSource&) = delete;
+  OffloadingProofSource& operator=(const OffloadingProofSource&) = delete;
+  ~OffloadingProofSource() override;
+
+  // ProofSource implementation.
+  void GetProof(const QuicSocketAddress& server_address,
+                const QuicString& hostname,
+                const QuicString& server_config,
+                QuicTransportVersion transport_version,
+                QuicStringPiece chlo_hash,
+                std::unique_ptr<Callback> callback) override;
+  QuicReferenceCountedPointer<Chain> GetCertChain(
+      const QuicSocketAddress& server_address,
+      const QuicString& hostname) override;
+  void ComputeTlsSignature(
+      const QuicSocketAddress& server_address,
+      const QuicString& hostname,
+      uint16_t signature_algorithm,
+      QuicStringPiece in,
+      std::unique_ptr<SignatureCallback> callback) override;
+
+ private:
+  class GetProofTask;
+  class ComputeTlsSignatureTask;
+
+  std::unique_ptr<ProofSource> proof_source_;
+  CryptoWorkerPool* pool_;  // Not owned.
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_CRYPTO_OFFLOADING_PROOF_SOURCE_H_
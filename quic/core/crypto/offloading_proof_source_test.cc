@@ -0,0 +1,81 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/crypto/offloading_proof_source.h"
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_mutex.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+#include "net/third_party/quiche/src/quic/test_tools/crypto_test_utils.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+class TestCallback : public ProofSource::Callback {
+ public:
+  TestCallback(bool* called,
+               bool* ok,
+               QuicReferenceCountedPointer<ProofSource::Chain>* chain)
+      : called_(called), ok_(ok), chain_(chain) {}
+
+  void Run(bool ok,
+           const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
+           const QuicCryptoProof& /* proof */,
+           std::unique_ptr<ProofSource::Details> /* details */) override {
+    *called_ = true;
+    *ok_ = ok;
+    *chain_ = chain;
+  }
+
+ private:
+  bool* called_;
+  bool* ok_;
+  QuicReferenceCountedPointer<ProofSource::Chain>* chain_;
+};
+
+class OffloadingProofSourceTest : public QuicTest {
+ protected:
+  OffloadingProofSourceTest()
+      : proof_source_(crypto_test_utils::ProofSourceForTesting(), &pool_) {}
+
+  OffloadingProofSource proof_source_;
+  // Declared after |proof_source_| so that it is destroyed first.
+  CryptoWorkerPool pool_{1, 10};
+};
+
+TEST_F(OffloadingProofSourceTest, GetProofCompletesOnOwnerThread) {
+  QuicNotification task_done;
+  pool_.set_completion_notifier([&task_done]() { task_done.Notify(); });
+
+  bool called = false;
+  bool ok = false;
+  QuicReferenceCountedPointer<ProofSource::Chain> chain;
+  proof_source_.GetProof(
+      QuicSocketAddress(QuicIpAddress::Any4(), 42), "", "",
+      AllSupportedTransportVersions().front(), "",
+      QuicMakeUnique<TestCallback>(&called, &ok, &chain));
+
+  task_done.WaitForNotification();
+  EXPECT_FALSE(called);
+
+  pool_.RunCompletions();
+  EXPECT_TRUE(called);
+  EXPECT_TRUE(ok);
+  ASSERT_NE(nullptr, chain.get());
+  EXPECT_FALSE(chain->certs.empty());
+}
+
+TEST_F(OffloadingProofSourceTest, GetCertChainIsSynchronous) {
+  QuicReferenceCountedPointer<ProofSource::Chain> chain =
+      proof_source_.GetCertChain(QuicSocketAddress(QuicIpAddress::Any4(), 42),
+                                 "");
+  ASSERT_NE(nullptr, chain.get());
+  EXPECT_FALSE(chain->certs.empty());
+  EXPECT_EQ(0u, pool_.num_pending_tasks());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -0,0 +1,63 @@
+// Copyright (c) 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/crypto/quic_client_session_cache.h"
+
+#include <utility>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+const size_t QuicClientSessionCache::kQuicClientSessionCacheSize = 1024;
+
+QuicClientSessionCache::QuicClientSessionCache(size_t max_entries)
+    : max_entries_(max_entries) {}
+
+QuicClientSessionCache::~QuicClientSessionCache() {}
+
+void QuicClientSessionCache::Insert(const QuicServerId& server_id,
+                                    bssl::UniquePtr<SSL_SESSION> session) {
+  if (session == nullptr || !SSL_SESSION_is_resumable(session.get())) {
+    return;
+  }
+
+  auto it = cache_.find(server_id);
+  if (it != cache_.end()) {
+    cache_.erase(it);
+  }
+  cache_.emplace(server_id, std::move(session));
+
+  if (cache_.size() > max_entries_) {
+    cache_.pop_front();
+  }
+  DCHECK_LE(cache_.size(), max_entries_);
+}
+
+bssl::UniquePtr<SSL_SESSION> QuicClientSessionCache::Lookup(
+    const QuicServerId& server_id,
+    QuicWallTime now) {
+  auto it = cache_.find(server_id);
+  if (it == cache_.end()) {
+    return nullptr;
+  }
+
+  bssl::UniquePtr<SSL_SESSION> session = std::move(it->second);
+  cache_.erase(it);
+
+  const uint64_t expiry =
+      static_cast<uint64_t>(SSL_SESSION_get_time(session.get())) +
+      SSL_SESSION_get_timeout(session.get());
+  if (now.ToUNIXSeconds() >= expiry) {
+    QUIC_DVLOG(1) << "Cached session for " << server_id.host() << " expired";
+    return nullptr;
+  }
+  return session;
+}
+
+void QuicClientSessionCache::Clear() {
+  cache_.clear();
+}
+
+}  // namespace quic
@@ -0,0 +1,69 @@
+// Copyright (c) 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_CRYPTO_QUIC_CLIENT_SESSION_CACHE_H_
+#define QUICHE_QUIC_CORE_CRYPTO_QUIC_CLIENT_SESSION_CACHE_H_
+
+#include <cstddef>
+
+#include "third_party/boringssl/src/include/openssl/base.h"
+#include "third_party/boringssl/src/include/openssl/ssl.h"
+#include "net/third_party/quiche/src/quic/core/quic_server_id.h"
+#include "net/third_party/quiche/src/quic/core/quic_time.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_containers.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+
+namespace quic {
+
+// QuicClientSessionCache holds TLS 1.3 sessions (that is, session tickets and
+// the associated resumption secrets) received from servers, so that later
+// connections to the same server can resume the session instead of doing a
+// full handshake.  The cache holds at most one session per server, and at
+// most |max_entries| sessions in total, evicting the least recently inserted
+// one when full.
+//
+// This class is not thread-safe.
+class QUIC_EXPORT_PRIVATE QuicClientSessionCache {
+ public:
+  explicit QuicClientSessionCache(size_t max_entries);
+  QuicClientSessionCache(const QuicClientSessionCache&) = delete;
+  QuicClientSessionCache& operator=(const QuicClientSessionCache&) = delete;
+  ~QuicClientSessionCache();
+
+  // Stores |session| for |server_id|, replacing any session already cached for
+  // it.  Sessions that cannot be resumed are dropped.
+  void Insert(const QuicServerId& server_id,
+              bssl::UniquePtr<SSL_SESSION> session);
+
+  // Removes the session cached for |server_id| and returns it, or returns
+  // nullptr if there is none or it has expired at |now|.  Sessions are only
+  // handed out once, since TLS 1.3 tickets should not be reused (RFC 8446,
+  // appendix C.4).
+  bssl::UniquePtr<SSL_SESSION> Lookup(const QuicServerId& server_id,
+                                      QuicWallTime now);
+
+  // Removes all entries from the cache.
+  void Clear();
+
+  // Returns maximum number of entries the cache can hold.
+  size_t MaxSize() const { return max_entries_; }
+
+  // Returns current number of entries in the cache.
+  size_t Size() const { return cache_.size(); }
+
+  // Default size of the QuicClientSessionCache held by
+  // QuicCryptoClientConfig.
+  static const size_t kQuicClientSessionCacheSize;
+
+ private:
+  QuicLinkedHashMap<QuicServerId,
+                    bssl::UniquePtr<SSL_SESSION>,
+                    QuicServerIdHash>
+      cache_;
+  const size_t max_entries_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_CRYPTO_QUIC_CLIENT_SESSION_CACHE_H_
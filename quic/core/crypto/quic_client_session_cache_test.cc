@@ -0,0 +1,113 @@
+// Copyright (c) 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/crypto/quic_client_session_cache.h"
+
+#include <utility>
+
+#include "net/third_party/quiche/src/quic/core/crypto/quic_random.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+const uint64_t kIssueTime = 1000;
+const uint32_t kTimeout = 100;
+
+class QuicClientSessionCacheTest : public QuicTest {
+ public:
+  QuicClientSessionCacheTest() : ssl_ctx_(SSL_CTX_new(TLS_method())) {}
+
+ protected:
+  // Returns a resumable session issued at |kIssueTime| and valid for
+  // |kTimeout| seconds.
+  bssl::UniquePtr<SSL_SESSION> MakeSession() {
+    bssl::UniquePtr<SSL_SESSION> session(SSL_SESSION_new(ssl_ctx_.get()));
+    uint8_t id[SSL_MAX_SSL_SESSION_ID_LENGTH];
+    QuicRandom::GetInstance()->RandBytes(id, sizeof(id));
+    SSL_SESSION_set1_id(session.get(), id, sizeof(id));
+    SSL_SESSION_set_time(session.get(), kIssueTime);
+    SSL_SESSION_set_timeout(session.get(), kTimeout);
+    return session;
+  }
+
+  QuicWallTime Now() const {
+    return QuicWallTime::FromUNIXSeconds(kIssueTime + 1);
+  }
+
+  bssl::UniquePtr<SSL_CTX> ssl_ctx_;
+};
+
+TEST_F(QuicClientSessionCacheTest, InsertAndLookup) {
+  QuicClientSessionCache cache(2);
+  QuicServerId server_id("www.google.com", 443, false);
+  EXPECT_EQ(nullptr, cache.Lookup(server_id, Now()));
+
+  bssl::UniquePtr<SSL_SESSION> session = MakeSession();
+  SSL_SESSION* session_ptr = session.get();
+  cache.Insert(server_id, std::move(session));
+  EXPECT_EQ(1u, cache.Size());
+
+  // Sessions are single-use.
+  EXPECT_EQ(session_ptr, cache.Lookup(server_id, Now()).get());
+  EXPECT_EQ(0u, cache.Size());
+  EXPECT_EQ(nullptr, cache.Lookup(server_id, Now()));
+}
+
+TEST_F(QuicClientSessionCacheTest, InsertReplacesExistingEntry) {
+  QuicClientSessionCache cache(2);
+  QuicServerId server_id("www.google.com", 443, false);
+  cache.Insert(server_id, MakeSession());
+  bssl::UniquePtr<SSL_SESSION> session = MakeSession();
+  SSL_SESSION* session_ptr = session.get();
+  cache.Insert(server_id, std::move(session));
+  EXPECT_EQ(1u, cache.Size());
+  EXPECT_EQ(session_ptr, cache.Lookup(server_id, Now()).get());
+}
+
+TEST_F(QuicClientSessionCacheTest, DropsUnresumableSession) {
+  QuicClientSessionCache cache(2);
+  QuicServerId server_id("www.google.com", 443, false);
+  cache.Insert(server_id, nullptr);
+  cache.Insert(server_id,
+               bssl::UniquePtr<SSL_SESSION>(SSL_SESSION_new(ssl_ctx_.get())));
+  EXPECT_EQ(0u, cache.Size());
+}
+
+TEST_F(QuicClientSessionCacheTest, EvictsOldestEntry) {
+  QuicClientSessionCache cache(2);
+  QuicServerId server_id1("a.google.com", 443, false);
+  QuicServerId server_id2("b.google.com", 443, false);
+  QuicServerId server_id3("c.google.com", 443, false);
+  cache.Insert(server_id1, MakeSession());
+  cache.Insert(server_id2, MakeSession());
+  cache.Insert(server_id3, MakeSession());
+  EXPECT_EQ(2u, cache.Size());
+  EXPECT_EQ(nullptr, cache.Lookup(server_id1, Now()));
+  EXPECT_NE(nullptr, cache.Lookup(server_id2, Now()));
+  EXPECT_NE(nullptr, cache.Lookup(server_id3, Now()));
+}
+
+TEST_F(QuicClientSessionCacheTest, ExpiredSession) {
+  QuicClientSessionCache cache(2);
+  QuicServerId server_id("www.google.com", 443, false);
+  cache.Insert(server_id, MakeSession());
+  EXPECT_EQ(nullptr,
+            cache.Lookup(server_id,
+                         QuicWallTime::FromUNIXSeconds(kIssueTime + kTimeout)));
+  // The expired session is removed from the cache.
+  EXPECT_EQ(0u, cache.Size());
+}
+
+TEST_F(QuicClientSessionCacheTest, Clear) {
+  QuicClientSessionCache cache(2);
+  cache.Insert(QuicServerId("www.google.com", 443, false), MakeSession());
+  cache.Clear();
+  EXPECT_EQ(0u, cache.Size());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -3,20 +3,11 @@
 // found in the LICENSE file.
 
 #include "net/third_party/quiche/src/quic/core/crypto/quic_compressed_certs_cache.h"
+#include "net/third_party/quiche/src/quic/core/quic_utils.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
 
 namespace quic {
 
-namespace {
-
-// Inline helper function for extending a 64-bit |seed| in-place with a 64-bit
-// |value|. Based on Boost's hash_combine function.
-inline void hash_combine(uint64_t* seed, const uint64_t& val) {
-  (*seed) ^= val + 0x9e3779b9 + ((*seed) << 6) + ((*seed) >> 2);
-}
-
-}  // namespace
-
 const size_t QuicCompressedCertsCache::kQuicCompressedCertsCacheSize = 225;
 
 QuicCompressedCertsCache::UncompressedCerts::UncompressedCerts()
@@ -118,10 +109,10 @@ uint64_t QuicCompressedCertsCache::ComputeUncompressedCertsHash(
       std::hash<QuicString>()(*uncompressed_certs.client_common_set_hashes);
   uint64_t h =
       std::hash<QuicString>()(*uncompressed_certs.client_cached_cert_hashes);
-  hash_combine(&hash, h);
+  QuicUtils::HashCombine(&hash, h);
 
-  hash_combine(&hash,
-               reinterpret_cast<uint64_t>(uncompressed_certs.chain.get()));
+  QuicUtils::HashCombine(
+      &hash, reinterpret_cast<uint64_t>(uncompressed_certs.chain.get()));
   return hash;
 }
 
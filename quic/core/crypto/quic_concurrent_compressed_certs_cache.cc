@@ -0,0 +1,206 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/crypto/quic_concurrent_compressed_certs_cache.h"
+
+#include <algorithm>
+
+#include "net/third_party/quiche/src/quic/core/quic_utils.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
+
+namespace quic {
+
+QuicConcurrentCompressedCertsCache::UncompressedCerts::UncompressedCerts(
+    const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
+    const QuicString& client_common_set_hashes,
+    const QuicString& client_cached_cert_hashes)
+    : chain(chain),
+      client_common_set_hashes(client_common_set_hashes),
+      client_cached_cert_hashes(client_cached_cert_hashes) {}
+
+QuicConcurrentCompressedCertsCache::UncompressedCerts::~UncompressedCerts() {}
+
+bool QuicConcurrentCompressedCertsCache::UncompressedCerts::operator==(
+    const UncompressedCerts& other) const {
+  return client_common_set_hashes == other.client_common_set_hashes &&
+         client_cached_cert_hashes == other.client_cached_cert_hashes &&
+         chain == other.chain;
+}
+
+QuicConcurrentCompressedCertsCache::Entry::Entry(
+    uint64_t key,
+    const UncompressedCerts& uncompressed_certs,
+    const QuicString& compressed_cert)
+    : key(key),
+      uncompressed_certs(uncompressed_certs),
+      compressed_cert(compressed_cert),
+      referenced(false) {}
+
+QuicConcurrentCompressedCertsCache::Entry::~Entry() {}
+
+QuicConcurrentCompressedCertsCache::PendingCompression::PendingCompression(
+    const UncompressedCerts& uncompressed_certs)
+    : uncompressed_certs(uncompressed_certs) {}
+
+QuicConcurrentCompressedCertsCache::PendingCompression::~PendingCompression() {}
+
+QuicConcurrentCompressedCertsCache::Shard::Shard() : clock_hand(0) {}
+
+QuicConcurrentCompressedCertsCache::Shard::~Shard() {}
+
+QuicConcurrentCompressedCertsCache::QuicConcurrentCompressedCertsCache(
+    size_t max_num_certs,
+    size_t num_shards)
+    : max_entries_per_shard_(std::max<size_t>(
+          1,
+          (max_num_certs + num_shards - 1) / std::max<size_t>(1, num_shards))) {
+  DCHECK_GT(num_shards, 0u);
+  for (size_t i = 0; i < std::max<size_t>(1, num_shards); ++i) {
+    shards_.push_back(QuicMakeUnique<Shard>());
+  }
+}
+
+QuicConcurrentCompressedCertsCache::~QuicConcurrentCompressedCertsCache() {}
+
+QuicString QuicConcurrentCompressedCertsCache::GetOrCompress(
+    const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
+    const QuicString& client_common_set_hashes,
+    const QuicString& client_cached_cert_hashes,
+    const CompressFunction& compress) {
+  UncompressedCerts uncompressed_certs(chain, client_common_set_hashes,
+                                       client_cached_cert_hashes);
+  uint64_t key = ComputeUncompressedCertsHash(uncompressed_certs);
+  Shard* shard = shards_[key % shards_.size()].get();
+
+  QuicString compressed_cert;
+  {
+    QuicReaderMutexLock lock(&shard->lock);
+    if (Lookup(*shard, key, uncompressed_certs, &compressed_cert)) {
+      return compressed_cert;
+    }
+  }
+
+  QuicReferenceCountedPointer<PendingCompression> pending;
+  bool compresses = true;
+  {
+    QuicWriterMutexLock lock(&shard->lock);
+    if (Lookup(*shard, key, uncompressed_certs, &compressed_cert)) {
+      return compressed_cert;
+    }
+    auto it = shard->pending.find(key);
+    if (it == shard->pending.end()) {
+      pending = QuicReferenceCountedPointer<PendingCompression>(
+          new PendingCompression(uncompressed_certs));
+      shard->pending[key] = pending;
+    } else if (it->second->uncompressed_certs == uncompressed_certs) {
+      pending = it->second;
+      compresses = false;
+    }
+    // Otherwise a different set of certs with the same hash is being
+    // compressed, and this one is compressed without being shared.
+  }
+
+  if (!compresses) {
+    pending->done.WaitForNotification();
+    return pending->compressed_cert;
+  }
+
+  compressed_cert = compress();
+  if (pending != nullptr) {
+    pending->compressed_cert = compressed_cert;
+  }
+  {
+    QuicWriterMutexLock lock(&shard->lock);
+    Insert(shard, key, uncompressed_certs, compressed_cert);
+    if (pending != nullptr) {
+      shard->pending.erase(key);
+    }
+  }
+  if (pending != nullptr) {
+    pending->done.Notify();
+  }
+  return compressed_cert;
+}
+
+size_t QuicConcurrentCompressedCertsCache::MaxSize() const {
+  return max_entries_per_shard_ * shards_.size();
+}
+
+size_t QuicConcurrentCompressedCertsCache::Size() const {
+  size_t size = 0;
+  for (const auto& shard : shards_) {
+    QuicReaderMutexLock lock(&shard->lock);
+    size += shard->entries.size();
+  }
+  return size;
+}
+
+// static
+uint64_t QuicConcurrentCompressedCertsCache::ComputeUncompressedCertsHash(
+    const UncompressedCerts& uncompressed_certs) {
+  uint64_t hash =
+      std::hash<QuicString>()(uncompressed_certs.client_common_set_hashes);
+  uint64_t h =
+      std::hash<QuicString>()(uncompressed_certs.client_cached_cert_hashes);
+  QuicUtils::HashCombine(&hash, h);
+
+  QuicUtils::HashCombine(
+      &hash, reinterpret_cast<uint64_t>(uncompressed_certs.chain.get()));
+  return hash;
+}
+
+// static
+bool QuicConcurrentCompressedCertsCache::Lookup(
+    const Shard& shard,
+    uint64_t key,
+    const UncompressedCerts& uncompressed_certs,
+    QuicString* compressed_cert) {
+  auto it = shard.index.find(key);
+  if (it == shard.index.end()) {
+    return false;
+  }
+  Entry* entry = shard.entries[it->second].get();
+  if (!(entry->uncompressed_certs == uncompressed_certs)) {
+    return false;
+  }
+  // Only a reader lock may be held, hence the atomic.
+  entry->referenced.store(true, std::memory_order_relaxed);
+  *compressed_cert = entry->compressed_cert;
+  return true;
+}
+
+void QuicConcurrentCompressedCertsCache::Insert(
+    Shard* shard,
+    uint64_t key,
+    const UncompressedCerts& uncompressed_certs,
+    const QuicString& compressed_cert) {
+  auto entry = QuicMakeUnique<Entry>(key, uncompressed_certs, compressed_cert);
+
+  auto it = shard->index.find(key);
+  if (it != shard->index.end()) {
+    shard->entries[it->second] = std::move(entry);
+    return;
+  }
+
+  if (shard->entries.size() < max_entries_per_shard_) {
+    shard->index[key] = shard->entries.size();
+    shard->entries.push_back(std::move(entry));
+    return;
+  }
+
+  // Advance the clock hand to the first entry which has not been referenced
+  // since the hand last passed it.  This terminates within one revolution,
+  // since every entry passed is cleared.
+  while (shard->entries[shard->clock_hand]->referenced.exchange(
+      false, std::memory_order_relaxed)) {
+    shard->clock_hand = (shard->clock_hand + 1) % shard->entries.size();
+  }
+  shard->index.erase(shard->entries[shard->clock_hand]->key);
+  shard->index[key] = shard->clock_hand;
+  shard->entries[shard->clock_hand] = std::move(entry);
+  shard->clock_hand = (shard->clock_hand + 1) % shard->entries.size();
+}
+
+}  // namespace quic
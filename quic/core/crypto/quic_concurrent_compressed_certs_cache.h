@@ -0,0 +1,143 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_CRYPTO_QUIC_CONCURRENT_COMPRESSED_CERTS_CACHE_H_
+#define QUICHE_QUIC_CORE_CRYPTO_QUIC_CONCURRENT_COMPRESSED_CERTS_CACHE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/core/crypto/proof_source.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_containers.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_mutex.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_reference_counted.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
+
+namespace quic {
+
+// QuicConcurrentCompressedCertsCache is a cache of compressed certs which can
+// be shared by the dispatchers of several threads.  Entries are spread over
+// independently locked shards, lookups only take a reader lock, and each
+// shard evicts with the CLOCK approximation of LRU.  Concurrent misses for the
+// same certs compress them only once.
+class QUIC_EXPORT_PRIVATE QuicConcurrentCompressedCertsCache {
+ public:
+  // Produces the compressed representation of certs on a cache miss.
+  using CompressFunction = std::function<QuicString()>;
+
+  // Holds up to about |max_num_certs| entries, spread over |num_shards|
+  // shards.
+  QuicConcurrentCompressedCertsCache(size_t max_num_certs, size_t num_shards);
+  QuicConcurrentCompressedCertsCache(
+      const QuicConcurrentCompressedCertsCache&) = delete;
+  QuicConcurrentCompressedCertsCache& operator=(
+      const QuicConcurrentCompressedCertsCache&) = delete;
+  ~QuicConcurrentCompressedCertsCache();
+
+  // Returns the cached compressed cert for
+  // |chain, client_common_set_hashes, client_cached_cert_hashes|.  On a miss,
+  // calls |compress| and caches its result, unless another thread is already
+  // compressing the same certs, in which case waits for and returns its
+  // result.
+  QuicString GetOrCompress(
+      const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
+      const QuicString& client_common_set_hashes,
+      const QuicString& client_cached_cert_hashes,
+      const CompressFunction& compress);
+
+  // Returns max number of cache entries the cache can carry.
+  size_t MaxSize() const;
+
+  // Returns current number of cache entries in the cache.
+  size_t Size() const;
+
+ private:
+  // The uncompressed certs which identify an entry.
+  struct UncompressedCerts {
+    UncompressedCerts(
+        const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
+        const QuicString& client_common_set_hashes,
+        const QuicString& client_cached_cert_hashes);
+    ~UncompressedCerts();
+
+    bool operator==(const UncompressedCerts& other) const;
+
+    QuicReferenceCountedPointer<ProofSource::Chain> chain;
+    QuicString client_common_set_hashes;
+    QuicString client_cached_cert_hashes;
+  };
+
+  struct Entry {
+    Entry(uint64_t key,
+          const UncompressedCerts& uncompressed_certs,
+          const QuicString& compressed_cert);
+    ~Entry();
+
+    const uint64_t key;
+    const UncompressedCerts uncompressed_certs;
+    const QuicString compressed_cert;
+    // Set on every hit, and cleared when the clock hand passes the entry.
+    std::atomic<bool> referenced;
+  };
+
+  // A compression which is in progress on one thread, and which other threads
+  // with the same certs wait for.
+  class PendingCompression : public QuicReferenceCounted {
+   public:
+    explicit PendingCompression(const UncompressedCerts& uncompressed_certs);
+
+    const UncompressedCerts uncompressed_certs;
+    // Set before |done| is notified.
+    QuicString compressed_cert;
+    QuicNotification done;
+
+   private:
+    ~PendingCompression() override;
+  };
+
+  struct Shard {
+    Shard();
+    ~Shard();
+
+    mutable QuicMutex lock;
+    std::vector<std::unique_ptr<Entry>> entries GUARDED_BY(lock);
+    // Maps keys to indices in |entries|.
+    QuicUnorderedMap<uint64_t, size_t> index GUARDED_BY(lock);
+    // The next entry considered for eviction.
+    size_t clock_hand GUARDED_BY(lock);
+    QuicUnorderedMap<uint64_t, QuicReferenceCountedPointer<PendingCompression>>
+        pending GUARDED_BY(lock);
+  };
+
+  // Computes a uint64_t hash for |uncompressed_certs|.
+  static uint64_t ComputeUncompressedCertsHash(
+      const UncompressedCerts& uncompressed_certs);
+
+  // Returns true and sets |compressed_cert| if |shard| holds an entry for
+  // |key| and |uncompressed_certs|.
+  static bool Lookup(const Shard& shard,
+                     uint64_t key,
+                     const UncompressedCerts& uncompressed_certs,
+                     QuicString* compressed_cert)
+      SHARED_LOCKS_REQUIRED(shard.lock);
+
+  // Inserts an entry into |shard|, evicting one if it is full.
+  void Insert(Shard* shard,
+              uint64_t key,
+              const UncompressedCerts& uncompressed_certs,
+              const QuicString& compressed_cert)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
+
+  const size_t max_entries_per_shard_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_CRYPTO_QUIC_CONCURRENT_COMPRESSED_CERTS_CACHE_H_
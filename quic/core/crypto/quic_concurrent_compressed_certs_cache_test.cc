@@ -0,0 +1,148 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/crypto/quic_concurrent_compressed_certs_cache.h"
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_mutex.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_thread.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+QuicReferenceCountedPointer<ProofSource::Chain> MakeChain() {
+  std::vector<QuicString> certs = {"leaf cert", "intermediate cert",
+                                   "root cert"};
+  return QuicReferenceCountedPointer<ProofSource::Chain>(
+      new ProofSource::Chain(certs));
+}
+
+// Returns |compressed| and counts the calls in |num_calls|.
+QuicConcurrentCompressedCertsCache::CompressFunction CountingCompress(
+    const QuicString& compressed,
+    int* num_calls) {
+  return [compressed, num_calls]() {
+    ++*num_calls;
+    return compressed;
+  };
+}
+
+class QuicConcurrentCompressedCertsCacheTest : public QuicTest {};
+
+TEST_F(QuicConcurrentCompressedCertsCacheTest, CacheHit) {
+  QuicConcurrentCompressedCertsCache certs_cache(10, 4);
+  QuicReferenceCountedPointer<ProofSource::Chain> chain = MakeChain();
+  int num_calls = 0;
+
+  EXPECT_EQ("compressed cert",
+            certs_cache.GetOrCompress(
+                chain, "common certs", "cached certs",
+                CountingCompress("compressed cert", &num_calls)));
+  EXPECT_EQ("compressed cert",
+            certs_cache.GetOrCompress(
+                chain, "common certs", "cached certs",
+                CountingCompress("compressed cert", &num_calls)));
+  EXPECT_EQ(1, num_calls);
+  EXPECT_EQ(1u, certs_cache.Size());
+}
+
+TEST_F(QuicConcurrentCompressedCertsCacheTest, CacheMiss) {
+  QuicConcurrentCompressedCertsCache certs_cache(10, 4);
+  QuicReferenceCountedPointer<ProofSource::Chain> chain = MakeChain();
+  int num_calls = 0;
+
+  certs_cache.GetOrCompress(chain, "common certs", "cached certs",
+                            CountingCompress("compressed cert", &num_calls));
+  certs_cache.GetOrCompress(chain, "mismatched common certs", "cached certs",
+                            CountingCompress("compressed cert", &num_calls));
+  certs_cache.GetOrCompress(chain, "common certs", "mismatched cached certs",
+                            CountingCompress("compressed cert", &num_calls));
+  // A different chain though with equivalent certs should get a cache miss.
+  certs_cache.GetOrCompress(MakeChain(), "common certs", "cached certs",
+                            CountingCompress("compressed cert", &num_calls));
+  EXPECT_EQ(4, num_calls);
+}
+
+TEST_F(QuicConcurrentCompressedCertsCacheTest, ClockEviction) {
+  QuicConcurrentCompressedCertsCache certs_cache(2, 1);
+  EXPECT_EQ(2u, certs_cache.MaxSize());
+  QuicReferenceCountedPointer<ProofSource::Chain> chain = MakeChain();
+  int num_calls = 0;
+
+  certs_cache.GetOrCompress(chain, "a", "", CountingCompress("A", &num_calls));
+  certs_cache.GetOrCompress(chain, "b", "", CountingCompress("B", &num_calls));
+  // Reference "a", so that the clock hand passes over it.
+  certs_cache.GetOrCompress(chain, "a", "", CountingCompress("A", &num_calls));
+  EXPECT_EQ(2, num_calls);
+
+  certs_cache.GetOrCompress(chain, "c", "", CountingCompress("C", &num_calls));
+  EXPECT_EQ(3, num_calls);
+  EXPECT_EQ(2u, certs_cache.Size());
+
+  // "b" was evicted, "a" was not.
+  certs_cache.GetOrCompress(chain, "a", "", CountingCompress("A", &num_calls));
+  EXPECT_EQ(3, num_calls);
+  certs_cache.GetOrCompress(chain, "b", "", CountingCompress("B", &num_calls));
+  EXPECT_EQ(4, num_calls);
+}
+
+class CompressingThread : public QuicThread {
+ public:
+  CompressingThread(
+      QuicConcurrentCompressedCertsCache* certs_cache,
+      const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
+      QuicConcurrentCompressedCertsCache::CompressFunction compress)
+      : QuicThread("compressing_thread"),
+        certs_cache_(certs_cache),
+        chain_(chain),
+        compress_(std::move(compress)) {}
+
+  void Run() override {
+    compressed_ = certs_cache_->GetOrCompress(chain_, "common certs",
+                                              "cached certs", compress_);
+  }
+
+  const QuicString& compressed() const { return compressed_; }
+
+ private:
+  QuicConcurrentCompressedCertsCache* certs_cache_;
+  QuicReferenceCountedPointer<ProofSource::Chain> chain_;
+  QuicConcurrentCompressedCertsCache::CompressFunction compress_;
+  QuicString compressed_;
+};
+
+TEST_F(QuicConcurrentCompressedCertsCacheTest, ConcurrentMissesCompressOnce) {
+  QuicConcurrentCompressedCertsCache certs_cache(10, 4);
+  QuicReferenceCountedPointer<ProofSource::Chain> chain = MakeChain();
+
+  QuicNotification started;
+  QuicNotification unblock;
+  CompressingThread first(&certs_cache, chain, [&started, &unblock]() {
+    started.Notify();
+    unblock.WaitForNotification();
+    return QuicString("compressed cert");
+  });
+  first.Start();
+  started.WaitForNotification();
+
+  // The second thread either waits for the first, or hits the cache if the
+  // first has finished; it never compresses.
+  CompressingThread second(&certs_cache, chain, []() {
+    ADD_FAILURE() << "Certs compressed twice.";
+    return QuicString();
+  });
+  second.Start();
+  unblock.Notify();
+
+  first.Join();
+  second.Join();
+  EXPECT_EQ("compressed cert", first.compressed());
+  EXPECT_EQ("compressed cert", second.compressed());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
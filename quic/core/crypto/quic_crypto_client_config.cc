@@ -62,7 +62,9 @@ void RecordDiskCacheServerConfigState(
 QuicCryptoClientConfig::QuicCryptoClientConfig(
     std::unique_ptr<ProofVerifier> proof_verifier,
     bssl::UniquePtr<SSL_CTX> ssl_ctx)
-    : proof_verifier_(std::move(proof_verifier)), ssl_ctx_(std::move(ssl_ctx)) {
+    : proof_verifier_(std::move(proof_verifier)),
+      ssl_ctx_(std::move(ssl_ctx)),
+      session_cache_(QuicClientSessionCache::kQuicClientSessionCacheSize) {
   DCHECK(proof_verifier_.get());
   SetDefaults();
 }
@@ -786,7 +788,8 @@ QuicErrorCode QuicCryptoClientConfig::CacheNewServerConfig(
   if (has_proof && has_cert) {
     std::vector<QuicString> certs;
     if (!CertCompressor::DecompressChain(cert_bytes, cached_certs,
-                                         common_cert_sets, &certs)) {
+                                         common_cert_sets,
+                                         zlib_stream_pool_.get(), &certs)) {
       *error_details = "Certificate data invalid";
       return QUIC_INVALID_CRYPTO_MESSAGE_PARAMETER;
     }
@@ -980,6 +983,11 @@ void QuicCryptoClientConfig::AddCanonicalSuffix(const QuicString& suffix) {
   canonical_suffixes_.push_back(suffix);
 }
 
+void QuicCryptoClientConfig::EnableZlibStreamPool(size_t max_idle_streams) {
+  zlib_stream_pool_ =
+      QuicMakeUnique<CertCompressor::ZlibStreamPool>(max_idle_streams);
+}
+
 bool QuicCryptoClientConfig::PopulateFromCanonicalConfig(
     const QuicServerId& server_id,
     CachedState* server_state) {
@@ -12,8 +12,10 @@
 
 #include "base/macros.h"
 #include "third_party/boringssl/src/include/openssl/base.h"
+#include "net/third_party/quiche/src/quic/core/crypto/cert_compressor.h"
 #include "net/third_party/quiche/src/quic/core/crypto/crypto_handshake.h"
 #include "net/third_party/quiche/src/quic/core/crypto/crypto_protocol.h"
+#include "net/third_party/quiche/src/quic/core/crypto/quic_client_session_cache.h"
 #include "net/third_party/quiche/src/quic/core/quic_packets.h"
 #include "net/third_party/quiche/src/quic/core/quic_server_id.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
@@ -317,6 +319,10 @@ class QUIC_EXPORT_PRIVATE QuicCryptoClientConfig : public QuicCryptoConfig {
 
   SSL_CTX* ssl_ctx() const;
 
+  // Returns the cache of TLS sessions used to resume connections to servers
+  // when the TLS handshake is used.
+  QuicClientSessionCache* session_cache() { return &session_cache_; }
+
   // SetChannelIDSource sets a ChannelIDSource that will be called, when the
   // server supports channel IDs, to obtain a channel ID for signing a message
   // proving possession of the channel ID. This object takes ownership of
@@ -360,6 +366,16 @@ class QUIC_EXPORT_PRIVATE QuicCryptoClientConfig : public QuicCryptoConfig {
   bool pad_full_hello() const { return pad_full_hello_; }
   void set_pad_full_hello(bool new_value) { pad_full_hello_ = new_value; }
 
+  // Decompresses certs with up to |max_idle_streams| reused zlib streams
+  // instead of initializing a stream for each chain.  Useful when one config
+  // is used for many connections.
+  void EnableZlibStreamPool(size_t max_idle_streams);
+
+  // Returns the zlib stream pool, or nullptr if it is not enabled.
+  CertCompressor::ZlibStreamPool* zlib_stream_pool() const {
+    return zlib_stream_pool_.get();
+  }
+
  private:
   // Sets the members to reasonable, default values.
   void SetDefaults();
@@ -402,6 +418,12 @@ class QUIC_EXPORT_PRIVATE QuicCryptoClientConfig : public QuicCryptoConfig {
   std::unique_ptr<ChannelIDSource> channel_id_source_;
   bssl::UniquePtr<SSL_CTX> ssl_ctx_;
 
+  // Sessions received from servers in TLS handshakes, keyed by server id.
+  QuicClientSessionCache session_cache_;
+
+  // Keeps idle zlib streams for decompressing certs, if enabled.
+  std::unique_ptr<CertCompressor::ZlibStreamPool> zlib_stream_pool_;
+
   // The |user_agent_id_| passed in QUIC's CHLO message.
   QuicString user_agent_id_;
 
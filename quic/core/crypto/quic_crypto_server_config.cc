@@ -6,9 +6,11 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 
 #include "base/macros.h"
+#include "third_party/boringssl/src/include/openssl/hmac.h"
 #include "third_party/boringssl/src/include/openssl/sha.h"
 #include "third_party/boringssl/src/include/openssl/ssl.h"
 #include "net/third_party/quiche/src/quic/core/crypto/aes_128_gcm_12_decrypter.h"
@@ -69,6 +71,17 @@ QuicString DeriveSourceAddressTokenKey(
   return QuicString(hkdf.server_write_key());
 }
 
+// Key used to derive stateless reset tokens.  Like the source address token
+// key, it only depends on the secret so that every server sharing the secret
+// produces the same token for a connection ID.
+QuicString DeriveStatelessResetTokenKey(
+    QuicStringPiece source_address_token_secret) {
+  QuicHKDF hkdf(source_address_token_secret, QuicStringPiece() /* no salt */,
+                "QUIC stateless reset token key", SHA256_DIGEST_LENGTH,
+                0 /* no fixed IV needed */, 0 /* no subkey secret */);
+  return QuicString(hkdf.server_write_key());
+}
+
 // Default source for creating KeyExchange objects.
 class DefaultKeyExchangeSource : public KeyExchangeSource {
  public:
@@ -114,6 +127,48 @@ class DefaultKeyExchangeSource : public KeyExchangeSource {
   }
 };
 
+// Inserts the proof returned by a ProofSource into a QuicProofCache, and then
+// passes it on to another callback.
+class ProofCacheInsertingCallback : public ProofSource::Callback {
+ public:
+  ProofCacheInsertingCallback(QuicProofCache* proof_cache,
+                              const QuicSocketAddress& server_address,
+                              const QuicString& hostname,
+                              const QuicString& server_config,
+                              QuicTransportVersion transport_version,
+                              QuicStringPiece chlo_hash,
+                              std::unique_ptr<ProofSource::Callback> callback)
+      : proof_cache_(proof_cache),
+        server_address_(server_address),
+        hostname_(hostname),
+        server_config_(server_config),
+        transport_version_(transport_version),
+        chlo_hash_(chlo_hash),
+        callback_(std::move(callback)) {}
+
+  void Run(bool ok,
+           const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
+           const QuicCryptoProof& proof,
+           std::unique_ptr<ProofSource::Details> details) override {
+    // Details are specific to one handshake, so proofs which come with them
+    // are not cached.
+    if (ok && chain != nullptr && details == nullptr) {
+      proof_cache_->Insert(server_address_, hostname_, server_config_,
+                           transport_version_, chlo_hash_, chain, proof);
+    }
+    callback_->Run(ok, chain, proof, std::move(details));
+  }
+
+ private:
+  QuicProofCache* proof_cache_;  // Not owned.
+  const QuicSocketAddress server_address_;
+  const QuicString hostname_;
+  const QuicString server_config_;
+  const QuicTransportVersion transport_version_;
+  const QuicString chlo_hash_;
+  std::unique_ptr<ProofSource::Callback> callback_;
+};
+
 }  // namespace
 
 // static
@@ -214,6 +269,7 @@ QuicCryptoServerConfig::QuicCryptoServerConfig(
       configs_lock_(),
       primary_config_(nullptr),
       next_config_promotion_time_(QuicWallTime::Zero()),
+      config_snapshot_(new ConfigSnapshot()),
       proof_source_(std::move(proof_source)),
       key_exchange_source_(std::move(key_exchange_source)),
       ssl_ctx_(std::move(ssl_ctx)),
@@ -224,7 +280,10 @@ QuicCryptoServerConfig::QuicCryptoServerConfig(
       pad_rej_(true),
       pad_shlo_(true),
       validate_chlo_size_(true),
-      validate_source_address_token_(true) {
+      validate_source_address_token_(true),
+      enable_tls_early_data_(false),
+      stateless_reset_token_key_(
+          DeriveStatelessResetTokenKey(source_address_token_secret)) {
   DCHECK(proof_source_.get());
   source_address_token_boxer_.SetKeys(
       {DeriveSourceAddressTokenKey(source_address_token_secret)});
@@ -238,6 +297,12 @@ QuicCryptoServerConfig::QuicCryptoServerConfig(
 
   server_nonce_boxer_.SetKeys(
       {QuicString(reinterpret_cast<char*>(key_bytes.get()), key_size)});
+
+  // Generate a random key for session tickets, which is only good for this
+  // instance of the server unless replaced by SetSessionTicketKeys().
+  server_nonce_entropy->RandBytes(key_bytes.get(), key_size);
+  session_ticket_boxer_.SetKeys(
+      {QuicString(reinterpret_cast<char*>(key_bytes.get()), key_size)});
 }
 
 QuicCryptoServerConfig::~QuicCryptoServerConfig() {}
@@ -482,10 +547,36 @@ void QuicCryptoServerConfig::SetSourceAddressTokenKeys(
   source_address_token_boxer_.SetKeys(keys);
 }
 
+void QuicCryptoServerConfig::SetSessionTicketKeys(
+    const std::vector<QuicString>& keys) {
+  session_ticket_boxer_.SetKeys(keys);
+}
+
+QuicUint128 QuicCryptoServerConfig::GenerateStatelessResetToken(
+    QuicConnectionId connection_id) const {
+  uint8_t digest[SHA256_DIGEST_LENGTH];
+  unsigned int digest_length = 0;
+  if (HMAC(EVP_sha256(), stateless_reset_token_key_.data(),
+           stateless_reset_token_key_.size(),
+           reinterpret_cast<const uint8_t*>(connection_id.data()),
+           connection_id.length(), digest, &digest_length) == nullptr ||
+      digest_length != sizeof(digest)) {
+    QUIC_BUG << "Failed to generate stateless reset token";
+    return QuicUtils::GenerateStatelessResetToken(connection_id);
+  }
+  uint64_t high;
+  uint64_t low;
+  memcpy(&high, digest, sizeof(high));
+  memcpy(&low, digest + sizeof(high), sizeof(low));
+  return MakeQuicUint128(QuicEndian::NetToHost64(high),
+                         QuicEndian::NetToHost64(low));
+}
+
 void QuicCryptoServerConfig::GetConfigIds(
     std::vector<QuicString>* scids) const {
-  QuicReaderMutexLock locked(&configs_lock_);
-  for (auto it = configs_.begin(); it != configs_.end(); ++it) {
+  QuicReferenceCountedPointer<ConfigSnapshot> snapshot = GetConfigSnapshot();
+  for (auto it = snapshot->configs.begin(); it != snapshot->configs.end();
+       ++it) {
     scids->push_back(it->first);
   }
 }
@@ -507,30 +598,17 @@ void QuicCryptoServerConfig::ValidateClientHello(
   QuicStringPiece requested_scid;
   client_hello.GetStringPiece(kSCID, &requested_scid);
 
-  QuicReferenceCountedPointer<Config> requested_config;
-  QuicReferenceCountedPointer<Config> primary_config;
-  {
-    QuicReaderMutexLock locked(&configs_lock_);
-    if (!primary_config_.get()) {
-      result->error_code = QUIC_CRYPTO_INTERNAL_ERROR;
-      result->error_details = "No configurations loaded";
-    } else {
-      if (IsNextConfigReady(now)) {
-        configs_lock_.ReaderUnlock();
-        configs_lock_.WriterLock();
-        SelectNewPrimaryConfig(now);
-        DCHECK(primary_config_.get());
-        DCHECK_EQ(configs_.find(primary_config_->id)->second.get(),
-                  primary_config_.get());
-        configs_lock_.WriterUnlock();
-        configs_lock_.ReaderLock();
-      }
-    }
-
-    requested_config = GetConfigWithScid(requested_scid);
-    primary_config = primary_config_;
-    signed_config->config = primary_config_;
+  QuicReferenceCountedPointer<ConfigSnapshot> snapshot =
+      GetCurrentConfigSnapshot(now);
+  if (!snapshot->primary_config) {
+    result->error_code = QUIC_CRYPTO_INTERNAL_ERROR;
+    result->error_details = "No configurations loaded";
   }
+  QuicReferenceCountedPointer<Config> requested_config =
+      GetConfigWithScid(*snapshot, requested_scid);
+  QuicReferenceCountedPointer<Config> primary_config =
+      snapshot->primary_config;
+  signed_config->config = primary_config;
 
   if (result->error_code == QUIC_NO_ERROR) {
     // QUIC requires a new proof for each CHLO so clear any existing proof.
@@ -776,37 +854,19 @@ void QuicCryptoServerConfig::ProcessClientHello(
   client_hello.GetStringPiece(kSCID, &requested_scid);
   const QuicWallTime now(clock->WallNow());
 
-  QuicReferenceCountedPointer<Config> requested_config;
-  QuicReferenceCountedPointer<Config> primary_config;
-  bool no_primary_config = false;
-  {
-    QuicReaderMutexLock locked(&configs_lock_);
-
-    if (!primary_config_) {
-      no_primary_config = true;
-    } else {
-      if (IsNextConfigReady(now)) {
-        configs_lock_.ReaderUnlock();
-        configs_lock_.WriterLock();
-        SelectNewPrimaryConfig(now);
-        DCHECK(primary_config_.get());
-        DCHECK_EQ(configs_.find(primary_config_->id)->second.get(),
-                  primary_config_.get());
-        configs_lock_.WriterUnlock();
-        configs_lock_.ReaderLock();
-      }
-
-      // Use the config that the client requested in order to do key-agreement.
-      // Otherwise give it a copy of |primary_config_| to use.
-      primary_config = signed_config->config;
-      requested_config = GetConfigWithScid(requested_scid);
-    }
-  }
-  if (no_primary_config) {
+  QuicReferenceCountedPointer<ConfigSnapshot> snapshot =
+      GetCurrentConfigSnapshot(now);
+  if (!snapshot->primary_config) {
     helper.Fail(QUIC_CRYPTO_INTERNAL_ERROR, "No configurations loaded");
     return;
   }
 
+  // Use the config that the client requested in order to do key-agreement.
+  // Otherwise give it a copy of |primary_config_| to use.
+  QuicReferenceCountedPointer<Config> primary_config = signed_config->config;
+  QuicReferenceCountedPointer<Config> requested_config =
+      GetConfigWithScid(*snapshot, requested_scid);
+
   if (validate_chlo_result->error_code != QUIC_NO_ERROR) {
     helper.Fail(validate_chlo_result->error_code,
                 validate_chlo_result->error_details);
@@ -832,9 +892,8 @@ void QuicCryptoServerConfig::ProcessClientHello(
             compressed_certs_cache, params, signed_config,
             total_framing_overhead, chlo_packet_size, requested_config,
             primary_config, std::move(done_cb)));
-    proof_source_->GetProof(
-        server_address, QuicString(info.sni), primary_config->serialized,
-        version.transport_version, chlo_hash, std::move(cb));
+    GetProof(server_address, QuicString(info.sni), primary_config->serialized,
+             version.transport_version, chlo_hash, std::move(cb));
     helper.DetachCallback();
     return;
   }
@@ -1110,7 +1169,9 @@ void QuicCryptoServerConfig::ProcessClientHelloAfterCalculateSharedKeys(
 
   QuicString forward_secure_public_value;
   std::unique_ptr<KeyExchange> forward_secure_key_exchange =
-      key_exchange_factory.Create(rand);
+      ephemeral_key_exchange_pool_ != nullptr
+          ? ephemeral_key_exchange_pool_->Take(key_exchange_factory, rand)
+          : key_exchange_factory.Create(rand);
   forward_secure_public_value =
       QuicString(forward_secure_key_exchange->public_value());
   if (!forward_secure_key_exchange->CalculateSharedKey(
@@ -1156,14 +1217,13 @@ void QuicCryptoServerConfig::ProcessClientHelloAfterCalculateSharedKeys(
                  std::move(proof_source_details));
 }
 
+// static
 QuicReferenceCountedPointer<QuicCryptoServerConfig::Config>
-QuicCryptoServerConfig::GetConfigWithScid(
-    QuicStringPiece requested_scid) const {
-  configs_lock_.AssertReaderHeld();
-
+QuicCryptoServerConfig::GetConfigWithScid(const ConfigSnapshot& snapshot,
+                                          QuicStringPiece requested_scid) {
   if (!requested_scid.empty()) {
-    auto it = configs_.find((QuicString(requested_scid)));
-    if (it != configs_.end()) {
+    auto it = snapshot.configs.find((QuicString(requested_scid)));
+    if (it != snapshot.configs.end()) {
       // We'll use the config that the client requested in order to do
       // key-agreement.
       return QuicReferenceCountedPointer<Config>(it->second);
@@ -1173,6 +1233,44 @@ QuicCryptoServerConfig::GetConfigWithScid(
   return QuicReferenceCountedPointer<Config>();
 }
 
+QuicReferenceCountedPointer<QuicCryptoServerConfig::ConfigSnapshot>
+QuicCryptoServerConfig::GetConfigSnapshot() const {
+  QuicReaderMutexLock locked(&snapshot_lock_);
+  return config_snapshot_;
+}
+
+QuicReferenceCountedPointer<QuicCryptoServerConfig::ConfigSnapshot>
+QuicCryptoServerConfig::GetCurrentConfigSnapshot(QuicWallTime now) const {
+  QuicReferenceCountedPointer<ConfigSnapshot> snapshot = GetConfigSnapshot();
+  if (!snapshot->primary_config ||
+      !IsNextConfigReady(snapshot->next_config_promotion_time, now)) {
+    return snapshot;
+  }
+
+  {
+    QuicWriterMutexLock locked(&configs_lock_);
+    // Another thread may have promoted the config since |snapshot| was
+    // published.
+    if (IsNextConfigReady(next_config_promotion_time_, now)) {
+      SelectNewPrimaryConfig(now);
+      DCHECK(primary_config_.get());
+      DCHECK_EQ(configs_.find(primary_config_->id)->second.get(),
+                primary_config_.get());
+    }
+  }
+  return GetConfigSnapshot();
+}
+
+void QuicCryptoServerConfig::PublishConfigSnapshot() const {
+  QuicReferenceCountedPointer<ConfigSnapshot> snapshot(new ConfigSnapshot());
+  snapshot->configs = configs_;
+  snapshot->primary_config = primary_config_;
+  snapshot->next_config_promotion_time = next_config_promotion_time_;
+
+  QuicWriterMutexLock locked(&snapshot_lock_);
+  config_snapshot_ = std::move(snapshot);
+}
+
 // ConfigPrimaryTimeLessThan is a comparator that implements "less than" for
 // Config's based on their primary_time.
 // static
@@ -1248,6 +1346,7 @@ void QuicCryptoServerConfig::SelectNewPrimaryConfig(
                     << QuicTextUtils::HexEncode(reinterpret_cast<const char*>(
                                                     primary_config_->orbit),
                                                 kOrbitSize);
+    PublishConfigSnapshot();
     if (primary_config_changed_cb_ != nullptr) {
       primary_config_changed_cb_->Run(primary_config_->id);
     }
@@ -1269,6 +1368,7 @@ void QuicCryptoServerConfig::SelectNewPrimaryConfig(
                          kOrbitSize)
                   << " scid: " << QuicTextUtils::HexEncode(primary_config_->id);
   next_config_promotion_time_ = QuicWallTime::Zero();
+  PublishConfigSnapshot();
   if (primary_config_changed_cb_ != nullptr) {
     primary_config_changed_cb_->Run(primary_config_->id);
   }
@@ -1467,17 +1567,13 @@ void QuicCryptoServerConfig::BuildServerConfigUpdateMessage(
     const QuicCryptoNegotiatedParameters& params,
     const CachedNetworkParameters* cached_network_params,
     std::unique_ptr<BuildServerConfigUpdateMessageResultCallback> cb) const {
-  QuicString serialized;
-  QuicString source_address_token;
-  const CommonCertSets* common_cert_sets;
-  {
-    QuicReaderMutexLock locked(&configs_lock_);
-    serialized = primary_config_->serialized;
-    common_cert_sets = primary_config_->common_cert_sets;
-    source_address_token = NewSourceAddressToken(
-        *primary_config_, previous_source_address_tokens, client_ip, rand,
-        clock->WallNow(), cached_network_params);
-  }
+  QuicReferenceCountedPointer<Config> primary_config =
+      GetConfigSnapshot()->primary_config;
+  const QuicString& serialized = primary_config->serialized;
+  const CommonCertSets* common_cert_sets = primary_config->common_cert_sets;
+  QuicString source_address_token = NewSourceAddressToken(
+      *primary_config, previous_source_address_tokens, client_ip, rand,
+      clock->WallNow(), cached_network_params);
 
   CryptoHandshakeMessage message;
   message.set_tag(kSCUP);
@@ -1489,8 +1585,8 @@ void QuicCryptoServerConfig::BuildServerConfigUpdateMessage(
           this, version, compressed_certs_cache, common_cert_sets, params,
           std::move(message), std::move(cb)));
 
-  proof_source_->GetProof(server_address, params.sni, serialized, version,
-                          chlo_hash, std::move(proof_source_cb));
+  GetProof(server_address, params.sni, serialized, version, chlo_hash,
+           std::move(proof_source_cb));
 }
 
 QuicCryptoServerConfig::BuildServerConfigUpdateMessageProofSourceCallback::
@@ -1550,7 +1646,9 @@ void QuicCryptoServerConfig::FinishBuildServerConfigUpdateMessage(
   }
 
   const QuicString compressed =
-      CompressChain(compressed_certs_cache, chain, client_common_set_hashes,
+      CompressChain(compressed_certs_cache,
+                    shared_compressed_certs_cache_.get(),
+                    zlib_stream_pool_.get(), chain, client_common_set_hashes,
                     client_cached_cert_hashes, common_cert_sets);
 
   message.SetStringPiece(kCertificateTag, compressed);
@@ -1636,7 +1734,9 @@ void QuicCryptoServerConfig::BuildRejection(
   }
 
   const QuicString compressed =
-      CompressChain(compressed_certs_cache, signed_config.chain,
+      CompressChain(compressed_certs_cache,
+                    shared_compressed_certs_cache_.get(),
+                    zlib_stream_pool_.get(), signed_config.chain,
                     params->client_common_set_hashes,
                     params->client_cached_cert_hashes, config.common_cert_sets);
 
@@ -1699,10 +1799,21 @@ void QuicCryptoServerConfig::BuildRejection(
 
 QuicString QuicCryptoServerConfig::CompressChain(
     QuicCompressedCertsCache* compressed_certs_cache,
+    QuicConcurrentCompressedCertsCache* shared_compressed_certs_cache,
+    CertCompressor::ZlibStreamPool* zlib_stream_pool,
     const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
     const QuicString& client_common_set_hashes,
     const QuicString& client_cached_cert_hashes,
     const CommonCertSets* common_sets) {
+  if (shared_compressed_certs_cache != nullptr) {
+    return shared_compressed_certs_cache->GetOrCompress(
+        chain, client_common_set_hashes, client_cached_cert_hashes, [&]() {
+          return CertCompressor::CompressChain(
+              chain->certs, client_common_set_hashes,
+              client_cached_cert_hashes, common_sets, zlib_stream_pool);
+        });
+  }
+
   // Check whether the compressed certs is available in the cache.
   DCHECK(compressed_certs_cache);
   const QuicString* cached_value = compressed_certs_cache->GetCompressedCert(
@@ -1712,7 +1823,8 @@ QuicString QuicCryptoServerConfig::CompressChain(
   }
   QuicString compressed =
       CertCompressor::CompressChain(chain->certs, client_common_set_hashes,
-                                    client_cached_cert_hashes, common_sets);
+                                    client_cached_cert_hashes, common_sets,
+                                    zlib_stream_pool);
   // Insert the newly compressed cert to cache.
   compressed_certs_cache->Insert(chain, client_common_set_hashes,
                                  client_cached_cert_hashes, compressed);
@@ -1906,14 +2018,64 @@ QuicString QuicCryptoServerConfig::NewSourceAddressToken(
 }
 
 int QuicCryptoServerConfig::NumberOfConfigs() const {
-  QuicReaderMutexLock locked(&configs_lock_);
-  return configs_.size();
+  return GetConfigSnapshot()->configs.size();
 }
 
 ProofSource* QuicCryptoServerConfig::proof_source() const {
   return proof_source_.get();
 }
 
+void QuicCryptoServerConfig::EnableProofCache(size_t max_num_proofs) {
+  proof_cache_ = QuicMakeUnique<QuicProofCache>(max_num_proofs);
+}
+
+void QuicCryptoServerConfig::EnableSharedCompressedCertsCache(
+    size_t max_num_certs,
+    size_t num_shards) {
+  shared_compressed_certs_cache_ =
+      QuicMakeUnique<QuicConcurrentCompressedCertsCache>(max_num_certs,
+                                                         num_shards);
+}
+
+void QuicCryptoServerConfig::EnableZlibStreamPool(size_t max_idle_streams) {
+  zlib_stream_pool_ =
+      QuicMakeUnique<CertCompressor::ZlibStreamPool>(max_idle_streams);
+}
+
+void QuicCryptoServerConfig::EnableEphemeralKeyExchangePool(
+    size_t max_depth,
+    CryptoWorkerPool* worker_pool) {
+  ephemeral_key_exchange_pool_ =
+      QuicMakeUnique<EphemeralKeyExchangePool>(max_depth, worker_pool);
+}
+
+void QuicCryptoServerConfig::GetProof(
+    const QuicSocketAddress& server_address,
+    const QuicString& hostname,
+    const QuicString& server_config,
+    QuicTransportVersion transport_version,
+    QuicStringPiece chlo_hash,
+    std::unique_ptr<ProofSource::Callback> callback) const {
+  if (proof_cache_ == nullptr) {
+    proof_source_->GetProof(server_address, hostname, server_config,
+                            transport_version, chlo_hash, std::move(callback));
+    return;
+  }
+
+  QuicReferenceCountedPointer<ProofSource::Chain> chain;
+  QuicCryptoProof proof;
+  if (proof_cache_->GetProof(server_address, hostname, server_config,
+                             transport_version, chlo_hash, &chain, &proof)) {
+    callback->Run(/* ok = */ true, chain, proof, /* details = */ nullptr);
+    return;
+  }
+  proof_source_->GetProof(
+      server_address, hostname, server_config, transport_version, chlo_hash,
+      QuicMakeUnique<ProofCacheInsertingCallback>(
+          proof_cache_.get(), server_address, hostname, server_config,
+          transport_version, chlo_hash, std::move(callback)));
+}
+
 SSL_CTX* QuicCryptoServerConfig::ssl_ctx() const {
   return ssl_ctx_.get();
 }
@@ -2047,14 +2209,17 @@ bool QuicCryptoServerConfig::ClientDemandsX509Proof(
   return false;
 }
 
-bool QuicCryptoServerConfig::IsNextConfigReady(QuicWallTime now) const {
+// static
+bool QuicCryptoServerConfig::IsNextConfigReady(
+    QuicWallTime next_config_promotion_time,
+    QuicWallTime now) {
   if (GetQuicReloadableFlag(quic_fix_config_rotation)) {
     QUIC_RELOADABLE_FLAG_COUNT(quic_fix_config_rotation);
-    return !next_config_promotion_time_.IsZero() &&
-           !next_config_promotion_time_.IsAfter(now);
+    return !next_config_promotion_time.IsZero() &&
+           !next_config_promotion_time.IsAfter(now);
   }
-  return !next_config_promotion_time_.IsZero() &&
-         next_config_promotion_time_.IsAfter(now);
+  return !next_config_promotion_time.IsZero() &&
+         next_config_promotion_time.IsAfter(now);
 }
 
 QuicCryptoServerConfig::Config::Config()
@@ -2067,6 +2232,11 @@ QuicCryptoServerConfig::Config::Config()
 
 QuicCryptoServerConfig::Config::~Config() {}
 
+QuicCryptoServerConfig::ConfigSnapshot::ConfigSnapshot()
+    : next_config_promotion_time(QuicWallTime::Zero()) {}
+
+QuicCryptoServerConfig::ConfigSnapshot::~ConfigSnapshot() {}
+
 QuicSignedServerConfig::QuicSignedServerConfig() {}
 QuicSignedServerConfig::~QuicSignedServerConfig() {}
 
@@ -13,14 +13,18 @@
 
 #include "base/macros.h"
 #include "third_party/boringssl/src/include/openssl/base.h"
+#include "net/third_party/quiche/src/quic/core/crypto/cert_compressor.h"
 #include "net/third_party/quiche/src/quic/core/crypto/crypto_handshake.h"
 #include "net/third_party/quiche/src/quic/core/crypto/crypto_handshake_message.h"
 #include "net/third_party/quiche/src/quic/core/crypto/crypto_protocol.h"
 #include "net/third_party/quiche/src/quic/core/crypto/crypto_secret_boxer.h"
+#include "net/third_party/quiche/src/quic/core/crypto/ephemeral_key_exchange_pool.h"
 #include "net/third_party/quiche/src/quic/core/crypto/key_exchange.h"
 #include "net/third_party/quiche/src/quic/core/crypto/proof_source.h"
 #include "net/third_party/quiche/src/quic/core/crypto/quic_compressed_certs_cache.h"
+#include "net/third_party/quiche/src/quic/core/crypto/quic_concurrent_compressed_certs_cache.h"
 #include "net/third_party/quiche/src/quic/core/crypto/quic_crypto_proof.h"
+#include "net/third_party/quiche/src/quic/core/crypto/quic_proof_cache.h"
 #include "net/third_party/quiche/src/quic/core/proto/cached_network_parameters.proto.h"
 #include "net/third_party/quiche/src/quic/core/proto/source_address_token.proto.h"
 #include "net/third_party/quiche/src/quic/core/quic_time.h"
@@ -30,6 +34,7 @@
 #include "net/third_party/quiche/src/quic/platform/api/quic_socket_address.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_uint128.h"
 
 namespace quic {
 
@@ -264,6 +269,20 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
   // |source_address_token_secret| argument to the constructor.
   void SetSourceAddressTokenKeys(const std::vector<QuicString>& keys);
 
+  // SetSessionTicketKeys sets the keys used to protect TLS 1.3 session tickets.
+  // The first key encrypts new tickets and all keys are tried when decrypting,
+  // so keys can be rotated by prepending a new key and dropping the oldest one
+  // once tickets protected by it are no longer expected.  Keys must be
+  // |CryptoSecretBoxer::GetKeySize()| bytes long.  A random key is used until
+  // this is called.
+  void SetSessionTicketKeys(const std::vector<QuicString>& keys);
+
+  // Returns the stateless reset token for |connection_id|, an HMAC of the
+  // connection ID keyed from the source address token secret.  Servers sharing
+  // that secret derive the same token, so one that has lost the connection
+  // state can still reset it, but peers cannot predict the token.
+  QuicUint128 GenerateStatelessResetToken(QuicConnectionId connection_id) const;
+
   // Get the server config ids for all known configs.
   void GetConfigIds(std::vector<QuicString>* scids) const;
 
@@ -408,6 +427,15 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
   // (RFC6962) in server hello.
   void set_enable_serving_sct(bool enable_serving_sct);
 
+  // set_enable_tls_early_data controls whether TLS 1.3 handshakes accept early
+  // (0-RTT) data from clients resuming a session. It is off by default: early
+  // data can be replayed by an attacker, and there is no anti-replay
+  // mechanism for it, so only enable it if the application can tolerate
+  // requests being processed more than once.
+  void set_enable_tls_early_data(bool enable_tls_early_data) {
+    enable_tls_early_data_ = enable_tls_early_data;
+  }
+
   // Set and take ownership of the callback to invoke on primary config changes.
   void AcquirePrimaryConfigChangedCb(
       std::unique_ptr<PrimaryConfigChangedCallback> cb);
@@ -423,8 +451,59 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
 
   ProofSource* proof_source() const;
 
+  // Caches the last |max_num_proofs| proofs returned by the ProofSource, so
+  // that identical signing requests are not signed again.  Must be called
+  // before the config is used.  If the certificates of the ProofSource
+  // change, proof_cache()->Clear() must be called.
+  void EnableProofCache(size_t max_num_proofs);
+
+  // Returns the proof cache, or nullptr if it is not enabled.
+  QuicProofCache* proof_cache() const { return proof_cache_.get(); }
+
+  // Compresses certs through a cache of up to |max_num_certs| entries in
+  // |num_shards| shards, which is shared by all the threads using this
+  // config, instead of through the QuicCompressedCertsCache of each
+  // dispatcher.  Must be called before the config is used.
+  void EnableSharedCompressedCertsCache(size_t max_num_certs,
+                                        size_t num_shards);
+
+  // Returns the shared compressed certs cache, or nullptr if it is not
+  // enabled.
+  QuicConcurrentCompressedCertsCache* shared_compressed_certs_cache() const {
+    return shared_compressed_certs_cache_.get();
+  }
+
+  // Compresses certs with up to |max_idle_streams| reused zlib streams
+  // instead of initializing a stream for each chain.  Must be called before
+  // the config is used.
+  void EnableZlibStreamPool(size_t max_idle_streams);
+
+  // Returns the zlib stream pool, or nullptr if it is not enabled.
+  CertCompressor::ZlibStreamPool* zlib_stream_pool() const {
+    return zlib_stream_pool_.get();
+  }
+
+  // Takes forward-secure key exchanges from a pool of up to |max_depth|
+  // pre-generated key pairs of each type, instead of generating them while
+  // processing a client hello.  If |worker_pool| is not null, the pool is
+  // refilled on it and it must be destroyed before this object.  Must be
+  // called before the config is used.
+  void EnableEphemeralKeyExchangePool(size_t max_depth,
+                                      CryptoWorkerPool* worker_pool);
+
+  // Returns the ephemeral key exchange pool, or nullptr if it is not enabled.
+  EphemeralKeyExchangePool* ephemeral_key_exchange_pool() const {
+    return ephemeral_key_exchange_pool_.get();
+  }
+
   SSL_CTX* ssl_ctx() const;
 
+  const CryptoSecretBoxer* session_ticket_boxer() const {
+    return &session_ticket_boxer_;
+  }
+
+  bool enable_tls_early_data() const { return enable_tls_early_data_; }
+
   void set_pre_shared_key(QuicStringPiece psk) {
     pre_shared_key_ = QuicString(psk);
   }
@@ -506,10 +585,36 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
   typedef std::map<ServerConfigID, QuicReferenceCountedPointer<Config>>
       ConfigMap;
 
+  // ConfigSnapshot is a copy of |configs_|, |primary_config_| and
+  // |next_config_promotion_time_|.  It is never modified once published, so
+  // readers only hold |snapshot_lock_| long enough to take a reference to it.
+  struct ConfigSnapshot : public QuicReferenceCounted {
+    ConfigSnapshot();
+
+    ConfigMap configs;
+    QuicReferenceCountedPointer<Config> primary_config;
+    QuicWallTime next_config_promotion_time;
+
+   private:
+    ~ConfigSnapshot() override;
+  };
+
   // Get a ref to the config with a given server config id.
-  QuicReferenceCountedPointer<Config> GetConfigWithScid(
-      QuicStringPiece requested_scid) const
-      SHARED_LOCKS_REQUIRED(configs_lock_);
+  static QuicReferenceCountedPointer<Config> GetConfigWithScid(
+      const ConfigSnapshot& snapshot,
+      QuicStringPiece requested_scid);
+
+  // Returns the most recently published config snapshot.
+  QuicReferenceCountedPointer<ConfigSnapshot> GetConfigSnapshot() const;
+
+  // Returns the most recently published config snapshot, after promoting the
+  // next config to primary if its primary time is before |now|.
+  QuicReferenceCountedPointer<ConfigSnapshot> GetCurrentConfigSnapshot(
+      QuicWallTime now) const;
+
+  // Publishes a new snapshot of |configs_|, |primary_config_| and
+  // |next_config_promotion_time_|.
+  void PublishConfigSnapshot() const EXCLUSIVE_LOCKS_REQUIRED(configs_lock_);
 
   // ConfigPrimaryTimeLessThan returns true if a->primary_time <
   // b->primary_time.
@@ -518,7 +623,7 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
       const QuicReferenceCountedPointer<Config>& b);
 
   // SelectNewPrimaryConfig reevaluates the primary config based on the
-  // "primary_time" deadlines contained in each.
+  // "primary_time" deadlines contained in each, and publishes the result.
   void SelectNewPrimaryConfig(QuicWallTime now) const
       EXCLUSIVE_LOCKS_REQUIRED(configs_lock_);
 
@@ -585,6 +690,15 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
       const QuicReferenceCountedPointer<Config>& primary_config,
       std::unique_ptr<ProcessClientHelloResultCallback> done_cb) const;
 
+  // Calls proof_source_->GetProof(), unless the proof is in proof_cache_, in
+  // which case |callback| is run synchronously with the cached proof.
+  void GetProof(const QuicSocketAddress& server_address,
+                const QuicString& hostname,
+                const QuicString& server_config,
+                QuicTransportVersion transport_version,
+                QuicStringPiece chlo_hash,
+                std::unique_ptr<ProofSource::Callback> callback) const;
+
   // Callback class for bridging between ProcessClientHelloAfterGetProof and
   // ProcessClientHelloAfterCalculateSharedKeys.
   class ProcessClientHelloAfterGetProofCallback;
@@ -633,8 +747,13 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
   // sets known locally and |client_common_set_hashes| contains the hashes of
   // the common sets known to the peer. |client_cached_cert_hashes| contains
   // 64-bit, FNV-1a hashes of certificates that the peer already possesses.
+  // |shared_compressed_certs_cache| is used instead of
+  // |compressed_certs_cache| if it is not null.  |zlib_stream_pool| may be
+  // null.
   static QuicString CompressChain(
       QuicCompressedCertsCache* compressed_certs_cache,
+      QuicConcurrentCompressedCertsCache* shared_compressed_certs_cache,
+      CertCompressor::ZlibStreamPool* zlib_stream_pool,
       const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
       const QuicString& client_common_set_hashes,
       const QuicString& client_cached_cert_hashes,
@@ -766,9 +885,10 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
       CryptoHandshakeMessage message,
       std::unique_ptr<BuildServerConfigUpdateMessageResultCallback> cb) const;
 
-  // Returns true if the next config promotion should happen now.
-  bool IsNextConfigReady(QuicWallTime now) const
-      SHARED_LOCKS_REQUIRED(configs_lock_);
+  // Returns true if the next config promotion, at
+  // |next_config_promotion_time|, should happen now.
+  static bool IsNextConfigReady(QuicWallTime next_config_promotion_time,
+                                QuicWallTime now);
 
   // replay_protection_ controls whether the server enforces that handshakes
   // aren't replays.
@@ -783,6 +903,7 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
   //   1) configs_.empty() <-> primary_config_ == nullptr
   //   2) primary_config_ != nullptr -> primary_config_->is_primary
   //   3) ∀ c∈configs_, c->is_primary <-> c == primary_config_
+  // configs_lock_ serializes writers.  Readers use config_snapshot_ instead.
   mutable QuicMutex configs_lock_;
   // configs_ contains all active server configs. It's expected that there are
   // about half-a-dozen configs active at any one time.
@@ -798,6 +919,12 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
   std::unique_ptr<PrimaryConfigChangedCallback> primary_config_changed_cb_
       GUARDED_BY(configs_lock_);
 
+  // snapshot_lock_ only protects the pointer config_snapshot_, which is
+  // replaced whenever the configs or the primary config change.
+  mutable QuicMutex snapshot_lock_;
+  mutable QuicReferenceCountedPointer<ConfigSnapshot> config_snapshot_
+      GUARDED_BY(snapshot_lock_);
+
   // Used to protect the source-address tokens that are given to clients.
   CryptoSecretBoxer source_address_token_boxer_;
 
@@ -805,6 +932,10 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
   // nonces.
   CryptoSecretBoxer server_nonce_boxer_;
 
+  // session_ticket_boxer_ is used to encrypt and decrypt TLS 1.3 session
+  // tickets.
+  CryptoSecretBoxer session_ticket_boxer_;
+
   // server_nonce_orbit_ contains the random, per-server orbit values that this
   // server will use to generate server nonces (the moral equivalent of a SYN
   // cookies).
@@ -814,10 +945,26 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
   // signatures.
   std::unique_ptr<ProofSource> proof_source_;
 
+  // shared_compressed_certs_cache_ caches compressed certs for all threads, if
+  // enabled.
+  std::unique_ptr<QuicConcurrentCompressedCertsCache>
+      shared_compressed_certs_cache_;
+
+  // zlib_stream_pool_ keeps idle zlib streams for compressing certs, if
+  // enabled.
+  std::unique_ptr<CertCompressor::ZlibStreamPool> zlib_stream_pool_;
+
+  // proof_cache_ caches the proofs of proof_source_, if enabled.
+  std::unique_ptr<QuicProofCache> proof_cache_;
+
   // key_exchange_source_ contains an object that can provide key exchange
   // objects.
   std::unique_ptr<KeyExchangeSource> key_exchange_source_;
 
+  // ephemeral_key_exchange_pool_ provides forward-secure key exchanges, if
+  // enabled.
+  std::unique_ptr<EphemeralKeyExchangePool> ephemeral_key_exchange_pool_;
+
   // ssl_ctx_ contains the server configuration for doing TLS handshakes.
   bssl::UniquePtr<SSL_CTX> ssl_ctx_;
 
@@ -852,6 +999,12 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
   // When source address is validated by some other means (e.g. when using ICE),
   // source address token validation may be disabled.
   bool validate_source_address_token_;
+
+  // Whether TLS 1.3 handshakes accept early data.
+  bool enable_tls_early_data_;
+
+  // Key of the HMAC from which stateless reset tokens are taken.
+  const QuicString stateless_reset_token_key_;
 };
 
 struct QUIC_EXPORT_PRIVATE QuicSignedServerConfig
@@ -15,13 +15,16 @@
 #include "net/third_party/quiche/src/quic/core/crypto/quic_random.h"
 #include "net/third_party/quiche/src/quic/core/proto/crypto_server_config.proto.h"
 #include "net/third_party/quiche/src/quic/core/quic_time.h"
+#include "net/third_party/quiche/src/quic/core/quic_utils.h"
 #include "net/third_party/quiche/src/quic/core/tls_server_handshaker.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_socket_address.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
 #include "net/third_party/quiche/src/quic/test_tools/crypto_test_utils.h"
 #include "net/third_party/quiche/src/quic/test_tools/mock_clock.h"
 #include "net/third_party/quiche/src/quic/test_tools/quic_crypto_server_config_peer.h"
+#include "net/third_party/quiche/src/quic/test_tools/quic_test_utils.h"
 
 namespace quic {
 namespace test {
@@ -47,6 +50,32 @@ TEST_F(QuicCryptoServerConfigTest, ServerConfig) {
   EXPECT_LE(1u, aead.size());
 }
 
+TEST_F(QuicCryptoServerConfigTest, StatelessResetTokenIsKeyed) {
+  QuicRandom* rand = QuicRandom::GetInstance();
+  QuicCryptoServerConfig server(QuicCryptoServerConfig::TESTING, rand,
+                                crypto_test_utils::ProofSourceForTesting(),
+                                KeyExchangeSource::Default(),
+                                TlsServerHandshaker::CreateSslCtx());
+  QuicCryptoServerConfig same_secret_server(
+      QuicCryptoServerConfig::TESTING, rand,
+      crypto_test_utils::ProofSourceForTesting(), KeyExchangeSource::Default(),
+      TlsServerHandshaker::CreateSslCtx());
+  QuicCryptoServerConfig other_secret_server(
+      "other secret", rand, crypto_test_utils::ProofSourceForTesting(),
+      KeyExchangeSource::Default(), TlsServerHandshaker::CreateSslCtx());
+
+  const QuicConnectionId connection_id = TestConnectionId(42);
+  const QuicUint128 token = server.GenerateStatelessResetToken(connection_id);
+  EXPECT_EQ(token, server.GenerateStatelessResetToken(connection_id));
+  EXPECT_EQ(token,
+            same_secret_server.GenerateStatelessResetToken(connection_id));
+  EXPECT_NE(token,
+            other_secret_server.GenerateStatelessResetToken(connection_id));
+  EXPECT_NE(token, server.GenerateStatelessResetToken(TestConnectionId(43)));
+  // Unlike the unkeyed token, it cannot be computed from the connection ID.
+  EXPECT_NE(token, QuicUtils::GenerateStatelessResetToken(connection_id));
+}
+
 TEST_F(QuicCryptoServerConfigTest, CompressCerts) {
   QuicCompressedCertsCache compressed_certs_cache(
       QuicCompressedCertsCache::kQuicCompressedCertsCacheSize);
@@ -484,6 +513,44 @@ TEST_F(CryptoServerConfigsTest, AdvancePrimaryViaValidate) {
   test_peer_.CheckConfigs({{"a", false}, {"b", true}});
 }
 
+TEST_F(CryptoServerConfigsTest, ReadersSeePublishedConfigs) {
+  SetConfigs({{"a", 900, 1}, {"b", 1100, 1}});
+  EXPECT_EQ(2, config_.NumberOfConfigs());
+  std::vector<QuicString> scids;
+  config_.GetConfigIds(&scids);
+  EXPECT_EQ((std::vector<QuicString>{"a", "b"}), scids);
+
+  SetConfigs({{"c", 900, 1}});
+  EXPECT_EQ(1, config_.NumberOfConfigs());
+  scids.clear();
+  config_.GetConfigIds(&scids);
+  EXPECT_EQ(std::vector<QuicString>{"c"}, scids);
+
+  // Handshakes use the primary config of the latest snapshot.
+  CryptoHandshakeMessage client_hello;
+  QuicReferenceCountedPointer<QuicSignedServerConfig> signed_config(
+      new QuicSignedServerConfig);
+  MockClock clock;
+  config_.ValidateClientHello(client_hello, QuicIpAddress(),
+                              QuicSocketAddress(), QUIC_VERSION_99, &clock,
+                              signed_config, QuicMakeUnique<ValidateCallback>());
+  EXPECT_EQ(test_peer_.GetPrimaryConfig(), signed_config->config);
+}
+
+TEST_F(CryptoServerConfigsTest, SnapshotsArePerInstance) {
+  SetConfigs({{"a", 900, 1}, {"b", 1100, 1}});
+  EXPECT_EQ(2, config_.NumberOfConfigs());
+
+  // Reading another instance on this thread does not affect |config_|.
+  QuicCryptoServerConfig other_config(
+      QuicCryptoServerConfig::TESTING, rand_,
+      crypto_test_utils::ProofSourceForTesting(), KeyExchangeSource::Default(),
+      TlsServerHandshaker::CreateSslCtx());
+  EXPECT_EQ(0, other_config.NumberOfConfigs());
+  EXPECT_EQ(2, config_.NumberOfConfigs());
+  EXPECT_EQ(0, other_config.NumberOfConfigs());
+}
+
 TEST_F(CryptoServerConfigsTest, InvalidConfigs) {
   // Ensure that invalid configs don't change anything.
   SetConfigs({{"a", 800, 1}, {"b", 900, 1}, {"c", 1100, 1}});
@@ -0,0 +1,137 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/crypto/quic_proof_cache.h"
+
+#include "net/third_party/quiche/src/quic/core/quic_utils.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
+
+namespace quic {
+
+const size_t QuicProofCache::kQuicProofCacheSize = 64;
+
+QuicProofCache::CachedProof::CachedProof(
+    const QuicSocketAddress& server_address,
+    const QuicString& hostname,
+    const QuicString& server_config,
+    QuicTransportVersion transport_version,
+    QuicStringPiece chlo_hash,
+    const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
+    const QuicCryptoProof& proof)
+    : server_address(server_address),
+      hostname(hostname),
+      server_config(server_config),
+      transport_version(transport_version),
+      chlo_hash(chlo_hash),
+      chain(chain),
+      proof(proof) {}
+
+QuicProofCache::CachedProof::~CachedProof() {}
+
+bool QuicProofCache::CachedProof::Matches(
+    const QuicSocketAddress& server_address,
+    const QuicString& hostname,
+    const QuicString& server_config,
+    QuicTransportVersion transport_version,
+    QuicStringPiece chlo_hash) const {
+  return this->server_address == server_address &&
+         this->hostname == hostname && this->server_config == server_config &&
+         this->transport_version == transport_version &&
+         this->chlo_hash == chlo_hash;
+}
+
+QuicProofCache::QuicProofCache(int64_t max_num_proofs)
+    : proof_cache_(max_num_proofs), num_hits_(0), num_misses_(0) {}
+
+QuicProofCache::~QuicProofCache() {
+  // Underlying cache must be cleared before destruction.
+  QuicWriterMutexLock lock(&lock_);
+  proof_cache_.Clear();
+}
+
+bool QuicProofCache::GetProof(
+    const QuicSocketAddress& server_address,
+    const QuicString& hostname,
+    const QuicString& server_config,
+    QuicTransportVersion transport_version,
+    QuicStringPiece chlo_hash,
+    QuicReferenceCountedPointer<ProofSource::Chain>* chain,
+    QuicCryptoProof* proof) {
+  uint64_t key = ComputeKey(server_address, hostname, server_config,
+                            transport_version, chlo_hash);
+
+  // Lookup() updates the LRU order, so a writer lock is needed.
+  QuicWriterMutexLock lock(&lock_);
+  CachedProof* cached_value = proof_cache_.Lookup(key);
+  if (cached_value == nullptr ||
+      !cached_value->Matches(server_address, hostname, server_config,
+                             transport_version, chlo_hash)) {
+    ++num_misses_;
+    return false;
+  }
+  ++num_hits_;
+  *chain = cached_value->chain;
+  *proof = cached_value->proof;
+  return true;
+}
+
+void QuicProofCache::Insert(
+    const QuicSocketAddress& server_address,
+    const QuicString& hostname,
+    const QuicString& server_config,
+    QuicTransportVersion transport_version,
+    QuicStringPiece chlo_hash,
+    const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
+    const QuicCryptoProof& proof) {
+  uint64_t key = ComputeKey(server_address, hostname, server_config,
+                            transport_version, chlo_hash);
+  auto cached_proof =
+      QuicMakeUnique<CachedProof>(server_address, hostname, server_config,
+                                  transport_version, chlo_hash, chain, proof);
+
+  QuicWriterMutexLock lock(&lock_);
+  proof_cache_.Insert(key, std::move(cached_proof));
+}
+
+void QuicProofCache::Clear() {
+  QuicWriterMutexLock lock(&lock_);
+  proof_cache_.Clear();
+}
+
+size_t QuicProofCache::MaxSize() {
+  QuicReaderMutexLock lock(&lock_);
+  return proof_cache_.MaxSize();
+}
+
+size_t QuicProofCache::Size() {
+  QuicReaderMutexLock lock(&lock_);
+  return proof_cache_.Size();
+}
+
+uint64_t QuicProofCache::num_hits() const {
+  QuicReaderMutexLock lock(&lock_);
+  return num_hits_;
+}
+
+uint64_t QuicProofCache::num_misses() const {
+  QuicReaderMutexLock lock(&lock_);
+  return num_misses_;
+}
+
+// static
+uint64_t QuicProofCache::ComputeKey(const QuicSocketAddress& server_address,
+                                    const QuicString& hostname,
+                                    const QuicString& server_config,
+                                    QuicTransportVersion transport_version,
+                                    QuicStringPiece chlo_hash) {
+  uint64_t hash = std::hash<QuicString>()(server_address.ToString());
+  QuicUtils::HashCombine(&hash, std::hash<QuicString>()(hostname));
+  QuicUtils::HashCombine(&hash, std::hash<QuicString>()(server_config));
+  QuicUtils::HashCombine(&hash, static_cast<uint64_t>(transport_version));
+  QuicUtils::HashCombine(&hash,
+                         std::hash<QuicString>()(QuicString(chlo_hash)));
+  return hash;
+}
+
+}  // namespace quic
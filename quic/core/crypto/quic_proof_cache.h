@@ -0,0 +1,116 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_CRYPTO_QUIC_PROOF_CACHE_H_
+#define QUICHE_QUIC_CORE_CRYPTO_QUIC_PROOF_CACHE_H_
+
+#include <cstdint>
+
+#include "net/third_party/quiche/src/quic/core/crypto/proof_source.h"
+#include "net/third_party/quiche/src/quic/core/crypto/quic_crypto_proof.h"
+#include "net/third_party/quiche/src/quic/core/quic_lru_cache.h"
+#include "net/third_party/quiche/src/quic/core/quic_versions.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_mutex.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_socket_address.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
+
+namespace quic {
+
+// QuicProofCache is a cache of the most recently computed results of
+// ProofSource::GetProof, so that identical signing requests are not signed
+// again.  Unlike QuicCompressedCertsCache, it is shared by all the handshakes
+// of a QuicCryptoServerConfig and is safe to use from multiple threads.
+class QUIC_EXPORT_PRIVATE QuicProofCache {
+ public:
+  explicit QuicProofCache(int64_t max_num_proofs);
+  QuicProofCache(const QuicProofCache&) = delete;
+  QuicProofCache& operator=(const QuicProofCache&) = delete;
+  ~QuicProofCache();
+
+  // Returns true and sets |chain| and |proof| if the proof of
+  // |server_address, hostname, server_config, transport_version, chlo_hash|
+  // hits cache.  Otherwise, returns false.
+  bool GetProof(const QuicSocketAddress& server_address,
+                const QuicString& hostname,
+                const QuicString& server_config,
+                QuicTransportVersion transport_version,
+                QuicStringPiece chlo_hash,
+                QuicReferenceCountedPointer<ProofSource::Chain>* chain,
+                QuicCryptoProof* proof);
+
+  // Inserts |chain| and |proof| as the proof of
+  // |server_address, hostname, server_config, transport_version, chlo_hash|.
+  // If the insertion causes the cache to become overfull, entries will be
+  // deleted in an LRU order to make room.
+  void Insert(const QuicSocketAddress& server_address,
+              const QuicString& hostname,
+              const QuicString& server_config,
+              QuicTransportVersion transport_version,
+              QuicStringPiece chlo_hash,
+              const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
+              const QuicCryptoProof& proof);
+
+  // Removes all entries, for example after the certificates of the
+  // ProofSource have changed.
+  void Clear();
+
+  // Returns max number of cache entries the cache can carry.
+  size_t MaxSize();
+
+  // Returns current number of cache entries in the cache.
+  size_t Size();
+
+  // Number of calls to GetProof() which hit and missed the cache.
+  uint64_t num_hits() const;
+  uint64_t num_misses() const;
+
+  // Default size of the QuicProofCache.
+  static const size_t kQuicProofCacheSize;
+
+ private:
+  // The inputs of a signature, and the resulting proof.
+  struct CachedProof {
+    CachedProof(const QuicSocketAddress& server_address,
+                const QuicString& hostname,
+                const QuicString& server_config,
+                QuicTransportVersion transport_version,
+                QuicStringPiece chlo_hash,
+                const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
+                const QuicCryptoProof& proof);
+    ~CachedProof();
+
+    // Returns true if this proof was computed from the given inputs.
+    bool Matches(const QuicSocketAddress& server_address,
+                 const QuicString& hostname,
+                 const QuicString& server_config,
+                 QuicTransportVersion transport_version,
+                 QuicStringPiece chlo_hash) const;
+
+    const QuicSocketAddress server_address;
+    const QuicString hostname;
+    const QuicString server_config;
+    const QuicTransportVersion transport_version;
+    const QuicString chlo_hash;
+    const QuicReferenceCountedPointer<ProofSource::Chain> chain;
+    const QuicCryptoProof proof;
+  };
+
+  // Computes a uint64_t hash of the inputs of a signature.
+  static uint64_t ComputeKey(const QuicSocketAddress& server_address,
+                             const QuicString& hostname,
+                             const QuicString& server_config,
+                             QuicTransportVersion transport_version,
+                             QuicStringPiece chlo_hash);
+
+  mutable QuicMutex lock_;
+  QuicLRUCache<uint64_t, CachedProof> proof_cache_ GUARDED_BY(lock_);
+  uint64_t num_hits_ GUARDED_BY(lock_);
+  uint64_t num_misses_ GUARDED_BY(lock_);
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_CRYPTO_QUIC_PROOF_CACHE_H_
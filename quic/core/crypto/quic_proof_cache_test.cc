@@ -0,0 +1,102 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/crypto/quic_proof_cache.h"
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+class QuicProofCacheTest : public QuicTest {
+ public:
+  QuicProofCacheTest()
+      : proof_cache_(2),
+        server_address_(QuicIpAddress::Loopback4(), 443),
+        version_(AllSupportedTransportVersions().front()),
+        chain_(new ProofSource::Chain(
+            std::vector<QuicString>{"leaf cert", "intermediate cert"})) {
+    proof_.signature = "signature";
+    proof_.leaf_cert_scts = "scts";
+  }
+
+ protected:
+  QuicProofCache proof_cache_;
+  QuicSocketAddress server_address_;
+  QuicTransportVersion version_;
+  QuicReferenceCountedPointer<ProofSource::Chain> chain_;
+  QuicCryptoProof proof_;
+};
+
+TEST_F(QuicProofCacheTest, CacheHit) {
+  proof_cache_.Insert(server_address_, "example.org", "scfg", version_,
+                      "chlo hash", chain_, proof_);
+
+  QuicReferenceCountedPointer<ProofSource::Chain> chain;
+  QuicCryptoProof proof;
+  EXPECT_TRUE(proof_cache_.GetProof(server_address_, "example.org", "scfg",
+                                    version_, "chlo hash", &chain, &proof));
+  EXPECT_EQ(chain_, chain);
+  EXPECT_EQ(proof_.signature, proof.signature);
+  EXPECT_EQ(proof_.leaf_cert_scts, proof.leaf_cert_scts);
+  EXPECT_EQ(1u, proof_cache_.num_hits());
+  EXPECT_EQ(0u, proof_cache_.num_misses());
+}
+
+TEST_F(QuicProofCacheTest, CacheMiss) {
+  proof_cache_.Insert(server_address_, "example.org", "scfg", version_,
+                      "chlo hash", chain_, proof_);
+
+  QuicReferenceCountedPointer<ProofSource::Chain> chain;
+  QuicCryptoProof proof;
+  EXPECT_FALSE(proof_cache_.GetProof(
+      QuicSocketAddress(QuicIpAddress::Loopback4(), 444), "example.org",
+      "scfg", version_, "chlo hash", &chain, &proof));
+  EXPECT_FALSE(proof_cache_.GetProof(server_address_, "example.com", "scfg",
+                                     version_, "chlo hash", &chain, &proof));
+  EXPECT_FALSE(proof_cache_.GetProof(server_address_, "example.org",
+                                     "other scfg", version_, "chlo hash",
+                                     &chain, &proof));
+  EXPECT_FALSE(proof_cache_.GetProof(server_address_, "example.org", "scfg",
+                                     version_, "other chlo hash", &chain,
+                                     &proof));
+  EXPECT_EQ(nullptr, chain.get());
+  EXPECT_EQ(0u, proof_cache_.num_hits());
+  EXPECT_EQ(4u, proof_cache_.num_misses());
+}
+
+TEST_F(QuicProofCacheTest, CacheMissDueToEviction) {
+  proof_cache_.Insert(server_address_, "example.org", "scfg", version_,
+                      "chlo hash 1", chain_, proof_);
+  proof_cache_.Insert(server_address_, "example.org", "scfg", version_,
+                      "chlo hash 2", chain_, proof_);
+  proof_cache_.Insert(server_address_, "example.org", "scfg", version_,
+                      "chlo hash 3", chain_, proof_);
+  EXPECT_EQ(2u, proof_cache_.Size());
+
+  QuicReferenceCountedPointer<ProofSource::Chain> chain;
+  QuicCryptoProof proof;
+  EXPECT_FALSE(proof_cache_.GetProof(server_address_, "example.org", "scfg",
+                                     version_, "chlo hash 1", &chain, &proof));
+  EXPECT_TRUE(proof_cache_.GetProof(server_address_, "example.org", "scfg",
+                                    version_, "chlo hash 3", &chain, &proof));
+}
+
+TEST_F(QuicProofCacheTest, Clear) {
+  proof_cache_.Insert(server_address_, "example.org", "scfg", version_,
+                      "chlo hash", chain_, proof_);
+  proof_cache_.Clear();
+  EXPECT_EQ(0u, proof_cache_.Size());
+
+  QuicReferenceCountedPointer<ProofSource::Chain> chain;
+  QuicCryptoProof proof;
+  EXPECT_FALSE(proof_cache_.GetProof(server_address_, "example.org", "scfg",
+                                     version_, "chlo hash", &chain, &proof));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -0,0 +1,26 @@
+// Copyright (c) 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/frames/quic_fec_frame.h"
+
+namespace quic {
+
+QuicFecFrame::QuicFecFrame() : repair_offset(0) {}
+
+QuicFecFrame::QuicFecFrame(const QuicFecFrame& other) = default;
+
+QuicFecFrame::~QuicFecFrame() {}
+
+std::ostream& operator<<(std::ostream& os, const QuicFecFrame& s) {
+  os << "{ protected_frames: [";
+  for (const QuicFecFrame::ProtectedStreamFrame& frame : s.protected_frames) {
+    os << " { stream_id: " << frame.stream_id << ", offset: " << frame.offset
+       << ", length: " << frame.data_length << ", fin: " << frame.fin << " }";
+  }
+  os << " ], repair_offset: " << s.repair_offset
+     << ", repair_length: " << s.repair_data.length() << " }\n";
+  return os;
+}
+
+}  // namespace quic
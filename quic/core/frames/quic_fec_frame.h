@@ -0,0 +1,45 @@
+// Copyright (c) 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_FRAMES_QUIC_FEC_FRAME_H_
+#define QUICHE_QUIC_CORE_FRAMES_QUIC_FEC_FRAME_H_
+
+#include <ostream>
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/core/quic_types.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
+
+namespace quic {
+
+// Carries the XOR of the data of recently sent stream frames, which lets the
+// receiver rebuild one of them if it was lost.  Frames shorter than the longest
+// protected frame are padded with zeros.  A repair frame may only carry part of
+// the XOR, starting at |repair_offset|, so that the repair of full-sized
+// packets fits into packets of the same size.
+struct QUIC_EXPORT_PRIVATE QuicFecFrame {
+  struct QUIC_EXPORT_PRIVATE ProtectedStreamFrame {
+    QuicStreamId stream_id;
+    QuicStreamOffset offset;
+    QuicPacketLength data_length;
+    bool fin;
+  };
+
+  QuicFecFrame();
+  QuicFecFrame(const QuicFecFrame& other);
+  ~QuicFecFrame();
+
+  friend QUIC_EXPORT_PRIVATE std::ostream& operator<<(std::ostream& os,
+                                                      const QuicFecFrame& s);
+
+  std::vector<ProtectedStreamFrame> protected_frames;
+  // Offset into the protected data of the first byte of |repair_data|.
+  QuicPacketLength repair_offset;
+  QuicString repair_data;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_FRAMES_QUIC_FEC_FRAME_H_
@@ -75,6 +75,9 @@ QuicFrame::QuicFrame(QuicMessageFrame* frame)
 QuicFrame::QuicFrame(QuicNewTokenFrame* frame)
     : type(NEW_TOKEN_FRAME), new_token_frame(frame) {}
 
+QuicFrame::QuicFrame(QuicFecFrame* frame)
+    : type(FEC_FRAME), fec_frame(frame) {}
+
 void DeleteFrames(QuicFrames* frames) {
   for (QuicFrame& frame : *frames) {
     DeleteFrame(&frame);
@@ -140,6 +143,9 @@ void DeleteFrame(QuicFrame* frame) {
     case NEW_TOKEN_FRAME:
       delete frame->new_token_frame;
       break;
+    case FEC_FRAME:
+      delete frame->fec_frame;
+      break;
 
     case NUM_FRAME_TYPES:
       DCHECK(false) << "Cannot delete type: " << frame->type;
@@ -341,6 +347,9 @@ std::ostream& operator<<(std::ostream& os, const QuicFrame& frame) {
     case NEW_TOKEN_FRAME:
       os << "type { NEW_TOKEN_FRAME }" << *(frame.new_token_frame);
       break;
+    case FEC_FRAME:
+      os << "type { FEC_FRAME }" << *(frame.fec_frame);
+      break;
     default: {
       QUIC_LOG(ERROR) << "Unknown frame type: " << frame.type;
       break;
@@ -13,6 +13,7 @@
 #include "net/third_party/quiche/src/quic/core/frames/quic_blocked_frame.h"
 #include "net/third_party/quiche/src/quic/core/frames/quic_connection_close_frame.h"
 #include "net/third_party/quiche/src/quic/core/frames/quic_crypto_frame.h"
+#include "net/third_party/quiche/src/quic/core/frames/quic_fec_frame.h"
 #include "net/third_party/quiche/src/quic/core/frames/quic_goaway_frame.h"
 #include "net/third_party/quiche/src/quic/core/frames/quic_max_stream_id_frame.h"
 #include "net/third_party/quiche/src/quic/core/frames/quic_message_frame.h"
@@ -62,6 +63,7 @@ struct QUIC_EXPORT_PRIVATE QuicFrame {
   explicit QuicFrame(QuicStopSendingFrame* frame);
   explicit QuicFrame(QuicMessageFrame* message_frame);
   explicit QuicFrame(QuicCryptoFrame* crypto_frame);
+  explicit QuicFrame(QuicFecFrame* fec_frame);
 
   QUIC_EXPORT_PRIVATE friend std::ostream& operator<<(std::ostream& os,
                                                       const QuicFrame& frame);
@@ -103,6 +105,7 @@ struct QUIC_EXPORT_PRIVATE QuicFrame {
         QuicMessageFrame* message_frame;
         QuicCryptoFrame* crypto_frame;
         QuicNewTokenFrame* new_token_frame;
+        QuicFecFrame* fec_frame;
       };
     };
   };
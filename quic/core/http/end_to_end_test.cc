@@ -3241,8 +3241,10 @@ TEST_P(EndToEndTest, SendStatelessResetTokenInShlo) {
   EXPECT_TRUE(client_->client()->WaitForCryptoHandshakeConfirmed());
   QuicConfig* config = client_->client()->session()->config();
   EXPECT_TRUE(config->HasReceivedStatelessResetToken());
-  // TODO(dschinazi) b/120240679 - convert connection ID to UInt128
-  EXPECT_EQ(TestConnectionIdToUInt64(
+  // The token is keyed by the server's source address token secret.
+  const QuicCryptoServerConfig& crypto_config =
+      server_thread_->server()->crypto_config();
+  EXPECT_EQ(crypto_config.GenerateStatelessResetToken(
                 client_->client()->session()->connection()->connection_id()),
             config->ReceivedStatelessResetToken());
   client_->Disconnect();
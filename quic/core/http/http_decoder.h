@@ -72,7 +72,8 @@ class QUIC_EXPORT_PRIVATE HttpDecoder {
     virtual void OnDataFrameEnd() = 0;
 
     // Called when a HEADERS frame has been recevied.
-    virtual void OnHeadersFrameStart() = 0;
+    // |frame_lengths| contains the length of the frame header and payload.
+    virtual void OnHeadersFrameStart(Http3FrameLengths frame_lengths) = 0;
     // Called when the payload of a HEADERS frame has read. May be called
     // multiple times for a single frame.
     virtual void OnHeadersFramePayload(QuicStringPiece payload) = 0;
@@ -0,0 +1,155 @@
+// Copyright (c) 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/http/quic_header_block_builder.h"
+
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/core/quic_constants.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_bug_tracker.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_text_utils.h"
+#include "net/third_party/quiche/src/spdy/core/spdy_protocol.h"
+
+namespace quic {
+
+QuicHeaderBlockBuilder::QuicHeaderBlockBuilder()
+    : max_header_list_size_(kDefaultMaxUncompressedHeaderSize),
+      current_header_list_size_(0),
+      uncompressed_header_bytes_(0),
+      compressed_header_bytes_(0),
+      headers_valid_(true),
+      header_list_too_large_(false),
+      has_pseudo_header_(false),
+      has_final_byte_offset_(false),
+      final_byte_offset_(0),
+      content_length_(-1) {}
+
+QuicHeaderBlockBuilder::~QuicHeaderBlockBuilder() {}
+
+void QuicHeaderBlockBuilder::OnHeaderBlockStart() {
+  QUIC_BUG_IF(current_header_list_size_ != 0)
+      << "OnHeaderBlockStart called more than once!";
+}
+
+void QuicHeaderBlockBuilder::OnHeader(QuicStringPiece name,
+                                      QuicStringPiece value) {
+  // Avoid infinite buffering of headers. No longer store headers
+  // once the current headers are over the limit.
+  if (current_header_list_size_ >= max_header_list_size_) {
+    return;
+  }
+  current_header_list_size_ +=
+      name.size() + value.size() + spdy::kPerHeaderOverhead;
+
+  // There is no need to keep storing headers once the block is known to be
+  // malformed; only the size accounting above is still needed.
+  if (!headers_valid_) {
+    return;
+  }
+
+  if (name.empty()) {
+    QUIC_DLOG(ERROR) << "Header name must not be empty.";
+    headers_valid_ = false;
+    return;
+  }
+
+  if (QuicTextUtils::ContainsUpperCase(name)) {
+    QUIC_DLOG(ERROR) << "Malformed header: Header name " << name
+                     << " contains upper-case characters.";
+    headers_valid_ = false;
+    return;
+  }
+
+  if (name[0] == ':') {
+    // Pull out the first parseable final offset pseudo header, which is
+    // required in trailers.  Any other pseudo-header is not allowed there.
+    if (!has_final_byte_offset_ && name == kFinalOffsetHeaderKey &&
+        QuicTextUtils::StringToSizeT(value, &final_byte_offset_)) {
+      has_final_byte_offset_ = true;
+    } else {
+      has_pseudo_header_ = true;
+    }
+  } else if (name == "content-length" && !UpdateContentLength(value)) {
+    headers_valid_ = false;
+    return;
+  }
+
+  header_block_.AppendValueOrAddHeader(name, value);
+}
+
+void QuicHeaderBlockBuilder::OnHeaderBlockEnd(size_t uncompressed_header_bytes,
+                                              size_t compressed_header_bytes) {
+  uncompressed_header_bytes_ = uncompressed_header_bytes;
+  compressed_header_bytes_ = compressed_header_bytes;
+  if (current_header_list_size_ > max_header_list_size_) {
+    header_list_too_large_ = true;
+    header_block_.clear();
+  }
+}
+
+void QuicHeaderBlockBuilder::Clear() {
+  header_block_.clear();
+  current_header_list_size_ = 0;
+  uncompressed_header_bytes_ = 0;
+  compressed_header_bytes_ = 0;
+  headers_valid_ = true;
+  header_list_too_large_ = false;
+  has_pseudo_header_ = false;
+  has_final_byte_offset_ = false;
+  final_byte_offset_ = 0;
+  content_length_ = -1;
+}
+
+bool QuicHeaderBlockBuilder::ValidateAsTrailers(size_t* final_byte_offset) {
+  if (!headers_valid_) {
+    return false;
+  }
+
+  if (has_pseudo_header_) {
+    QUIC_DLOG(ERROR) << "Trailers must not contain pseudo-headers.";
+    return false;
+  }
+
+  if (!has_final_byte_offset_) {
+    QUIC_DLOG(ERROR) << "Required key '" << kFinalOffsetHeaderKey
+                     << "' not present";
+    return false;
+  }
+
+  header_block_.erase(kFinalOffsetHeaderKey);
+  *final_byte_offset = final_byte_offset_;
+  return true;
+}
+
+spdy::SpdyHeaderBlock QuicHeaderBlockBuilder::ReleaseHeaderBlock() {
+  spdy::SpdyHeaderBlock header_block = std::move(header_block_);
+  header_block_.clear();
+  return header_block;
+}
+
+bool QuicHeaderBlockBuilder::UpdateContentLength(QuicStringPiece value) {
+  // A single value may itself contain multiple NUL-separated values.
+  std::vector<QuicStringPiece> values = QuicTextUtils::Split(value, '\0');
+  for (const QuicStringPiece& v : values) {
+    uint64_t new_value;
+    if (!QuicTextUtils::StringToUint64(v, &new_value)) {
+      QUIC_DLOG(ERROR) << "Content length was either unparseable or negative.";
+      return false;
+    }
+    if (content_length_ < 0) {
+      content_length_ = new_value;
+      continue;
+    }
+    if (new_value != static_cast<uint64_t>(content_length_)) {
+      QUIC_DLOG(ERROR) << "Parsed content length " << new_value << " is "
+                       << "inconsistent with previously detected content "
+                       << "length " << content_length_;
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace quic
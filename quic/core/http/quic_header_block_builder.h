@@ -0,0 +1,110 @@
+// Copyright (c) 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_HTTP_QUIC_HEADER_BLOCK_BUILDER_H_
+#define QUICHE_QUIC_CORE_HTTP_QUIC_HEADER_BLOCK_BUILDER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
+#include "net/third_party/quiche/src/spdy/core/spdy_header_block.h"
+#include "net/third_party/quiche/src/spdy/core/spdy_headers_handler_interface.h"
+
+namespace quic {
+
+// A SpdyHeadersHandlerInterface that validates headers as they are decoded and
+// appends them directly to a SpdyHeaderBlock.  This avoids buffering every
+// header in a QuicHeaderList and then copying the list into a SpdyHeaderBlock
+// with SpdyUtils::CopyAndValidateHeaders().  The validation performed is the
+// same as that of SpdyUtils::CopyAndValidateHeaders() and
+// SpdyUtils::CopyAndValidateTrailers().
+class QUIC_EXPORT_PRIVATE QuicHeaderBlockBuilder
+    : public spdy::SpdyHeadersHandlerInterface {
+ public:
+  QuicHeaderBlockBuilder();
+  QuicHeaderBlockBuilder(const QuicHeaderBlockBuilder&) = delete;
+  QuicHeaderBlockBuilder& operator=(const QuicHeaderBlockBuilder&) = delete;
+  ~QuicHeaderBlockBuilder() override;
+
+  // From SpdyHeadersHandlerInterface.
+  void OnHeaderBlockStart() override;
+  void OnHeader(QuicStringPiece name, QuicStringPiece value) override;
+  void OnHeaderBlockEnd(size_t uncompressed_header_bytes,
+                        size_t compressed_header_bytes) override;
+
+  // Resets all state so that the builder can be used for the next header
+  // block.  Does not change |max_header_list_size_|.
+  void Clear();
+
+  // Returns true if every header received so far is valid as part of an
+  // initial header block, and the content-length values (if any) are
+  // consistent.
+  bool headers_valid() const { return headers_valid_; }
+
+  // Returns true if the header block is valid as a trailer block: headers must
+  // be valid, a parseable final offset must be present, and no other
+  // pseudo-headers are allowed.  On success, removes the final offset from
+  // |header_block_| and sets |final_byte_offset|.
+  bool ValidateAsTrailers(size_t* final_byte_offset);
+
+  // Returns true if the header list exceeded |max_header_list_size_|, in which
+  // case the header block has been cleared.
+  bool header_list_too_large() const { return header_list_too_large_; }
+
+  // Returns the value of the content-length header, or -1 if not present.
+  int64_t content_length() const { return content_length_; }
+
+  // Returns true if a parseable final offset header has been received.
+  bool has_final_byte_offset() const { return has_final_byte_offset_; }
+  size_t final_byte_offset() const { return final_byte_offset_; }
+
+  const spdy::SpdyHeaderBlock& header_block() const { return header_block_; }
+
+  // Moves the accumulated header block out of the builder.
+  spdy::SpdyHeaderBlock ReleaseHeaderBlock();
+
+  size_t uncompressed_header_bytes() const {
+    return uncompressed_header_bytes_;
+  }
+  size_t compressed_header_bytes() const { return compressed_header_bytes_; }
+
+  void set_max_header_list_size(size_t max_header_list_size) {
+    max_header_list_size_ = max_header_list_size;
+  }
+
+  size_t max_header_list_size() const { return max_header_list_size_; }
+
+ private:
+  // Parses |value| of a content-length header and checks it against any
+  // previously received value.  Returns false on error.
+  bool UpdateContentLength(QuicStringPiece value);
+
+  spdy::SpdyHeaderBlock header_block_;
+
+  // The limit on the size of the header list (defined by spec as name + value +
+  // overhead for each header field).  Headers over this limit will not be
+  // stored, and the block will be cleared upon OnHeaderBlockEnd.
+  size_t max_header_list_size_;
+
+  // Defined per the spec as the size of all header fields with an additional
+  // overhead for each field.
+  size_t current_header_list_size_;
+
+  size_t uncompressed_header_bytes_;
+  size_t compressed_header_bytes_;
+
+  bool headers_valid_;
+  bool header_list_too_large_;
+  // True if a pseudo-header other than the final offset has been received.
+  bool has_pseudo_header_;
+  bool has_final_byte_offset_;
+  size_t final_byte_offset_;
+  int64_t content_length_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_HTTP_QUIC_HEADER_BLOCK_BUILDER_H_
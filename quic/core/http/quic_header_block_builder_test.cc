@@ -0,0 +1,152 @@
+// Copyright (c) 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/http/quic_header_block_builder.h"
+
+#include "net/third_party/quiche/src/quic/core/quic_constants.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+
+using spdy::SpdyHeaderBlock;
+
+namespace quic {
+namespace test {
+namespace {
+
+class QuicHeaderBlockBuilderTest : public QuicTest {
+ protected:
+  QuicHeaderBlockBuilder builder_;
+};
+
+TEST_F(QuicHeaderBlockBuilderTest, ValidHeaders) {
+  builder_.OnHeaderBlockStart();
+  builder_.OnHeader(":method", "GET");
+  builder_.OnHeader("foo", "bar");
+  builder_.OnHeader("foo", "baz");
+  builder_.OnHeader("content-length", "42");
+  builder_.OnHeaderBlockEnd(100, 50);
+
+  EXPECT_TRUE(builder_.headers_valid());
+  EXPECT_FALSE(builder_.header_list_too_large());
+  EXPECT_EQ(42, builder_.content_length());
+  EXPECT_EQ(100u, builder_.uncompressed_header_bytes());
+  EXPECT_EQ(50u, builder_.compressed_header_bytes());
+
+  SpdyHeaderBlock expected;
+  expected[":method"] = "GET";
+  expected.AppendValueOrAddHeader("foo", "bar");
+  expected.AppendValueOrAddHeader("foo", "baz");
+  expected["content-length"] = "42";
+  SpdyHeaderBlock headers = builder_.ReleaseHeaderBlock();
+  EXPECT_EQ(expected, headers);
+  EXPECT_TRUE(builder_.header_block().empty());
+}
+
+TEST_F(QuicHeaderBlockBuilderTest, EmptyHeaderName) {
+  builder_.OnHeader("", "bar");
+  builder_.OnHeaderBlockEnd(3, 3);
+  EXPECT_FALSE(builder_.headers_valid());
+}
+
+TEST_F(QuicHeaderBlockBuilderTest, UpperCaseHeaderName) {
+  builder_.OnHeader("Foo", "bar");
+  builder_.OnHeader("baz", "qux");
+  builder_.OnHeaderBlockEnd(12, 12);
+  EXPECT_FALSE(builder_.headers_valid());
+  // Headers are no longer stored once the block is known to be invalid.
+  EXPECT_TRUE(builder_.header_block().empty());
+}
+
+TEST_F(QuicHeaderBlockBuilderTest, MultipleConsistentContentLength) {
+  builder_.OnHeader("content-length", "9000");
+  builder_.OnHeader("content-length", QuicString("9000\09000", 9));
+  builder_.OnHeaderBlockEnd(0, 0);
+  EXPECT_TRUE(builder_.headers_valid());
+  EXPECT_EQ(9000, builder_.content_length());
+}
+
+TEST_F(QuicHeaderBlockBuilderTest, InconsistentContentLength) {
+  builder_.OnHeader("content-length", "9000");
+  builder_.OnHeader("content-length", "9001");
+  builder_.OnHeaderBlockEnd(0, 0);
+  EXPECT_FALSE(builder_.headers_valid());
+}
+
+TEST_F(QuicHeaderBlockBuilderTest, UnparseableContentLength) {
+  builder_.OnHeader("content-length", "-1");
+  builder_.OnHeaderBlockEnd(0, 0);
+  EXPECT_FALSE(builder_.headers_valid());
+}
+
+TEST_F(QuicHeaderBlockBuilderTest, TooLarge) {
+  QuicString key = "key";
+  QuicString value(1 << 18, '1');
+  builder_.OnHeader(key, value);
+  builder_.OnHeader(key + "2", value);
+  size_t total_bytes = 2 * (key.size() + value.size()) + 1;
+  builder_.OnHeaderBlockEnd(total_bytes, total_bytes);
+  EXPECT_TRUE(builder_.header_list_too_large());
+  EXPECT_TRUE(builder_.header_block().empty());
+}
+
+TEST_F(QuicHeaderBlockBuilderTest, NotTooLarge) {
+  builder_.set_max_header_list_size(1 << 20);
+  QuicString key = "key";
+  QuicString value(1 << 18, '1');
+  builder_.OnHeader(key, value);
+  size_t total_bytes = key.size() + value.size();
+  builder_.OnHeaderBlockEnd(total_bytes, total_bytes);
+  EXPECT_FALSE(builder_.header_list_too_large());
+  EXPECT_FALSE(builder_.header_block().empty());
+}
+
+TEST_F(QuicHeaderBlockBuilderTest, ValidTrailers) {
+  builder_.OnHeader("key1", "value1");
+  builder_.OnHeader(kFinalOffsetHeaderKey, "1234");
+  builder_.OnHeader("key2", "value2");
+  builder_.OnHeaderBlockEnd(0, 0);
+
+  size_t final_byte_offset = 0;
+  EXPECT_TRUE(builder_.ValidateAsTrailers(&final_byte_offset));
+  EXPECT_EQ(1234u, final_byte_offset);
+
+  SpdyHeaderBlock expected;
+  expected["key1"] = "value1";
+  expected["key2"] = "value2";
+  EXPECT_EQ(expected, builder_.header_block());
+}
+
+TEST_F(QuicHeaderBlockBuilderTest, TrailersWithoutFinalOffset) {
+  builder_.OnHeader("key1", "value1");
+  builder_.OnHeaderBlockEnd(0, 0);
+
+  size_t final_byte_offset = 0;
+  EXPECT_FALSE(builder_.ValidateAsTrailers(&final_byte_offset));
+}
+
+TEST_F(QuicHeaderBlockBuilderTest, TrailersWithPseudoHeader) {
+  builder_.OnHeader(kFinalOffsetHeaderKey, "1234");
+  builder_.OnHeader(":path", "/");
+  builder_.OnHeaderBlockEnd(0, 0);
+
+  size_t final_byte_offset = 0;
+  EXPECT_FALSE(builder_.ValidateAsTrailers(&final_byte_offset));
+}
+
+TEST_F(QuicHeaderBlockBuilderTest, Clear) {
+  builder_.OnHeader("Foo", "bar");
+  builder_.OnHeader(kFinalOffsetHeaderKey, "1234");
+  builder_.OnHeaderBlockEnd(0, 0);
+  EXPECT_FALSE(builder_.headers_valid());
+
+  builder_.Clear();
+  EXPECT_TRUE(builder_.headers_valid());
+  EXPECT_FALSE(builder_.has_final_byte_offset());
+  EXPECT_EQ(-1, builder_.content_length());
+  EXPECT_TRUE(builder_.header_block().empty());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -268,6 +268,11 @@ const QuicCryptoServerStreamBase* QuicServerSessionBase::GetCryptoStream()
   return crypto_stream_.get();
 }
 
+QuicUint128 QuicServerSessionBase::GetStatelessResetToken() const {
+  return crypto_config_->GenerateStatelessResetToken(
+      connection()->connection_id());
+}
+
 int32_t QuicServerSessionBase::BandwidthToCachedParameterBytesPerSecond(
     const QuicBandwidth& bandwidth) {
   return static_cast<int32_t>(std::min<int64_t>(
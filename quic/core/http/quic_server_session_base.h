@@ -76,6 +76,10 @@ class QUIC_EXPORT_PRIVATE QuicServerSessionBase : public QuicSpdySession {
 
   const QuicCryptoServerStreamBase* GetCryptoStream() const override;
 
+  // Uses the same keyed derivation as the time wait list, so that the token
+  // sent to the peer matches the one in stateless resets.
+  QuicUint128 GetStatelessResetToken() const override;
+
   // If an outgoing stream can be created, return true.
   // Return false when connection is closed or forward secure encryption hasn't
   // established yet or number of server initiated streams already reaches the
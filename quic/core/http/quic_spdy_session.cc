@@ -93,10 +93,27 @@ class QuicSpdySession::SpdyFramerVisitor
 
   SpdyHeadersHandlerInterface* OnHeaderFrameStart(
       SpdyStreamId /* stream_id */) override {
+    // PUSH_PROMISE headers are always delivered as a QuicHeaderList.
+    use_header_block_builder_ =
+        session_->deliver_header_blocks() &&
+        session_->promised_stream_id_ ==
+            QuicUtils::GetInvalidStreamId(
+                session_->connection()->transport_version());
+    if (use_header_block_builder_) {
+      return &header_block_builder_;
+    }
     return &header_list_;
   }
 
   void OnHeaderFrameEnd(SpdyStreamId /* stream_id */) override {
+    if (use_header_block_builder_) {
+      if (session_->IsConnected()) {
+        session_->OnHeaderBlock(&header_block_builder_);
+      }
+      header_block_builder_.Clear();
+      use_header_block_builder_ = false;
+      return;
+    }
     if (session_->IsConnected()) {
       session_->OnHeaderList(header_list_);
     }
@@ -280,6 +297,8 @@ class QuicSpdySession::SpdyFramerVisitor
   void set_max_uncompressed_header_bytes(
       size_t set_max_uncompressed_header_bytes) {
     header_list_.set_max_header_list_size(set_max_uncompressed_header_bytes);
+    header_block_builder_.set_max_header_list_size(
+        set_max_uncompressed_header_bytes);
   }
 
  private:
@@ -292,6 +311,10 @@ class QuicSpdySession::SpdyFramerVisitor
  private:
   QuicSpdySession* session_;
   QuicHeaderList header_list_;
+  QuicHeaderBlockBuilder header_block_builder_;
+  // True if the header block currently being decoded is delivered to
+  // |header_block_builder_| rather than |header_list_|.
+  bool use_header_block_builder_ = false;
 };
 
 QuicHpackDebugVisitor::QuicHpackDebugVisitor() {}
@@ -314,6 +337,7 @@ QuicSpdySession::QuicSpdySession(
       frame_len_(0),
       uncompressed_frame_len_(0),
       supports_push_promise_(perspective() == Perspective::IS_CLIENT),
+      deliver_header_blocks_(false),
       spdy_framer_(SpdyFramer::ENABLE_COMPRESSION),
       spdy_framer_visitor_(new SpdyFramerVisitor(this)) {
   h2_deframer_.set_visitor(spdy_framer_visitor_.get());
@@ -389,8 +413,12 @@ void QuicSpdySession::OnEncoderStreamError(QuicStringPiece error_message) {
 void QuicSpdySession::WriteDecoderStreamData(QuicStringPiece data) {
   DCHECK(VersionUsesQpack(connection()->transport_version()));
 
-  // TODO(112770235): Send decoder stream data on decoder stream.
-  QUIC_NOTREACHED();
+  // TODO(112770235): Send decoder stream data on decoder stream.  Until then,
+  // header acknowledgements for HEADERS frames received on request streams are
+  // dropped.  This is harmless while the decoder is never given a dynamic
+  // table capacity, because the peer cannot insert entries to acknowledge.
+  QUIC_DVLOG(1) << "Dropping " << data.length() << " bytes of decoder stream "
+                << "data";
 }
 
 void QuicSpdySession::OnStreamHeadersPriority(QuicStreamId stream_id,
@@ -441,6 +469,38 @@ void QuicSpdySession::OnStreamHeaderList(QuicStreamId stream_id,
   stream->OnStreamHeaderList(fin, frame_len, header_list);
 }
 
+void QuicSpdySession::OnStreamHeaderBlock(QuicStreamId stream_id,
+                                          bool fin,
+                                          size_t frame_len,
+                                          QuicHeaderBlockBuilder* builder) {
+  if (QuicContainsKey(static_streams(), stream_id)) {
+    connection()->CloseConnection(
+        QUIC_INVALID_HEADERS_STREAM_DATA, "stream is static",
+        ConnectionCloseBehavior::SEND_CONNECTION_CLOSE_PACKET);
+    return;
+  }
+  QuicSpdyStream* stream = GetSpdyDataStream(stream_id);
+  if (stream == nullptr) {
+    // The stream no longer exists, but trailing headers may contain the final
+    // byte offset necessary for flow control and open stream accounting.
+    if (builder->has_final_byte_offset()) {
+      DVLOG(1) << "Received final byte offset in trailers for stream "
+               << stream_id << ", which no longer exists.";
+      OnFinalByteOffsetReceived(stream_id, builder->final_byte_offset());
+    } else if (builder->header_block().find(kFinalOffsetHeaderKey) !=
+               builder->header_block().end()) {
+      connection()->CloseConnection(
+          QUIC_INVALID_HEADERS_STREAM_DATA,
+          "Trailers are malformed (no final offset)",
+          ConnectionCloseBehavior::SEND_CONNECTION_CLOSE_PACKET);
+    }
+
+    // It's quite possible to receive headers after a stream has been reset.
+    return;
+  }
+  stream->OnStreamHeaderBlock(fin, frame_len, builder);
+}
+
 void QuicSpdySession::OnPriorityFrame(QuicStreamId stream_id,
                                       SpdyPriority priority) {
   QuicSpdyStream* stream = GetSpdyDataStream(stream_id);
@@ -647,6 +707,19 @@ void QuicSpdySession::OnHeaderList(const QuicHeaderList& header_list) {
   uncompressed_frame_len_ = 0;
 }
 
+void QuicSpdySession::OnHeaderBlock(QuicHeaderBlockBuilder* builder) {
+  QUIC_DVLOG(1) << "Received header block for stream " << stream_id_ << ": "
+                << builder->header_block().DebugString();
+  DCHECK_EQ(QuicUtils::GetInvalidStreamId(connection()->transport_version()),
+            promised_stream_id_);
+  OnStreamHeaderBlock(stream_id_, fin_, frame_len_, builder);
+  // Reset state for the next frame.
+  stream_id_ = QuicUtils::GetInvalidStreamId(connection()->transport_version());
+  fin_ = false;
+  frame_len_ = 0;
+  uncompressed_frame_len_ = 0;
+}
+
 void QuicSpdySession::OnCompressedFrameSize(size_t frame_len) {
   frame_len_ += frame_len;
 }
@@ -9,6 +9,7 @@
 #include <memory>
 
 #include "base/macros.h"
+#include "net/third_party/quiche/src/quic/core/http/quic_header_block_builder.h"
 #include "net/third_party/quiche/src/quic/core/http/quic_header_list.h"
 #include "net/third_party/quiche/src/quic/core/http/quic_headers_stream.h"
 #include "net/third_party/quiche/src/quic/core/http/quic_spdy_stream.h"
@@ -93,6 +94,15 @@ class QUIC_EXPORT_PRIVATE QuicSpdySession
                                   size_t frame_len,
                                   const QuicHeaderList& header_list);
 
+  // Called by |headers_stream_| when headers have been completely received
+  // for a stream and decoded directly into |builder|.  Only called if
+  // deliver_header_blocks() is true.  |fin| will be true if the fin flag was
+  // set in the headers frame.
+  virtual void OnStreamHeaderBlock(QuicStreamId stream_id,
+                                   bool fin,
+                                   size_t frame_len,
+                                   QuicHeaderBlockBuilder* builder);
+
   // Called by |headers_stream_| when push promise headers have been
   // completely received.  |fin| will be true if the fin flag was set
   // in the headers.
@@ -159,6 +169,19 @@ class QUIC_EXPORT_PRIVATE QuicSpdySession
     max_inbound_header_list_size_ = max_inbound_header_list_size;
   }
 
+  size_t max_inbound_header_list_size() const {
+    return max_inbound_header_list_size_;
+  }
+
+  // If true, headers received in HEADERS frames are validated as they are
+  // decoded and delivered to streams as a SpdyHeaderBlock through
+  // OnStreamHeaderBlock(), instead of being accumulated in a QuicHeaderList.
+  // PUSH_PROMISE headers are always delivered as a QuicHeaderList.
+  bool deliver_header_blocks() const { return deliver_header_blocks_; }
+  void set_deliver_header_blocks(bool deliver_header_blocks) {
+    deliver_header_blocks_ = deliver_header_blocks;
+  }
+
  protected:
   // Override CreateIncomingStream(), CreateOutgoingBidirectionalStream() and
   // CreateOutgoingUnidirectionalStream() with QuicSpdyStream return type to
@@ -244,6 +267,10 @@ class QUIC_EXPORT_PRIVATE QuicSpdySession
   // Called when the complete list of headers is available.
   void OnHeaderList(const QuicHeaderList& header_list);
 
+  // Called when the complete header block of a HEADERS frame has been decoded
+  // into |builder|.
+  void OnHeaderBlock(QuicHeaderBlockBuilder* builder);
+
   // Called when the size of the compressed frame payload is available.
   void OnCompressedFrameSize(size_t frame_len);
 
@@ -270,6 +297,9 @@ class QUIC_EXPORT_PRIVATE QuicSpdySession
 
   bool supports_push_promise_;
 
+  // If true, HEADERS frames are delivered through OnStreamHeaderBlock().
+  bool deliver_header_blocks_;
+
   spdy::SpdyFramer spdy_framer_;
   http2::Http2DecoderAdapter h2_deframer_;
   std::unique_ptr<SpdyFramerVisitor> spdy_framer_visitor_;
@@ -1622,10 +1622,8 @@ TEST_P(QuicSpdySessionTestClient, WritePriority) {
     SpdyFramer spdy_framer(SpdyFramer::ENABLE_COMPRESSION);
     SpdySerializedFrame frame = spdy_framer.SerializeFrame(priority_frame);
 
-    const QuicMemSlice& slice =
-        QuicStreamSendBufferPeer::CurrentWriteSlice(&send_buffer)->slice;
     EXPECT_EQ(QuicStringPiece(frame.data(), frame.size()),
-              QuicStringPiece(slice.data(), slice.length()));
+              QuicStreamSendBufferPeer::CurrentWriteSlice(&send_buffer)->data);
   } else {
     EXPECT_EQ(0u, send_buffer.size());
   }
@@ -8,6 +8,7 @@
 
 #include "net/third_party/quiche/src/quic/core/http/quic_spdy_session.h"
 #include "net/third_party/quiche/src/quic/core/http/spdy_utils.h"
+#include "net/third_party/quiche/src/quic/core/qpack/qpack_decoder.h"
 #include "net/third_party/quiche/src/quic/core/quic_utils.h"
 #include "net/third_party/quiche/src/quic/core/quic_write_blocked_list.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_bug_tracker.h"
@@ -15,6 +16,8 @@
 #include "net/third_party/quiche/src/quic/platform/api/quic_flags.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_mem_slice_storage.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_str_cat.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_text_utils.h"
@@ -73,16 +76,31 @@ class QuicSpdyStream::HttpDecoderVisitor : public HttpDecoder::Visitor {
 
   void OnDataFrameEnd() override { stream_->OnDataFrameEnd(); }
 
-  void OnHeadersFrameStart() override {
-    CloseConnectionOnWrongFrame("Headers");
+  void OnHeadersFrameStart(Http3FrameLengths frame_lengths) override {
+    if (!VersionUsesQpack(
+            stream_->session()->connection()->transport_version())) {
+      CloseConnectionOnWrongFrame("Headers");
+      return;
+    }
+    stream_->OnHeadersFrameStart(frame_lengths);
   }
 
   void OnHeadersFramePayload(QuicStringPiece payload) override {
-    CloseConnectionOnWrongFrame("Headers");
+    if (!VersionUsesQpack(
+            stream_->session()->connection()->transport_version())) {
+      CloseConnectionOnWrongFrame("Headers");
+      return;
+    }
+    stream_->OnHeadersFramePayload(payload);
   }
 
   void OnHeadersFrameEnd(QuicByteCount frame_len) override {
-    CloseConnectionOnWrongFrame("Headers");
+    if (!VersionUsesQpack(
+            stream_->session()->connection()->transport_version())) {
+      CloseConnectionOnWrongFrame("Headers");
+      return;
+    }
+    stream_->OnHeadersFrameEnd(frame_len);
   }
 
   void OnPushPromiseFrameStart(PushId push_id) override {
@@ -121,15 +139,20 @@ QuicSpdyStream::QuicSpdyStream(QuicStreamId id,
       headers_decompressed_(false),
       trailers_decompressed_(false),
       trailers_consumed_(false),
+      headers_frame_length_(0),
+      headers_frame_decoded_(false),
       http_decoder_visitor_(new HttpDecoderVisitor(this)),
       body_buffer_(sequencer()),
       ack_listener_(nullptr) {
   DCHECK_NE(QuicUtils::GetCryptoStreamId(
                 spdy_session->connection()->transport_version()),
             id);
-  // Don't receive any callbacks from the sequencer until headers
-  // are complete.
-  sequencer()->SetBlockedUntilFlush();
+  // If headers are sent on the headers stream, then don't receive any callbacks
+  // from the sequencer until headers are complete.  Over HTTP/3, headers are
+  // read from the sequencer in HEADERS frames.
+  if (!VersionUsesQpack(spdy_session_->connection()->transport_version())) {
+    sequencer()->SetBlockedUntilFlush();
+  }
 
   if (VersionHasDataFrameHeader(
           spdy_session_->connection()->transport_version())) {
@@ -147,15 +170,20 @@ QuicSpdyStream::QuicSpdyStream(PendingStream pending,
       headers_decompressed_(false),
       trailers_decompressed_(false),
       trailers_consumed_(false),
+      headers_frame_length_(0),
+      headers_frame_decoded_(false),
       http_decoder_visitor_(new HttpDecoderVisitor(this)),
       body_buffer_(sequencer()),
       ack_listener_(nullptr) {
   DCHECK_NE(QuicUtils::GetCryptoStreamId(
                 spdy_session->connection()->transport_version()),
             id());
-  // Don't receive any callbacks from the sequencer until headers
-  // are complete.
-  sequencer()->SetBlockedUntilFlush();
+  // If headers are sent on the headers stream, then don't receive any callbacks
+  // from the sequencer until headers are complete.  Over HTTP/3, headers are
+  // read from the sequencer in HEADERS frames.
+  if (!VersionUsesQpack(spdy_session_->connection()->transport_version())) {
+    sequencer()->SetBlockedUntilFlush();
+  }
 
   if (VersionHasDataFrameHeader(
           spdy_session_->connection()->transport_version())) {
@@ -190,10 +218,41 @@ void QuicSpdyStream::WriteOrBufferBody(QuicStringPiece data, bool fin) {
   QuicConnection::ScopedPacketFlusher flusher(
       spdy_session_->connection(), QuicConnection::SEND_ACK_IF_PENDING);
 
-  // Write frame header.
+  WriteOrBufferDataFrameHeader(data.length());
+
+  // Write body.
+  QUIC_DLOG(INFO) << "Stream " << id() << " is writing body of length "
+                  << data.length();
+  WriteOrBufferData(data, fin, nullptr);
+}
+
+void QuicSpdyStream::WriteOrBufferBody(
+    QuicReferenceCountedPointer<QuicSharedBuffer> body,
+    bool fin) {
+  if (body->empty()) {
+    WriteOrBufferData(QuicStringPiece(), fin, nullptr);
+    return;
+  }
+  if (!VersionHasDataFrameHeader(
+          spdy_session_->connection()->transport_version())) {
+    WriteOrBufferSharedData(std::move(body), fin, nullptr);
+    return;
+  }
+  QuicConnection::ScopedPacketFlusher flusher(
+      spdy_session_->connection(), QuicConnection::SEND_ACK_IF_PENDING);
+
+  WriteOrBufferDataFrameHeader(body->length());
+
+  // Write body.
+  QUIC_DLOG(INFO) << "Stream " << id() << " is writing shared body of length "
+                  << body->length();
+  WriteOrBufferSharedData(std::move(body), fin, nullptr);
+}
+
+void QuicSpdyStream::WriteOrBufferDataFrameHeader(QuicByteCount body_length) {
   std::unique_ptr<char[]> buffer;
   QuicByteCount header_length =
-      encoder_.SerializeDataFrameHeader(data.length(), &buffer);
+      encoder_.SerializeDataFrameHeader(body_length, &buffer);
   unacked_frame_headers_offsets_.Add(
       send_buffer().stream_offset(),
       send_buffer().stream_offset() + header_length);
@@ -201,11 +260,6 @@ void QuicSpdyStream::WriteOrBufferBody(QuicStringPiece data, bool fin) {
                   << header_length;
   WriteOrBufferData(QuicStringPiece(buffer.get(), header_length), false,
                     nullptr);
-
-  // Write body.
-  QUIC_DLOG(INFO) << "Stream " << id() << " is writing body of length "
-                  << data.length();
-  WriteOrBufferData(data, fin, nullptr);
 }
 
 size_t QuicSpdyStream::WriteTrailers(
@@ -350,6 +404,7 @@ uint64_t QuicSpdyStream::total_body_bytes_read() const {
 void QuicSpdyStream::ConsumeHeaderList() {
   header_list_.Clear();
   if (FinishedReadingHeaders()) {
+    // Over HTTP/3, this delivers body which arrived with the headers.
     sequencer()->SetUnblocked();
   }
 }
@@ -381,6 +436,22 @@ void QuicSpdyStream::OnStreamHeaderList(bool fin,
   }
 }
 
+void QuicSpdyStream::OnStreamHeaderBlock(bool fin,
+                                         size_t frame_len,
+                                         QuicHeaderBlockBuilder* builder) {
+  if (builder->header_list_too_large()) {
+    OnHeadersTooLarge();
+    if (IsDoneReading()) {
+      return;
+    }
+  }
+  if (!headers_decompressed_) {
+    OnInitialHeaderBlockComplete(fin, frame_len, builder);
+  } else {
+    OnTrailingHeaderBlockComplete(fin, frame_len, builder);
+  }
+}
+
 void QuicSpdyStream::OnHeadersTooLarge() {
   Reset(QUIC_HEADERS_TOO_LARGE);
 }
@@ -399,6 +470,31 @@ void QuicSpdyStream::OnInitialHeadersComplete(
   }
 }
 
+void QuicSpdyStream::OnInitialHeaderBlockComplete(
+    bool fin,
+    size_t /*frame_len*/,
+    QuicHeaderBlockBuilder* builder) {
+  headers_decompressed_ = true;
+  if (!builder->headers_valid()) {
+    QUIC_DLOG(ERROR) << "Headers for stream " << id() << " are malformed.";
+    OnInvalidHeaderBlock();
+    return;
+  }
+  // The header block is not buffered in |header_list_|, so headers are
+  // considered consumed as soon as they are delivered.
+  received_headers_ = builder->ReleaseHeaderBlock();
+  if (fin) {
+    OnStreamFrame(QuicStreamFrame(id(), fin, 0, QuicStringPiece()));
+  }
+  if (FinishedReadingHeaders()) {
+    sequencer()->SetUnblocked();
+  }
+}
+
+void QuicSpdyStream::OnInvalidHeaderBlock() {
+  Reset(QUIC_BAD_APPLICATION_PAYLOAD);
+}
+
 void QuicSpdyStream::OnPromiseHeaderList(
     QuicStreamId /* promised_id */,
     size_t /* frame_len */,
@@ -414,36 +510,65 @@ void QuicSpdyStream::OnTrailingHeadersComplete(
     bool fin,
     size_t /*frame_len*/,
     const QuicHeaderList& header_list) {
-  DCHECK(!trailers_decompressed_);
-  if (fin_received()) {
-    QUIC_DLOG(ERROR) << "Received Trailers after FIN, on stream: " << id();
-    session()->connection()->CloseConnection(
-        QUIC_INVALID_HEADERS_STREAM_DATA, "Trailers after fin",
-        ConnectionCloseBehavior::SEND_CONNECTION_CLOSE_PACKET);
+  if (!CanReceiveTrailers(fin)) {
     return;
   }
-  if (!fin) {
-    QUIC_DLOG(ERROR) << "Trailers must have FIN set, on stream: " << id();
+
+  size_t final_byte_offset = 0;
+  if (!SpdyUtils::CopyAndValidateTrailers(header_list, &final_byte_offset,
+                                          &received_trailers_)) {
+    QUIC_DLOG(ERROR) << "Trailers for stream " << id() << " are malformed.";
     session()->connection()->CloseConnection(
-        QUIC_INVALID_HEADERS_STREAM_DATA, "Fin missing from trailers",
+        QUIC_INVALID_HEADERS_STREAM_DATA, "Trailers are malformed",
         ConnectionCloseBehavior::SEND_CONNECTION_CLOSE_PACKET);
     return;
   }
+  trailers_decompressed_ = true;
+  OnStreamFrame(
+      QuicStreamFrame(id(), fin, final_byte_offset, QuicStringPiece()));
+}
+
+void QuicSpdyStream::OnTrailingHeaderBlockComplete(
+    bool fin,
+    size_t /*frame_len*/,
+    QuicHeaderBlockBuilder* builder) {
+  if (!CanReceiveTrailers(fin)) {
+    return;
+  }
 
   size_t final_byte_offset = 0;
-  if (!SpdyUtils::CopyAndValidateTrailers(header_list, &final_byte_offset,
-                                          &received_trailers_)) {
+  if (!builder->ValidateAsTrailers(&final_byte_offset)) {
     QUIC_DLOG(ERROR) << "Trailers for stream " << id() << " are malformed.";
     session()->connection()->CloseConnection(
         QUIC_INVALID_HEADERS_STREAM_DATA, "Trailers are malformed",
         ConnectionCloseBehavior::SEND_CONNECTION_CLOSE_PACKET);
     return;
   }
+  received_trailers_ = builder->ReleaseHeaderBlock();
   trailers_decompressed_ = true;
   OnStreamFrame(
       QuicStreamFrame(id(), fin, final_byte_offset, QuicStringPiece()));
 }
 
+bool QuicSpdyStream::CanReceiveTrailers(bool fin) {
+  DCHECK(!trailers_decompressed_);
+  if (fin_received()) {
+    QUIC_DLOG(ERROR) << "Received Trailers after FIN, on stream: " << id();
+    session()->connection()->CloseConnection(
+        QUIC_INVALID_HEADERS_STREAM_DATA, "Trailers after fin",
+        ConnectionCloseBehavior::SEND_CONNECTION_CLOSE_PACKET);
+    return false;
+  }
+  if (!fin) {
+    QUIC_DLOG(ERROR) << "Trailers must have FIN set, on stream: " << id();
+    session()->connection()->CloseConnection(
+        QUIC_INVALID_HEADERS_STREAM_DATA, "Fin missing from trailers",
+        ConnectionCloseBehavior::SEND_CONNECTION_CLOSE_PACKET);
+    return false;
+  }
+  return true;
+}
+
 size_t QuicSpdyStream::WriteHeadersImpl(
     spdy::SpdyHeaderBlock header_block,
     bool fin,
@@ -486,7 +611,20 @@ void QuicSpdyStream::OnDataAvailable() {
     }
   }
 
-  if (has_payload) {
+  // Headers are delivered outside of HttpDecoder::ProcessInput(), because
+  // consuming them calls back into OnDataAvailable() to deliver the body.
+  if (headers_frame_decoded_) {
+    DeliverDecodedHeaders();
+    return;
+  }
+
+  // Over HTTP/3, body is not delivered until the HEADERS frame carrying the
+  // initial headers has been decoded and consumed.
+  if (!FinishedReadingHeaders()) {
+    return;
+  }
+
+  if (has_payload || body_buffer_.HasBytesToRead()) {
     OnBodyAvailable();
     return;
   }
@@ -572,6 +710,89 @@ void QuicSpdyStream::OnDataFrameEnd() {
            << body_buffer_.total_body_bytes_received();
 }
 
+void QuicSpdyStream::OnHeadersFrameStart(Http3FrameLengths frame_lengths) {
+  DCHECK(VersionUsesQpack(spdy_session_->connection()->transport_version()));
+
+  if (headers_decompressed_ || qpack_decoded_headers_accumulator_) {
+    // Trailers sent in HEADERS frames are not supported yet.
+    session()->connection()->CloseConnection(
+        QUIC_INVALID_HEADERS_STREAM_DATA,
+        "Trailing HEADERS frames are not supported",
+        ConnectionCloseBehavior::SEND_CONNECTION_CLOSE_PACKET);
+    return;
+  }
+
+  headers_frame_length_ = frame_lengths.header_length +
+                          frame_lengths.payload_length;
+  if (spdy_session_->deliver_header_blocks()) {
+    header_block_builder_ = QuicMakeUnique<QuicHeaderBlockBuilder>();
+    header_block_builder_->set_max_header_list_size(
+        spdy_session_->max_inbound_header_list_size());
+    qpack_decoded_headers_accumulator_ =
+        QuicMakeUnique<QpackDecodedHeadersAccumulator>(
+            id(), spdy_session_->qpack_decoder(), header_block_builder_.get());
+  } else {
+    qpack_decoded_headers_accumulator_ =
+        QuicMakeUnique<QpackDecodedHeadersAccumulator>(
+            id(), spdy_session_->qpack_decoder());
+  }
+}
+
+void QuicSpdyStream::OnHeadersFramePayload(QuicStringPiece payload) {
+  if (!qpack_decoded_headers_accumulator_ || headers_frame_decoded_) {
+    return;
+  }
+  if (!qpack_decoded_headers_accumulator_->Decode(payload)) {
+    OnHeadersDecodingError();
+  }
+}
+
+void QuicSpdyStream::OnHeadersFrameEnd(QuicByteCount /*frame_len*/) {
+  if (!qpack_decoded_headers_accumulator_ || headers_frame_decoded_) {
+    return;
+  }
+  if (!qpack_decoded_headers_accumulator_->EndHeaderBlock()) {
+    OnHeadersDecodingError();
+    return;
+  }
+
+  // The HEADERS frame has been decoded, so the sequencer can release it.  The
+  // headers are delivered by OnDataAvailable() once HttpDecoder returns.
+  body_buffer_.OnNonBody(headers_frame_length_);
+  headers_frame_decoded_ = true;
+}
+
+void QuicSpdyStream::DeliverDecodedHeaders() {
+  DCHECK(headers_frame_decoded_);
+  std::unique_ptr<QpackDecodedHeadersAccumulator> accumulator =
+      std::move(qpack_decoded_headers_accumulator_);
+  std::unique_ptr<QuicHeaderBlockBuilder> builder =
+      std::move(header_block_builder_);
+  const QuicByteCount frame_len = headers_frame_length_;
+  headers_frame_length_ = 0;
+  headers_frame_decoded_ = false;
+
+  // The stream's FIN, if any, is delivered by the sequencer, so headers are
+  // never reported with |fin| set here.
+  if (builder != nullptr) {
+    OnStreamHeaderBlock(/*fin=*/false, frame_len, builder.get());
+  } else {
+    OnStreamHeaderList(/*fin=*/false, frame_len,
+                       accumulator->quic_header_list());
+  }
+}
+
+void QuicSpdyStream::OnHeadersDecodingError() {
+  const QuicString error_message = QuicStrCat(
+      "Error decompressing header block on stream ", id(), ": ",
+      qpack_decoded_headers_accumulator_->error_message());
+  qpack_decoded_headers_accumulator_.reset();
+  header_block_builder_.reset();
+  session()->connection()->CloseConnection(
+      QUIC_DECOMPRESSION_FAILURE, error_message,
+      ConnectionCloseBehavior::SEND_CONNECTION_CLOSE_PACKET);
+}
+
 bool QuicSpdyStream::OnStreamFrameAcked(QuicStreamOffset offset,
                                         QuicByteCount data_length,
                                         bool fin_acked,
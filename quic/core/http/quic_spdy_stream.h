@@ -13,12 +13,15 @@
 
 #include <cstddef>
 #include <list>
+#include <memory>
 
 #include "base/macros.h"
 #include "net/third_party/quiche/src/quic/core/http/http_decoder.h"
 #include "net/third_party/quiche/src/quic/core/http/http_encoder.h"
+#include "net/third_party/quiche/src/quic/core/http/quic_header_block_builder.h"
 #include "net/third_party/quiche/src/quic/core/http/quic_header_list.h"
 #include "net/third_party/quiche/src/quic/core/http/quic_spdy_stream_body_buffer.h"
+#include "net/third_party/quiche/src/quic/core/qpack/qpack_decoded_headers_accumulator.h"
 #include "net/third_party/quiche/src/quic/core/quic_packets.h"
 #include "net/third_party/quiche/src/quic/core/quic_stream.h"
 #include "net/third_party/quiche/src/quic/core/quic_stream_sequencer.h"
@@ -85,6 +88,15 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStream : public QuicStream {
                                   size_t frame_len,
                                   const QuicHeaderList& header_list);
 
+  // Called by the session when headers have been completely decoded and
+  // validated into |builder|, if the session delivers header blocks rather
+  // than QuicHeaderLists.  The header block may be moved out of |builder|.
+  // If |fin| is true, then this stream should be closed; no more data will be
+  // sent by the peer.
+  virtual void OnStreamHeaderBlock(bool fin,
+                                   size_t frame_len,
+                                   QuicHeaderBlockBuilder* builder);
+
   // Called when the received headers are too large. By default this will
   // reset the stream.
   virtual void OnHeadersTooLarge();
@@ -120,6 +132,11 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStream : public QuicStream {
   // Sends |data| to the peer, or buffers if it can't be sent immediately.
   void WriteOrBufferBody(QuicStringPiece data, bool fin);
 
+  // Same as above, but the send buffer holds a reference to |body| instead of
+  // a copy of it.
+  void WriteOrBufferBody(QuicReferenceCountedPointer<QuicSharedBuffer> body,
+                         bool fin);
+
   // Writes the trailers contained in |trailer_block| to the dedicated
   // headers stream. Trailers will always have the FIN set.
   virtual size_t WriteTrailers(
@@ -183,6 +200,12 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStream : public QuicStream {
 
   bool trailers_decompressed() const { return trailers_decompressed_; }
 
+  // Returns the initial headers received through OnStreamHeaderBlock(), unless
+  // a subclass has taken them out with mutable_received_headers().
+  const spdy::SpdyHeaderBlock& received_headers() const {
+    return received_headers_;
+  }
+
   // Returns whatever trailers have been received for this stream.
   const spdy::SpdyHeaderBlock& received_trailers() const {
     return received_trailers_;
@@ -207,6 +230,13 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStream : public QuicStream {
   void OnDataFramePayload(QuicStringPiece payload);
   void OnDataFrameEnd();
 
+  // Called by HttpDecoder when HEADERS frames are received over HTTP/3.  The
+  // payload is decoded by a QpackDecodedHeadersAccumulator, into a
+  // QuicHeaderBlockBuilder if the session delivers header blocks.
+  void OnHeadersFrameStart(Http3FrameLengths frame_lengths);
+  void OnHeadersFramePayload(QuicStringPiece payload);
+  void OnHeadersFrameEnd(QuicByteCount frame_len);
+
   using QuicStream::CloseWriteSide;
 
  protected:
@@ -216,14 +246,31 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStream : public QuicStream {
   virtual void OnTrailingHeadersComplete(bool fin,
                                          size_t frame_len,
                                          const QuicHeaderList& header_list);
+  // Counterparts of the above methods for headers delivered through
+  // OnStreamHeaderBlock().  By default, valid initial headers are stored in
+  // received_headers(), and OnInvalidHeaderBlock() is called otherwise.
+  virtual void OnInitialHeaderBlockComplete(bool fin,
+                                            size_t frame_len,
+                                            QuicHeaderBlockBuilder* builder);
+  virtual void OnTrailingHeaderBlockComplete(bool fin,
+                                             size_t frame_len,
+                                             QuicHeaderBlockBuilder* builder);
   virtual size_t WriteHeadersImpl(
       spdy::SpdyHeaderBlock header_block,
       bool fin,
       QuicReferenceCountedPointer<QuicAckListenerInterface> ack_listener);
 
+  // Called when initial headers delivered through OnStreamHeaderBlock() fail
+  // validation.  Resets the stream by default.
+  virtual void OnInvalidHeaderBlock();
+
   QuicSpdySession* spdy_session() const { return spdy_session_; }
   Visitor* visitor() { return visitor_; }
 
+  spdy::SpdyHeaderBlock* mutable_received_headers() {
+    return &received_headers_;
+  }
+
   void set_headers_decompressed(bool val) { headers_decompressed_ = val; }
 
   void set_ack_listener(
@@ -241,6 +288,23 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStream : public QuicStream {
   friend class QuicStreamUtils;
   class HttpDecoderVisitor;
 
+  // Common validation of received trailers.  Returns false and closes the
+  // connection if trailers are not acceptable at this point.
+  bool CanReceiveTrailers(bool fin);
+
+  // Passes the headers of the HEADERS frame decoded by
+  // |qpack_decoded_headers_accumulator_| to OnStreamHeaderBlock() or
+  // OnStreamHeaderList().
+  void DeliverDecodedHeaders();
+
+  // Closes the connection after |qpack_decoded_headers_accumulator_| failed to
+  // decode a HEADERS frame.
+  void OnHeadersDecodingError();
+
+  // Writes or buffers the header of a DATA frame with |body_length| bytes of
+  // payload.
+  void WriteOrBufferDataFrameHeader(QuicByteCount body_length);
+
   // Given the interval marked by [|offset|, |offset| + |data_length|), return
   // the number of frame header bytes contained in it.
   QuicByteCount GetNumFrameHeadersInInterval(QuicStreamOffset offset,
@@ -261,6 +325,19 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStream : public QuicStream {
   bool trailers_consumed_;
   // The parsed trailers received from the peer.
   spdy::SpdyHeaderBlock received_trailers_;
+  // The initial headers received through OnStreamHeaderBlock().
+  spdy::SpdyHeaderBlock received_headers_;
+
+  // Decodes the HEADERS frame being received over HTTP/3, if any.
+  std::unique_ptr<QpackDecodedHeadersAccumulator>
+      qpack_decoded_headers_accumulator_;
+  // Receives the decoded headers if the session delivers header blocks.
+  std::unique_ptr<QuicHeaderBlockBuilder> header_block_builder_;
+  // Length of the HEADERS frame being received, including its frame header.
+  QuicByteCount headers_frame_length_;
+  // True if the HEADERS frame has been decoded but its headers have not been
+  // delivered yet.
+  bool headers_frame_decoded_;
 
   // Http encoder for writing streams.
   HttpEncoder encoder_;
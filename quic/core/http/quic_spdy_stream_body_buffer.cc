@@ -22,6 +22,11 @@ void QuicSpdyStreamBodyBuffer::OnDataHeader(Http3FrameLengths frame_lengths) {
   total_payload_lengths_ += frame_lengths.payload_length;
 }
 
+void QuicSpdyStreamBodyBuffer::OnNonBody(QuicByteCount length) {
+  frame_meta_.push_back(Http3FrameLengths(length, 0));
+  ConsumeEmptyFrames();
+}
+
 void QuicSpdyStreamBodyBuffer::OnDataPayload(QuicStringPiece payload) {
   bodies_.push_back(payload);
   total_body_bytes_received_ += payload.length();
@@ -70,6 +75,15 @@ void QuicSpdyStreamBodyBuffer::MarkBodyConsumed(size_t num_bytes) {
   // Update accountings.
   bytes_remaining_ -= num_bytes;
   total_body_bytes_readable_ -= num_bytes;
+  ConsumeEmptyFrames();
+}
+
+void QuicSpdyStreamBodyBuffer::ConsumeEmptyFrames() {
+  while (bytes_remaining_ == 0 && !frame_meta_.empty() &&
+         frame_meta_.front().payload_length == 0) {
+    sequencer_->MarkConsumed(frame_meta_.front().header_length);
+    frame_meta_.pop_front();
+  }
 }
 
 int QuicSpdyStreamBodyBuffer::PeekBody(iovec* iov, size_t iov_len) const {
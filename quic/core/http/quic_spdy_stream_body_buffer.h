@@ -25,6 +25,11 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStreamBodyBuffer {
   // Called when QuicSpdyStream receives data frame header.
   void OnDataHeader(Http3FrameLengths frame_lengths);
 
+  // Called when QuicSpdyStream has processed a frame of |length| bytes, such as
+  // a HEADERS frame, which carries no body.  The frame is consumed in the
+  // stream sequencer once all body before it has been consumed.
+  void OnNonBody(QuicByteCount length);
+
   // Add new data payload to buffer.
   // Called when QuicSpdyStream received data payload.
   // Data pointed by payload must be alive until consumed by
@@ -54,6 +59,10 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStreamBodyBuffer {
   }
 
  private:
+  // Consumes the frames at the front of |frame_meta_| which have no payload
+  // left to consume.
+  void ConsumeEmptyFrames();
+
   // Storage for decoded data.
   QuicDeque<QuicStringPiece> bodies_;
   // Storage for header lengths.
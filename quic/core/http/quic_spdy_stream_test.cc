@@ -35,7 +35,9 @@ using spdy::SpdyHeaderBlock;
 using spdy::SpdyPriority;
 using testing::_;
 using testing::AtLeast;
+using testing::ElementsAre;
 using testing::Invoke;
+using testing::Pair;
 using testing::Return;
 using testing::StrictMock;
 
@@ -969,6 +971,152 @@ TEST_P(QuicSpdyStreamTest, ReceivingTrailersWithoutOffset) {
                               trailers.uncompressed_header_bytes(), trailers);
 }
 
+TEST_P(QuicSpdyStreamTest, ReceivingHeadersAndTrailersViaHeaderBlock) {
+  // Test that receiving headers and trailers from the peer via
+  // OnStreamHeaderBlock() works without buffering a QuicHeaderList.
+  Initialize(kShouldProcessData);
+
+  // Receive initial headers.
+  QuicHeaderBlockBuilder headers;
+  size_t total_bytes = 0;
+  for (const auto& p : headers_) {
+    headers.OnHeader(p.first, p.second);
+    total_bytes += p.first.size() + p.second.size();
+  }
+  headers.OnHeaderBlockEnd(total_bytes, total_bytes);
+  stream_->OnStreamHeadersPriority(kV3HighestPriority);
+  stream_->OnStreamHeaderBlock(/*fin=*/false, total_bytes, &headers);
+  EXPECT_TRUE(stream_->headers_decompressed());
+  EXPECT_TRUE(stream_->FinishedReadingHeaders());
+  EXPECT_EQ(headers_, stream_->received_headers());
+
+  // Receive trailing headers.
+  SpdyHeaderBlock trailers_block;
+  trailers_block["key1"] = "value1";
+  trailers_block["key2"] = "value2";
+  QuicHeaderBlockBuilder trailers;
+  total_bytes = 0;
+  for (const auto& p : trailers_block) {
+    trailers.OnHeader(p.first, p.second);
+    total_bytes += p.first.size() + p.second.size();
+  }
+  trailers.OnHeader(kFinalOffsetHeaderKey, "0");
+  trailers.OnHeaderBlockEnd(total_bytes, total_bytes);
+  stream_->OnStreamHeaderBlock(/*fin=*/true, total_bytes, &trailers);
+
+  // The final offset trailer is consumed by QUIC.
+  EXPECT_TRUE(stream_->trailers_decompressed());
+  EXPECT_EQ(trailers_block, stream_->received_trailers());
+  EXPECT_FALSE(stream_->IsDoneReading());
+  stream_->MarkTrailersConsumed();
+  EXPECT_TRUE(stream_->IsDoneReading());
+}
+
+TEST_P(QuicSpdyStreamTest, ReceivingTrailersViaHeaderBlockWithoutOffset) {
+  // Test that receiving trailers without a final offset field via
+  // OnStreamHeaderBlock() is an error.
+  Initialize(kShouldProcessData);
+
+  QuicHeaderBlockBuilder headers;
+  for (const auto& p : headers_) {
+    headers.OnHeader(p.first, p.second);
+  }
+  headers.OnHeaderBlockEnd(0, 0);
+  stream_->OnStreamHeaderBlock(/*fin=*/false, 0, &headers);
+
+  QuicHeaderBlockBuilder trailers;
+  trailers.OnHeader("key1", "value1");
+  trailers.OnHeaderBlockEnd(0, 0);
+
+  EXPECT_CALL(*connection_,
+              CloseConnection(QUIC_INVALID_HEADERS_STREAM_DATA, _, _))
+      .Times(1);
+  stream_->OnStreamHeaderBlock(/*fin=*/true, 0, &trailers);
+}
+
+TEST_P(QuicSpdyStreamTest, ReceivingInvalidHeaderBlockResetsStream) {
+  Initialize(kShouldProcessData);
+
+  QuicHeaderBlockBuilder headers;
+  // Upper case header names are not allowed.
+  headers.OnHeader("Foo", "bar");
+  headers.OnHeaderBlockEnd(0, 0);
+  ASSERT_FALSE(headers.headers_valid());
+
+  EXPECT_CALL(*session_,
+              SendRstStream(stream_->id(), QUIC_BAD_APPLICATION_PAYLOAD, _));
+  stream_->OnStreamHeaderBlock(/*fin=*/false, 0, &headers);
+  EXPECT_TRUE(stream_->received_headers().empty());
+}
+
+TEST_P(QuicSpdyStreamTest, ProcessHeadersFrameAndBody) {
+  Initialize(kShouldProcessData);
+  if (!VersionUsesQpack(GetParam().transport_version)) {
+    return;
+  }
+
+  // A HEADERS frame carrying the QPACK encoded header "foo: bar".
+  QuicString headers_frame =
+      QuicTextUtils::HexDecode("0a01000023666f6f03626172");
+  QuicString body = "this is the body";
+  std::unique_ptr<char[]> buffer;
+  QuicByteCount header_length =
+      encoder_.SerializeDataFrameHeader(body.length(), &buffer);
+  QuicString data =
+      headers_frame + QuicString(buffer.get(), header_length) + body;
+
+  stream_->OnStreamFrame(
+      QuicStreamFrame(stream_->id(), /*fin=*/false, 0, data));
+  EXPECT_TRUE(stream_->headers_decompressed());
+  EXPECT_THAT(stream_->header_list(), ElementsAre(Pair("foo", "bar")));
+  // Body is not delivered until the headers are consumed.
+  EXPECT_EQ("", stream_->data());
+
+  stream_->ConsumeHeaderList();
+  EXPECT_EQ(body, stream_->data());
+}
+
+TEST_P(QuicSpdyStreamTest, ProcessHeadersFrameAsHeaderBlock) {
+  Initialize(kShouldProcessData);
+  if (!VersionUsesQpack(GetParam().transport_version)) {
+    return;
+  }
+  session_->set_deliver_header_blocks(true);
+
+  QuicString headers_frame =
+      QuicTextUtils::HexDecode("0a01000023666f6f03626172");
+  QuicString body = "this is the body";
+  std::unique_ptr<char[]> buffer;
+  QuicByteCount header_length =
+      encoder_.SerializeDataFrameHeader(body.length(), &buffer);
+  QuicString data =
+      headers_frame + QuicString(buffer.get(), header_length) + body;
+
+  // Headers delivered as a block are consumed right away.
+  stream_->OnStreamFrame(
+      QuicStreamFrame(stream_->id(), /*fin=*/false, 0, data));
+  SpdyHeaderBlock expected_headers;
+  expected_headers["foo"] = "bar";
+  EXPECT_EQ(expected_headers, stream_->received_headers());
+  EXPECT_TRUE(stream_->FinishedReadingHeaders());
+  EXPECT_EQ(body, stream_->data());
+}
+
+TEST_P(QuicSpdyStreamTest, MalformedHeadersFrameClosesConnection) {
+  Initialize(kShouldProcessData);
+  if (!VersionUsesQpack(GetParam().transport_version)) {
+    return;
+  }
+
+  // A HEADERS frame whose payload ends within the header block prefix.
+  QuicString headers_frame = QuicTextUtils::HexDecode("010100");
+  EXPECT_CALL(*connection_,
+              CloseConnection(QUIC_DECOMPRESSION_FAILURE, _, _));
+  stream_->OnStreamFrame(
+      QuicStreamFrame(stream_->id(), /*fin=*/false, 0, headers_frame));
+  EXPECT_FALSE(stream_->headers_decompressed());
+}
+
 TEST_P(QuicSpdyStreamTest, ReceivingTrailersWithoutFin) {
   // Test that received Trailers must always have the FIN set.
   Initialize(kShouldProcessData);
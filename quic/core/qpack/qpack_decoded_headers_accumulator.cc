@@ -11,11 +11,18 @@ namespace quic {
 QpackDecodedHeadersAccumulator::QpackDecodedHeadersAccumulator(
     QuicStreamId id,
     QpackDecoder* qpack_decoder)
+    : QpackDecodedHeadersAccumulator(id, qpack_decoder, nullptr) {}
+
+QpackDecodedHeadersAccumulator::QpackDecodedHeadersAccumulator(
+    QuicStreamId id,
+    QpackDecoder* qpack_decoder,
+    spdy::SpdyHeadersHandlerInterface* handler)
     : decoder_(qpack_decoder->DecodeHeaderBlock(id, this)),
+      handler_(handler != nullptr ? handler : &quic_header_list_),
       uncompressed_header_bytes_(0),
       compressed_header_bytes_(0),
       error_detected_(false) {
-  quic_header_list_.OnHeaderBlockStart();
+  handler_->OnHeaderBlockStart();
 }
 
 void QpackDecodedHeadersAccumulator::OnHeaderDecoded(QuicStringPiece name,
@@ -23,7 +30,7 @@ void QpackDecodedHeadersAccumulator::OnHeaderDecoded(QuicStringPiece name,
   DCHECK(!error_detected_);
 
   uncompressed_header_bytes_ += name.size() + value.size();
-  quic_header_list_.OnHeader(name, value);
+  handler_->OnHeader(name, value);
 }
 
 void QpackDecodedHeadersAccumulator::OnDecodingCompleted() {}
@@ -51,14 +58,15 @@ bool QpackDecodedHeadersAccumulator::EndHeaderBlock() {
 
   decoder_->EndHeaderBlock();
 
-  quic_header_list_.OnHeaderBlockEnd(uncompressed_header_bytes_,
-                                     compressed_header_bytes_);
+  handler_->OnHeaderBlockEnd(uncompressed_header_bytes_,
+                             compressed_header_bytes_);
 
   return !error_detected_;
 }
 
 const QuicHeaderList& QpackDecodedHeadersAccumulator::quic_header_list() const {
   DCHECK(!error_detected_);
+  DCHECK_EQ(&quic_header_list_, handler_);
   return quic_header_list_;
 }
 
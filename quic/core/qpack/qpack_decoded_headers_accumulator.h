@@ -13,6 +13,7 @@
 #include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
+#include "net/third_party/quiche/src/spdy/core/spdy_headers_handler_interface.h"
 
 namespace quic {
 
@@ -21,10 +22,19 @@ class QpackDecoder;
 // A class that creates and owns a QpackProgressiveDecoder instance, accumulates
 // decoded headers in a QuicHeaderList, and keeps track of uncompressed and
 // compressed size so that it can be passed to QuicHeaderList::EndHeaderBlock().
+// Alternatively, decoded headers can be passed directly to a caller-provided
+// spdy::SpdyHeadersHandlerInterface as they are decoded, without being
+// buffered in a QuicHeaderList.
 class QUIC_EXPORT_PRIVATE QpackDecodedHeadersAccumulator
     : public QpackProgressiveDecoder::HeadersHandlerInterface {
  public:
+  // Accumulates decoded headers in a QuicHeaderList.
   QpackDecodedHeadersAccumulator(QuicStreamId id, QpackDecoder* qpack_decoder);
+  // Passes decoded headers to |handler|, which must outlive |this|.
+  // quic_header_list() must not be called in this mode.
+  QpackDecodedHeadersAccumulator(QuicStreamId id,
+                                 QpackDecoder* qpack_decoder,
+                                 spdy::SpdyHeadersHandlerInterface* handler);
   virtual ~QpackDecodedHeadersAccumulator() = default;
 
   // QpackProgressiveDecoder::HeadersHandlerInterface implementation.
@@ -44,6 +54,7 @@ class QUIC_EXPORT_PRIVATE QpackDecodedHeadersAccumulator
   bool EndHeaderBlock();
 
   // Returns accumulated header list.
+  // Must not be called if a handler was passed in at construction time.
   const QuicHeaderList& quic_header_list() const;
 
   // Returns error message.
@@ -53,6 +64,9 @@ class QUIC_EXPORT_PRIVATE QpackDecodedHeadersAccumulator
  private:
   std::unique_ptr<QpackProgressiveDecoder> decoder_;
   QuicHeaderList quic_header_list_;
+  // Receives decoded headers.  Points to |quic_header_list_| unless a handler
+  // was passed in at construction time.
+  spdy::SpdyHeadersHandlerInterface* handler_;
   size_t uncompressed_header_bytes_;
   size_t compressed_header_bytes_;
   bool error_detected_;
@@ -10,6 +10,7 @@
 #include "net/third_party/quiche/src/quic/core/qpack/qpack_decoder_test_utils.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_text_utils.h"
+#include "net/third_party/quiche/src/spdy/core/spdy_test_utils.h"
 
 using ::testing::Eq;
 using ::testing::StrictMock;
@@ -96,5 +97,25 @@ TEST_F(QpackDecodedHeadersAccumulatorTest, Success) {
   EXPECT_EQ(encoded_data.size(), header_list.compressed_header_bytes());
 }
 
+TEST_F(QpackDecodedHeadersAccumulatorTest, SuccessWithHandler) {
+  EXPECT_CALL(decoder_stream_sender_delegate_,
+              WriteDecoderStreamData(Eq(kHeaderAcknowledgement)));
+
+  spdy::test::TestHeadersHandler handler;
+  QpackDecodedHeadersAccumulator accumulator(kTestStreamId, &qpack_decoder_,
+                                             &handler);
+
+  QuicString encoded_data(QuicTextUtils::HexDecode("000023666f6f03626172"));
+  EXPECT_TRUE(accumulator.Decode(encoded_data));
+  EXPECT_TRUE(accumulator.EndHeaderBlock());
+
+  spdy::SpdyHeaderBlock expected;
+  expected["foo"] = "bar";
+  EXPECT_EQ(expected, handler.decoded_block());
+
+  EXPECT_EQ(strlen("foo") + strlen("bar"), handler.header_bytes_parsed());
+  EXPECT_EQ(encoded_data.size(), handler.compressed_header_bytes_parsed());
+}
+
 }  // namespace test
 }  // namespace quic
@@ -22,6 +22,7 @@ const size_t kStringLiteralLengthLimit = 1024 * 1024;
 QpackInstructionDecoder::QpackInstructionDecoder(const QpackLanguage* language,
                                                  Delegate* delegate)
     : language_(language),
+      use_opcode_table_(true),
       delegate_(delegate),
       s_bit_(false),
       varint_(0),
@@ -29,7 +30,20 @@ QpackInstructionDecoder::QpackInstructionDecoder(const QpackLanguage* language,
       is_huffman_encoded_(false),
       string_length_(0),
       error_detected_(false),
-      state_(State::kStartInstruction) {}
+      state_(State::kStartInstruction) {
+  for (const auto* instruction : *language_) {
+    if ((instruction->opcode.mask & 0x0f) != 0) {
+      use_opcode_table_ = false;
+      break;
+    }
+  }
+
+  if (use_opcode_table_) {
+    for (uint8_t i = 0; i < 16; ++i) {
+      opcode_table_[i] = LookupOpcodeSlow(i << 4);
+    }
+  }
+}
 
 void QpackInstructionDecoder::Decode(QuicStringPiece data) {
   DCHECK(!data.empty());
@@ -289,6 +303,15 @@ void QpackInstructionDecoder::DoReadStringDone() {
 
 const QpackInstruction* QpackInstructionDecoder::LookupOpcode(
     uint8_t byte) const {
+  if (use_opcode_table_) {
+    DCHECK_EQ(LookupOpcodeSlow(byte), opcode_table_[byte >> 4]);
+    return opcode_table_[byte >> 4];
+  }
+  return LookupOpcodeSlow(byte);
+}
+
+const QpackInstruction* QpackInstructionDecoder::LookupOpcodeSlow(
+    uint8_t byte) const {
   for (const auto* instruction : *language_) {
     if ((byte & instruction->opcode.mask) == instruction->opcode.value) {
       return instruction;
@@ -101,12 +101,23 @@ class QUIC_EXPORT_PRIVATE QpackInstructionDecoder {
   // Returns a pointer to an element of |*language_|.
   const QpackInstruction* LookupOpcode(uint8_t byte) const;
 
+  // Slow path of LookupOpcode() that tests every opcode in |*language_|.
+  const QpackInstruction* LookupOpcodeSlow(uint8_t byte) const;
+
   // Stops decoding and calls Delegate::OnError().
   void OnError(QuicStringPiece error_message);
 
   // Describes the language used for decoding.
   const QpackLanguage* const language_;
 
+  // Instruction for each possible value of the four high-order bits of the
+  // first byte, precomputed from |*language_|.  Only used if
+  // |use_opcode_table_| is true, that is, if every opcode mask in the language
+  // is confined to the high-order nibble, which is the case for all QPACK
+  // languages.
+  const QpackInstruction* opcode_table_[16];
+  bool use_opcode_table_;
+
   // The Delegate to notify of decoded instructions and errors.
   Delegate* const delegate_;
 
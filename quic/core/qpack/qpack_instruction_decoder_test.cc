@@ -51,6 +51,29 @@ const QpackLanguage* TestLanguage() {
   return language;
 }
 
+// These two instructions are distinguished by a bit outside of the high-order
+// nibble of the first byte, so that opcode lookup cannot use a table indexed
+// by the high-order nibble.
+const QpackInstruction* TestInstruction3() {
+  static const QpackInstruction* const instruction =
+      new QpackInstruction{QpackInstructionOpcode{0x00, 0x08},
+                           {{QpackInstructionFieldType::kVarint, 3}}};
+  return instruction;
+}
+
+const QpackInstruction* TestInstruction4() {
+  static const QpackInstruction* const instruction =
+      new QpackInstruction{QpackInstructionOpcode{0x08, 0x08},
+                           {{QpackInstructionFieldType::kVarint, 3}}};
+  return instruction;
+}
+
+const QpackLanguage* LowBitOpcodeTestLanguage() {
+  static const QpackLanguage* const language =
+      new QpackLanguage{TestInstruction3(), TestInstruction4()};
+  return language;
+}
+
 class MockDelegate : public QpackInstructionDecoder::Delegate {
  public:
   MockDelegate() {
@@ -166,6 +189,19 @@ TEST_P(QpackInstructionDecoderTest, DelegateSignalsError) {
   EXPECT_EQ(2u, decoder_.varint());
 }
 
+TEST(QpackInstructionDecoderLowBitOpcodeTest, LookupOpcode) {
+  StrictMock<MockDelegate> delegate;
+  QpackInstructionDecoder decoder(LowBitOpcodeTestLanguage(), &delegate);
+
+  EXPECT_CALL(delegate, OnInstructionDecoded(TestInstruction3()));
+  decoder.Decode(QuicTextUtils::HexDecode("f5"));
+  EXPECT_EQ(5u, decoder.varint());
+
+  EXPECT_CALL(delegate, OnInstructionDecoded(TestInstruction4()));
+  decoder.Decode(QuicTextUtils::HexDecode("0f0a"));
+  EXPECT_EQ(17u, decoder.varint());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace quic
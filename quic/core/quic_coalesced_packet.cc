@@ -0,0 +1,57 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/quic_coalesced_packet.h"
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_bug_tracker.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+QuicCoalescedPacket::QuicCoalescedPacket()
+    : max_packet_length_(0),
+      last_encryption_level_(ENCRYPTION_NONE),
+      num_packets_(0) {}
+
+QuicCoalescedPacket::~QuicCoalescedPacket() {}
+
+bool QuicCoalescedPacket::MaybeCoalescePacket(
+    const SerializedPacket& packet,
+    QuicPacketLength max_packet_length) {
+  if (packet.encrypted_buffer == nullptr || packet.encrypted_length == 0) {
+    QUIC_BUG << "Trying to coalesce an empty packet";
+    return false;
+  }
+  if (IsEmpty()) {
+    max_packet_length_ = max_packet_length;
+  } else if (IsComplete() ||
+             packet.encryption_level <= last_encryption_level_) {
+    return false;
+  }
+  if (length() + packet.encrypted_length > max_packet_length_) {
+    return false;
+  }
+
+  QUIC_DVLOG(1) << "Coalescing packet " << packet.packet_number
+                << " of length " << packet.encrypted_length
+                << " after " << num_packets_ << " packets of length "
+                << length();
+  buffer_.append(packet.encrypted_buffer, packet.encrypted_length);
+  last_encryption_level_ = packet.encryption_level;
+  ++num_packets_;
+  return true;
+}
+
+void QuicCoalescedPacket::Clear() {
+  buffer_.clear();
+  max_packet_length_ = 0;
+  last_encryption_level_ = ENCRYPTION_NONE;
+  num_packets_ = 0;
+}
+
+bool QuicCoalescedPacket::IsComplete() const {
+  return !IsEmpty() && last_encryption_level_ == ENCRYPTION_FORWARD_SECURE;
+}
+
+}  // namespace quic
@@ -0,0 +1,64 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_COALESCED_PACKET_H_
+#define QUICHE_QUIC_CORE_QUIC_COALESCED_PACKET_H_
+
+#include "net/third_party/quiche/src/quic/core/quic_packets.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
+
+namespace quic {
+
+// QuicCoalescedPacket buffers encrypted packets of increasing encryption
+// levels, so that they are written in a single UDP datagram.  Every packet but
+// the last must have a long header carrying its length, which is what lets the
+// peer split the datagram.
+class QUIC_EXPORT_PRIVATE QuicCoalescedPacket {
+ public:
+  QuicCoalescedPacket();
+  QuicCoalescedPacket(const QuicCoalescedPacket&) = delete;
+  QuicCoalescedPacket& operator=(const QuicCoalescedPacket&) = delete;
+  ~QuicCoalescedPacket();
+
+  // Copies the encrypted |packet| into the datagram and returns true if the
+  // datagram does not end with a short header packet, |packet| has a higher
+  // encryption level than the packets already coalesced, and the datagram
+  // stays within |max_packet_length|.  |max_packet_length| is latched by the
+  // first packet.
+  bool MaybeCoalescePacket(const SerializedPacket& packet,
+                           QuicPacketLength max_packet_length);
+
+  // Discards the coalesced packets.
+  void Clear();
+
+  // Returns true if no more packets can be coalesced, because the datagram
+  // ends with a short header packet.
+  bool IsComplete() const;
+
+  bool IsEmpty() const { return buffer_.empty(); }
+
+  const char* data() const { return buffer_.data(); }
+
+  QuicPacketLength length() const {
+    return static_cast<QuicPacketLength>(buffer_.length());
+  }
+
+  QuicPacketLength max_packet_length() const { return max_packet_length_; }
+
+  size_t num_packets() const { return num_packets_; }
+
+ private:
+  // The encrypted packets, back to back.
+  QuicString buffer_;
+  // The datagram size which buffer_ must not exceed.
+  QuicPacketLength max_packet_length_;
+  // Encryption level of the last packet in buffer_.
+  EncryptionLevel last_encryption_level_;
+  size_t num_packets_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_COALESCED_PACKET_H_
@@ -0,0 +1,72 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/quic_coalesced_packet.h"
+
+#include <cstring>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+SerializedPacket CreatePacket(const char* buffer,
+                              QuicPacketLength length,
+                              EncryptionLevel level) {
+  SerializedPacket packet(QuicPacketNumber(1), PACKET_4BYTE_PACKET_NUMBER,
+                          buffer, length, false, false);
+  packet.encryption_level = level;
+  return packet;
+}
+
+TEST(QuicCoalescedPacketTest, CoalescePacketsOfIncreasingLevels) {
+  char buffer[1000];
+  memset(buffer, 'a', sizeof(buffer));
+  QuicCoalescedPacket coalesced;
+  EXPECT_TRUE(coalesced.IsEmpty());
+
+  EXPECT_TRUE(coalesced.MaybeCoalescePacket(
+      CreatePacket(buffer, 500, ENCRYPTION_NONE), 1200));
+  EXPECT_EQ(500u, coalesced.length());
+  EXPECT_EQ(1200u, coalesced.max_packet_length());
+  EXPECT_FALSE(coalesced.IsComplete());
+
+  // A second packet at the same level is not coalesced.
+  EXPECT_FALSE(coalesced.MaybeCoalescePacket(
+      CreatePacket(buffer, 100, ENCRYPTION_NONE), 1200));
+
+  EXPECT_TRUE(coalesced.MaybeCoalescePacket(
+      CreatePacket(buffer, 300, ENCRYPTION_ZERO_RTT), 1200));
+  EXPECT_EQ(800u, coalesced.length());
+
+  // The packet does not fit in the datagram.
+  EXPECT_FALSE(coalesced.MaybeCoalescePacket(
+      CreatePacket(buffer, 401, ENCRYPTION_FORWARD_SECURE), 1200));
+
+  EXPECT_TRUE(coalesced.MaybeCoalescePacket(
+      CreatePacket(buffer, 400, ENCRYPTION_FORWARD_SECURE), 1200));
+  EXPECT_EQ(1200u, coalesced.length());
+  EXPECT_EQ(3u, coalesced.num_packets());
+  EXPECT_TRUE(coalesced.IsComplete());
+
+  coalesced.Clear();
+  EXPECT_TRUE(coalesced.IsEmpty());
+  EXPECT_EQ(0u, coalesced.num_packets());
+}
+
+TEST(QuicCoalescedPacketTest, NothingFollowsShortHeaderPacket) {
+  char buffer[100];
+  memset(buffer, 'a', sizeof(buffer));
+  QuicCoalescedPacket coalesced;
+  EXPECT_TRUE(coalesced.MaybeCoalescePacket(
+      CreatePacket(buffer, 100, ENCRYPTION_FORWARD_SECURE), 1200));
+  EXPECT_TRUE(coalesced.IsComplete());
+  EXPECT_FALSE(coalesced.MaybeCoalescePacket(
+      CreatePacket(buffer, 100, ENCRYPTION_FORWARD_SECURE), 1200));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -396,6 +396,10 @@ QuicConfig::QuicConfig()
     : max_time_before_crypto_handshake_(QuicTime::Delta::Zero()),
       max_idle_time_before_crypto_handshake_(QuicTime::Delta::Zero()),
       max_undecryptable_packets_(0),
+      ecn_marking_enabled_(false),
+      max_mtu_probe_packet_size_(0),
+      receive_window_budget_(0),
+      packet_coalescing_enabled_(false),
       connection_options_(kCOPT, PRESENCE_OPTIONAL),
       client_connection_options_(kCLOP, PRESENCE_OPTIONAL),
       idle_network_timeout_seconds_(kICSL, PRESENCE_REQUIRED),
@@ -345,6 +345,44 @@ class QUIC_EXPORT_PRIVATE QuicConfig {
     return max_undecryptable_packets_;
   }
 
+  // Whether this endpoint's socket marks outgoing packets ECT(0).  When set,
+  // the connection validates the ECN counts reported by the peer and treats
+  // CE marks as congestion.
+  void set_ecn_marking_enabled(bool ecn_marking_enabled) {
+    ecn_marking_enabled_ = ecn_marking_enabled;
+  }
+
+  bool ecn_marking_enabled() const { return ecn_marking_enabled_; }
+
+  // The largest packet size which the connection searches for with path MTU
+  // probes.  Zero disables the search.  The socket must set the don't fragment
+  // bit, and the writer must accept packets of this size.
+  void set_max_mtu_probe_packet_size(QuicByteCount max_mtu_probe_packet_size) {
+    max_mtu_probe_packet_size_ = max_mtu_probe_packet_size;
+  }
+
+  QuicByteCount max_mtu_probe_packet_size() const {
+    return max_mtu_probe_packet_size_;
+  }
+
+  // The most data the session buffers across all of its streams.  If nonzero,
+  // receive windows are sized from the bandwidth-delay product of the data the
+  // application consumes, up to this budget, instead of doubling.
+  void set_receive_window_budget(QuicByteCount receive_window_budget) {
+    receive_window_budget_ = receive_window_budget;
+  }
+
+  QuicByteCount receive_window_budget() const { return receive_window_budget_; }
+
+  // Whether long header packets are coalesced with packets of higher
+  // encryption levels into one datagram.  Only applies to versions whose long
+  // headers carry the packet length.
+  void set_packet_coalescing_enabled(bool packet_coalescing_enabled) {
+    packet_coalescing_enabled_ = packet_coalescing_enabled;
+  }
+
+  bool packet_coalescing_enabled() const { return packet_coalescing_enabled_; }
+
   bool HasSetBytesForConnectionIdToSend() const;
 
   // Sets the peer's connection id length, in bytes.
@@ -446,6 +484,14 @@ class QUIC_EXPORT_PRIVATE QuicConfig {
   QuicTime::Delta max_idle_time_before_crypto_handshake_;
   // Maximum number of undecryptable packets stored before CHLO/SHLO.
   size_t max_undecryptable_packets_;
+  // Whether outgoing packets are marked ECT(0).
+  bool ecn_marking_enabled_;
+  // Largest packet size probed by search-based path MTU discovery.
+  QuicByteCount max_mtu_probe_packet_size_;
+  // Upper limit on the session receive window, or zero.
+  QuicByteCount receive_window_budget_;
+  // Whether packets of different encryption levels share datagrams.
+  bool packet_coalescing_enabled_;
 
   // Connection options which affect the server side.  May also affect the
   // client side in cases when identical behavior is desirable.
@@ -32,6 +32,7 @@
 #include "net/third_party/quiche/src/quic/platform/api/quic_flags.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_map_util.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_str_cat.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string_utils.h"
@@ -238,6 +239,7 @@ QuicConnection::QuicConnection(
       last_size_(0),
       current_packet_data_(nullptr),
       last_decrypted_packet_level_(ENCRYPTION_NONE),
+      last_ecn_codepoint_(ECN_NOT_ECT),
       should_last_packet_instigate_acks_(false),
       was_last_packet_missing_(false),
       max_undecryptable_packets_(0),
@@ -245,6 +247,8 @@ QuicConnection::QuicConnection(
       pending_version_negotiation_packet_(false),
       send_ietf_version_negotiation_packet_(false),
       save_crypto_packets_as_termination_packets_(false),
+      coalesce_packets_(false),
+      multipath_negotiated_(false),
       idle_timeout_connection_close_behavior_(
           ConnectionCloseBehavior::SEND_CONNECTION_CLOSE_PACKET),
       close_connection_after_five_rtos_(false),
@@ -261,6 +265,8 @@ QuicConnection::QuicConnection(
       fast_ack_after_quiescence_(false),
       pending_retransmission_alarm_(false),
       defer_send_in_response_to_packets_(false),
+      processing_packet_batch_(false),
+      send_in_response_to_packet_batch_(false),
       ping_timeout_(QuicTime::Delta::FromSeconds(kPingTimeoutSecs)),
       retransmittable_on_wire_timeout_(QuicTime::Delta::Infinite()),
       arena_(),
@@ -313,6 +319,9 @@ QuicConnection::QuicConnection(
       mtu_probe_count_(0),
       packets_between_mtu_probes_(kPacketsBetweenMtuProbesBase),
       next_mtu_probe_at_(kPacketsBetweenMtuProbesBase),
+      mtu_search_max_packet_size_(0),
+      mtu_search_upper_bound_(0),
+      mtu_search_base_packet_size_(0),
       largest_received_packet_size_(0),
       write_error_occurred_(false),
       no_stop_waiting_frames_(transport_version() > QUIC_VERSION_43),
@@ -376,6 +385,9 @@ QuicConnection::~QuicConnection() {
   if (owns_writer_) {
     delete writer_;
   }
+  if (alternative_path_ != nullptr && alternative_path_->owns_writer) {
+    delete alternative_path_->writer;
+  }
   ClearQueuedPackets();
 }
 
@@ -410,6 +422,10 @@ void QuicConnection::SetFromConfig(const QuicConfig& config) {
         config.ReceivedBytesForConnectionId());
   }
   max_undecryptable_packets_ = config.max_undecryptable_packets();
+  // Only IETF QUIC acks carry ECN counts.
+  if (config.ecn_marking_enabled() && transport_version() == QUIC_VERSION_99) {
+    sent_packet_manager_.EnableEcn();
+  }
 
   if (config.HasClientSentConnectionOption(kMTUH, perspective_)) {
     SetMtuDiscoveryTarget(kMtuDiscoveryTargetPacketSizeHigh);
@@ -417,6 +433,25 @@ void QuicConnection::SetFromConfig(const QuicConfig& config) {
   if (config.HasClientSentConnectionOption(kMTUL, perspective_)) {
     SetMtuDiscoveryTarget(kMtuDiscoveryTargetPacketSizeLow);
   }
+  if (config.HasClientSentConnectionOption(kMPTH, perspective_)) {
+    multipath_negotiated_ = true;
+  }
+  // FEC frames are only understood by versions which support message frames.
+  if (config.HasClientSentConnectionOption(kFECT, perspective_) &&
+      transport_version() > QUIC_VERSION_44 && fec_encoder_ == nullptr) {
+    fec_encoder_ = QuicMakeUnique<QuicFecEncoder>();
+    fec_decoder_ = QuicMakeUnique<QuicFecDecoder>();
+  }
+  if (config.max_mtu_probe_packet_size() > 0 &&
+      mtu_search_max_packet_size_ == 0) {
+    EnableMtuSearch(config.max_mtu_probe_packet_size());
+  }
+  // Only long headers which carry the packet length can be followed by another
+  // packet in the same datagram.
+  if (config.packet_coalescing_enabled() &&
+      QuicVersionHasLongHeaderLengths(transport_version())) {
+    coalesce_packets_ = true;
+  }
   if (debug_visitor_ != nullptr) {
     debug_visitor_->OnSetFromConfig(config);
   }
@@ -838,8 +873,10 @@ bool QuicConnection::OnPacketHeader(const QuicPacketHeader& header) {
   current_effective_peer_migration_type_ = NO_CHANGE;
 
   if (perspective_ == Perspective::IS_CLIENT) {
-    if (!received_packet_manager_.GetLargestObserved().IsInitialized() ||
-        header.packet_number > received_packet_manager_.GetLargestObserved()) {
+    if (!IsCurrentPacketOnAlternativePath() &&
+        (!received_packet_manager_.GetLargestObserved().IsInitialized() ||
+         header.packet_number >
+             received_packet_manager_.GetLargestObserved())) {
       // Update peer_address_ and effective_peer_address_ immediately for
       // client connections.
       direct_peer_address_ = last_packet_source_address_;
@@ -879,8 +916,8 @@ bool QuicConnection::OnPacketHeader(const QuicPacketHeader& header) {
 
   // Record packet receipt to populate ack info before processing stream
   // frames, since the processing may result in sending a bundled ack.
-  received_packet_manager_.RecordPacketReceived(last_header_,
-                                                time_of_last_received_packet_);
+  received_packet_manager_.RecordPacketReceived(
+      last_header_, time_of_last_received_packet_, last_ecn_codepoint_);
   DCHECK(connected_);
   return true;
 }
@@ -914,6 +951,10 @@ bool QuicConnection::OnStreamFrame(const QuicStreamFrame& frame) {
                     ConnectionCloseBehavior::SEND_CONNECTION_CLOSE_PACKET);
     return false;
   }
+  if (fec_decoder_ != nullptr &&
+      frame.stream_id != QuicUtils::GetCryptoStreamId(transport_version())) {
+    fec_decoder_->OnStreamFrameReceived(frame);
+  }
   visitor_->OnStreamFrame(frame);
   stats_.stream_bytes_received += frame.data_length;
   should_last_packet_instigate_acks_ = true;
@@ -989,6 +1030,21 @@ bool QuicConnection::OnAckFrameStart(QuicPacketNumber largest_acked,
   return true;
 }
 
+bool QuicConnection::OnAckEcnCounts(const QuicEcnCounts& ecn_counts) {
+  DCHECK(connected_);
+  QUIC_DVLOG(1) << ENDPOINT << "OnAckEcnCounts, ect0: " << ecn_counts.ect0
+                << ", ect1: " << ecn_counts.ect1 << ", ce: " << ecn_counts.ce;
+
+  if (largest_seen_packet_with_ack_.IsInitialized() &&
+      last_header_.packet_number <= largest_seen_packet_with_ack_) {
+    QUIC_DLOG(INFO) << ENDPOINT << "Received an old ack frame: ignoring";
+    return true;
+  }
+
+  sent_packet_manager_.OnAckEcnCounts(ecn_counts);
+  return true;
+}
+
 bool QuicConnection::OnAckRange(QuicPacketNumber start, QuicPacketNumber end) {
   DCHECK(connected_);
   QUIC_DVLOG(1) << ENDPOINT << "OnAckRange: [" << start << ", " << end << ")";
@@ -1343,6 +1399,28 @@ bool QuicConnection::OnMessageFrame(const QuicMessageFrame& frame) {
   return connected_;
 }
 
+bool QuicConnection::OnFecFrame(const QuicFecFrame& frame) {
+  DCHECK(connected_);
+
+  // Since a FEC frame was received, this is not a connectivity probe.
+  // A probe only contains a PING and full padding.
+  UpdatePacketContent(NOT_PADDED_PING);
+
+  if (debug_visitor_ != nullptr) {
+    debug_visitor_->OnFecFrame(frame);
+  }
+  QuicStreamFrame recovered_frame;
+  if (fec_decoder_ != nullptr &&
+      fec_decoder_->RecoverStreamFrame(frame, &recovered_frame)) {
+    QUIC_DVLOG(1) << ENDPOINT << "Recovered lost " << recovered_frame;
+    ++stats_.stream_frames_recovered_by_fec;
+    // The stream ignores the data if the lost frame arrives later.
+    visitor_->OnStreamFrame(recovered_frame);
+  }
+  should_last_packet_instigate_acks_ = true;
+  return connected_;
+}
+
 bool QuicConnection::OnBlockedFrame(const QuicBlockedFrame& frame) {
   DCHECK(connected_);
 
@@ -1386,6 +1464,7 @@ void QuicConnection::OnPacketComplete() {
                   << " from ip:port: " << last_packet_source_address_.ToString()
                   << " to ip:port: "
                   << last_packet_destination_address_.ToString();
+    MaybeValidateAlternativePath();
     // TODO(zhongyi): change the method name.
     visitor_->OnConnectivityProbeReceived(last_packet_destination_address_,
                                           last_packet_source_address_);
@@ -1397,6 +1476,10 @@ void QuicConnection::OnPacketComplete() {
                   << " from ip:port: " << last_packet_source_address_.ToString()
                   << " to ip:port: "
                   << last_packet_destination_address_.ToString();
+    if (multipath_negotiated_) {
+      // A multipath peer probes the alternative path before sending on it.
+      alternative_peer_address_ = last_packet_source_address_;
+    }
     visitor_->OnConnectivityProbeReceived(last_packet_destination_address_,
                                           last_packet_source_address_);
   } else {
@@ -1415,8 +1498,9 @@ void QuicConnection::OnPacketComplete() {
                                  /* is_response= */ true);
     }
 
-    if (last_header_.packet_number ==
-        received_packet_manager_.GetLargestObserved()) {
+    if (!IsCurrentPacketOnAlternativePath() &&
+        last_header_.packet_number ==
+            received_packet_manager_.GetLargestObserved()) {
       direct_peer_address_ = last_packet_source_address_;
       if (current_effective_peer_migration_type_ != NO_CHANGE) {
         StartEffectivePeerMigration(current_effective_peer_migration_type_);
@@ -1771,6 +1855,7 @@ void QuicConnection::ProcessUdpPacket(const QuicSocketAddress& self_address,
   }
   last_size_ = packet.length();
   current_packet_data_ = packet.data();
+  last_ecn_codepoint_ = packet.ecn_codepoint();
 
   last_packet_destination_address_ = self_address;
   last_packet_source_address_ = peer_address;
@@ -1850,12 +1935,36 @@ void QuicConnection::ProcessUdpPacket(const QuicSocketAddress& self_address,
 
   MaybeProcessCoalescedPackets();
   MaybeProcessUndecryptablePackets();
-  MaybeSendInResponseToPacket();
+  if (processing_packet_batch_) {
+    send_in_response_to_packet_batch_ = true;
+  } else {
+    MaybeSendInResponseToPacket();
+  }
   SetPingAlarm();
   current_packet_data_ = nullptr;
   is_current_packet_connectivity_probing_ = false;
 }
 
+void QuicConnection::OnPacketBatchStart() {
+  DCHECK(!processing_packet_batch_);
+  QUIC_BUG_IF(current_packet_data_ != nullptr)
+      << "OnPacketBatchStart must not be called while processing a packet.";
+  processing_packet_batch_ = true;
+}
+
+void QuicConnection::OnPacketBatchEnd() {
+  if (!processing_packet_batch_) {
+    return;
+  }
+  processing_packet_batch_ = false;
+  if (!send_in_response_to_packet_batch_) {
+    return;
+  }
+  send_in_response_to_packet_batch_ = false;
+  ScopedPacketFlusher flusher(this, NO_ACK);
+  MaybeSendInResponseToPacket();
+}
+
 void QuicConnection::OnBlockedWriterCanWrite() {
   if (GetQuicRestartFlag(quic_check_blocked_writer_for_blockage)) {
     QUIC_RESTART_FLAG_COUNT_N(quic_check_blocked_writer_for_blockage, 3, 6);
@@ -2041,6 +2150,8 @@ void QuicConnection::WriteQueuedPackets() {
     SendVersionNegotiationPacket(send_ietf_version_negotiation_packet_);
   }
 
+  FlushCoalescedPacket();
+
   while (!queued_packets_.empty()) {
     // WritePacket() can potentially clear all queued packets, so we need to
     // save the first queued packet to a local variable before calling it.
@@ -2091,8 +2202,15 @@ void QuicConnection::WritePendingRetransmissions() {
       packet_generator_.FlushAllQueuedFrames();
     }
     DCHECK(!packet_generator_.HasQueuedFrames());
-    char buffer[kMaxPacketSize];
-    packet_generator_.ReserializeAllFrames(pending, buffer, kMaxPacketSize);
+    if (max_packet_length() > kMaxPacketSize) {
+      // Packets larger than kMaxPacketSize do not fit on the stack.
+      std::unique_ptr<char[]> buffer(new char[max_packet_length()]);
+      packet_generator_.ReserializeAllFrames(pending, buffer.get(),
+                                             max_packet_length());
+    } else {
+      char buffer[kMaxPacketSize];
+      packet_generator_.ReserializeAllFrames(pending, buffer, kMaxPacketSize);
+    }
   }
 }
 
@@ -2226,7 +2344,7 @@ bool QuicConnection::WritePacket(SerializedPacket* packet) {
     }
   }
 
-  DCHECK_LE(encrypted_length, kMaxPacketSize);
+  DCHECK_LE(encrypted_length, kMaxJumboPacketSize);
   DCHECK_LE(encrypted_length, packet_generator_.GetCurrentMaxPacketLength());
   QUIC_DVLOG(1) << ENDPOINT << "Sending packet " << packet_number << " : "
                 << (IsRetransmittable(*packet) == HAS_RETRANSMITTABLE_DATA
@@ -2254,9 +2372,33 @@ bool QuicConnection::WritePacket(SerializedPacket* packet) {
     }
     per_packet_options_->release_time_delay = release_time_delay;
   }
-  WriteResult result = writer_->WritePacket(
-      packet->encrypted_buffer, encrypted_length, self_address().host(),
-      peer_address(), per_packet_options_);
+  packet->path_id = SelectPath(*packet);
+  QuicPacketWriter* writer = writer_;
+  QuicSocketAddress path_self_address = self_address();
+  QuicSocketAddress path_peer_address = peer_address();
+  if (packet->path_id == kAlternativePathId) {
+    writer = alternative_path_->writer;
+    path_self_address = alternative_path_->self_address;
+    path_peer_address = alternative_path_->peer_address;
+  }
+  bool coalesced = MaybeCoalescePacket(*packet);
+  if (!coalesced && !coalesced_packet_.IsEmpty()) {
+    // Write the datagram of coalesced packets first, to keep the packets in
+    // order.
+    FlushCoalescedPacket();
+    if (!coalesced_packet_.IsEmpty() || !connected_) {
+      return is_termination_packet;
+    }
+    coalesced = MaybeCoalescePacket(*packet);
+  }
+  // A coalesced packet is considered sent once it is in the datagram, which is
+  // written when it is full or when the packet flusher goes out of scope.
+  WriteResult result(WRITE_STATUS_OK, encrypted_length);
+  if (!coalesced) {
+    result = writer->WritePacket(packet->encrypted_buffer, encrypted_length,
+                                 path_self_address.host(), path_peer_address,
+                                 per_packet_options_);
+  }
 
   QUIC_HISTOGRAM_ENUM(
       "QuicConnection.WritePacketStatus", result.status,
@@ -2266,7 +2408,7 @@ bool QuicConnection::WritePacket(SerializedPacket* packet) {
   if (IsWriteBlockedStatus(result.status)) {
     // Ensure the writer is still write blocked, otherwise QUIC may continue
     // trying to write when it will not be able to.
-    DCHECK(writer_->IsWriteBlocked());
+    DCHECK(writer->IsWriteBlocked());
     visitor_->OnWriteBlocked();
     // If the socket buffers the data, then the packet should not
     // be queued and sent again, which would result in an unnecessary
@@ -2281,8 +2423,14 @@ bool QuicConnection::WritePacket(SerializedPacket* packet) {
   // MTU discovery is permanently unsuccessful.
   if (IsMsgTooBig(result) && packet->retransmittable_frames.empty() &&
       packet->encrypted_length > long_term_mtu_) {
-    mtu_discovery_target_ = 0;
     mtu_discovery_alarm_->Cancel();
+    if (mtu_search_max_packet_size_ > 0) {
+      // Larger packets cannot leave this host, so search below the probe.
+      mtu_search_upper_bound_ = packet->encrypted_length - 1;
+      UpdateMtuSearchTarget();
+    } else {
+      mtu_discovery_target_ = 0;
+    }
     // The write failed, but the writer is not blocked, so return true.
     return true;
   }
@@ -2291,12 +2439,29 @@ bool QuicConnection::WritePacket(SerializedPacket* packet) {
     OnWriteError(result.error_code);
     QUIC_LOG_FIRST_N(ERROR, 10)
         << ENDPOINT << "failed writing " << encrypted_length
-        << " bytes from host " << self_address().host().ToString()
-        << " to address " << peer_address().ToString() << " with error code "
+        << " bytes from host " << path_self_address.host().ToString()
+        << " to address " << path_peer_address.ToString()
+        << " with error code "
         << result.error_code;
     return false;
   }
 
+  if (packet->path_id == kAlternativePathId) {
+    ++stats_.packets_sent_on_alternative_path;
+  }
+
+  if (fec_encoder_ != nullptr &&
+      packet->encryption_level == ENCRYPTION_FORWARD_SECURE) {
+    for (const QuicFrame& frame : packet->retransmittable_frames) {
+      if (frame.type == STREAM_FRAME &&
+          frame.stream_frame.stream_id !=
+              QuicUtils::GetCryptoStreamId(transport_version())) {
+        fec_encoder_->OnStreamFrameSent(frame.stream_frame,
+                                        framer_.data_producer());
+      }
+    }
+  }
+
   if (debug_visitor_ != nullptr) {
     // Pass the write result to the visitor.
     debug_visitor_->OnPacketSent(*packet, packet->original_packet_number,
@@ -2359,9 +2524,65 @@ bool QuicConnection::WritePacket(SerializedPacket* packet) {
     ++stats_.packets_retransmitted;
   }
 
+  if (coalesced) {
+    if (coalesced_packet_.num_packets() > 1) {
+      ++stats_.packets_coalesced;
+    }
+    if (coalesced_packet_.IsComplete()) {
+      FlushCoalescedPacket();
+    } else {
+      // Limit the next packet to the space left in the datagram.
+      packet_generator_.SetSoftMaxPacketLength(
+          coalesced_packet_.max_packet_length() - coalesced_packet_.length());
+    }
+  }
+
   return true;
 }
 
+bool QuicConnection::MaybeCoalescePacket(const SerializedPacket& packet) {
+  if (!coalesce_packets_ || IsTerminationPacket(packet)) {
+    return false;
+  }
+  if (coalesced_packet_.IsEmpty() &&
+      packet.encryption_level == ENCRYPTION_FORWARD_SECURE) {
+    // Nothing can follow a short header packet.
+    return false;
+  }
+  return coalesced_packet_.MaybeCoalescePacket(packet, max_packet_length());
+}
+
+void QuicConnection::FlushCoalescedPacket() {
+  if (coalesced_packet_.IsEmpty()) {
+    return;
+  }
+  packet_generator_.RemoveSoftMaxPacketLength();
+  if (!connected_) {
+    coalesced_packet_.Clear();
+    return;
+  }
+  if (HandleWriteBlocked()) {
+    return;
+  }
+
+  QUIC_DVLOG(1) << ENDPOINT << "Sending " << coalesced_packet_.num_packets()
+                << " coalesced packets of length "
+                << coalesced_packet_.length();
+  WriteResult result = writer_->WritePacket(
+      coalesced_packet_.data(), coalesced_packet_.length(),
+      self_address().host(), peer_address(), per_packet_options_);
+  if (IsWriteBlockedStatus(result.status)) {
+    visitor_->OnWriteBlocked();
+    if (result.status != WRITE_STATUS_BLOCKED_DATA_BUFFERED) {
+      return;
+    }
+  }
+  coalesced_packet_.Clear();
+  if (IsWriteError(result.status)) {
+    OnWriteError(result.error_code);
+  }
+}
+
 void QuicConnection::FlushPackets() {
   if (GetQuicRestartFlag(quic_check_blocked_writer_for_blockage) &&
       !connected_) {
@@ -2515,6 +2736,9 @@ void QuicConnection::OnCongestionChange() {
 void QuicConnection::OnPathMtuIncreased(QuicPacketLength packet_size) {
   if (packet_size > max_packet_length()) {
     SetMaxPacketLength(packet_size);
+    if (mtu_search_max_packet_size_ > 0) {
+      UpdateMtuSearchTarget();
+    }
   }
 }
 
@@ -2593,7 +2817,21 @@ void QuicConnection::OnRetransmissionTimeout() {
     return;
   }
 
+  if (fec_enabled() &&
+      sent_packet_manager_.IsTimeoutWithoutRetransmittableData()) {
+    // Only FEC repair packets are in flight, so a TLP or RTO would have nothing
+    // to retransmit. Send a PING instead, whose ack acks or reveals the loss of
+    // the repair packets and frees their bytes in flight.
+    QUIC_DVLOG(1) << ENDPOINT << "Probing outstanding FEC packets with a PING";
+    visitor_->SendPing();
+    if (!HasQueuedData() && !retransmission_alarm_->IsSet()) {
+      SetRetransmissionAlarm();
+    }
+    return;
+  }
+
   sent_packet_manager_.OnRetransmissionTimeout();
+  MaybeRevertMtuOnBlackHole();
   WriteIfNotBlocked();
 
   // A write failure can result in the connection being closed, don't attempt to
@@ -2682,6 +2920,9 @@ void QuicConnection::MaybeProcessUndecryptablePackets() {
     return;
   }
 
+  // The ECN codepoints of undecryptable packets are not kept.
+  const QuicEcnCodepoint ecn_codepoint = last_ecn_codepoint_;
+  last_ecn_codepoint_ = ECN_NOT_ECT;
   while (connected_ && !undecryptable_packets_.empty()) {
     // Making sure there is no pending frames when processing next undecrypted
     // packet because the queued ack frame may change.
@@ -2700,6 +2941,7 @@ void QuicConnection::MaybeProcessUndecryptablePackets() {
     ++stats_.packets_processed;
     undecryptable_packets_.pop_front();
   }
+  last_ecn_codepoint_ = ecn_codepoint;
 
   // Once forward secure encryption is in use, there will be no
   // new keys installed and hence any undecryptable packets will
@@ -3010,6 +3252,13 @@ void QuicConnection::MaybeSetMtuAlarm(QuicPacketNumber sent_packet_number) {
   }
 
   if (mtu_probe_count_ >= kMtuDiscoveryAttempts) {
+    if (mtu_search_max_packet_size_ > 0 &&
+        sent_packet_number >= next_mtu_probe_at_) {
+      // None of the probes of |mtu_discovery_target_| has been acknowledged,
+      // so search below it.
+      mtu_search_upper_bound_ = mtu_discovery_target_ - 1;
+      UpdateMtuSearchTarget();
+    }
     return;
   }
 
@@ -3075,6 +3324,8 @@ QuicConnection::ScopedPacketFlusher::~ScopedPacketFlusher() {
 
   if (flush_and_set_pending_retransmission_alarm_on_delete_) {
     connection_->packet_generator_.Flush();
+    connection_->MaybeSendFecPackets();
+    connection_->FlushCoalescedPacket();
     connection_->FlushPackets();
     if (connection_->session_decides_what_to_write()) {
       // Reset transmission type.
@@ -3110,12 +3361,39 @@ QuicConnection::ScopedPacketFlusher::~ScopedPacketFlusher() {
             !connection_->packet_generator_.PacketFlusherAttached());
 }
 
+void QuicConnection::MaybeSendFecPackets() {
+  if (fec_encoder_ == nullptr || !fec_encoder_->HasProtectedFrames() ||
+      !connected_ || encryption_level_ != ENCRYPTION_FORWARD_SECURE ||
+      IsWriterBlocked() || visitor_->WillingAndAbleToWrite()) {
+    return;
+  }
+  // Leave the protected frames in the encoder until congestion control and
+  // pacing allow sending. CanWrite sets the send alarm if pacing delays the
+  // repair, and the flusher of OnCanWrite gets back here.
+  if (!CanWrite(HAS_RETRANSMITTABLE_DATA)) {
+    return;
+  }
+  // A FEC frame can use all the room a message frame without length has.
+  for (QuicFecFrame& fec_frame : fec_encoder_->GenerateRepairFrames(
+           transport_version(),
+           GetLargestMessagePayload() + kQuicFrameTypeSize)) {
+    if (!packet_generator_.GenerateFecPacket(&fec_frame)) {
+      // Repair is best effort: lost stream frames are still retransmitted, so
+      // the rest of the repair data is dropped rather than queued.
+      QUIC_DVLOG(1) << ENDPOINT << "Dropping FEC repair data: " << fec_frame;
+      break;
+    }
+    ++stats_.fec_packets_sent;
+  }
+}
+
 HasRetransmittableData QuicConnection::IsRetransmittable(
     const SerializedPacket& packet) {
   // Retransmitted packets retransmittable frames are owned by the unacked
-  // packet map, but are not present in the serialized packet.
+  // packet map, but are not present in the serialized packet. FEC packets are
+  // never retransmitted, but count as in flight like data.
   if (packet.transmission_type != NOT_RETRANSMISSION ||
-      !packet.retransmittable_frames.empty()) {
+      !packet.retransmittable_frames.empty() || packet.has_fec) {
     return HAS_RETRANSMITTABLE_DATA;
   } else {
     return NO_RETRANSMITTABLE_DATA;
@@ -3155,12 +3433,66 @@ QuicByteCount QuicConnection::GetLimitedMaxPacketSize(
   if (max_packet_size > writer_limit) {
     max_packet_size = writer_limit;
   }
-  if (max_packet_size > kMaxPacketSize) {
-    max_packet_size = kMaxPacketSize;
+  if (max_packet_size > kMaxJumboPacketSize) {
+    max_packet_size = kMaxJumboPacketSize;
   }
   return max_packet_size;
 }
 
+void QuicConnection::EnableMtuSearch(QuicByteCount max_packet_size) {
+  mtu_search_max_packet_size_ = GetLimitedMaxPacketSize(max_packet_size);
+  mtu_search_upper_bound_ = mtu_search_max_packet_size_;
+  UpdateMtuSearchTarget();
+}
+
+void QuicConnection::UpdateMtuSearchTarget() {
+  if (mtu_search_upper_bound_ <= long_term_mtu_ + kMtuSearchPrecision) {
+    QUIC_DVLOG(1) << ENDPOINT << "Path MTU search converged at "
+                  << long_term_mtu_;
+    mtu_discovery_target_ = 0;
+    return;
+  }
+
+  if (mtu_search_upper_bound_ == mtu_search_max_packet_size_) {
+    // No probe has been lost yet, so try the largest size first.
+    mtu_discovery_target_ = mtu_search_upper_bound_;
+  } else {
+    mtu_discovery_target_ =
+        long_term_mtu_ + (mtu_search_upper_bound_ - long_term_mtu_ + 1) / 2;
+  }
+  QUIC_DVLOG(1) << ENDPOINT << "Path MTU search target "
+                << mtu_discovery_target_;
+
+  mtu_probe_count_ = 0;
+  packets_between_mtu_probes_ = kPacketsBetweenMtuProbesBase;
+  if (sent_packet_manager_.GetLargestSentPacket().IsInitialized()) {
+    next_mtu_probe_at_ = sent_packet_manager_.GetLargestSentPacket() +
+                         packets_between_mtu_probes_ + 1;
+  }
+}
+
+void QuicConnection::MaybeRevertMtuOnBlackHole() {
+  if (mtu_search_max_packet_size_ == 0 || mtu_search_base_packet_size_ == 0 ||
+      long_term_mtu_ <= mtu_search_base_packet_size_ ||
+      sent_packet_manager_.GetConsecutiveRtoCount() < kMtuBlackHoleRtoCount) {
+    return;
+  }
+  // Without the session writing retransmissions, lost frames are reserialized
+  // whole and would not fit in smaller packets.
+  if (!session_decides_what_to_write()) {
+    return;
+  }
+
+  QUIC_DLOG(INFO) << ENDPOINT << "Packets of " << long_term_mtu_
+                  << " bytes are no longer delivered, reverting to "
+                  << mtu_search_base_packet_size_ << " bytes";
+  ++stats_.mtu_black_holes_detected;
+  mtu_search_upper_bound_ = long_term_mtu_ - 1;
+  SetMaxPacketLength(mtu_search_base_packet_size_);
+  sent_packet_manager_.OnPathMtuDecreased();
+  UpdateMtuSearchTarget();
+}
+
 void QuicConnection::SendMtuDiscoveryPacket(QuicByteCount target_mtu) {
   // Currently, this limit is ensured by the caller.
   DCHECK_EQ(target_mtu, GetLimitedMaxPacketSize(target_mtu));
@@ -3185,6 +3517,148 @@ void QuicConnection::SendConnectivityProbingResponsePacket(
                              /* is_response= */ true);
 }
 
+bool QuicConnection::ValidateAlternativePath(
+    QuicPacketWriter* writer,
+    const QuicSocketAddress& self_address,
+    const QuicSocketAddress& peer_address) {
+  DCHECK(writer != nullptr);
+  if (perspective_ == Perspective::IS_SERVER) {
+    QUIC_BUG << "Only clients validate alternative paths.";
+    return false;
+  }
+  if (multipath_enabled()) {
+    // The alternative path carries data and cannot be replaced.
+    return false;
+  }
+  if (alternative_path_ != nullptr && alternative_path_->owns_writer) {
+    delete alternative_path_->writer;
+  }
+  alternative_path_ = QuicMakeUnique<AlternativePath>();
+  alternative_path_->self_address = self_address;
+  alternative_path_->peer_address = peer_address;
+  alternative_path_->writer = writer;
+  alternative_path_->path_state.rtt_stats.set_initial_rtt(
+      sent_packet_manager_.GetRttStats()->initial_rtt());
+
+  QUIC_DLOG(INFO) << ENDPOINT << "Validating path from "
+                  << self_address.ToString() << " to "
+                  << peer_address.ToString();
+  const QuicTime probe_sent_time = clock_->Now();
+  if (!SendConnectivityProbingPacket(writer, peer_address)) {
+    return false;
+  }
+  alternative_path_->probe_sent_time = probe_sent_time;
+  return true;
+}
+
+bool QuicConnection::IsAlternativePathValidated() const {
+  return alternative_path_ != nullptr && alternative_path_->validated;
+}
+
+bool QuicConnection::SwitchToAlternativePath() {
+  if (!IsAlternativePathValidated() || multipath_enabled()) {
+    return false;
+  }
+  QUIC_DLOG(INFO) << ENDPOINT << "Switching from path "
+                  << self_address_.ToString() << " -> "
+                  << direct_peer_address_.ToString() << " to path "
+                  << alternative_path_->self_address.ToString() << " -> "
+                  << alternative_path_->peer_address.ToString();
+  std::swap(self_address_, alternative_path_->self_address);
+  std::swap(direct_peer_address_, alternative_path_->peer_address);
+  peer_address_ = direct_peer_address_;
+  effective_peer_address_ = direct_peer_address_;
+  std::swap(writer_, alternative_path_->writer);
+  std::swap(owns_writer_, alternative_path_->owns_writer);
+  alternative_path_->probe_sent_time = QuicTime::Zero();
+  sent_packet_manager_.SwitchPath(&alternative_path_->path_state);
+  return true;
+}
+
+const RttStats* QuicConnection::GetAlternativePathRttStats() const {
+  if (alternative_path_ == nullptr) {
+    return nullptr;
+  }
+  return &alternative_path_->path_state.rtt_stats;
+}
+
+bool QuicConnection::EnableMultipath(
+    std::unique_ptr<QuicPathScheduler> scheduler) {
+  if (perspective_ == Perspective::IS_SERVER) {
+    QUIC_BUG << "Server connections cannot enable multipath.";
+    return false;
+  }
+  if (!multipath_negotiated_ || !IsAlternativePathValidated() ||
+      multipath_enabled() || !sent_packet_manager_.handshake_confirmed()) {
+    return false;
+  }
+  QUIC_DLOG(INFO) << ENDPOINT << "Enabling multipath on "
+                  << alternative_path_->self_address.ToString() << " -> "
+                  << alternative_path_->peer_address.ToString();
+  sent_packet_manager_.EnableMultipath(&alternative_path_->path_state);
+  path_scheduler_ = std::move(scheduler);
+  return true;
+}
+
+QuicPathId QuicConnection::SelectPath(const SerializedPacket& packet) {
+  // Only forward secure data is spread over the paths; handshake, ack-only and
+  // probing packets stay on the active path.
+  if (!multipath_enabled() ||
+      packet.encryption_level != ENCRYPTION_FORWARD_SECURE ||
+      IsRetransmittable(packet) != HAS_RETRANSMITTABLE_DATA ||
+      packet.retransmittable_frames.empty()) {
+    return kDefaultPathId;
+  }
+  const QuicTime now = clock_->Now();
+  std::vector<QuicPathScheduler::PathInfo> paths = {
+      {kDefaultPathId, sent_packet_manager_.GetPathRttStats(kDefaultPathId),
+       !writer_->IsWriteBlocked() &&
+           sent_packet_manager_.TimeUntilSendOnPath(now, kDefaultPathId)
+               .IsZero()},
+      {kAlternativePathId,
+       sent_packet_manager_.GetPathRttStats(kAlternativePathId),
+       !alternative_path_->writer->IsWriteBlocked() &&
+           sent_packet_manager_.TimeUntilSendOnPath(now, kAlternativePathId)
+               .IsZero()}};
+  const QuicPathId path_id = path_scheduler_->SelectPath(paths);
+  if (path_id == kAlternativePathId &&
+      alternative_path_->writer->IsWriteBlocked()) {
+    return kDefaultPathId;
+  }
+  return path_id;
+}
+
+bool QuicConnection::IsCurrentPacketOnAlternativePath() const {
+  if (perspective_ == Perspective::IS_CLIENT) {
+    return multipath_enabled() &&
+           last_packet_destination_address_ ==
+               alternative_path_->self_address &&
+           last_packet_source_address_ == alternative_path_->peer_address;
+  }
+  return alternative_peer_address_.IsInitialized() &&
+         last_packet_source_address_ == alternative_peer_address_;
+}
+
+void QuicConnection::MaybeValidateAlternativePath() {
+  if (alternative_path_ == nullptr || !IsCurrentPacketConnectivityProbing() ||
+      last_packet_destination_address_ != alternative_path_->self_address ||
+      last_packet_source_address_ != alternative_path_->peer_address) {
+    return;
+  }
+  if (alternative_path_->probe_sent_time.IsInitialized()) {
+    alternative_path_->path_state.rtt_stats.UpdateRtt(
+        time_of_last_received_packet_ - alternative_path_->probe_sent_time,
+        QuicTime::Delta::Zero(), time_of_last_received_packet_);
+    alternative_path_->probe_sent_time = QuicTime::Zero();
+  }
+  if (!alternative_path_->validated) {
+    QUIC_DLOG(INFO) << ENDPOINT << "Validated path from "
+                    << alternative_path_->self_address.ToString() << " to "
+                    << alternative_path_->peer_address.ToString();
+  }
+  alternative_path_->validated = true;
+}
+
 bool QuicConnection::SendGenericPathProbePacket(
     QuicPacketWriter* probing_writer,
     const QuicSocketAddress& peer_address,
@@ -3317,6 +3791,9 @@ void QuicConnection::DiscoverMtu() {
   next_mtu_probe_at_ = sent_packet_manager_.GetLargestSentPacket() +
                        packets_between_mtu_probes_ + 1;
   ++mtu_probe_count_;
+  if (mtu_search_max_packet_size_ > 0 && mtu_search_base_packet_size_ == 0) {
+    mtu_search_base_packet_size_ = long_term_mtu_;
+  }
 
   QUIC_DVLOG(2) << "Sending a path MTU discovery packet #" << mtu_probe_count_;
   SendMtuDiscoveryPacket(mtu_discovery_target_);
@@ -3483,7 +3960,8 @@ void QuicConnection::UpdatePacketContent(PacketContent type) {
   }
 
   current_packet_content_ = NOT_PADDED_PING;
-  if (received_packet_manager_.GetLargestObserved().IsInitialized() &&
+  if (!IsCurrentPacketOnAlternativePath() &&
+      received_packet_manager_.GetLargestObserved().IsInitialized() &&
       last_header_.packet_number ==
           received_packet_manager_.GetLargestObserved()) {
     direct_peer_address_ = last_packet_source_address_;
@@ -30,13 +30,17 @@
 #include "net/third_party/quiche/src/quic/core/quic_alarm.h"
 #include "net/third_party/quiche/src/quic/core/quic_alarm_factory.h"
 #include "net/third_party/quiche/src/quic/core/quic_blocked_writer_interface.h"
+#include "net/third_party/quiche/src/quic/core/quic_coalesced_packet.h"
 #include "net/third_party/quiche/src/quic/core/quic_connection_stats.h"
+#include "net/third_party/quiche/src/quic/core/quic_fec_decoder.h"
+#include "net/third_party/quiche/src/quic/core/quic_fec_encoder.h"
 #include "net/third_party/quiche/src/quic/core/quic_framer.h"
 #include "net/third_party/quiche/src/quic/core/quic_one_block_arena.h"
 #include "net/third_party/quiche/src/quic/core/quic_packet_creator.h"
 #include "net/third_party/quiche/src/quic/core/quic_packet_generator.h"
 #include "net/third_party/quiche/src/quic/core/quic_packet_writer.h"
 #include "net/third_party/quiche/src/quic/core/quic_packets.h"
+#include "net/third_party/quiche/src/quic/core/quic_path_scheduler.h"
 #include "net/third_party/quiche/src/quic/core/quic_received_packet_manager.h"
 #include "net/third_party/quiche/src/quic/core/quic_sent_packet_manager.h"
 #include "net/third_party/quiche/src/quic/core/quic_time.h"
@@ -87,6 +91,16 @@ static_assert(kMtuDiscoveryTargetPacketSizeLow > kDefaultMaxPacketSize,
 static_assert(kMtuDiscoveryTargetPacketSizeHigh > kDefaultMaxPacketSize,
               "MTU discovery target does not exceed the default packet size");
 
+// Search-based path MTU discovery stops once the largest packet size known to
+// be delivered on the path is within this many bytes of the smallest size which
+// is known to be lost.
+const QuicByteCount kMtuSearchPrecision = 32;
+
+// The number of consecutive retransmission timeouts after which a connection
+// which has raised its packet size through search-based path MTU discovery
+// assumes that the path no longer delivers packets of that size.
+const size_t kMtuBlackHoleRtoCount = 2;
+
 // Class that receives callbacks from the connection when frames are received
 // and when other interesting events happen.
 class QUIC_EXPORT_PRIVATE QuicConnectionVisitorInterface {
@@ -266,6 +280,9 @@ class QUIC_EXPORT_PRIVATE QuicConnectionDebugVisitor
   // Called when a MessageFrame has been parsed.
   virtual void OnMessageFrame(const QuicMessageFrame& frame) {}
 
+  // Called when a FecFrame has been parsed.
+  virtual void OnFecFrame(const QuicFecFrame& frame) {}
+
   // Called when a public reset packet has been received.
   virtual void OnPublicResetPacket(const QuicPublicResetPacket& packet) {}
 
@@ -491,6 +508,7 @@ class QUIC_EXPORT_PRIVATE QuicConnection
   bool OnCryptoFrame(const QuicCryptoFrame& frame) override;
   bool OnAckFrameStart(QuicPacketNumber largest_acked,
                        QuicTime::Delta ack_delay_time) override;
+  bool OnAckEcnCounts(const QuicEcnCounts& ecn_counts) override;
   bool OnAckRange(QuicPacketNumber start, QuicPacketNumber end) override;
   bool OnAckTimestamp(QuicPacketNumber packet_number,
                       QuicTime timestamp) override;
@@ -514,6 +532,7 @@ class QUIC_EXPORT_PRIVATE QuicConnection
       const QuicRetireConnectionIdFrame& frame) override;
   bool OnNewTokenFrame(const QuicNewTokenFrame& frame) override;
   bool OnMessageFrame(const QuicMessageFrame& frame) override;
+  bool OnFecFrame(const QuicFecFrame& frame) override;
   void OnPacketComplete() override;
   bool IsValidStatelessResetToken(QuicUint128 token) const override;
   void OnAuthenticatedIetfStatelessResetPacket(
@@ -586,6 +605,12 @@ class QUIC_EXPORT_PRIVATE QuicConnection
 
   size_t mtu_probe_count() const { return mtu_probe_count_; }
 
+  // Searches for the largest packet size up to |max_packet_size| which the
+  // path delivers, rather than probing a single fixed target.  Probes are sent
+  // at |max_packet_size| first, then bisect between the largest size which has
+  // been acknowledged and the smallest whose probes were all lost.
+  void EnableMtuSearch(QuicByteCount max_packet_size);
+
   bool connected() const { return connected_; }
 
   // Must only be called on client connections.
@@ -738,6 +763,40 @@ class QUIC_EXPORT_PRIVATE QuicConnection
   virtual void SendConnectivityProbingResponsePacket(
       const QuicSocketAddress& peer_address);
 
+  // Starts validating the path from |self_address| to |peer_address| by sending
+  // a connectivity probe with |writer|, which is not owned and must outlive
+  // the path.  The active path is not affected.  Replaces the previous
+  // alternative path, if any.  Returns false if the probe was not sent.
+  bool ValidateAlternativePath(QuicPacketWriter* writer,
+                               const QuicSocketAddress& self_address,
+                               const QuicSocketAddress& peer_address);
+
+  // Returns true once a probe sent on the alternative path has been answered.
+  bool IsAlternativePathValidated() const;
+
+  // Makes the validated alternative path the active path.  The previously
+  // active path becomes the alternative path and keeps its RTT and congestion
+  // state for a later switch back.  Returns false if there is no validated
+  // alternative path.
+  bool SwitchToAlternativePath();
+
+  // Returns the RTT estimates of the alternative path, or nullptr if there is
+  // no alternative path.
+  const RttStats* GetAlternativePathRttStats() const;
+
+  // Sends retransmittable packets on both the active path and the validated
+  // alternative path, using |scheduler| to pick the path of each packet.  The
+  // peer keeps acking on the active path.  Requires the kMPTH connection
+  // option to have been negotiated, and cannot be undone.  Returns false if
+  // multipath cannot be enabled.  Only valid for clients.
+  bool EnableMultipath(std::unique_ptr<QuicPathScheduler> scheduler);
+
+  bool multipath_enabled() const { return path_scheduler_ != nullptr; }
+
+  // True if kFECT was negotiated, in which case the tail of each flight of
+  // stream data is followed by FEC repair packets.
+  bool fec_enabled() const { return fec_encoder_ != nullptr; }
+
   // Sends an MTU discovery packet of size |mtu_discovery_target_| and updates
   // the MTU discovery alarm.
   void DiscoverMtu();
@@ -839,6 +898,15 @@ class QUIC_EXPORT_PRIVATE QuicConnection
     defer_send_in_response_to_packets_ = defer;
   }
 
+  // Called before and after a batch of packets read from the socket together
+  // is passed to ProcessUdpPacket().  While a batch is being processed, ACKs
+  // and data sent in response to received packets are held back, and
+  // OnPacketBatchEnd() sends them once for the whole batch.
+  void OnPacketBatchStart();
+  void OnPacketBatchEnd();
+
+  bool processing_packet_batch() const { return processing_packet_batch_; }
+
   bool session_decides_what_to_write() const;
 
   void SetRetransmittableOnWireAlarm();
@@ -976,6 +1044,34 @@ class QUIC_EXPORT_PRIVATE QuicConnection
   // Flush packets buffered in the writer, if any.
   void FlushPackets();
 
+  // Copies |packet| into |coalesced_packet_| and returns true if packets are
+  // coalesced and |packet| fits in the datagram.  Only long header packets
+  // start a datagram.
+  bool MaybeCoalescePacket(const SerializedPacket& packet);
+
+  // Writes the datagram of coalesced packets, if any.  The datagram is kept if
+  // the writer is blocked.
+  void FlushCoalescedPacket();
+
+  // Sends FEC repair packets for the stream frames sent since the last repair
+  // if the session has nothing more to write, so that losing the tail of a
+  // flight does not have to wait for a retransmission. Repair packets are
+  // congestion controlled and paced like data.
+  void MaybeSendFecPackets();
+
+  // Validates the alternative path if the current packet answers a probe sent
+  // on it, and records the probe's round trip as an RTT sample of the path.
+  void MaybeValidateAlternativePath();
+
+  // Returns true if the current packet arrived on the alternative path of a
+  // multipath connection.  Such packets do not update the peer address, and
+  // all other packets are handled as usual, including NAT rebinding and
+  // migration.
+  bool IsCurrentPacketOnAlternativePath() const;
+
+  // Returns the path |packet| is sent on.
+  QuicPathId SelectPath(const SerializedPacket& packet);
+
   // Make sure an ack we got from our peer is sane.
   // Returns nullptr for valid acks or an error string if it was invalid.
   const char* ValidateAckFrame(const QuicAckFrame& incoming_ack);
@@ -1046,6 +1142,16 @@ class QUIC_EXPORT_PRIVATE QuicConnection
   // Set the size of the packet we are targeting while doing path MTU discovery.
   void SetMtuDiscoveryTarget(QuicByteCount target);
 
+  // Picks the next packet size to probe during search-based path MTU
+  // discovery, or ends the search if it has converged, and restarts the probe
+  // schedule.
+  void UpdateMtuSearchTarget();
+
+  // Restores the packet size from before search-based path MTU discovery
+  // raised it if repeated retransmission timeouts suggest that the path no
+  // longer delivers packets of the raised size.
+  void MaybeRevertMtuOnBlackHole();
+
   // Returns |suggested_max_packet_size| clamped to any limits set by the
   // underlying writer, connection, or protocol.
   QuicByteCount GetLimitedMaxPacketSize(
@@ -1153,6 +1259,8 @@ class QUIC_EXPORT_PRIVATE QuicConnection
                                      // parsed or nullptr.
   EncryptionLevel last_decrypted_packet_level_;
   QuicPacketHeader last_header_;
+  // ECN codepoint of the UDP packet currently being processed.
+  QuicEcnCodepoint last_ecn_codepoint_;
   bool should_last_packet_instigate_acks_;
   // Whether the most recent packet was missing before it was received.
   bool was_last_packet_missing_;
@@ -1200,6 +1308,42 @@ class QUIC_EXPORT_PRIVATE QuicConnection
   std::unique_ptr<std::vector<std::unique_ptr<QuicEncryptedPacket>>>
       termination_packets_;
 
+  // If true, packets of different encryption levels are coalesced into one
+  // datagram.
+  bool coalesce_packets_;
+
+  // Packets which have been sent to the sent packet manager, but whose
+  // datagram has not been written yet.
+  QuicCoalescedPacket coalesced_packet_;
+
+  // A network path other than the active one, which is validated with
+  // connectivity probes before the connection switches to it.
+  struct AlternativePath {
+    QuicSocketAddress self_address;
+    QuicSocketAddress peer_address;
+    // Owned or not depending on |owns_writer|.
+    QuicPacketWriter* writer = nullptr;
+    bool owns_writer = false;
+    bool validated = false;
+    // Send time of the outstanding probe, or zero if none is outstanding.
+    QuicTime probe_sent_time = QuicTime::Zero();
+    QuicSentPacketManager::PathState path_state;
+  };
+  std::unique_ptr<AlternativePath> alternative_path_;
+
+  // True if kMPTH was negotiated.  The peer of a multipath connection may send
+  // from more than one address, which does not mean it migrated.
+  bool multipath_negotiated_;
+  // Server only.  The address from which a multipath peer last sent a
+  // connectivity probe, which is the peer's end of its alternative path.
+  QuicSocketAddress alternative_peer_address_;
+  // Not null once multipath is enabled.
+  std::unique_ptr<QuicPathScheduler> path_scheduler_;
+
+  // Not null if kFECT was negotiated.
+  std::unique_ptr<QuicFecEncoder> fec_encoder_;
+  std::unique_ptr<QuicFecDecoder> fec_decoder_;
+
   // Determines whether or not a connection close packet is sent to the peer
   // after idle timeout due to lack of network activity.
   // This is particularly important on mobile, where waking up the radio is
@@ -1239,6 +1383,13 @@ class QUIC_EXPORT_PRIVATE QuicConnection
   // SendAlarm.
   bool defer_send_in_response_to_packets_;
 
+  // True between OnPacketBatchStart() and OnPacketBatchEnd().
+  bool processing_packet_batch_;
+
+  // Indicates a packet received in the current batch needs a response to be
+  // sent in OnPacketBatchEnd().
+  bool send_in_response_to_packet_batch_;
+
   // The timeout for PING.
   QuicTime::Delta ping_timeout_;
 
@@ -1356,6 +1507,19 @@ class QUIC_EXPORT_PRIVATE QuicConnection
   // different.
   QuicByteCount long_term_mtu_;
 
+  // The largest packet size searched for by search-based path MTU discovery,
+  // or zero if the search is disabled.
+  QuicByteCount mtu_search_max_packet_size_;
+
+  // The largest packet size which is not known to be lost on the path.
+  // Search-based path MTU discovery probes sizes between |long_term_mtu_| and
+  // this bound.
+  QuicByteCount mtu_search_upper_bound_;
+
+  // The value of |long_term_mtu_| when the first search probe was sent, which
+  // is restored when the path stops delivering larger packets.
+  QuicByteCount mtu_search_base_packet_size_;
+
   // The size of the largest packet received from peer.
   QuicByteCount largest_received_packet_size_;
 
@@ -37,6 +37,13 @@ QuicConnectionStats::QuicConnectionStats()
       max_sequence_reordering(0),
       max_time_reordering_us(0),
       tcp_loss_events(0),
+      ecn_ce_packets_received(0),
+      ecn_ce_events(0),
+      mtu_black_holes_detected(0),
+      packets_coalesced(0),
+      packets_sent_on_alternative_path(0),
+      fec_packets_sent(0),
+      stream_frames_recovered_by_fec(0),
       connection_creation_time(QuicTime::Zero()),
       blocked_frames_received(0),
       blocked_frames_sent(0),
@@ -79,6 +86,15 @@ std::ostream& operator<<(std::ostream& os, const QuicConnectionStats& s) {
   os << " max_sequence_reordering: " << s.max_sequence_reordering;
   os << " max_time_reordering_us: " << s.max_time_reordering_us;
   os << " tcp_loss_events: " << s.tcp_loss_events;
+  os << " ecn_ce_packets_received: " << s.ecn_ce_packets_received;
+  os << " ecn_ce_events: " << s.ecn_ce_events;
+  os << " mtu_black_holes_detected: " << s.mtu_black_holes_detected;
+  os << " packets_coalesced: " << s.packets_coalesced;
+  os << " packets_sent_on_alternative_path: "
+     << s.packets_sent_on_alternative_path;
+  os << " fec_packets_sent: " << s.fec_packets_sent;
+  os << " stream_frames_recovered_by_fec: "
+     << s.stream_frames_recovered_by_fec;
   os << " connection_creation_time: "
      << s.connection_creation_time.ToDebuggingValue();
   os << " blocked_frames_received: " << s.blocked_frames_received;
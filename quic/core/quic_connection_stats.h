@@ -82,6 +82,28 @@ struct QUIC_EXPORT_PRIVATE QuicConnectionStats {
   // one or more lost packets.
   uint32_t tcp_loss_events;
 
+  // Number of received packets whose IP header carried the ECN-CE codepoint.
+  QuicPacketCount ecn_ce_packets_received;
+  // Number of times the peer reported newly CE marked packets, each of which
+  // was treated as a congestion event by the send algorithm.
+  uint32_t ecn_ce_events;
+
+  // Number of times the connection reduced its packet size because packets of
+  // the size found by path MTU discovery stopped being delivered.
+  uint32_t mtu_black_holes_detected;
+
+  // Number of packets written in the same datagram as a packet of a lower
+  // encryption level.
+  QuicPacketCount packets_coalesced;
+
+  // Number of packets sent on the alternative path of a multipath connection.
+  QuicPacketCount packets_sent_on_alternative_path;
+
+  // Number of FEC repair packets sent.
+  QuicPacketCount fec_packets_sent;
+  // Number of lost stream frames rebuilt from received FEC frames.
+  size_t stream_frames_recovered_by_fec;
+
   // Creation time, as reported by the QuicClock.
   QuicTime connection_creation_time;
 
@@ -695,6 +695,31 @@ class TestConnection : public QuicConnection {
         .WillRepeatedly(Return(QuicBandwidth::Infinite()));
   }
 
+  // Enables search-based path MTU discovery up to |max_packet_size| through
+  // the config.
+  void EnableMtuSearchFromConfig(MockSendAlgorithm* send_algorithm,
+                                 QuicByteCount max_packet_size) {
+    QuicConfig config;
+    config.set_max_mtu_probe_packet_size(max_packet_size);
+    EXPECT_CALL(*send_algorithm, SetFromConfig(_, _));
+    SetFromConfig(config);
+
+    EXPECT_CALL(*send_algorithm, PacingRate(_))
+        .WillRepeatedly(Return(QuicBandwidth::Infinite()));
+  }
+
+  // Enables coalescing of packets of different encryption levels through the
+  // config.
+  void EnablePacketCoalescingFromConfig(MockSendAlgorithm* send_algorithm) {
+    QuicConfig config;
+    config.set_packet_coalescing_enabled(true);
+    EXPECT_CALL(*send_algorithm, SetFromConfig(_, _));
+    SetFromConfig(config);
+
+    EXPECT_CALL(*send_algorithm, PacingRate(_))
+        .WillRepeatedly(Return(QuicBandwidth::Infinite()));
+  }
+
   TestAlarmFactory::TestAlarm* GetAckAlarm() {
     return reinterpret_cast<TestAlarmFactory::TestAlarm*>(
         QuicConnectionPeer::GetAckAlarm(this));
@@ -4423,6 +4448,168 @@ TEST_P(QuicConnectionTest, MtuDiscoveryWriterFailed) {
   EXPECT_EQ(1u, connection_.mtu_probe_count());
 }
 
+// Tests that search-based MTU discovery first probes the largest size, and
+// stops once that probe is acknowledged.
+TEST_P(QuicConnectionTest, MtuSearchJumboProbeAcked) {
+  EXPECT_TRUE(connection_.connected());
+
+  writer_->set_max_packet_size(kMaxJumboPacketSize);
+  connection_.EnableMtuSearchFromConfig(send_algorithm_, kMaxJumboPacketSize);
+
+  const QuicPacketCount packets_between_probes_base = 5;
+  set_packets_between_probes_base(packets_between_probes_base);
+
+  // Send enough packets so that the next one triggers path MTU discovery.
+  for (QuicPacketCount i = 0; i < packets_between_probes_base - 1; i++) {
+    SendStreamDataToPeer(3, ".", i, NO_FIN, nullptr);
+    ASSERT_FALSE(connection_.GetMtuDiscoveryAlarm()->IsSet());
+  }
+
+  // Trigger the probe.
+  SendStreamDataToPeer(3, "!", packets_between_probes_base - 1, NO_FIN,
+                       nullptr);
+  ASSERT_TRUE(connection_.GetMtuDiscoveryAlarm()->IsSet());
+  QuicByteCount probe_size;
+  EXPECT_CALL(*send_algorithm_, OnPacketSent(_, _, _, _, _))
+      .WillOnce(SaveArg<3>(&probe_size));
+  connection_.GetMtuDiscoveryAlarm()->Fire();
+  EXPECT_EQ(kMaxJumboPacketSize, probe_size);
+
+  // Acknowledge all packets sent so far.
+  QuicAckFrame probe_ack = InitAckFrame(creator_->packet_number());
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  EXPECT_CALL(*send_algorithm_, OnCongestionEvent(true, _, _, _, _));
+  ProcessAckPacket(&probe_ack);
+  EXPECT_EQ(kMaxJumboPacketSize, connection_.max_packet_length());
+
+  // The search has converged, so no more probes are sent.
+  for (QuicPacketCount i = 0; i < 4 * kPacketsBetweenMtuProbesBase; i++) {
+    SendStreamDataToPeer(3, ".", packets_between_probes_base + i, NO_FIN,
+                         nullptr);
+    ASSERT_FALSE(connection_.GetMtuDiscoveryAlarm()->IsSet());
+  }
+  EXPECT_EQ(1u, connection_.mtu_probe_count());
+}
+
+// Tests that search-based MTU discovery bisects the remaining range after a
+// probe is rejected with EMSGSIZE.
+TEST_P(QuicConnectionTest, MtuSearchBisectsAfterProbeTooLarge) {
+  EXPECT_TRUE(connection_.connected());
+
+  const QuicByteCount initial_mtu = connection_.max_packet_length();
+  writer_->set_max_packet_size(kMaxJumboPacketSize);
+  connection_.EnableMtuSearchFromConfig(send_algorithm_, kMaxJumboPacketSize);
+
+  const QuicPacketCount packets_between_probes_base = 5;
+  set_packets_between_probes_base(packets_between_probes_base);
+
+  QuicStreamOffset offset = 0;
+  for (QuicPacketCount i = 0; i < packets_between_probes_base; i++) {
+    SendStreamDataToPeer(3, ".", offset++, NO_FIN, nullptr);
+  }
+  ASSERT_TRUE(connection_.GetMtuDiscoveryAlarm()->IsSet());
+  writer_->SimulateNextPacketTooLarge();
+  connection_.GetMtuDiscoveryAlarm()->Fire();
+  ASSERT_TRUE(connection_.connected());
+  EXPECT_FALSE(connection_.GetMtuDiscoveryAlarm()->IsSet());
+  EXPECT_EQ(initial_mtu, connection_.max_packet_length());
+
+  // The next probe is sent after the base number of packets, at the midpoint
+  // between the current size and the rejected one.
+  for (QuicPacketCount i = 0; i < kPacketsBetweenMtuProbesBase; i++) {
+    ASSERT_FALSE(connection_.GetMtuDiscoveryAlarm()->IsSet());
+    SendStreamDataToPeer(3, ".", offset++, NO_FIN, nullptr);
+  }
+  ASSERT_TRUE(connection_.GetMtuDiscoveryAlarm()->IsSet());
+  QuicByteCount probe_size;
+  EXPECT_CALL(*send_algorithm_, OnPacketSent(_, _, _, _, _))
+      .WillOnce(SaveArg<3>(&probe_size));
+  connection_.GetMtuDiscoveryAlarm()->Fire();
+  const QuicByteCount expected_probe_size =
+      initial_mtu + (kMaxJumboPacketSize - initial_mtu) / 2;
+  EXPECT_EQ(expected_probe_size, probe_size);
+
+  QuicAckFrame probe_ack = InitAckFrame(creator_->packet_number());
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  EXPECT_CALL(*send_algorithm_, OnCongestionEvent(true, _, _, _, _));
+  ProcessAckPacket(&probe_ack);
+  EXPECT_EQ(expected_probe_size, connection_.max_packet_length());
+}
+
+// Tests that a connection whose packet size was raised by search-based MTU
+// discovery reverts to its original size after repeated RTOs.
+TEST_P(QuicConnectionTest, MtuSearchRevertsOnBlackHole) {
+  if (!connection_.session_decides_what_to_write()) {
+    return;
+  }
+  EXPECT_TRUE(connection_.connected());
+
+  const QuicByteCount initial_mtu = connection_.max_packet_length();
+  writer_->set_max_packet_size(kMaxJumboPacketSize);
+  connection_.EnableMtuSearchFromConfig(send_algorithm_, kMaxJumboPacketSize);
+
+  const QuicPacketCount packets_between_probes_base = 5;
+  set_packets_between_probes_base(packets_between_probes_base);
+
+  QuicStreamOffset offset = 0;
+  for (QuicPacketCount i = 0; i < packets_between_probes_base; i++) {
+    SendStreamDataToPeer(3, ".", offset++, NO_FIN, nullptr);
+  }
+  ASSERT_TRUE(connection_.GetMtuDiscoveryAlarm()->IsSet());
+  connection_.GetMtuDiscoveryAlarm()->Fire();
+
+  QuicAckFrame probe_ack = InitAckFrame(creator_->packet_number());
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  EXPECT_CALL(*send_algorithm_, OnCongestionEvent(true, _, _, _, _));
+  ProcessAckPacket(&probe_ack);
+  EXPECT_EQ(kMaxJumboPacketSize, connection_.max_packet_length());
+
+  // Lose everything sent at the new size.
+  connection_.SetMaxTailLossProbes(0);
+  EXPECT_CALL(*send_algorithm_, OnPacketSent(_, _, _, _, _))
+      .Times(AnyNumber());
+  connection_.SendStreamDataWithString(3, "foo", offset, NO_FIN);
+  clock_.AdvanceTime(DefaultRetransmissionTime());
+  connection_.GetRetransmissionAlarm()->Fire();
+  EXPECT_EQ(kMaxJumboPacketSize, connection_.max_packet_length());
+
+  clock_.AdvanceTime(2 * DefaultRetransmissionTime());
+  connection_.GetRetransmissionAlarm()->Fire();
+  EXPECT_EQ(initial_mtu, connection_.max_packet_length());
+  EXPECT_EQ(1u, connection_.GetStats().mtu_black_holes_detected);
+}
+
+TEST_P(QuicConnectionTest, CoalescePacketsOfDifferentEncryptionLevels) {
+  if (!QuicVersionHasLongHeaderLengths(connection_.transport_version())) {
+    return;
+  }
+  connection_.EnablePacketCoalescingFromConfig(send_algorithm_);
+  connection_.set_fully_pad_crypto_hadshake_packets(false);
+  use_tagging_decrypter();
+  connection_.SetEncrypter(ENCRYPTION_NONE,
+                           QuicMakeUnique<TaggingEncrypter>(0x01));
+  EXPECT_CALL(*send_algorithm_, OnPacketSent(_, _, _, _, _)).Times(2);
+  {
+    QuicConnection::ScopedPacketFlusher flusher(&connection_,
+                                                QuicConnection::NO_ACK);
+    connection_.SendStreamDataWithString(
+        QuicUtils::GetCryptoStreamId(connection_.transport_version()), "foo",
+        0, NO_FIN);
+    connection_.SetEncrypter(ENCRYPTION_ZERO_RTT,
+                             QuicMakeUnique<TaggingEncrypter>(0x02));
+    connection_.SetDefaultEncryptionLevel(ENCRYPTION_ZERO_RTT);
+    connection_.SendStreamDataWithString(
+        GetNthClientInitiatedStreamId(0, connection_.transport_version()),
+        "bar", 0, NO_FIN);
+    // The packets wait for the flusher to go out of scope.
+    EXPECT_EQ(0u, writer_->packets_write_attempts());
+  }
+  EXPECT_EQ(1u, writer_->packets_write_attempts());
+  EXPECT_EQ(1u, connection_.GetStats().packets_coalesced);
+  // The datagram ends with the 0-RTT packet.
+  EXPECT_EQ(0x02020202u, writer_->final_bytes_of_last_packet());
+}
+
 TEST_P(QuicConnectionTest, NoMtuDiscoveryAfterConnectionClosed) {
   EXPECT_TRUE(connection_.connected());
 
@@ -5814,6 +6001,24 @@ TEST_P(QuicConnectionTest, SendDelayedAckOnSecondPacket) {
   EXPECT_FALSE(connection_.GetAckAlarm()->IsSet());
 }
 
+TEST_P(QuicConnectionTest, SendOneAckPerPacketBatch) {
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  connection_.OnPacketBatchStart();
+  ProcessPacket(1);
+  ProcessPacket(2);
+  ProcessPacket(3);
+  ProcessPacket(4);
+  // Nothing is sent until the end of the batch.
+  EXPECT_EQ(0u, writer_->packets_write_attempts());
+  EXPECT_TRUE(connection_.processing_packet_batch());
+
+  connection_.OnPacketBatchEnd();
+  EXPECT_FALSE(connection_.processing_packet_batch());
+  EXPECT_EQ(1u, writer_->packets_write_attempts());
+  EXPECT_FALSE(writer_->ack_frames().empty());
+  EXPECT_FALSE(connection_.GetAckAlarm()->IsSet());
+}
+
 TEST_P(QuicConnectionTest, NoAckOnOldNacks) {
   EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
   // Drop one packet, triggering a sequence of acks.
@@ -6096,6 +6301,176 @@ TEST_P(QuicConnectionTest, WriteBlockedAfterClientSendsConnectivityProbe) {
                                             connection_.peer_address());
 }
 
+TEST_P(QuicConnectionTest, ValidateAndSwitchToAlternativePath) {
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  set_perspective(Perspective::IS_CLIENT);
+  QuicStreamFrame stream_frame(
+      QuicUtils::GetCryptoStreamId(connection_.transport_version()), false, 0u,
+      QuicStringPiece());
+  EXPECT_CALL(visitor_, OnStreamFrame(_)).Times(AnyNumber());
+  EXPECT_CALL(visitor_, OnConnectivityProbeReceived(_, _)).Times(AnyNumber());
+  ProcessFramePacketWithAddresses(QuicFrame(stream_frame), kSelfAddress,
+                                  kPeerAddress);
+  const QuicTime::Delta active_path_min_rtt =
+      connection_.sent_packet_manager().GetRttStats()->min_rtt();
+
+  // Probe the alternative path without disturbing the active one.
+  const QuicSocketAddress kNewSelfAddress =
+      QuicSocketAddress(QuicIpAddress::Loopback6(), /*port=*/23456);
+  TestPacketWriter probing_writer(version(), &clock_);
+  EXPECT_CALL(*send_algorithm_, OnPacketSent(_, _, _, _, _)).Times(1);
+  EXPECT_TRUE(connection_.ValidateAlternativePath(
+      &probing_writer, kNewSelfAddress, kPeerAddress));
+  EXPECT_EQ(1u, probing_writer.packets_write_attempts());
+  EXPECT_FALSE(connection_.IsAlternativePathValidated());
+  EXPECT_FALSE(connection_.SwitchToAlternativePath());
+
+  // The probe is answered on the alternative path 50ms later.
+  clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(50));
+  OwningSerializedPacketPointer probing_packet = ConstructProbingPacket();
+  std::unique_ptr<QuicReceivedPacket> received(ConstructReceivedPacket(
+      QuicEncryptedPacket(probing_packet->encrypted_buffer,
+                          probing_packet->encrypted_length),
+      clock_.Now()));
+  ProcessReceivedPacket(kNewSelfAddress, kPeerAddress, *received);
+  EXPECT_TRUE(connection_.IsAlternativePathValidated());
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(50),
+            connection_.GetAlternativePathRttStats()->min_rtt());
+  EXPECT_EQ(kSelfAddress, connection_.self_address());
+  EXPECT_EQ(active_path_min_rtt,
+            connection_.sent_packet_manager().GetRttStats()->min_rtt());
+
+  // Switch to the alternative path, which brings its own RTT estimates.
+  EXPECT_CALL(*send_algorithm_, GetCongestionControlType())
+      .WillRepeatedly(Return(kCubicBytes));
+  EXPECT_TRUE(connection_.SwitchToAlternativePath());
+  EXPECT_EQ(kNewSelfAddress, connection_.self_address());
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(50),
+            connection_.sent_packet_manager().GetRttStats()->min_rtt());
+  EXPECT_EQ(active_path_min_rtt,
+            connection_.GetAlternativePathRttStats()->min_rtt());
+  connection_.SendStreamDataWithString(3, "foo", 0, NO_FIN);
+  EXPECT_EQ(2u, probing_writer.packets_write_attempts());
+
+  // The previous path stays validated and can be switched back to.
+  EXPECT_TRUE(connection_.IsAlternativePathValidated());
+  EXPECT_TRUE(connection_.SwitchToAlternativePath());
+  EXPECT_EQ(kSelfAddress, connection_.self_address());
+  EXPECT_EQ(active_path_min_rtt,
+            connection_.sent_packet_manager().GetRttStats()->min_rtt());
+}
+
+TEST_P(QuicConnectionTest, SendOnAlternativePathWithMultipath) {
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  set_perspective(Perspective::IS_CLIENT);
+  QuicStreamFrame stream_frame(
+      QuicUtils::GetCryptoStreamId(connection_.transport_version()), false, 0u,
+      QuicStringPiece());
+  EXPECT_CALL(visitor_, OnStreamFrame(_)).Times(AnyNumber());
+  EXPECT_CALL(visitor_, OnConnectivityProbeReceived(_, _)).Times(AnyNumber());
+  ProcessFramePacketWithAddresses(QuicFrame(stream_frame), kSelfAddress,
+                                  kPeerAddress);
+
+  // Validate the alternative path, which is 50ms away.
+  const QuicSocketAddress kNewSelfAddress =
+      QuicSocketAddress(QuicIpAddress::Loopback6(), /*port=*/23456);
+  TestPacketWriter probing_writer(version(), &clock_);
+  EXPECT_CALL(*send_algorithm_, OnPacketSent(_, _, _, _, _)).Times(1);
+  EXPECT_TRUE(connection_.ValidateAlternativePath(
+      &probing_writer, kNewSelfAddress, kPeerAddress));
+  clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(50));
+  OwningSerializedPacketPointer probing_packet = ConstructProbingPacket();
+  std::unique_ptr<QuicReceivedPacket> received(ConstructReceivedPacket(
+      QuicEncryptedPacket(probing_packet->encrypted_buffer,
+                          probing_packet->encrypted_length),
+      clock_.Now()));
+  ProcessReceivedPacket(kNewSelfAddress, kPeerAddress, *received);
+  ASSERT_TRUE(connection_.IsAlternativePathValidated());
+
+  // Multipath needs the connection option and a confirmed handshake.
+  EXPECT_FALSE(
+      connection_.EnableMultipath(QuicMakeUnique<MinRttPathScheduler>()));
+  QuicConfig config;
+  QuicTagVector connection_options;
+  connection_options.push_back(kMPTH);
+  config.SetConnectionOptionsToSend(connection_options);
+  EXPECT_CALL(*send_algorithm_, SetFromConfig(_, _));
+  EXPECT_CALL(*send_algorithm_, PacingRate(_))
+      .WillRepeatedly(Return(QuicBandwidth::Infinite()));
+  connection_.SetFromConfig(config);
+  EXPECT_FALSE(
+      connection_.EnableMultipath(QuicMakeUnique<MinRttPathScheduler>()));
+  connection_.OnHandshakeComplete();
+  EXPECT_CALL(*send_algorithm_, GetCongestionControlType())
+      .WillRepeatedly(Return(kCubicBytes));
+  EXPECT_TRUE(
+      connection_.EnableMultipath(QuicMakeUnique<MinRttPathScheduler>()));
+  EXPECT_TRUE(connection_.multipath_enabled());
+  EXPECT_FALSE(connection_.SwitchToAlternativePath());
+
+  // The alternative path has the lower RTT, so data goes out on it and is
+  // accounted to its own congestion controller.
+  const size_t packets_written = writer_->packets_write_attempts();
+  EXPECT_CALL(*send_algorithm_, OnPacketSent(_, _, _, _, _)).Times(0);
+  connection_.SendStreamDataWithString(3, "foo", 0, NO_FIN);
+  EXPECT_EQ(2u, probing_writer.packets_write_attempts());
+  EXPECT_EQ(packets_written, writer_->packets_write_attempts());
+  EXPECT_EQ(1u, connection_.GetStats().packets_sent_on_alternative_path);
+  EXPECT_EQ(kSelfAddress, connection_.self_address());
+  EXPECT_LT(0u, connection_.sent_packet_manager().GetBytesInFlightOnPath(
+                    kAlternativePathId));
+}
+
+TEST_P(QuicConnectionTest, MultipathPeerAddressesAtServer) {
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  set_perspective(Perspective::IS_SERVER);
+  QuicPacketCreatorPeer::SetSendVersionInPacket(creator_, false);
+  QuicConnectionPeer::SetDirectPeerAddress(&connection_, QuicSocketAddress());
+  QuicConnectionPeer::SetEffectivePeerAddress(&connection_,
+                                              QuicSocketAddress());
+
+  QuicConfig config;
+  QuicTagVector connection_options;
+  connection_options.push_back(kMPTH);
+  QuicConfigPeer::SetReceivedConnectionOptions(&config, connection_options);
+  EXPECT_CALL(*send_algorithm_, SetFromConfig(_, _));
+  connection_.SetFromConfig(config);
+
+  QuicStreamFrame stream_frame(
+      QuicUtils::GetCryptoStreamId(connection_.transport_version()), false, 0u,
+      QuicStringPiece());
+  EXPECT_CALL(visitor_, OnStreamFrame(_)).Times(AnyNumber());
+  ProcessFramePacketWithAddresses(QuicFrame(stream_frame), kSelfAddress,
+                                  kPeerAddress);
+  EXPECT_EQ(kPeerAddress, connection_.peer_address());
+
+  // The peer probes its alternative path, then sends data on it.  Neither is
+  // a migration.
+  const QuicSocketAddress kAlternativePeerAddress =
+      QuicSocketAddress(QuicIpAddress::Loopback6(), /*port=*/23456);
+  EXPECT_CALL(visitor_, OnConnectivityProbeReceived(_, _)).Times(1);
+  EXPECT_CALL(visitor_, OnConnectionMigration(_)).Times(0);
+  OwningSerializedPacketPointer probing_packet = ConstructProbingPacket();
+  std::unique_ptr<QuicReceivedPacket> received(ConstructReceivedPacket(
+      QuicEncryptedPacket(probing_packet->encrypted_buffer,
+                          probing_packet->encrypted_length),
+      clock_.Now()));
+  ProcessReceivedPacket(kSelfAddress, kAlternativePeerAddress, *received);
+  ProcessFramePacketWithAddresses(QuicFrame(stream_frame), kSelfAddress,
+                                  kAlternativePeerAddress);
+  EXPECT_EQ(kPeerAddress, connection_.peer_address());
+  EXPECT_EQ(kPeerAddress, connection_.effective_peer_address());
+
+  // A NAT rebinding of the primary path is still followed.
+  const QuicSocketAddress kReboundPeerAddress =
+      QuicSocketAddress(QuicIpAddress::Loopback6(), /*port=*/34567);
+  EXPECT_CALL(visitor_, OnConnectionMigration(PORT_CHANGE)).Times(1);
+  ProcessFramePacketWithAddresses(QuicFrame(stream_frame), kSelfAddress,
+                                  kReboundPeerAddress);
+  EXPECT_EQ(kReboundPeerAddress, connection_.peer_address());
+  EXPECT_EQ(kReboundPeerAddress, connection_.effective_peer_address());
+}
+
 TEST_P(QuicConnectionTest, WriterBlockedAfterServerSendsConnectivityProbe) {
   set_perspective(Perspective::IS_SERVER);
   QuicPacketCreatorPeer::SetSendVersionInPacket(creator_, false);
@@ -7682,6 +8057,149 @@ TEST_P(QuicConnectionTest, SendMessage) {
                    &storage)));
 }
 
+TEST_P(QuicConnectionTest, SendFecPacketAfterTailOfFlight) {
+  if (connection_.transport_version() <= QUIC_VERSION_44) {
+    return;
+  }
+  QuicConfig config;
+  config.SetConnectionOptionsToSend({kFECT});
+  EXPECT_CALL(*send_algorithm_, SetFromConfig(_, _));
+  connection_.SetFromConfig(config);
+  ASSERT_TRUE(connection_.fec_enabled());
+
+  // The session has more to write, so this is not the tail of the flight.
+  EXPECT_CALL(visitor_, WillingAndAbleToWrite()).WillRepeatedly(Return(true));
+  size_t packets_written = writer_->packets_write_attempts();
+  connection_.SendStreamDataWithString(3, "foo", 0, NO_FIN);
+  EXPECT_EQ(packets_written + 1, writer_->packets_write_attempts());
+  EXPECT_EQ(0u, connection_.GetStats().fec_packets_sent);
+
+  // The last write of the flight is followed by a repair packet covering both
+  // stream frames.
+  EXPECT_CALL(visitor_, WillingAndAbleToWrite()).WillRepeatedly(Return(false));
+  packets_written = writer_->packets_write_attempts();
+  connection_.SendStreamDataWithString(3, "bar", 3, FIN);
+  EXPECT_EQ(packets_written + 2, writer_->packets_write_attempts());
+  EXPECT_EQ(1u, connection_.GetStats().fec_packets_sent);
+  EXPECT_TRUE(writer_->stream_frames().empty());
+}
+
+TEST_P(QuicConnectionTest, FecPacketIsCongestionControlled) {
+  if (connection_.transport_version() <= QUIC_VERSION_44) {
+    return;
+  }
+  QuicConfig config;
+  config.SetConnectionOptionsToSend({kFECT});
+  EXPECT_CALL(*send_algorithm_, SetFromConfig(_, _));
+  connection_.SetFromConfig(config);
+  ASSERT_TRUE(connection_.fec_enabled());
+
+  EXPECT_CALL(visitor_, WillingAndAbleToWrite()).WillRepeatedly(Return(true));
+  connection_.SendStreamDataWithString(3, "foo", 0, FIN);
+  const QuicByteCount bytes_in_flight = manager_->GetBytesInFlight();
+
+  // The repair packet waits while congestion control blocks sending.
+  EXPECT_CALL(visitor_, WillingAndAbleToWrite()).WillRepeatedly(Return(false));
+  EXPECT_CALL(*send_algorithm_, CanSend(_)).WillRepeatedly(Return(false));
+  size_t packets_written = writer_->packets_write_attempts();
+  connection_.OnCanWrite();
+  EXPECT_EQ(packets_written, writer_->packets_write_attempts());
+  EXPECT_EQ(0u, connection_.GetStats().fec_packets_sent);
+
+  // Once sending is allowed, the repair packet is sent and counts as in
+  // flight.
+  EXPECT_CALL(*send_algorithm_, CanSend(_)).WillRepeatedly(Return(true));
+  EXPECT_CALL(*send_algorithm_,
+              OnPacketSent(_, _, _, _, HAS_RETRANSMITTABLE_DATA));
+  connection_.OnCanWrite();
+  EXPECT_EQ(packets_written + 1, writer_->packets_write_attempts());
+  EXPECT_EQ(1u, connection_.GetStats().fec_packets_sent);
+  EXPECT_LT(bytes_in_flight, manager_->GetBytesInFlight());
+}
+
+TEST_P(QuicConnectionTest, ProbeOutstandingFecPacketWithPing) {
+  if (connection_.transport_version() <= QUIC_VERSION_44) {
+    return;
+  }
+  QuicConfig config;
+  config.SetConnectionOptionsToSend({kFECT});
+  EXPECT_CALL(*send_algorithm_, SetFromConfig(_, _));
+  connection_.SetFromConfig(config);
+  ASSERT_TRUE(connection_.fec_enabled());
+
+  // Send a stream frame followed by its repair packet, then ack only the
+  // stream frame, leaving the repair packet as the only packet in flight.
+  EXPECT_CALL(visitor_, WillingAndAbleToWrite()).WillRepeatedly(Return(false));
+  connection_.SendStreamDataWithString(3, "foo", 0, FIN);
+  ASSERT_EQ(1u, connection_.GetStats().fec_packets_sent);
+  QuicAckFrame ack = InitAckFrame(1);
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  EXPECT_CALL(*send_algorithm_, OnCongestionEvent(true, _, _, _, _));
+  ProcessAckPacket(&ack);
+  EXPECT_LT(0u, QuicSentPacketManagerPeer::GetBytesInFlight(manager_));
+  if (!connection_.GetRetransmissionAlarm()->IsSet()) {
+    // Without retransmittable data in flight, the alarm may not be armed at
+    // all.
+    return;
+  }
+
+  // The timeout probes the repair packet with a PING instead of counting as a
+  // TLP or RTO with nothing to retransmit.
+  writer_->Reset();
+  EXPECT_CALL(visitor_, SendPing()).WillOnce(Invoke([this]() {
+    connection_.SendControlFrame(QuicFrame(QuicPingFrame(1)));
+  }));
+  clock_.AdvanceTime(connection_.GetRetransmissionAlarm()->deadline() -
+                     clock_.Now());
+  connection_.GetRetransmissionAlarm()->Fire();
+  ASSERT_EQ(1u, writer_->ping_frames().size());
+  EXPECT_EQ(0u, connection_.GetStats().tlp_count);
+  EXPECT_EQ(0u, connection_.GetStats().rto_count);
+  EXPECT_EQ(0u, manager_->GetConsecutiveRtoCount());
+  EXPECT_TRUE(connection_.GetRetransmissionAlarm()->IsSet());
+}
+
+TEST_P(QuicConnectionTest, RecoverLostStreamFrameFromFecFrame) {
+  if (connection_.transport_version() <= QUIC_VERSION_44) {
+    return;
+  }
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  QuicConfig config;
+  config.SetConnectionOptionsToSend({kFECT});
+  EXPECT_CALL(*send_algorithm_, SetFromConfig(_, _));
+  connection_.SetFromConfig(config);
+  const uint8_t tag = 0x07;
+  connection_.SetDecrypter(ENCRYPTION_ZERO_RTT,
+                           QuicMakeUnique<StrictTaggingDecrypter>(tag));
+  framer_.SetEncrypter(ENCRYPTION_ZERO_RTT,
+                       QuicMakeUnique<TaggingEncrypter>(tag));
+
+  QuicStreamFrame received_frame(3, false, 0, "foo");
+  QuicStreamFrame lost_frame(3, true, 3, "ba");
+  QuicFecEncoder encoder;
+  EXPECT_TRUE(encoder.OnStreamFrameSent(received_frame, nullptr));
+  EXPECT_TRUE(encoder.OnStreamFrameSent(lost_frame, nullptr));
+  std::vector<QuicFecFrame> repair_frames = encoder.GenerateRepairFrames(
+      connection_.transport_version(), kMaxPacketSize);
+  ASSERT_EQ(1u, repair_frames.size());
+
+  EXPECT_CALL(visitor_, OnStreamFrame(_));
+  ProcessFramePacketAtLevel(1, QuicFrame(received_frame), ENCRYPTION_ZERO_RTT);
+
+  // Packet 2 carrying |lost_frame| is lost, and the repair rebuilds it.
+  QuicStreamFrame recovered_frame;
+  EXPECT_CALL(visitor_, OnStreamFrame(_))
+      .WillOnce(SaveArg<0>(&recovered_frame));
+  ProcessFramePacketAtLevel(3, QuicFrame(&repair_frames[0]),
+                            ENCRYPTION_ZERO_RTT);
+  EXPECT_EQ(3u, recovered_frame.stream_id);
+  EXPECT_EQ(3u, recovered_frame.offset);
+  EXPECT_TRUE(recovered_frame.fin);
+  EXPECT_EQ("ba", QuicStringPiece(recovered_frame.data_buffer,
+                                  recovered_frame.data_length));
+  EXPECT_EQ(1u, connection_.GetStats().stream_frames_recovered_by_fec);
+}
+
 // Test to check that the path challenge/path response logic works
 // correctly. This test is only for version-99
 TEST_P(QuicConnectionTest, PathChallengeResponse) {
@@ -41,6 +41,11 @@ const QuicByteCount kMaxPacketSize = 1452;
 // The maximum packet size of any QUIC packet over IPv4.
 // 1500(Ethernet) - 20(IPv4 header) - 8(UDP header) = 1472.
 const QuicByteCount kMaxV4PacketSize = 1472;
+// The maximum packet size of any QUIC packet on a path whose links all carry
+// jumbo frames.  9000(jumbo frame) - 40(IPv6 header) - 8(UDP header) = 8952.
+// Packets larger than kMaxPacketSize are only sent once path MTU discovery has
+// confirmed that the path carries them.
+const QuicByteCount kMaxJumboPacketSize = 9000 - 40 - 8;
 // ETH_MAX_MTU - MAX(sizeof(iphdr), sizeof(ip6_hdr)) - sizeof(udphdr).
 const QuicByteCount kMaxGsoPacketSize = 65535 - 40 - 8;
 // Default maximum packet size used in the Linux TCP implementation.
@@ -224,6 +229,19 @@ const size_t kMinRandomBytesLengthInStatelessReset = 24;
 // Maximum length allowed for the token in a NEW_TOKEN frame.
 const size_t kMaxNewTokenTokenLength = 0xffff;
 
+// Maximum number of stream frames a FEC repair frame protects.  A repair
+// rebuilds at most one lost frame, so it covers only the tail of a flight.
+const size_t kMaxFecProtectedStreamFrames = 8;
+
+// Number of recently received stream frames kept for FEC recovery.
+const size_t kMaxFecReceivedStreamFrames = 4 * kMaxFecProtectedStreamFrames;
+
+// The path a connection is established on, and the alternative path which a
+// multipath connection also sends on.
+const QuicPathId kDefaultPathId = 0;
+const QuicPathId kAlternativePathId = 1;
+const size_t kMaxNumPaths = 2;
+
 // Packet number of first sending packet of a connection. Please note, this
 // cannot be used as first received packet because peer can choose its starting
 // packet number.
@@ -45,7 +45,7 @@ QuicCryptoClientStream::QuicCryptoClientStream(
       handshaker_ = QuicMakeUnique<TlsClientHandshaker>(
           this, session, server_id, crypto_config->proof_verifier(),
           crypto_config->ssl_ctx(), std::move(verify_context),
-          crypto_config->user_agent_id());
+          crypto_config->user_agent_id(), crypto_config->session_cache());
       break;
     case PROTOCOL_UNSUPPORTED:
       QUIC_BUG << "Attempting to create QuicCryptoClientStream for unknown "
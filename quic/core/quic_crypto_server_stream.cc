@@ -163,7 +163,9 @@ void QuicCryptoServerStream::OnSuccessfulVersionNegotiation(
     case PROTOCOL_TLS1_3:
       handshaker_ = QuicMakeUnique<TlsServerHandshaker>(
           this, session(), crypto_config_->ssl_ctx(),
-          crypto_config_->proof_source());
+          crypto_config_->proof_source(),
+          crypto_config_->session_ticket_boxer(),
+          crypto_config_->enable_tls_early_data());
       break;
     case PROTOCOL_UNSUPPORTED:
       QUIC_BUG << "Attempting to create QuicCryptoServerStream for unknown "
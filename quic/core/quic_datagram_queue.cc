@@ -0,0 +1,121 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/quic_datagram_queue.h"
+
+#include <utility>
+
+#include "net/third_party/quiche/src/quic/core/quic_session.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_bug_tracker.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_mem_slice_storage.h"
+
+namespace quic {
+
+QuicDatagramQueue::QuicDatagramQueue(QuicSession* session)
+    : session_(session),
+      queue_size_(0),
+      datagrams_sent_(0),
+      datagrams_expired_(0),
+      datagrams_lost_(0) {}
+
+QuicDatagramQueue::~QuicDatagramQueue() {}
+
+MessageStatus QuicDatagramQueue::SendOrQueueDatagram(
+    QuicString datagram,
+    spdy::SpdyPriority priority,
+    QuicTime expiry) {
+  if (session_->connection()->transport_version() <= QUIC_VERSION_44) {
+    return MESSAGE_STATUS_UNSUPPORTED;
+  }
+  if (datagram.length() > session_->GetLargestMessagePayload()) {
+    return MESSAGE_STATUS_TOO_LARGE;
+  }
+  if (priority > spdy::kV3LowestPriority) {
+    QUIC_BUG << "Invalid datagram priority " << static_cast<int>(priority);
+    priority = spdy::kV3LowestPriority;
+  }
+
+  bool must_queue = false;
+  for (spdy::SpdyPriority p = spdy::kV3HighestPriority; p <= priority; ++p) {
+    if (!queues_[p].empty()) {
+      must_queue = true;
+      break;
+    }
+  }
+  if (!must_queue) {
+    MessageStatus status = SendDatagram(datagram);
+    if (status != MESSAGE_STATUS_BLOCKED &&
+        status != MESSAGE_STATUS_ENCRYPTION_NOT_ESTABLISHED) {
+      return status;
+    }
+  }
+
+  QUIC_DVLOG(1) << "Queueing datagram of " << datagram.length()
+                << " bytes at priority " << static_cast<int>(priority);
+  queues_[priority].push_back({std::move(datagram), expiry});
+  ++queue_size_;
+  return MESSAGE_STATUS_SUCCESS;
+}
+
+void QuicDatagramQueue::TrySendingNextDatagrams(
+    spdy::SpdyPriority lowest_priority) {
+  RemoveExpiredDatagrams();
+  for (spdy::SpdyPriority p = spdy::kV3HighestPriority;
+       p <= lowest_priority && p <= spdy::kV3LowestPriority; ++p) {
+    QuicDeque<QueuedDatagram>& queue = queues_[p];
+    while (!queue.empty()) {
+      MessageStatus status = SendDatagram(queue.front().data);
+      if (status == MESSAGE_STATUS_BLOCKED ||
+          status == MESSAGE_STATUS_ENCRYPTION_NOT_ESTABLISHED) {
+        // Retry when the session gets the next OnCanWrite.
+        return;
+      }
+      if (status != MESSAGE_STATUS_SUCCESS) {
+        QUIC_DLOG(DFATAL) << "Dropping queued datagram which failed to send"
+                          << ", status=" << status << ", datagram_size="
+                          << queue.front().data.length();
+      }
+      queue.pop_front();
+      --queue_size_;
+    }
+  }
+}
+
+MessageStatus QuicDatagramQueue::SendDatagram(const QuicString& datagram) {
+  struct iovec iov = {const_cast<char*>(datagram.data()), datagram.length()};
+  QuicMemSliceStorage storage(
+      &iov, 1,
+      session_->connection()->helper()->GetStreamSendBufferAllocator(),
+      datagram.length());
+  MessageResult result = session_->SendMessage(storage.ToSpan());
+  if (result.status == MESSAGE_STATUS_SUCCESS) {
+    QUIC_DVLOG(1) << "Datagram sent, message_id=" << result.message_id
+                  << ", datagram_size=" << datagram.length();
+    ++datagrams_sent_;
+  }
+  return result.status;
+}
+
+void QuicDatagramQueue::RemoveExpiredDatagrams() {
+  if (empty()) {
+    return;
+  }
+  const QuicTime now = session_->connection()->clock()->ApproximateNow();
+  for (QuicDeque<QueuedDatagram>& queue : queues_) {
+    for (auto it = queue.begin(); it != queue.end();) {
+      if (it->expiry > now) {
+        ++it;
+        continue;
+      }
+      QUIC_DVLOG(1) << "Dropping expired datagram of " << it->data.length()
+                    << " bytes";
+      it = queue.erase(it);
+      --queue_size_;
+      ++datagrams_expired_;
+    }
+  }
+}
+
+}  // namespace quic
@@ -0,0 +1,87 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_DATAGRAM_QUEUE_H_
+#define QUICHE_QUIC_CORE_QUIC_DATAGRAM_QUEUE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "net/third_party/quiche/src/quic/core/quic_time.h"
+#include "net/third_party/quiche/src/quic/core/quic_types.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_containers.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
+#include "net/third_party/quiche/src/spdy/core/spdy_protocol.h"
+
+namespace quic {
+
+class QuicSession;
+
+// Schedules unreliable datagrams, sent as MESSAGE frames, which cannot be sent
+// right away because the connection is blocked. Queued datagrams are sent in
+// priority order, oldest first within a priority, and are dropped once their
+// expiry has passed. There is no expiry alarm: expiry is only checked when the
+// session tries to send queued datagrams, which it does on every OnCanWrite
+// while the queue is not empty.
+class QUIC_EXPORT_PRIVATE QuicDatagramQueue {
+ public:
+  // |session| must outlive the queue.
+  explicit QuicDatagramQueue(QuicSession* session);
+  QuicDatagramQueue(const QuicDatagramQueue&) = delete;
+  QuicDatagramQueue& operator=(const QuicDatagramQueue&) = delete;
+  ~QuicDatagramQueue();
+
+  // Sends |datagram| if no datagram of the same or a higher |priority| is
+  // queued and the connection is not blocked, and queues it otherwise. A queued
+  // datagram which has not been sent by |expiry| is dropped. Returns
+  // MESSAGE_STATUS_SUCCESS if |datagram| was sent or queued, or the reason it
+  // will never be sent.
+  MessageStatus SendOrQueueDatagram(QuicString datagram,
+                                    spdy::SpdyPriority priority,
+                                    QuicTime expiry);
+
+  // Drops expired datagrams, then sends queued datagrams of |lowest_priority|
+  // or a higher priority until the connection is blocked.
+  void TrySendingNextDatagrams(spdy::SpdyPriority lowest_priority);
+
+  // Called when a message sent by the session is considered lost.
+  void OnDatagramLost() { ++datagrams_lost_; }
+
+  bool empty() const { return queue_size_ == 0; }
+
+  // Number of datagrams waiting to be sent, including expired datagrams which
+  // have not been dropped yet.
+  size_t queue_size() const { return queue_size_; }
+
+  uint64_t datagrams_sent() const { return datagrams_sent_; }
+  uint64_t datagrams_expired() const { return datagrams_expired_; }
+  uint64_t datagrams_lost() const { return datagrams_lost_; }
+
+ private:
+  struct QueuedDatagram {
+    QuicString data;
+    QuicTime expiry;
+  };
+
+  // Sends |datagram| and returns the status of the send.
+  MessageStatus SendDatagram(const QuicString& datagram);
+
+  // Drops the datagrams whose expiry has passed.
+  void RemoveExpiredDatagrams();
+
+  QuicSession* session_;  // Not owned.
+
+  // Queued datagrams indexed by priority, oldest first.
+  QuicDeque<QueuedDatagram> queues_[spdy::kV3LowestPriority + 1];
+  size_t queue_size_;
+
+  uint64_t datagrams_sent_;
+  uint64_t datagrams_expired_;
+  uint64_t datagrams_lost_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_DATAGRAM_QUEUE_H_
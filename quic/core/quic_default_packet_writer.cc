@@ -4,12 +4,16 @@
 
 #include "net/third_party/quiche/src/quic/core/quic_default_packet_writer.h"
 
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
 #include "net/quic/platform/impl/quic_socket_utils.h"
 
 namespace quic {
 
 QuicDefaultPacketWriter::QuicDefaultPacketWriter(int fd)
-    : fd_(fd), write_blocked_(false) {}
+    : fd_(fd), write_blocked_(false), max_packet_size_(kMaxPacketSize) {}
 
 QuicDefaultPacketWriter::~QuicDefaultPacketWriter() = default;
 
@@ -40,7 +44,7 @@ void QuicDefaultPacketWriter::SetWritable() {
 
 QuicByteCount QuicDefaultPacketWriter::GetMaxPacketSize(
     const QuicSocketAddress& peer_address) const {
-  return kMaxPacketSize;
+  return max_packet_size_;
 }
 
 bool QuicDefaultPacketWriter::SupportsReleaseTime() const {
@@ -65,4 +69,21 @@ void QuicDefaultPacketWriter::set_write_blocked(bool is_blocked) {
   write_blocked_ = is_blocked;
 }
 
+// static
+bool QuicDefaultPacketWriter::SetDontFragment(int fd, int address_family) {
+  // Unlike IP_PMTUDISC_DO, IP_PMTUDISC_PROBE does not limit packets to the
+  // path MTU cached by the kernel, which probes are meant to exceed.
+  int probe = IP_PMTUDISC_PROBE;
+  if (address_family == AF_INET) {
+    return setsockopt(fd, IPPROTO_IP, IP_MTU_DISCOVER, &probe,
+                      sizeof(probe)) == 0;
+  }
+  DCHECK_EQ(AF_INET6, address_family);
+  // Dual stack sockets use the IPv4 option for IPv4-mapped peers.
+  setsockopt(fd, IPPROTO_IP, IP_MTU_DISCOVER, &probe, sizeof(probe));
+  int probe6 = IPV6_PMTUDISC_PROBE;
+  return setsockopt(fd, IPPROTO_IPV6, IPV6_MTU_DISCOVER, &probe6,
+                    sizeof(probe6)) == 0;
+}
+
 }  // namespace quic
@@ -42,6 +42,19 @@ class QUIC_EXPORT_PRIVATE QuicDefaultPacketWriter : public QuicPacketWriter {
 
   void set_fd(int fd) { fd_ = fd; }
 
+  // Sets the size returned by GetMaxPacketSize(), kMaxPacketSize by default.
+  // Raising it lets path MTU discovery find packet sizes above
+  // kMaxPacketSize, up to kMaxJumboPacketSize.
+  void set_max_packet_size(QuicByteCount max_packet_size) {
+    max_packet_size_ = max_packet_size;
+  }
+
+  // Sets the don't fragment bit on packets sent on |fd|, so that path MTU
+  // probes which are too large for the path are dropped rather than
+  // fragmented.  |address_family| is AF_INET or AF_INET6.  Returns false if
+  // the socket option could not be set.
+  static bool SetDontFragment(int fd, int address_family);
+
  protected:
   void set_write_blocked(bool is_blocked);
   int fd() { return fd_; }
@@ -49,6 +62,7 @@ class QUIC_EXPORT_PRIVATE QuicDefaultPacketWriter : public QuicPacketWriter {
  private:
   int fd_;
   bool write_blocked_;
+  QuicByteCount max_packet_size_;
 };
 
 }  // namespace quic
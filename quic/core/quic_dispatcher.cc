@@ -310,6 +310,7 @@ QuicDispatcher::QuicDispatcher(
       last_error_(QUIC_NO_ERROR),
       new_sessions_allowed_per_event_loop_(0u),
       accept_new_connections_(true),
+      processing_packet_batch_(false),
       check_blocked_writer_for_blockage_(
           GetQuicRestartFlag(quic_check_blocked_writer_for_blockage)) {
   framer_.set_visitor(this);
@@ -324,6 +325,20 @@ void QuicDispatcher::InitializeWithWriter(QuicPacketWriter* writer) {
   DCHECK(writer_ == nullptr);
   writer_.reset(writer);
   time_wait_list_manager_.reset(CreateQuicTimeWaitListManager());
+  time_wait_list_manager_->set_crypto_config(crypto_config_);
+}
+
+void QuicDispatcher::SetTimeWaitResponseRateLimits(
+    QuicPacketCount max_packets_per_second,
+    QuicPacketCount max_packets_per_second_per_subnet) {
+  DCHECK(time_wait_list_manager_ != nullptr);
+  time_wait_list_manager_->SetResponseRateLimits(
+      max_packets_per_second, max_packets_per_second_per_subnet);
+}
+
+void QuicDispatcher::SetTimeWaitListCompactMode(bool compact_mode) {
+  DCHECK(time_wait_list_manager_ != nullptr);
+  time_wait_list_manager_->set_compact_mode(compact_mode);
 }
 
 void QuicDispatcher::ProcessPacket(const QuicSocketAddress& self_address,
@@ -334,6 +349,11 @@ void QuicDispatcher::ProcessPacket(const QuicSocketAddress& self_address,
   // GetClientAddress must be called after current_peer_address_ is set.
   current_client_address_ = GetClientAddress();
   current_packet_ = &packet;
+  // Packets for established connections, which are the vast majority, are
+  // routed without running them through |framer_|.
+  if (MaybeDispatchToExistingSession()) {
+    return;
+  }
   // ProcessPacket will cause the packet to be dispatched in
   // OnUnauthenticatedPublicHeader, or sent to the time wait list manager
   // in OnUnauthenticatedHeader.
@@ -344,6 +364,63 @@ void QuicDispatcher::ProcessPacket(const QuicSocketAddress& self_address,
   //            next packet does not use them incorrectly.
 }
 
+bool QuicDispatcher::MaybeDispatchToExistingSession() {
+  // Packets from port zero are dropped in OnUnauthenticatedPublicHeader.
+  if (current_peer_address_.port() == 0) {
+    return false;
+  }
+  PacketHeaderFormat form;
+  bool version_flag;
+  QuicVersionLabel version_label;
+  QuicConnectionId connection_id;
+  QuicString detailed_error;
+  if (QuicFramer::ProcessPacketDispatcher(
+          *current_packet_, &form, &version_flag, &version_label,
+          &connection_id, &detailed_error) != QUIC_NO_ERROR ||
+      connection_id.length() != kQuicDefaultConnectionIdLength) {
+    // Let |framer_| report the error or drop the packet.
+    return false;
+  }
+  auto it = session_map_.find(connection_id);
+  if (it == session_map_.end()) {
+    return false;
+  }
+  current_connection_id_ = connection_id;
+  DCHECK(!buffered_packets_.HasBufferedPackets(connection_id));
+  ProcessUdpPacketForSession(connection_id, it->second.get());
+  return true;
+}
+
+void QuicDispatcher::ProcessUdpPacketForSession(QuicConnectionId connection_id,
+                                                QuicSession* session) {
+  if (processing_packet_batch_ &&
+      !session->connection()->processing_packet_batch()) {
+    session->connection()->OnPacketBatchStart();
+    sessions_in_packet_batch_.push_back(connection_id);
+  }
+  session->ProcessUdpPacket(current_self_address_, current_peer_address_,
+                            *current_packet_);
+}
+
+void QuicDispatcher::OnPacketBatchStart() {
+  DCHECK(!processing_packet_batch_);
+  DCHECK(sessions_in_packet_batch_.empty());
+  processing_packet_batch_ = true;
+}
+
+void QuicDispatcher::OnPacketBatchEnd() {
+  processing_packet_batch_ = false;
+  for (QuicConnectionId connection_id : sessions_in_packet_batch_) {
+    // Sessions closed during the batch are no longer in |session_map_|, and
+    // have nothing left to send.
+    auto it = session_map_.find(connection_id);
+    if (it != session_map_.end()) {
+      it->second->connection()->OnPacketBatchEnd();
+    }
+  }
+  sessions_in_packet_batch_.clear();
+}
+
 bool QuicDispatcher::OnUnauthenticatedPublicHeader(
     const QuicPacketHeader& header) {
   current_connection_id_ = header.destination_connection_id;
@@ -369,8 +446,7 @@ bool QuicDispatcher::OnUnauthenticatedPublicHeader(
   auto it = session_map_.find(connection_id);
   if (it != session_map_.end()) {
     DCHECK(!buffered_packets_.HasBufferedPackets(connection_id));
-    it->second->ProcessUdpPacket(current_self_address_, current_peer_address_,
-                                 *current_packet_);
+    ProcessUdpPacketForSession(connection_id, it->second.get());
     return false;
   }
 
@@ -483,10 +559,7 @@ void QuicDispatcher::ProcessUnauthenticatedHeaderFate(
             "Reject connection",
             quic::QuicTimeWaitListManager::SEND_STATELESS_RESET);
       }
-      DCHECK(time_wait_list_manager_->IsConnectionIdInTimeWait(connection_id));
-      time_wait_list_manager_->ProcessPacket(
-          current_self_address_, current_peer_address_, connection_id,
-          GetPerPacketContext());
+      ProcessPacketInTimeWait(connection_id, form);
 
       // Any packets which were buffered while the stateless rejector logic was
       // running should be discarded.  Do not inform the time wait list manager,
@@ -814,6 +887,22 @@ void QuicDispatcher::StatelesslyTerminateConnection(
       QuicTimeWaitListManager::SEND_TERMINATION_PACKETS, &termination_packets);
 }
 
+void QuicDispatcher::ProcessPacketInTimeWait(QuicConnectionId connection_id,
+                                             PacketHeaderFormat form) {
+  if (!time_wait_list_manager_->IsConnectionIdInTimeWait(connection_id)) {
+    // In compact mode, connection IDs which only get stateless resets are not
+    // kept in the time-wait list.
+    DCHECK(time_wait_list_manager_->compact_mode());
+    time_wait_list_manager_->SendStatelessReset(
+        current_self_address_, current_peer_address_, connection_id,
+        form != GOOGLE_QUIC_PACKET, GetPerPacketContext());
+    return;
+  }
+  time_wait_list_manager_->ProcessPacket(current_self_address_,
+                                         current_peer_address_, connection_id,
+                                         GetPerPacketContext());
+}
+
 void QuicDispatcher::OnPacket() {}
 
 void QuicDispatcher::OnError(QuicFramer* framer) {
@@ -881,6 +970,11 @@ bool QuicDispatcher::OnAckFrameStart(QuicPacketNumber /*largest_acked*/,
   return false;
 }
 
+bool QuicDispatcher::OnAckEcnCounts(const QuicEcnCounts& /*ecn_counts*/) {
+  DCHECK(false);
+  return false;
+}
+
 bool QuicDispatcher::OnAckRange(QuicPacketNumber /*start*/,
                                 QuicPacketNumber /*end*/) {
   DCHECK(false);
@@ -994,6 +1088,11 @@ bool QuicDispatcher::OnMessageFrame(const QuicMessageFrame& frame) {
   return false;
 }
 
+bool QuicDispatcher::OnFecFrame(const QuicFecFrame& frame) {
+  DCHECK(false);
+  return false;
+}
+
 void QuicDispatcher::OnPacketComplete() {
   DCHECK(false);
 }
@@ -1105,9 +1204,7 @@ void QuicDispatcher::ProcessChlo(PacketHeaderFormat form,
         "Stop accepting new connections",
         quic::QuicTimeWaitListManager::SEND_STATELESS_RESET);
     // Time wait list will reject the packet correspondingly.
-    time_wait_list_manager()->ProcessPacket(
-        current_self_address(), current_peer_address(), current_connection_id(),
-        GetPerPacketContext());
+    ProcessPacketInTimeWait(current_connection_id(), form);
     return;
   }
   if (!buffered_packets_.HasBufferedPackets(current_connection_id_) &&
@@ -58,12 +58,32 @@ class QuicDispatcher : public QuicTimeWaitListManager::Visitor,
   // Takes ownership of |writer|.
   void InitializeWithWriter(QuicPacketWriter* writer);
 
+  // Limits the responses sent by the time-wait list, see
+  // QuicTimeWaitListManager::SetResponseRateLimits().  Must be called after
+  // InitializeWithWriter().
+  void SetTimeWaitResponseRateLimits(
+      QuicPacketCount max_packets_per_second,
+      QuicPacketCount max_packets_per_second_per_subnet);
+
+  // If true, the time-wait list only stores connection IDs which have
+  // termination packets, and packets of other closed connections are answered
+  // with stateless resets built from the connection ID, see
+  // QuicTimeWaitListManager::set_compact_mode().  Must be called after
+  // InitializeWithWriter().
+  void SetTimeWaitListCompactMode(bool compact_mode);
+
   // Process the incoming packet by creating a new session, passing it to
   // an existing session, or passing it to the time wait list.
   void ProcessPacket(const QuicSocketAddress& self_address,
                      const QuicSocketAddress& peer_address,
                      const QuicReceivedPacket& packet) override;
 
+  // Packets of a batch are delivered to their sessions as they are processed,
+  // and each session that received any of them sends its response once in
+  // OnPacketBatchEnd().
+  void OnPacketBatchStart() override;
+  void OnPacketBatchEnd() override;
+
   // Called when the socket becomes writable to allow queued writes to happen.
   virtual void OnCanWrite();
 
@@ -148,6 +168,7 @@ class QuicDispatcher : public QuicTimeWaitListManager::Visitor,
   bool OnCryptoFrame(const QuicCryptoFrame& frame) override;
   bool OnAckFrameStart(QuicPacketNumber largest_acked,
                        QuicTime::Delta ack_delay_time) override;
+  bool OnAckEcnCounts(const QuicEcnCounts& ecn_counts) override;
   bool OnAckRange(QuicPacketNumber start, QuicPacketNumber end) override;
   bool OnAckTimestamp(QuicPacketNumber packet_number,
                       QuicTime timestamp) override;
@@ -171,6 +192,7 @@ class QuicDispatcher : public QuicTimeWaitListManager::Visitor,
       const QuicRetireConnectionIdFrame& frame) override;
   bool OnNewTokenFrame(const QuicNewTokenFrame& frame) override;
   bool OnMessageFrame(const QuicMessageFrame& frame) override;
+  bool OnFecFrame(const QuicFecFrame& frame) override;
   void OnPacketComplete() override;
   bool IsValidStatelessResetToken(QuicUint128 token) const override;
   void OnAuthenticatedIetfStatelessResetPacket(
@@ -367,6 +389,22 @@ class QuicDispatcher : public QuicTimeWaitListManager::Visitor,
                               PacketHeaderFormat form,
                               ParsedQuicVersion version);
 
+  // Parses the invariant header of |current_packet_| and, if it belongs to a
+  // session in |session_map_|, delivers it to that session and returns true.
+  // Returns false if the packet needs the full public header processing done
+  // by |framer_|.
+  bool MaybeDispatchToExistingSession();
+
+  // Delivers |current_packet_| to |session|, adding |session| to the current
+  // packet batch, if any.
+  void ProcessUdpPacketForSession(QuicConnectionId connection_id,
+                                  QuicSession* session);
+
+  // Lets |time_wait_list_manager_| respond to |current_packet_|, which belongs
+  // to |connection_id| and has just been put in time-wait state.
+  void ProcessPacketInTimeWait(QuicConnectionId connection_id,
+                               PacketHeaderFormat form);
+
   // Deliver |packets| to |session| for further processing.
   void DeliverPacketsToSession(
       const std::list<QuicBufferedPacketStore::BufferedPacket>& packets,
@@ -475,6 +513,13 @@ class QuicDispatcher : public QuicTimeWaitListManager::Visitor,
   // True if this dispatcher is not draining.
   bool accept_new_connections_;
 
+  // True between OnPacketBatchStart() and OnPacketBatchEnd().
+  bool processing_packet_batch_;
+
+  // Connection IDs of the sessions which received packets in the current
+  // packet batch.
+  std::vector<QuicConnectionId> sessions_in_packet_batch_;
+
   // Latched value of --quic_check_blocked_writer_for_blockage.
   const bool check_blocked_writer_for_blockage_;
 };
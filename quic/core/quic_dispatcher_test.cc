@@ -447,6 +447,43 @@ TEST_F(QuicDispatcherTest, ProcessPackets) {
   ProcessPacket(client_address, TestConnectionId(1), false, "data");
 }
 
+TEST_F(QuicDispatcherTest, ProcessPacketBatch) {
+  QuicSocketAddress client_address(QuicIpAddress::Loopback4(), 1);
+
+  EXPECT_CALL(*dispatcher_,
+              CreateQuicSession(TestConnectionId(1), client_address,
+                                QuicStringPiece("hq"), _))
+      .WillOnce(testing::Return(CreateSession(
+          dispatcher_.get(), config_, TestConnectionId(1), client_address,
+          &mock_helper_, &mock_alarm_factory_, &crypto_config_,
+          QuicDispatcherPeer::GetCache(dispatcher_.get()), &session1_)));
+  EXPECT_CALL(*reinterpret_cast<MockQuicConnection*>(session1_->connection()),
+              ProcessUdpPacket(_, _, _))
+      .WillOnce(WithArg<2>(Invoke([this](const QuicEncryptedPacket& packet) {
+        ValidatePacket(TestConnectionId(1), packet);
+      })));
+  EXPECT_CALL(*dispatcher_,
+              ShouldCreateOrBufferPacketForConnection(TestConnectionId(1), _));
+  ProcessPacket(client_address, TestConnectionId(1), true, SerializeCHLO());
+  EXPECT_FALSE(session1_->connection()->processing_packet_batch());
+
+  // Packets of a batch for an existing session put its connection in batch
+  // mode until the end of the batch.
+  EXPECT_CALL(*reinterpret_cast<MockQuicConnection*>(session1_->connection()),
+              ProcessUdpPacket(_, _, _))
+      .Times(2)
+      .WillRepeatedly(
+          WithArg<2>(Invoke([this](const QuicEncryptedPacket& packet) {
+            ValidatePacket(TestConnectionId(1), packet);
+          })));
+  dispatcher_->OnPacketBatchStart();
+  ProcessPacket(client_address, TestConnectionId(1), false, "data");
+  EXPECT_TRUE(session1_->connection()->processing_packet_batch());
+  ProcessPacket(client_address, TestConnectionId(1), false, "data");
+  dispatcher_->OnPacketBatchEnd();
+  EXPECT_FALSE(session1_->connection()->processing_packet_batch());
+}
+
 // Regression test of b/93325907.
 TEST_F(QuicDispatcherTest, DispatcherDoesNotRejectPacketNumberZero) {
   QuicSocketAddress client_address(QuicIpAddress::Loopback4(), 1);
@@ -605,6 +642,33 @@ TEST_F(QuicDispatcherTest, NoVersionPacketToTimeWaitListManager) {
   ProcessPacket(client_address, connection_id, false, SerializeCHLO());
 }
 
+TEST_F(QuicDispatcherTest, CompactTimeWaitListSendsStatelessResets) {
+  CreateTimeWaitListManager();
+  dispatcher_->SetTimeWaitListCompactMode(true);
+  MockPacketWriter* writer = static_cast<MockPacketWriter*>(
+      QuicDispatcherPeer::GetWriter(dispatcher_.get()));
+
+  QuicSocketAddress client_address(QuicIpAddress::Loopback4(), 1);
+  QuicConnectionId connection_id = TestConnectionId(1);
+  // The connection ID is not stored, so each packet is answered with a
+  // stateless reset without going through ProcessPacket.
+  EXPECT_CALL(*dispatcher_, CreateQuicSession(_, _, QuicStringPiece("hq"), _))
+      .Times(0);
+  EXPECT_CALL(*time_wait_list_manager_, ProcessPacket(_, _, _, _)).Times(0);
+  EXPECT_CALL(*time_wait_list_manager_, AddConnectionIdToTimeWait(_, _, _, _))
+      .Times(2);
+  EXPECT_CALL(*writer, WritePacket(_, _, _, client_address, _))
+      .Times(2)
+      .WillRepeatedly(Return(WriteResult(WRITE_STATUS_OK, 1)));
+  ProcessPacket(client_address, connection_id, false, SerializeCHLO());
+  EXPECT_FALSE(
+      time_wait_list_manager_->IsConnectionIdInTimeWait(connection_id));
+  EXPECT_EQ(0u, time_wait_list_manager_->num_connections());
+
+  ProcessPacket(client_address, connection_id, false, "data");
+  EXPECT_EQ(0u, time_wait_list_manager_->num_connections());
+}
+
 TEST_F(QuicDispatcherTest, ProcessPacketWithZeroPort) {
   CreateTimeWaitListManager();
 
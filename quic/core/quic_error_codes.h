@@ -109,6 +109,8 @@ enum QuicErrorCode {
   QUIC_INVALID_ACK_DATA = 9,
   // Message frame data is malformed.
   QUIC_INVALID_MESSAGE_DATA = 112,
+  // FEC frame data is malformed.
+  QUIC_INVALID_FEC_DATA = 122,
 
   // Version negotiation packet is malformed.
   QUIC_INVALID_VERSION_NEGOTIATION_PACKET = 10,
@@ -329,7 +331,7 @@ enum QuicErrorCode {
   QUIC_STALE_CONNECTION_CANCELLED = 121,
 
   // No error. Used as bound while iterating.
-  QUIC_LAST_ERROR = 122,
+  QUIC_LAST_ERROR = 123,
 };
 // QuicErrorCodes is encoded as a single octet on-the-wire.
 static_assert(static_cast<int>(QUIC_LAST_ERROR) <=
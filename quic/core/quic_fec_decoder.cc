@@ -0,0 +1,91 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/quic_fec_decoder.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "net/third_party/quiche/src/quic/core/quic_constants.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+QuicFecDecoder::QuicFecDecoder() {}
+
+QuicFecDecoder::~QuicFecDecoder() {}
+
+void QuicFecDecoder::OnStreamFrameReceived(const QuicStreamFrame& frame) {
+  if (received_frames_.size() == kMaxFecReceivedStreamFrames) {
+    received_frames_.pop_front();
+  }
+  ReceivedStreamFrame received_frame;
+  received_frame.stream_id = frame.stream_id;
+  received_frame.offset = frame.offset;
+  if (frame.data_length > 0) {
+    received_frame.data.assign(frame.data_buffer, frame.data_length);
+  }
+  received_frames_.push_back(std::move(received_frame));
+}
+
+bool QuicFecDecoder::RecoverStreamFrame(const QuicFecFrame& frame,
+                                        QuicStreamFrame* recovered_frame) {
+  const QuicFecFrame::ProtectedStreamFrame* missing_frame = nullptr;
+  for (const QuicFecFrame::ProtectedStreamFrame& protected_frame :
+       frame.protected_frames) {
+    if (GetReceivedFrame(protected_frame) != nullptr) {
+      continue;
+    }
+    if (missing_frame != nullptr) {
+      QUIC_DVLOG(1) << "More than one protected frame is missing";
+      return false;
+    }
+    missing_frame = &protected_frame;
+  }
+  if (missing_frame == nullptr) {
+    return false;
+  }
+
+  // Only the part of the missing frame covered by |frame| can be rebuilt.
+  const size_t begin = frame.repair_offset;
+  const size_t end = std::min<size_t>(
+      missing_frame->data_length, begin + frame.repair_data.length());
+  if (begin >= end && !(missing_frame->fin && begin == 0)) {
+    return false;
+  }
+
+  recovered_data_.assign(frame.repair_data, 0, end - begin);
+  for (const QuicFecFrame::ProtectedStreamFrame& protected_frame :
+       frame.protected_frames) {
+    if (&protected_frame == missing_frame) {
+      continue;
+    }
+    const QuicString& data = GetReceivedFrame(protected_frame)->data;
+    const size_t data_end = std::min(end, data.length());
+    for (size_t i = begin; i < data_end; ++i) {
+      recovered_data_[i - begin] ^= data[i];
+    }
+  }
+
+  *recovered_frame = QuicStreamFrame(
+      missing_frame->stream_id,
+      missing_frame->fin && end == missing_frame->data_length,
+      missing_frame->offset + begin, recovered_data_.data(),
+      static_cast<QuicPacketLength>(recovered_data_.length()));
+  return true;
+}
+
+const QuicFecDecoder::ReceivedStreamFrame* QuicFecDecoder::GetReceivedFrame(
+    const QuicFecFrame::ProtectedStreamFrame& frame) const {
+  for (const ReceivedStreamFrame& received_frame : received_frames_) {
+    if (received_frame.stream_id == frame.stream_id &&
+        received_frame.offset == frame.offset &&
+        received_frame.data.length() == frame.data_length) {
+      return &received_frame;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace quic
@@ -0,0 +1,54 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_FEC_DECODER_H_
+#define QUICHE_QUIC_CORE_QUIC_FEC_DECODER_H_
+
+#include "net/third_party/quiche/src/quic/core/frames/quic_fec_frame.h"
+#include "net/third_party/quiche/src/quic/core/frames/quic_stream_frame.h"
+#include "net/third_party/quiche/src/quic/core/quic_types.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_containers.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
+
+namespace quic {
+
+// Keeps copies of the most recently received stream frames and uses them to
+// rebuild a lost stream frame from the FEC frames which protect it.
+class QUIC_EXPORT_PRIVATE QuicFecDecoder {
+ public:
+  QuicFecDecoder();
+  QuicFecDecoder(const QuicFecDecoder&) = delete;
+  QuicFecDecoder& operator=(const QuicFecDecoder&) = delete;
+  ~QuicFecDecoder();
+
+  // Keeps a copy of |frame|, dropping the oldest copy once
+  // kMaxFecReceivedStreamFrames are held.
+  void OnStreamFrameReceived(const QuicStreamFrame& frame);
+
+  // Returns true if exactly one of the frames protected by |frame| has not
+  // been received, in which case |recovered_frame| is set to the part of it
+  // which |frame| repairs. The data of |recovered_frame| is owned by the
+  // decoder and is valid until the next call.
+  bool RecoverStreamFrame(const QuicFecFrame& frame,
+                          QuicStreamFrame* recovered_frame);
+
+ private:
+  struct ReceivedStreamFrame {
+    QuicStreamId stream_id;
+    QuicStreamOffset offset;
+    QuicString data;
+  };
+
+  // Returns the received copy of |frame|, or nullptr if there is none.
+  const ReceivedStreamFrame* GetReceivedFrame(
+      const QuicFecFrame::ProtectedStreamFrame& frame) const;
+
+  QuicDeque<ReceivedStreamFrame> received_frames_;
+  QuicString recovered_data_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_FEC_DECODER_H_
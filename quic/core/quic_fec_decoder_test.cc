@@ -0,0 +1,113 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/quic_fec_decoder.h"
+
+#include "net/third_party/quiche/src/quic/core/quic_constants.h"
+#include "net/third_party/quiche/src/quic/core/quic_fec_encoder.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+const QuicTransportVersion kVersion = QUIC_VERSION_46;
+const QuicStreamId kStreamId = 5;
+
+class QuicFecDecoderTest : public QuicTest {
+ protected:
+  QuicFecDecoderTest()
+      : frames_({QuicStreamFrame(kStreamId, false, 0, "abcdef"),
+                 QuicStreamFrame(kStreamId, false, 6, "ghi"),
+                 QuicStreamFrame(kStreamId, true, 9, "jklm")}) {}
+
+  // Sends all frames and returns the repair frames of at most
+  // |max_frame_length| bytes protecting them.
+  std::vector<QuicFecFrame> Encode(QuicByteCount max_frame_length) {
+    QuicFecEncoder encoder;
+    for (const QuicStreamFrame& frame : frames_) {
+      EXPECT_TRUE(encoder.OnStreamFrameSent(frame, nullptr));
+    }
+    return encoder.GenerateRepairFrames(kVersion, max_frame_length);
+  }
+
+  // Receives all frames but the one with index |lost|.
+  void ReceiveAllBut(size_t lost) {
+    for (size_t i = 0; i < frames_.size(); ++i) {
+      if (i != lost) {
+        decoder_.OnStreamFrameReceived(frames_[i]);
+      }
+    }
+  }
+
+  std::vector<QuicStreamFrame> frames_;
+  QuicFecDecoder decoder_;
+};
+
+TEST_F(QuicFecDecoderTest, NothingToRecoverWhenAllReceived) {
+  std::vector<QuicFecFrame> repair_frames = Encode(kMaxPacketSize);
+  ASSERT_EQ(1u, repair_frames.size());
+  ReceiveAllBut(frames_.size());
+  QuicStreamFrame recovered_frame;
+  EXPECT_FALSE(decoder_.RecoverStreamFrame(repair_frames[0], &recovered_frame));
+}
+
+TEST_F(QuicFecDecoderTest, RecoversEachLostFrame) {
+  std::vector<QuicFecFrame> repair_frames = Encode(kMaxPacketSize);
+  ASSERT_EQ(1u, repair_frames.size());
+  for (size_t lost = 0; lost < frames_.size(); ++lost) {
+    QuicFecDecoder decoder;
+    for (size_t i = 0; i < frames_.size(); ++i) {
+      if (i != lost) {
+        decoder.OnStreamFrameReceived(frames_[i]);
+      }
+    }
+    QuicStreamFrame recovered_frame;
+    ASSERT_TRUE(decoder.RecoverStreamFrame(repair_frames[0], &recovered_frame));
+    EXPECT_EQ(frames_[lost].stream_id, recovered_frame.stream_id);
+    EXPECT_EQ(frames_[lost].offset, recovered_frame.offset);
+    EXPECT_EQ(frames_[lost].fin, recovered_frame.fin);
+    EXPECT_EQ(QuicStringPiece(frames_[lost].data_buffer,
+                              frames_[lost].data_length),
+              QuicStringPiece(recovered_frame.data_buffer,
+                              recovered_frame.data_length));
+  }
+}
+
+TEST_F(QuicFecDecoderTest, CannotRecoverTwoLostFrames) {
+  std::vector<QuicFecFrame> repair_frames = Encode(kMaxPacketSize);
+  ASSERT_EQ(1u, repair_frames.size());
+  decoder_.OnStreamFrameReceived(frames_[0]);
+  QuicStreamFrame recovered_frame;
+  EXPECT_FALSE(decoder_.RecoverStreamFrame(repair_frames[0], &recovered_frame));
+}
+
+TEST_F(QuicFecDecoderTest, RecoversSliceFromPartialRepair) {
+  // Leaves room for a few bytes of repair data per frame.
+  const QuicByteCount kMaxFrameLength = 20;
+  std::vector<QuicFecFrame> repair_frames = Encode(kMaxFrameLength);
+  ASSERT_LT(1u, repair_frames.size());
+  // Lose the frame carrying the FIN, which is shorter than the first frame.
+  ReceiveAllBut(2);
+
+  QuicString recovered;
+  bool fin = false;
+  for (const QuicFecFrame& repair_frame : repair_frames) {
+    QuicStreamFrame recovered_frame;
+    if (!decoder_.RecoverStreamFrame(repair_frame, &recovered_frame)) {
+      // Repairs beyond the end of the lost frame rebuild nothing.
+      EXPECT_LE(frames_[2].data_length, repair_frame.repair_offset);
+      continue;
+    }
+    EXPECT_EQ(frames_[2].offset + recovered.length(), recovered_frame.offset);
+    recovered.append(recovered_frame.data_buffer, recovered_frame.data_length);
+    fin = recovered_frame.fin;
+  }
+  EXPECT_EQ("jklm", recovered);
+  EXPECT_TRUE(fin);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
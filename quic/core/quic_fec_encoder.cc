@@ -0,0 +1,104 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/quic_fec_encoder.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "net/third_party/quiche/src/quic/core/quic_constants.h"
+#include "net/third_party/quiche/src/quic/core/quic_data_writer.h"
+#include "net/third_party/quiche/src/quic/core/quic_framer.h"
+#include "net/third_party/quiche/src/quic/core/quic_stream_frame_data_producer.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+QuicFecEncoder::QuicFecEncoder() {}
+
+QuicFecEncoder::~QuicFecEncoder() {}
+
+bool QuicFecEncoder::OnStreamFrameSent(
+    const QuicStreamFrame& frame,
+    QuicStreamFrameDataProducer* data_producer) {
+  SentStreamFrame sent_frame;
+  sent_frame.frame.stream_id = frame.stream_id;
+  sent_frame.frame.offset = frame.offset;
+  sent_frame.frame.data_length = frame.data_length;
+  sent_frame.frame.fin = frame.fin;
+  if (frame.data_buffer != nullptr) {
+    sent_frame.data.assign(frame.data_buffer, frame.data_length);
+  } else if (frame.data_length > 0) {
+    if (data_producer == nullptr) {
+      return false;
+    }
+    sent_frame.data.resize(frame.data_length);
+    QuicDataWriter writer(sent_frame.data.length(), &sent_frame.data[0]);
+    if (data_producer->WriteStreamData(frame.stream_id, frame.offset,
+                                       frame.data_length,
+                                       &writer) != WRITE_SUCCESS) {
+      QUIC_DVLOG(1) << "Unable to retrieve data of " << frame;
+      return false;
+    }
+  }
+
+  if (protected_frames_.size() == kMaxFecProtectedStreamFrames) {
+    protected_frames_.pop_front();
+  }
+  protected_frames_.push_back(std::move(sent_frame));
+  return true;
+}
+
+std::vector<QuicFecFrame> QuicFecEncoder::GenerateRepairFrames(
+    QuicTransportVersion version,
+    QuicByteCount max_frame_length) {
+  std::vector<QuicFecFrame> repair_frames;
+  if (protected_frames_.empty()) {
+    return repair_frames;
+  }
+
+  QuicFecFrame header;
+  QuicPacketLength max_data_length = 0;
+  for (const SentStreamFrame& sent_frame : protected_frames_) {
+    header.protected_frames.push_back(sent_frame.frame);
+    max_data_length = std::max(max_data_length, sent_frame.frame.data_length);
+  }
+  // Neither the repair offset nor the repair length exceed the longest frame.
+  const size_t header_length =
+      QuicFramer::GetFecFrameSize(version, header) -
+      2 * QuicDataWriter::GetVarInt62Len(0) +
+      2 * QuicDataWriter::GetVarInt62Len(max_data_length);
+  if (max_frame_length <= header_length) {
+    QUIC_DVLOG(1) << "No room for repair data in a frame of "
+                  << max_frame_length << " bytes";
+    protected_frames_.clear();
+    return repair_frames;
+  }
+  const QuicByteCount max_repair_length = max_frame_length - header_length;
+
+  // A repair of frames without data still lets a lost FIN be rebuilt.
+  QuicPacketLength repair_offset = 0;
+  do {
+    const QuicPacketLength repair_length =
+        static_cast<QuicPacketLength>(std::min<QuicByteCount>(
+            max_repair_length, max_data_length - repair_offset));
+    QuicFecFrame repair_frame(header);
+    repair_frame.repair_offset = repair_offset;
+    repair_frame.repair_data.assign(repair_length, '\0');
+    for (const SentStreamFrame& sent_frame : protected_frames_) {
+      const size_t end = std::min<size_t>(sent_frame.data.length(),
+                                          repair_offset + repair_length);
+      for (size_t i = repair_offset; i < end; ++i) {
+        repair_frame.repair_data[i - repair_offset] ^= sent_frame.data[i];
+      }
+    }
+    repair_frames.push_back(std::move(repair_frame));
+    repair_offset += repair_length;
+  } while (repair_offset < max_data_length);
+
+  protected_frames_.clear();
+  return repair_frames;
+}
+
+}  // namespace quic
@@ -0,0 +1,58 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_FEC_ENCODER_H_
+#define QUICHE_QUIC_CORE_QUIC_FEC_ENCODER_H_
+
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/core/frames/quic_fec_frame.h"
+#include "net/third_party/quiche/src/quic/core/frames/quic_stream_frame.h"
+#include "net/third_party/quiche/src/quic/core/quic_types.h"
+#include "net/third_party/quiche/src/quic/core/quic_versions.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_containers.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
+
+namespace quic {
+
+class QuicStreamFrameDataProducer;
+
+// Keeps copies of the most recently sent stream frames and builds FEC frames
+// which carry the XOR of their data.
+class QUIC_EXPORT_PRIVATE QuicFecEncoder {
+ public:
+  QuicFecEncoder();
+  QuicFecEncoder(const QuicFecEncoder&) = delete;
+  QuicFecEncoder& operator=(const QuicFecEncoder&) = delete;
+  ~QuicFecEncoder();
+
+  // Adds |frame| to the protected frames, dropping the oldest one once
+  // kMaxFecProtectedStreamFrames are held. The data is read from
+  // |frame.data_buffer| if it is set, otherwise from |data_producer|. Returns
+  // false if the data could not be retrieved.
+  bool OnStreamFrameSent(const QuicStreamFrame& frame,
+                         QuicStreamFrameDataProducer* data_producer);
+
+  // Returns the FEC frames protecting all frames added since the last call,
+  // each of which serializes to at most |max_frame_length| bytes in
+  // |version|, and forgets those frames.
+  std::vector<QuicFecFrame> GenerateRepairFrames(
+      QuicTransportVersion version,
+      QuicByteCount max_frame_length);
+
+  bool HasProtectedFrames() const { return !protected_frames_.empty(); }
+
+ private:
+  struct SentStreamFrame {
+    QuicFecFrame::ProtectedStreamFrame frame;
+    QuicString data;
+  };
+
+  QuicDeque<SentStreamFrame> protected_frames_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_FEC_ENCODER_H_
@@ -0,0 +1,100 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/quic_fec_encoder.h"
+
+#include "net/third_party/quiche/src/quic/core/quic_constants.h"
+#include "net/third_party/quiche/src/quic/core/quic_framer.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+const QuicTransportVersion kVersion = QUIC_VERSION_46;
+
+class QuicFecEncoderTest : public QuicTest {
+ protected:
+  void SendFrame(QuicStreamOffset offset, QuicStringPiece data, bool fin) {
+    EXPECT_TRUE(encoder_.OnStreamFrameSent(
+        QuicStreamFrame(kStreamId, fin, offset, data), nullptr));
+  }
+
+  const QuicStreamId kStreamId = 5;
+  QuicFecEncoder encoder_;
+};
+
+TEST_F(QuicFecEncoderTest, NoRepairWithoutFrames) {
+  EXPECT_FALSE(encoder_.HasProtectedFrames());
+  EXPECT_TRUE(encoder_.GenerateRepairFrames(kVersion, kMaxPacketSize).empty());
+}
+
+TEST_F(QuicFecEncoderTest, XorOfPaddedFrames) {
+  SendFrame(0, QuicString("\x01\x02\x03", 3), false);
+  SendFrame(3, QuicString("\x10\x20", 2), true);
+  EXPECT_TRUE(encoder_.HasProtectedFrames());
+
+  std::vector<QuicFecFrame> repair_frames =
+      encoder_.GenerateRepairFrames(kVersion, kMaxPacketSize);
+  ASSERT_EQ(1u, repair_frames.size());
+  const QuicFecFrame& repair_frame = repair_frames[0];
+  ASSERT_EQ(2u, repair_frame.protected_frames.size());
+  EXPECT_EQ(0u, repair_frame.protected_frames[0].offset);
+  EXPECT_EQ(3u, repair_frame.protected_frames[0].data_length);
+  EXPECT_FALSE(repair_frame.protected_frames[0].fin);
+  EXPECT_EQ(3u, repair_frame.protected_frames[1].offset);
+  EXPECT_EQ(2u, repair_frame.protected_frames[1].data_length);
+  EXPECT_TRUE(repair_frame.protected_frames[1].fin);
+  EXPECT_EQ(0u, repair_frame.repair_offset);
+  EXPECT_EQ(QuicString("\x11\x22\x03", 3), repair_frame.repair_data);
+
+  // The protected frames are forgotten once repaired.
+  EXPECT_FALSE(encoder_.HasProtectedFrames());
+}
+
+TEST_F(QuicFecEncoderTest, OnlyProtectsMostRecentFrames) {
+  for (size_t i = 0; i < kMaxFecProtectedStreamFrames + 2; ++i) {
+    SendFrame(i, "a", false);
+  }
+  std::vector<QuicFecFrame> repair_frames =
+      encoder_.GenerateRepairFrames(kVersion, kMaxPacketSize);
+  ASSERT_EQ(1u, repair_frames.size());
+  ASSERT_EQ(kMaxFecProtectedStreamFrames,
+            repair_frames[0].protected_frames.size());
+  EXPECT_EQ(2u, repair_frames[0].protected_frames[0].offset);
+}
+
+TEST_F(QuicFecEncoderTest, SplitsRepairToFitFrameLength) {
+  const QuicString data(1000, 'a');
+  SendFrame(0, data, false);
+  SendFrame(data.length(), data, false);
+
+  const QuicByteCount kMaxFrameLength = 400;
+  std::vector<QuicFecFrame> repair_frames =
+      encoder_.GenerateRepairFrames(kVersion, kMaxFrameLength);
+  ASSERT_EQ(3u, repair_frames.size());
+  QuicPacketLength repair_offset = 0;
+  for (const QuicFecFrame& repair_frame : repair_frames) {
+    EXPECT_GE(kMaxFrameLength,
+              QuicFramer::GetFecFrameSize(kVersion, repair_frame));
+    EXPECT_EQ(repair_offset, repair_frame.repair_offset);
+    EXPECT_EQ(QuicString(repair_frame.repair_data.length(), '\0'),
+              repair_frame.repair_data);
+    repair_offset += repair_frame.repair_data.length();
+  }
+  EXPECT_EQ(data.length(), repair_offset);
+}
+
+TEST_F(QuicFecEncoderTest, FinOnlyFrame) {
+  SendFrame(10, QuicStringPiece(), true);
+  std::vector<QuicFecFrame> repair_frames =
+      encoder_.GenerateRepairFrames(kVersion, kMaxPacketSize);
+  ASSERT_EQ(1u, repair_frames.size());
+  EXPECT_TRUE(repair_frames[0].protected_frames[0].fin);
+  EXPECT_TRUE(repair_frames[0].repair_data.empty());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
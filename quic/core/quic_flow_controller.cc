@@ -37,10 +37,13 @@ QuicFlowController::QuicFlowController(
       highest_received_byte_offset_(0),
       receive_window_offset_(receive_window_offset),
       receive_window_size_(receive_window_offset),
+      min_receive_window_size_(receive_window_offset),
+      receive_window_budget_(0),
       auto_tune_receive_window_(should_auto_tune_receive_window),
       session_flow_controller_(session_flow_controller),
       last_blocked_send_window_offset_(0),
-      prev_window_update_time_(QuicTime::Zero()) {
+      prev_window_update_time_(QuicTime::Zero()),
+      prev_window_update_bytes_consumed_(0) {
   receive_window_size_limit_ = (id_ == kConnectionLevelId)
                                    ? kSessionReceiveWindowLimit
                                    : kStreamReceiveWindowLimit;
@@ -115,13 +118,19 @@ void QuicFlowController::MaybeIncreaseMaxWindowSize() {
   // once per RTT.  If a window update happens much faster than RTT, it implies
   // that the flow control window is imposing a bottleneck.  To prevent this,
   // this method will increase the receive window size (subject to a reasonable
-  // upper bound).  For simplicity this algorithm is deliberately asymmetric, in
-  // that it may increase window size but never decreases.
+  // upper bound).  Without a receive window budget, this algorithm is
+  // deliberately asymmetric for simplicity, in that it may increase window size
+  // but never decreases.  With a budget, the window is instead set from the
+  // bandwidth-delay product measured since the last update, so it also shrinks
+  // when the delivery rate drops; see SizeWindowFromBdp.
 
   // Keep track of timing between successive window updates.
   QuicTime now = connection_->clock()->ApproximateNow();
   QuicTime prev = prev_window_update_time_;
   prev_window_update_time_ = now;
+  const QuicByteCount bytes_consumed_since_last =
+      bytes_consumed_ - prev_window_update_bytes_consumed_;
+  prev_window_update_bytes_consumed_ = bytes_consumed_;
   if (!prev.IsInitialized()) {
     QUIC_DVLOG(1) << ENDPOINT << "first window update for stream " << id_;
     return;
@@ -131,6 +140,11 @@ void QuicFlowController::MaybeIncreaseMaxWindowSize() {
     return;
   }
 
+  if (session_->flow_controller()->receive_window_budget() > 0) {
+    SizeWindowFromBdp(now - prev, bytes_consumed_since_last);
+    return;
+  }
+
   // Get outbound RTT.
   QuicTime::Delta rtt =
       connection_->sent_packet_manager().GetRttStats()->smoothed_rtt();
@@ -175,6 +189,38 @@ void QuicFlowController::IncreaseWindowSize() {
       std::min(receive_window_size_, receive_window_size_limit_);
 }
 
+void QuicFlowController::SizeWindowFromBdp(QuicTime::Delta interval,
+                                           QuicByteCount bytes_consumed) {
+  const QuicTime::Delta min_rtt =
+      connection_->sent_packet_manager().GetRttStats()->min_rtt();
+  if (min_rtt.IsZero() || interval.IsZero()) {
+    return;
+  }
+
+  const QuicBandwidth delivery_rate =
+      QuicBandwidth::FromBytesAndTimeDelta(bytes_consumed, interval);
+  QuicByteCount window_size = kBdpReceiveWindowMultiplier *
+                              delivery_rate.ToBytesPerPeriod(min_rtt);
+  window_size = std::max(window_size, min_receive_window_size_);
+  window_size = std::min(window_size, receive_window_size_limit_);
+  window_size =
+      std::min(window_size, session_->flow_controller()->receive_window_budget());
+
+  QUIC_DVLOG(1) << ENDPOINT << "Sizing receive window for stream " << id_
+                << " to " << window_size << " for delivery rate "
+                << delivery_rate << " and min RTT " << min_rtt.ToMicroseconds()
+                << "us";
+  receive_window_size_ = window_size;
+}
+
+void QuicFlowController::SetReceiveWindowBudget(
+    QuicByteCount receive_window_budget) {
+  DCHECK_EQ(kConnectionLevelId, id_);
+  receive_window_budget_ = std::max(receive_window_budget, receive_window_size_);
+  receive_window_size_limit_ = receive_window_budget_;
+  auto_tune_receive_window_ = true;
+}
+
 QuicByteCount QuicFlowController::WindowUpdateThreshold() {
   return receive_window_size_ / 2;
 }
@@ -201,6 +247,11 @@ void QuicFlowController::MaybeSendWindowUpdate() {
   }
 
   MaybeIncreaseMaxWindowSize();
+  if (receive_window_size_ <= available_window) {
+    // The window was sized down from the bandwidth-delay product, and the
+    // available window still exceeds the new size.
+    return;
+  }
   UpdateReceiveWindowOffsetAndSendWindowUpdate(available_window);
 }
 
@@ -289,6 +340,7 @@ void QuicFlowController::UpdateReceiveWindowSize(QuicStreamOffset size) {
   }
   receive_window_size_ = size;
   receive_window_offset_ = size;
+  min_receive_window_size_ = size;
 }
 
 void QuicFlowController::SendWindowUpdate() {
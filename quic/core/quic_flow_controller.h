@@ -24,6 +24,13 @@ const QuicStreamId kConnectionLevelId = 0;
 // stream's flow control window.
 const float kSessionFlowControlMultiplier = 1.5;
 
+// With a receive window budget, the receive window is sized to this many times
+// the bytes consumed per min RTT.  A WINDOW_UPDATE is only sent once half of
+// the window has been consumed, so a window of twice the bandwidth-delay
+// product keeps the peer from blocking; the extra half lets a window which
+// limits the delivery rate grow.
+const float kBdpReceiveWindowMultiplier = 3;
+
 class QUIC_EXPORT_PRIVATE QuicFlowControllerInterface {
  public:
   virtual ~QuicFlowControllerInterface() {}
@@ -106,13 +113,25 @@ class QUIC_EXPORT_PRIVATE QuicFlowController
 
   bool auto_tune_receive_window() { return auto_tune_receive_window_; }
 
+  // Sizes the receive windows of the session and of its streams from the
+  // bandwidth-delay product of the data they consume, instead of doubling
+  // them, and caps the session window, which bounds the data buffered by all
+  // streams, at |receive_window_budget|.  Must only be called on the
+  // connection level flow controller.
+  void SetReceiveWindowBudget(QuicByteCount receive_window_budget);
+
+  // Returns the budget set by SetReceiveWindowBudget(), or zero.
+  QuicByteCount receive_window_budget() const { return receive_window_budget_; }
+
  private:
   friend class test::QuicFlowControllerPeer;
 
   // Send a WINDOW_UPDATE frame if appropriate.
   void MaybeSendWindowUpdate();
 
-  // Auto-tune the max receive window size.
+  // Auto-tune the max receive window size.  It only grows, unless the session
+  // has a receive window budget, in which case it follows the measured
+  // bandwidth-delay product in both directions.
   void MaybeIncreaseMaxWindowSize();
 
   // Updates the current offset and sends a window update frame.
@@ -122,6 +141,12 @@ class QUIC_EXPORT_PRIVATE QuicFlowController
   // Double the window size as long as we haven't hit the max window size.
   void IncreaseWindowSize();
 
+  // Sets the window size to kBdpReceiveWindowMultiplier times the
+  // bandwidth-delay product of |bytes_consumed| over |interval|, within the
+  // initial window size and the session's receive window budget.
+  void SizeWindowFromBdp(QuicTime::Delta interval,
+                         QuicByteCount bytes_consumed);
+
   // The parent session/connection, used to send connection close on flow
   // control violation, and WINDOW_UPDATE and BLOCKED frames when appropriate.
   // Not owned.
@@ -180,6 +205,14 @@ class QUIC_EXPORT_PRIVATE QuicFlowController
   // Upper limit on receive_window_size_;
   QuicByteCount receive_window_size_limit_;
 
+  // Lower limit on receive_window_size_ when it is sized from the
+  // bandwidth-delay product; the initial window size.
+  QuicByteCount min_receive_window_size_;
+
+  // Upper limit on the session's receive window, or zero if windows are
+  // auto-tuned by doubling.  Only set on the connection level flow controller.
+  QuicByteCount receive_window_budget_;
+
   // Used to dynamically enable receive window auto-tuning.
   bool auto_tune_receive_window_;
 
@@ -197,6 +230,9 @@ class QUIC_EXPORT_PRIVATE QuicFlowController
   // Keep time of the last time a window update was sent.  We use this
   // as part of the receive window auto tuning.
   QuicTime prev_window_update_time_;
+
+  // The value of bytes_consumed_ at prev_window_update_time_.
+  QuicByteCount prev_window_update_bytes_consumed_;
 };
 
 }  // namespace quic
@@ -409,5 +409,56 @@ TEST_F(QuicFlowControllerTest, ReceivingBytesNormalNoAutoTune) {
   EXPECT_EQ(new_threshold, threshold);
 }
 
+TEST_F(QuicFlowControllerTest, ReceiveWindowSizedFromBdp) {
+  should_auto_tune_receive_window_ = true;
+  Initialize();
+  session_->flow_controller()->SetReceiveWindowBudget(4 * receive_window_);
+  // This test will generate two WINDOW_UPDATE frames.
+  EXPECT_CALL(*connection_, SendControlFrame(_))
+      .Times(2)
+      .WillRepeatedly(Invoke(this, &QuicFlowControllerTest::ClearControlFrame));
+  // The budget bounds the session window, so streams do not grow it.
+  EXPECT_CALL(session_flow_controller_, EnsureWindowAtLeast(_)).Times(0);
+
+  // Make sure clock is inititialized.
+  connection_->AdvanceTime(QuicTime::Delta::FromMilliseconds(1));
+
+  QuicSentPacketManager* manager =
+      QuicConnectionPeer::GetSentPacketManager(connection_);
+  RttStats* rtt_stats = const_cast<RttStats*>(manager->GetRttStats());
+  rtt_stats->UpdateRtt(QuicTime::Delta::FromMilliseconds(kRtt),
+                       QuicTime::Delta::Zero(), QuicTime::Zero());
+
+  QuicByteCount threshold =
+      QuicFlowControllerPeer::WindowUpdateThreshold(flow_controller_.get());
+  QuicStreamOffset receive_offset = threshold + 1;
+  EXPECT_TRUE(flow_controller_->UpdateHighestReceivedOffset(receive_offset));
+  flow_controller_->AddBytesConsumed(threshold + 1);
+  EXPECT_EQ(threshold,
+            QuicFlowControllerPeer::WindowUpdateThreshold(flow_controller_.get()));
+
+  // Half of the window is consumed in a tenth of the min RTT, so the window
+  // is sized to the budget.
+  connection_->AdvanceTime(QuicTime::Delta::FromMilliseconds(kRtt / 10));
+  receive_offset += threshold + 1;
+  EXPECT_TRUE(flow_controller_->UpdateHighestReceivedOffset(receive_offset));
+  flow_controller_->AddBytesConsumed(threshold + 1);
+  EXPECT_FALSE(flow_controller_->FlowControlViolation());
+  EXPECT_EQ(2 * receive_window_,
+            QuicFlowControllerPeer::WindowUpdateThreshold(flow_controller_.get()));
+
+  // Consuming slowly sizes the window back down to the initial size, without a
+  // WINDOW_UPDATE while the available window exceeds it.
+  connection_->AdvanceTime(QuicTime::Delta::FromSeconds(100));
+  QuicByteCount new_threshold =
+      QuicFlowControllerPeer::WindowUpdateThreshold(flow_controller_.get());
+  receive_offset += new_threshold + 1;
+  EXPECT_TRUE(flow_controller_->UpdateHighestReceivedOffset(receive_offset));
+  flow_controller_->AddBytesConsumed(new_threshold + 1);
+  EXPECT_FALSE(flow_controller_->FlowControlViolation());
+  EXPECT_EQ(threshold,
+            QuicFlowControllerPeer::WindowUpdateThreshold(flow_controller_.get()));
+}
+
 }  // namespace test
 }  // namespace quic
@@ -470,6 +470,26 @@ size_t QuicFramer::GetMessageFrameSize(QuicTransportVersion version,
          length;
 }
 
+// static
+size_t QuicFramer::GetFecFrameSize(QuicTransportVersion version,
+                                   const QuicFecFrame& frame) {
+  QUIC_BUG_IF(version <= QUIC_VERSION_44)
+      << "Try to serialize FEC frame in " << version;
+  size_t size =
+      kQuicFrameTypeSize +
+      QuicDataWriter::GetVarInt62Len(frame.protected_frames.size());
+  for (const QuicFecFrame::ProtectedStreamFrame& protected_frame :
+       frame.protected_frames) {
+    size += QuicDataWriter::GetVarInt62Len(protected_frame.stream_id) +
+            QuicDataWriter::GetVarInt62Len(protected_frame.offset) +
+            QuicDataWriter::GetVarInt62Len(protected_frame.data_length) +
+            sizeof(uint8_t);
+  }
+  return size + QuicDataWriter::GetVarInt62Len(frame.repair_offset) +
+         QuicDataWriter::GetVarInt62Len(frame.repair_data.length()) +
+         frame.repair_data.length();
+}
+
 // static
 size_t QuicFramer::GetMinAckFrameSize(
     QuicTransportVersion version,
@@ -672,6 +692,7 @@ size_t QuicFramer::GetRetransmittableControlFrameSize(
     case PADDING_FRAME:
     case MESSAGE_FRAME:
     case CRYPTO_FRAME:
+    case FEC_FRAME:
     case NUM_FRAME_TYPES:
       DCHECK(false);
       return 0;
@@ -999,6 +1020,12 @@ size_t QuicFramer::BuildDataPacket(const QuicPacketHeader& header,
           return 0;
         }
         break;
+      case FEC_FRAME:
+        if (!AppendFecFrameAndTypeByte(*frame.fec_frame, &writer)) {
+          QUIC_BUG << "AppendFecFrame failed";
+          return 0;
+        }
+        break;
       case CRYPTO_FRAME:
         if (version_.transport_version < QUIC_VERSION_47) {
           set_detailed_error(
@@ -1168,6 +1195,12 @@ size_t QuicFramer::AppendIetfFrames(const QuicFrames& frames,
           return 0;
         }
         break;
+      case FEC_FRAME:
+        if (!AppendFecFrameAndTypeByte(*frame.fec_frame, writer)) {
+          QUIC_BUG << "AppendFecFrame failed: " << detailed_error();
+          return 0;
+        }
+        break;
       case CRYPTO_FRAME:
         if (!AppendCryptoFrame(*frame.crypto_frame, writer)) {
           QUIC_BUG << "AppendCryptoFrame failed: " << detailed_error();
@@ -1545,6 +1578,9 @@ bool QuicFramer::ProcessPacket(const QuicEncryptedPacket& packet) {
       rv = ProcessDataPacket(&reader, &header, packet, buffer, kMaxPacketSize);
     }
   } else {
+    // Packets larger than kMaxPacketSize are only sent on paths which path MTU
+    // discovery has found to carry them, so they are rare enough to decrypt
+    // into a heap buffer.
     std::unique_ptr<char[]> large_buffer(new char[packet.length()]);
     if (last_packet_is_ietf_quic) {
       rv = ProcessIetfDataPacket(&reader, &header, packet, large_buffer.get(),
@@ -1553,12 +1589,101 @@ bool QuicFramer::ProcessPacket(const QuicEncryptedPacket& packet) {
       rv = ProcessDataPacket(&reader, &header, packet, large_buffer.get(),
                              packet.length());
     }
-    QUIC_BUG_IF(rv) << "QUIC should never successfully process packets larger"
-                    << "than kMaxPacketSize. packet size:" << packet.length();
+    QUIC_BUG_IF(rv && packet.length() > kMaxJumboPacketSize)
+        << "QUIC should never successfully process packets larger "
+        << "than kMaxJumboPacketSize. packet size:" << packet.length();
   }
   return rv;
 }
 
+// static
+QuicErrorCode QuicFramer::ProcessPacketDispatcher(
+    const QuicEncryptedPacket& packet,
+    PacketHeaderFormat* format,
+    bool* version_flag,
+    QuicVersionLabel* version_label,
+    QuicConnectionId* destination_connection_id,
+    QuicString* detailed_error) {
+  QuicDataReader reader(packet.data(), packet.length());
+  *version_label = 0;
+  *destination_connection_id = QuicConnectionId();
+
+  uint8_t first_byte;
+  if (!reader.ReadUInt8(&first_byte)) {
+    *detailed_error = "Unable to read first byte.";
+    return QUIC_INVALID_PACKET_HEADER;
+  }
+
+  if (!QuicUtils::IsIetfPacketHeader(first_byte)) {
+    *format = GOOGLE_QUIC_PACKET;
+    *version_flag = (first_byte & PACKET_PUBLIC_FLAGS_VERSION) != 0;
+    const bool reset_flag = (first_byte & PACKET_PUBLIC_FLAGS_RST) != 0;
+    if (!*version_flag && first_byte > PACKET_PUBLIC_FLAGS_MAX) {
+      *detailed_error = "Illegal public flags value.";
+      return QUIC_INVALID_PACKET_HEADER;
+    }
+    if (reset_flag && *version_flag) {
+      *detailed_error = "Got version flag in reset packet";
+      return QUIC_INVALID_PACKET_HEADER;
+    }
+    if ((first_byte & PACKET_PUBLIC_FLAGS_8BYTE_CONNECTION_ID) ==
+            PACKET_PUBLIC_FLAGS_8BYTE_CONNECTION_ID &&
+        !reader.ReadConnectionId(destination_connection_id,
+                                 kQuicDefaultConnectionIdLength)) {
+      *detailed_error = "Unable to read ConnectionId.";
+      return QUIC_INVALID_PACKET_HEADER;
+    }
+    if (*version_flag) {
+      if (!reader.ReadTag(version_label)) {
+        *detailed_error = "Unable to read protocol version.";
+        return QUIC_INVALID_PACKET_HEADER;
+      }
+      *version_label = QuicEndian::NetToHost32(*version_label);
+    }
+    return QUIC_NO_ERROR;
+  }
+
+  if (!(first_byte & FLAGS_LONG_HEADER)) {
+    *format = IETF_QUIC_SHORT_HEADER_PACKET;
+    *version_flag = false;
+    if (!reader.ReadConnectionId(destination_connection_id,
+                                 kQuicDefaultConnectionIdLength)) {
+      *detailed_error = "Unable to read Destination ConnectionId.";
+      return QUIC_INVALID_PACKET_HEADER;
+    }
+    return QUIC_NO_ERROR;
+  }
+
+  *format = IETF_QUIC_LONG_HEADER_PACKET;
+  *version_flag = true;
+  if (!reader.ReadTag(version_label)) {
+    *detailed_error = "Unable to read protocol version.";
+    return QUIC_INVALID_PACKET_HEADER;
+  }
+  *version_label = QuicEndian::NetToHost32(*version_label);
+  uint8_t connection_id_length;
+  if (!reader.ReadUInt8(&connection_id_length)) {
+    *detailed_error = "Unable to read ConnectionId length.";
+    return QUIC_INVALID_PACKET_HEADER;
+  }
+  // Long header packets received by the server must carry an 8-byte
+  // destination connection ID and no source connection ID.
+  const uint8_t dcil =
+      (connection_id_length & kDestinationConnectionIdLengthMask) >> 4;
+  const uint8_t scil = connection_id_length & kSourceConnectionIdLengthMask;
+  if (dcil != PACKET_8BYTE_CONNECTION_ID - kConnectionIdLengthAdjustment ||
+      scil != 0) {
+    *detailed_error = "Invalid ConnectionId length.";
+    return QUIC_INVALID_PACKET_HEADER;
+  }
+  if (!reader.ReadConnectionId(destination_connection_id,
+                               kQuicDefaultConnectionIdLength)) {
+    *detailed_error = "Unable to read Destination ConnectionId.";
+    return QUIC_INVALID_PACKET_HEADER;
+  }
+  return QUIC_NO_ERROR;
+}
+
 bool QuicFramer::ProcessVersionNegotiationPacket(
     QuicDataReader* reader,
     const QuicPacketHeader& header) {
@@ -1815,7 +1940,7 @@ bool QuicFramer::ProcessIetfDataPacket(QuicDataReader* encrypted_reader,
     return true;
   }
 
-  if (packet.length() > kMaxPacketSize) {
+  if (packet.length() > kMaxJumboPacketSize) {
     // If the packet has gotten this far, it should not be too large.
     QUIC_BUG << "Packet too large:" << packet.length();
     return RaiseError(QUIC_PACKET_TOO_LARGE);
@@ -1890,7 +2015,7 @@ bool QuicFramer::ProcessDataPacket(QuicDataReader* encrypted_reader,
     return true;
   }
 
-  if (packet.length() > kMaxPacketSize) {
+  if (packet.length() > kMaxJumboPacketSize) {
     // If the packet has gotten this far, it should not be too large.
     QUIC_BUG << "Packet too large:" << packet.length();
     return RaiseError(QUIC_PACKET_TOO_LARGE);
@@ -2709,6 +2834,19 @@ bool QuicFramer::ProcessFrameData(QuicDataReader* reader,
         }
         break;
       }
+      case IETF_EXTENSION_FEC: {
+        QuicFecFrame fec_frame;
+        if (!ProcessFecFrame(reader, &fec_frame)) {
+          return RaiseError(QUIC_INVALID_FEC_DATA);
+        }
+        if (!visitor_->OnFecFrame(fec_frame)) {
+          QUIC_DVLOG(1) << ENDPOINT
+                        << "Visitor asked to stop further processing.";
+          // Returning true since there was no parsing error.
+          return true;
+        }
+        break;
+      }
       case CRYPTO_FRAME: {
         if (version_.transport_version < QUIC_VERSION_47) {
           set_detailed_error("Illegal frame type.");
@@ -3012,6 +3150,19 @@ bool QuicFramer::ProcessIetfFrameData(QuicDataReader* reader,
           }
           break;
         }
+        case IETF_EXTENSION_FEC: {
+          QuicFecFrame fec_frame;
+          if (!ProcessFecFrame(reader, &fec_frame)) {
+            return RaiseError(QUIC_INVALID_FEC_DATA);
+          }
+          if (!visitor_->OnFecFrame(fec_frame)) {
+            QUIC_DVLOG(1) << ENDPOINT
+                          << "Visitor asked to stop further processing.";
+            // Returning true since there was no parsing error.
+            return true;
+          }
+          break;
+        }
         case IETF_CRYPTO: {
           QuicCryptoFrame frame;
           if (!ProcessCryptoFrame(reader, &frame)) {
@@ -3468,6 +3619,13 @@ bool QuicFramer::ProcessIetfAckFrame(QuicDataReader* reader,
     set_detailed_error("Visitor suppresses further processing of ACK frame.");
     return false;
   }
+  if (ack_frame->ecn_counters_populated &&
+      !visitor_->OnAckEcnCounts(QuicEcnCounts(ack_frame->ect_0_count,
+                                              ack_frame->ect_1_count,
+                                              ack_frame->ecn_ce_count))) {
+    set_detailed_error("Visitor suppresses further processing of ACK frame.");
+    return false;
+  }
 
   // Get number of ACK blocks from the packet.
   uint64_t ack_block_count;
@@ -3746,6 +3904,66 @@ bool QuicFramer::ProcessMessageFrame(QuicDataReader* reader,
   return true;
 }
 
+bool QuicFramer::ProcessFecFrame(QuicDataReader* reader, QuicFecFrame* frame) {
+  uint64_t num_protected_frames;
+  if (!reader->ReadVarInt62(&num_protected_frames)) {
+    set_detailed_error("Unable to read number of protected frames.");
+    return false;
+  }
+  if (num_protected_frames == 0 ||
+      num_protected_frames > kMaxFecProtectedStreamFrames) {
+    set_detailed_error("Invalid number of protected frames.");
+    return false;
+  }
+
+  QuicPacketLength max_data_length = 0;
+  frame->protected_frames.reserve(num_protected_frames);
+  for (uint64_t i = 0; i < num_protected_frames; ++i) {
+    uint64_t stream_id;
+    uint64_t offset;
+    uint64_t data_length;
+    uint8_t fin;
+    if (!reader->ReadVarInt62(&stream_id) || !reader->ReadVarInt62(&offset) ||
+        !reader->ReadVarInt62(&data_length) || !reader->ReadUInt8(&fin)) {
+      set_detailed_error("Unable to read protected frame.");
+      return false;
+    }
+    if (stream_id > std::numeric_limits<QuicStreamId>::max() ||
+        data_length > std::numeric_limits<QuicPacketLength>::max()) {
+      set_detailed_error("Invalid protected frame.");
+      return false;
+    }
+    QuicFecFrame::ProtectedStreamFrame protected_frame;
+    protected_frame.stream_id = static_cast<QuicStreamId>(stream_id);
+    protected_frame.offset = offset;
+    protected_frame.data_length = static_cast<QuicPacketLength>(data_length);
+    protected_frame.fin = fin != 0;
+    max_data_length = std::max(max_data_length, protected_frame.data_length);
+    frame->protected_frames.push_back(protected_frame);
+  }
+
+  uint64_t repair_offset;
+  uint64_t repair_length;
+  if (!reader->ReadVarInt62(&repair_offset) ||
+      !reader->ReadVarInt62(&repair_length)) {
+    set_detailed_error("Unable to read repair data length.");
+    return false;
+  }
+  if (repair_offset + repair_length > max_data_length) {
+    set_detailed_error("Repair data exceeds protected frames.");
+    return false;
+  }
+  QuicStringPiece repair_data;
+  if (!reader->ReadStringPiece(&repair_data, repair_length)) {
+    set_detailed_error("Unable to read repair data.");
+    return false;
+  }
+  frame->repair_offset = static_cast<QuicPacketLength>(repair_offset);
+  frame->repair_data = QuicString(repair_data);
+
+  return true;
+}
+
 // static
 QuicStringPiece QuicFramer::GetAssociatedDataFromEncryptedPacket(
     QuicTransportVersion version,
@@ -4091,6 +4309,8 @@ size_t QuicFramer::ComputeFrameLength(
       return GetMessageFrameSize(version_.transport_version,
                                  last_frame_in_packet,
                                  frame.message_frame->message_length);
+    case FEC_FRAME:
+      return GetFecFrameSize(version_.transport_version, *frame.fec_frame);
     case PADDING_FRAME:
       DCHECK(false);
       return 0;
@@ -4156,6 +4376,7 @@ bool QuicFramer::AppendTypeByte(const QuicFrame& frame,
           "Attempt to append STOP_SENDING frame and not in version 99.");
       return RaiseError(QUIC_INTERNAL_ERROR);
     case MESSAGE_FRAME:
+    case FEC_FRAME:
       return true;
 
     default:
@@ -4259,6 +4480,7 @@ bool QuicFramer::AppendIetfTypeByte(const QuicFrame& frame,
       type_byte = IETF_STOP_SENDING;
       break;
     case MESSAGE_FRAME:
+    case FEC_FRAME:
       return true;
     case CRYPTO_FRAME:
       type_byte = IETF_CRYPTO;
@@ -5039,6 +5261,27 @@ bool QuicFramer::AppendMessageFrameAndTypeByte(const QuicMessageFrame& frame,
   return true;
 }
 
+bool QuicFramer::AppendFecFrameAndTypeByte(const QuicFecFrame& frame,
+                                           QuicDataWriter* writer) {
+  if (!writer->WriteUInt8(IETF_EXTENSION_FEC) ||
+      !writer->WriteVarInt62(frame.protected_frames.size())) {
+    return false;
+  }
+  for (const QuicFecFrame::ProtectedStreamFrame& protected_frame :
+       frame.protected_frames) {
+    if (!writer->WriteVarInt62(protected_frame.stream_id) ||
+        !writer->WriteVarInt62(protected_frame.offset) ||
+        !writer->WriteVarInt62(protected_frame.data_length) ||
+        !writer->WriteUInt8(protected_frame.fin ? 1 : 0)) {
+      return false;
+    }
+  }
+  return writer->WriteVarInt62(frame.repair_offset) &&
+         writer->WriteVarInt62(frame.repair_data.length()) &&
+         writer->WriteBytes(frame.repair_data.data(),
+                            frame.repair_data.length());
+}
+
 bool QuicFramer::RaiseError(QuicErrorCode error) {
   QUIC_DLOG(INFO) << ENDPOINT << "Error: " << QuicErrorCodeToString(error)
                   << " detail: " << detailed_error_;
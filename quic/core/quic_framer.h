@@ -132,6 +132,10 @@ class QUIC_EXPORT_PRIVATE QuicFramerVisitorInterface {
   virtual bool OnAckFrameStart(QuicPacketNumber largest_acked,
                                QuicTime::Delta ack_delay_time) = 0;
 
+  // Called when the ECN counts of an IETF ACK_ECN frame have been parsed,
+  // after OnAckFrameStart() and before the ack ranges.
+  virtual bool OnAckEcnCounts(const QuicEcnCounts& ecn_counts) = 0;
+
   // Called when ack range [start, end) of an AckFrame has been parsed.
   virtual bool OnAckRange(QuicPacketNumber start, QuicPacketNumber end) = 0;
 
@@ -195,6 +199,9 @@ class QUIC_EXPORT_PRIVATE QuicFramerVisitorInterface {
   // Called when a message frame has been parsed.
   virtual bool OnMessageFrame(const QuicMessageFrame& frame) = 0;
 
+  // Called when a FEC frame has been parsed.
+  virtual bool OnFecFrame(const QuicFecFrame& frame) = 0;
+
   // Called when a packet has been completely processed.
   virtual void OnPacketComplete() = 0;
 
@@ -287,6 +294,9 @@ class QUIC_EXPORT_PRIVATE QuicFramer {
   static size_t GetMessageFrameSize(QuicTransportVersion version,
                                     bool last_frame_in_packet,
                                     QuicByteCount length);
+  // Size in bytes of a FEC frame, including the type byte.
+  static size_t GetFecFrameSize(QuicTransportVersion version,
+                                const QuicFecFrame& frame);
   // Size in bytes of all ack frame fields without the missing packets or ack
   // blocks.
   static size_t GetMinAckFrameSize(
@@ -440,6 +450,22 @@ class QUIC_EXPORT_PRIVATE QuicFramer {
       QuicConnectionId connection_id,
       const ParsedQuicVersionVector& versions);
 
+  // Parses the invariant part of the header of |packet|, as received by a
+  // server, without the state or visitor of a QuicFramer.  On success, returns
+  // QUIC_NO_ERROR and fills in |format|, |version_flag|, |version_label| (0 if
+  // the packet carries no version) and |destination_connection_id| (empty if
+  // the packet does not carry one).  Otherwise returns
+  // QUIC_INVALID_PACKET_HEADER and fills in |detailed_error|.  This is cheap
+  // enough for the dispatcher to route every incoming packet with, and does
+  // not allocate unless it fails.
+  static QuicErrorCode ProcessPacketDispatcher(
+      const QuicEncryptedPacket& packet,
+      PacketHeaderFormat* format,
+      bool* version_flag,
+      QuicVersionLabel* version_label,
+      QuicConnectionId* destination_connection_id,
+      QuicString* detailed_error);
+
   // If header.version_flag is set, the version in the
   // packet will be set -- but it will be set from version_ not
   // header.versions.
@@ -549,6 +575,8 @@ class QUIC_EXPORT_PRIVATE QuicFramer {
     data_producer_ = data_producer;
   }
 
+  QuicStreamFrameDataProducer* data_producer() const { return data_producer_; }
+
   // Returns true if we are doing IETF-formatted packets.
   // In the future this could encompass a wide variety of
   // versions. Doing the test by name ("ietf format") rather
@@ -659,6 +687,7 @@ class QUIC_EXPORT_PRIVATE QuicFramer {
   bool ProcessMessageFrame(QuicDataReader* reader,
                            bool no_message_length,
                            QuicMessageFrame* frame);
+  bool ProcessFecFrame(QuicDataReader* reader, QuicFecFrame* frame);
 
   bool DecryptPayload(QuicStringPiece encrypted,
                       QuicStringPiece associated_data,
@@ -762,6 +791,8 @@ class QUIC_EXPORT_PRIVATE QuicFramer {
   bool AppendMessageFrameAndTypeByte(const QuicMessageFrame& frame,
                                      bool last_frame_in_packet,
                                      QuicDataWriter* writer);
+  bool AppendFecFrameAndTypeByte(const QuicFecFrame& frame,
+                                 QuicDataWriter* writer);
 
   // IETF frame processing methods.
   bool ProcessIetfStreamFrame(QuicDataReader* reader,
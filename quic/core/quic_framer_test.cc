@@ -248,6 +248,16 @@ class TestQuicVisitor : public QuicFramerVisitorInterface {
     return true;
   }
 
+  bool OnAckEcnCounts(const QuicEcnCounts& ecn_counts) override {
+    DCHECK(!ack_frames_.empty());
+    QuicAckFrame* ack_frame = ack_frames_[ack_frames_.size() - 1].get();
+    ack_frame->ecn_counters_populated = true;
+    ack_frame->ect_0_count = ecn_counts.ect0;
+    ack_frame->ect_1_count = ecn_counts.ect1;
+    ack_frame->ecn_ce_count = ecn_counts.ce;
+    return true;
+  }
+
   bool OnAckRange(QuicPacketNumber start, QuicPacketNumber end) override {
     DCHECK(!ack_frames_.empty());
     ack_frames_[ack_frames_.size() - 1]->packets.AddRange(start, end);
@@ -287,6 +297,12 @@ class TestQuicVisitor : public QuicFramerVisitorInterface {
     return true;
   }
 
+  bool OnFecFrame(const QuicFecFrame& frame) override {
+    ++frame_count_;
+    fec_frames_.push_back(QuicMakeUnique<QuicFecFrame>(frame));
+    return true;
+  }
+
   void OnPacketComplete() override { ++complete_packets_; }
 
   bool OnRstStreamFrame(const QuicRstStreamFrame& frame) override {
@@ -391,6 +407,7 @@ class TestQuicVisitor : public QuicFramerVisitorInterface {
   std::vector<std::unique_ptr<QuicPaddingFrame>> padding_frames_;
   std::vector<std::unique_ptr<QuicPingFrame>> ping_frames_;
   std::vector<std::unique_ptr<QuicMessageFrame>> message_frames_;
+  std::vector<std::unique_ptr<QuicFecFrame>> fec_frames_;
   std::vector<std::unique_ptr<QuicEncryptedPacket>> coalesced_packets_;
   QuicRstStreamFrame rst_stream_frame_;
   QuicConnectionCloseFrame connection_close_frame_;
@@ -785,7 +802,7 @@ TEST_P(QuicFramerTest, EmptyPacket) {
 
 TEST_P(QuicFramerTest, LargePacket) {
   // clang-format off
-  unsigned char packet[kMaxPacketSize + 1] = {
+  unsigned char packet[kMaxJumboPacketSize + 1] = {
     // public flags (8 byte connection_id)
     0x28,
     // connection_id
@@ -795,7 +812,7 @@ TEST_P(QuicFramerTest, LargePacket) {
     // private flags
     0x00,
   };
-  unsigned char packet44[kMaxPacketSize + 1] = {
+  unsigned char packet44[kMaxJumboPacketSize + 1] = {
     // type (short header 4 byte packet number)
     0x32,
     // connection_id
@@ -803,7 +820,7 @@ TEST_P(QuicFramerTest, LargePacket) {
     // packet number
     0x78, 0x56, 0x34, 0x12,
   };
-  unsigned char packet46[kMaxPacketSize + 1] = {
+  unsigned char packet46[kMaxJumboPacketSize + 1] = {
     // type (short header 4 byte packet number)
     0x43,
     // connection_id
@@ -828,10 +845,10 @@ TEST_P(QuicFramerTest, LargePacket) {
       !kIncludeDiversificationNonce, PACKET_4BYTE_PACKET_NUMBER,
       VARIABLE_LENGTH_INTEGER_LENGTH_0, 0, VARIABLE_LENGTH_INTEGER_LENGTH_0);
 
-  memset(p + header_size, 0, kMaxPacketSize - header_size);
+  memset(p + header_size, 0, kMaxJumboPacketSize - header_size);
 
   QuicEncryptedPacket encrypted(AsChars(p), p_size, false);
-  EXPECT_QUIC_BUG(framer_.ProcessPacket(encrypted), "Packet too large:1");
+  EXPECT_QUIC_BUG(framer_.ProcessPacket(encrypted), "Packet too large:8953");
 
   ASSERT_TRUE(visitor_.header_.get());
   // Make sure we've parsed the packet header, so we can send an error.
@@ -841,6 +858,60 @@ TEST_P(QuicFramerTest, LargePacket) {
   EXPECT_EQ(QUIC_PACKET_TOO_LARGE, framer_.error());
 }
 
+TEST_P(QuicFramerTest, JumboPacket) {
+  // A packet larger than kMaxPacketSize, as sent once path MTU discovery has
+  // found a path which carries jumbo frames, is processed normally.
+  // clang-format off
+  unsigned char packet[kMaxPacketSize + 100] = {
+    // public flags (8 byte connection_id)
+    0x28,
+    // connection_id
+    0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10,
+    // packet number
+    0x12, 0x34, 0x56, 0x78,
+  };
+  unsigned char packet44[kMaxPacketSize + 100] = {
+    // type (short header 4 byte packet number)
+    0x32,
+    // connection_id
+    0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10,
+    // packet number
+    0x12, 0x34, 0x56, 0x78,
+  };
+  unsigned char packet46[kMaxPacketSize + 100] = {
+    // type (short header 4 byte packet number)
+    0x43,
+    // connection_id
+    0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10,
+    // packet number
+    0x12, 0x34, 0x56, 0x78,
+  };
+  // clang-format on
+  unsigned char* p = packet;
+  size_t p_size = QUIC_ARRAYSIZE(packet);
+  if (framer_.transport_version() > QUIC_VERSION_44) {
+    p = packet46;
+    p_size = QUIC_ARRAYSIZE(packet46);
+  } else if (framer_.transport_version() > QUIC_VERSION_43) {
+    p = packet44;
+    p_size = QUIC_ARRAYSIZE(packet44);
+  }
+
+  const size_t header_size = GetPacketHeaderSize(
+      framer_.transport_version(), PACKET_8BYTE_CONNECTION_ID,
+      PACKET_0BYTE_CONNECTION_ID, !kIncludeVersion,
+      !kIncludeDiversificationNonce, PACKET_4BYTE_PACKET_NUMBER,
+      VARIABLE_LENGTH_INTEGER_LENGTH_0, 0, VARIABLE_LENGTH_INTEGER_LENGTH_0);
+
+  QuicEncryptedPacket encrypted(AsChars(p), p_size, false);
+  EXPECT_TRUE(framer_.ProcessPacket(encrypted));
+  EXPECT_EQ(QUIC_NO_ERROR, framer_.error());
+  ASSERT_TRUE(visitor_.header_.get());
+  ASSERT_EQ(1u, visitor_.padding_frames_.size());
+  EXPECT_EQ(static_cast<int>(p_size - header_size),
+            visitor_.padding_frames_[0]->num_padding_bytes);
+}
+
 TEST_P(QuicFramerTest, PacketHeader) {
   if (framer_.transport_version() > QUIC_VERSION_43) {
     return;
@@ -1508,6 +1579,134 @@ TEST_P(QuicFramerTest, LargePublicFlagWithMismatchedVersions) {
   EXPECT_EQ(5, visitor_.padding_frames_[0]->num_padding_bytes);
 }
 
+TEST_P(QuicFramerTest, ProcessPacketDispatcherGoogleQuic) {
+  // clang-format off
+  unsigned char packet[] = {
+    // public flags (version, 8 byte connection_id)
+    0x09,
+    // connection_id
+    0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10,
+    // version tag
+    'Q', '0', '4', '3',
+    // packet number
+    0x12, 0x34, 0x56, 0x78,
+  };
+  // clang-format on
+
+  QuicEncryptedPacket encrypted(AsChars(packet), QUIC_ARRAYSIZE(packet), false);
+  PacketHeaderFormat format;
+  bool version_flag;
+  QuicVersionLabel version_label;
+  QuicConnectionId destination_connection_id;
+  QuicString detailed_error;
+  EXPECT_EQ(QUIC_NO_ERROR,
+            QuicFramer::ProcessPacketDispatcher(
+                encrypted, &format, &version_flag, &version_label,
+                &destination_connection_id, &detailed_error));
+  EXPECT_EQ(GOOGLE_QUIC_PACKET, format);
+  EXPECT_TRUE(version_flag);
+  EXPECT_EQ(CreateQuicVersionLabel(
+                ParsedQuicVersion(PROTOCOL_QUIC_CRYPTO, QUIC_VERSION_43)),
+            version_label);
+  EXPECT_EQ(FramerTestConnectionId(), destination_connection_id);
+
+  // Without the version flag, the version is not read.
+  packet[0] = 0x08;
+  EXPECT_EQ(QUIC_NO_ERROR,
+            QuicFramer::ProcessPacketDispatcher(
+                encrypted, &format, &version_flag, &version_label,
+                &destination_connection_id, &detailed_error));
+  EXPECT_FALSE(version_flag);
+  EXPECT_EQ(0u, version_label);
+  EXPECT_EQ(FramerTestConnectionId(), destination_connection_id);
+
+  // Without a connection ID.
+  packet[0] = 0x00;
+  EXPECT_EQ(QUIC_NO_ERROR,
+            QuicFramer::ProcessPacketDispatcher(
+                encrypted, &format, &version_flag, &version_label,
+                &destination_connection_id, &detailed_error));
+  EXPECT_EQ(0u, destination_connection_id.length());
+
+  // Version flag in a public reset.
+  packet[0] = 0x0B;
+  EXPECT_EQ(QUIC_INVALID_PACKET_HEADER,
+            QuicFramer::ProcessPacketDispatcher(
+                encrypted, &format, &version_flag, &version_label,
+                &destination_connection_id, &detailed_error));
+  EXPECT_EQ("Got version flag in reset packet", detailed_error);
+}
+
+TEST_P(QuicFramerTest, ProcessPacketDispatcherIetfQuic) {
+  // clang-format off
+  unsigned char long_header_packet[] = {
+    // type (long header with packet type INITIAL)
+    0xC3,
+    // version tag
+    'Q', '0', '9', '9',
+    // connection_id length
+    0x50,
+    // connection_id
+    0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10,
+    // packet number
+    0x12, 0x34, 0x56, 0x78,
+  };
+  unsigned char short_header_packet[] = {
+    // type (short header, 4 byte packet number)
+    0x43,
+    // connection_id
+    0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10,
+    // packet number
+    0x12, 0x34, 0x56, 0x78,
+  };
+  // clang-format on
+
+  PacketHeaderFormat format;
+  bool version_flag;
+  QuicVersionLabel version_label;
+  QuicConnectionId destination_connection_id;
+  QuicString detailed_error;
+  QuicEncryptedPacket long_header(AsChars(long_header_packet),
+                                  QUIC_ARRAYSIZE(long_header_packet), false);
+  EXPECT_EQ(QUIC_NO_ERROR,
+            QuicFramer::ProcessPacketDispatcher(
+                long_header, &format, &version_flag, &version_label,
+                &destination_connection_id, &detailed_error));
+  EXPECT_EQ(IETF_QUIC_LONG_HEADER_PACKET, format);
+  EXPECT_TRUE(version_flag);
+  EXPECT_EQ(CreateQuicVersionLabel(
+                ParsedQuicVersion(PROTOCOL_QUIC_CRYPTO, QUIC_VERSION_99)),
+            version_label);
+  EXPECT_EQ(FramerTestConnectionId(), destination_connection_id);
+
+  QuicEncryptedPacket short_header(AsChars(short_header_packet),
+                                   QUIC_ARRAYSIZE(short_header_packet), false);
+  EXPECT_EQ(QUIC_NO_ERROR,
+            QuicFramer::ProcessPacketDispatcher(
+                short_header, &format, &version_flag, &version_label,
+                &destination_connection_id, &detailed_error));
+  EXPECT_EQ(IETF_QUIC_SHORT_HEADER_PACKET, format);
+  EXPECT_FALSE(version_flag);
+  EXPECT_EQ(0u, version_label);
+  EXPECT_EQ(FramerTestConnectionId(), destination_connection_id);
+
+  // A server never receives long headers with a source connection ID.
+  long_header_packet[5] = 0x05;
+  EXPECT_EQ(QUIC_INVALID_PACKET_HEADER,
+            QuicFramer::ProcessPacketDispatcher(
+                long_header, &format, &version_flag, &version_label,
+                &destination_connection_id, &detailed_error));
+  EXPECT_EQ("Invalid ConnectionId length.", detailed_error);
+
+  // Truncated connection ID.
+  QuicEncryptedPacket truncated(AsChars(short_header_packet), 5, false);
+  EXPECT_EQ(QUIC_INVALID_PACKET_HEADER,
+            QuicFramer::ProcessPacketDispatcher(
+                truncated, &format, &version_flag, &version_label,
+                &destination_connection_id, &detailed_error));
+  EXPECT_EQ("Unable to read Destination ConnectionId.", detailed_error);
+}
+
 TEST_P(QuicFramerTest, PaddingFrame) {
   // clang-format off
   unsigned char packet[] = {
@@ -4999,6 +5198,124 @@ TEST_P(QuicFramerTest, MessageFrame) {
       QUIC_INVALID_MESSAGE_DATA);
 }
 
+TEST_P(QuicFramerTest, FecFrame) {
+  if (framer_.transport_version() <= QUIC_VERSION_44) {
+    return;
+  }
+  // clang-format off
+  PacketFragments packet45 = {
+       // type (short header, 4 byte packet number)
+       {"",
+        {0x32}},
+       // connection_id
+       {"",
+        {0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10}},
+       // packet number
+       {"",
+        {0x12, 0x34, 0x56, 0x78}},
+       // FEC frame type.
+       {"",
+        { 0x22 }},
+       // number of protected frames
+       {"Unable to read number of protected frames.",
+        {0x02}},
+       // stream id, offset, data length and fin of the protected frames
+       {"Unable to read protected frame.",
+        {0x05, 0x00, 0x03, 0x00}},
+       {"Unable to read protected frame.",
+        {0x05, 0x03, 0x02, 0x01}},
+       // repair offset and length
+       {"Unable to read repair data length.",
+        {0x00, 0x03}},
+       // repair data
+       {"Unable to read repair data.",
+        {0x11, 0x22, 0x03}},
+   };
+
+  PacketFragments packet46 = {
+       // type (short header, 4 byte packet number)
+       {"",
+        {0x43}},
+       // connection_id
+       {"",
+        {0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10}},
+       // packet number
+       {"",
+        {0x12, 0x34, 0x56, 0x78}},
+       // FEC frame type.
+       {"",
+        { 0x22 }},
+       // number of protected frames
+       {"Unable to read number of protected frames.",
+        {0x02}},
+       // stream id, offset, data length and fin of the protected frames
+       {"Unable to read protected frame.",
+        {0x05, 0x00, 0x03, 0x00}},
+       {"Unable to read protected frame.",
+        {0x05, 0x03, 0x02, 0x01}},
+       // repair offset and length
+       {"Unable to read repair data length.",
+        {0x00, 0x03}},
+       // repair data
+       {"Unable to read repair data.",
+        {0x11, 0x22, 0x03}},
+   };
+  // clang-format on
+
+  std::unique_ptr<QuicEncryptedPacket> encrypted(AssemblePacketFromFragments(
+      framer_.transport_version() > QUIC_VERSION_44 ? packet46 : packet45));
+  EXPECT_TRUE(framer_.ProcessPacket(*encrypted));
+
+  EXPECT_EQ(QUIC_NO_ERROR, framer_.error());
+  ASSERT_TRUE(visitor_.header_.get());
+
+  ASSERT_EQ(1u, visitor_.fec_frames_.size());
+  const QuicFecFrame& frame = *visitor_.fec_frames_[0];
+  ASSERT_EQ(2u, frame.protected_frames.size());
+  EXPECT_EQ(5u, frame.protected_frames[0].stream_id);
+  EXPECT_EQ(0u, frame.protected_frames[0].offset);
+  EXPECT_EQ(3u, frame.protected_frames[0].data_length);
+  EXPECT_FALSE(frame.protected_frames[0].fin);
+  EXPECT_EQ(3u, frame.protected_frames[1].offset);
+  EXPECT_EQ(2u, frame.protected_frames[1].data_length);
+  EXPECT_TRUE(frame.protected_frames[1].fin);
+  EXPECT_EQ(0u, frame.repair_offset);
+  EXPECT_EQ(QuicString("\x11\x22\x03", 3), frame.repair_data);
+
+  CheckFramingBoundaries(
+      framer_.transport_version() > QUIC_VERSION_44 ? packet46 : packet45,
+      QUIC_INVALID_FEC_DATA);
+}
+
+TEST_P(QuicFramerTest, FecFrameRepairLongerThanProtectedFrames) {
+  if (framer_.transport_version() <= QUIC_VERSION_44) {
+    return;
+  }
+  // clang-format off
+  unsigned char packet[] = {
+    // type (short header, 4 byte packet number)
+    0x43,
+    // connection_id
+    0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10,
+    // packet number
+    0x12, 0x34, 0x56, 0x78,
+
+    // FEC frame type
+    0x22,
+    // one protected frame of 1 byte
+    0x01, 0x05, 0x00, 0x01, 0x00,
+    // 2 bytes of repair data
+    0x00, 0x02, 0x11, 0x22,
+  };
+  // clang-format on
+
+  QuicEncryptedPacket encrypted(AsChars(packet), QUIC_ARRAYSIZE(packet),
+                                false);
+  EXPECT_FALSE(framer_.ProcessPacket(encrypted));
+  EXPECT_EQ(QUIC_INVALID_FEC_DATA, framer_.error());
+  EXPECT_EQ("Repair data exceeds protected frames.", framer_.detailed_error());
+}
+
 TEST_P(QuicFramerTest, PublicResetPacketV33) {
   // clang-format off
   PacketFragments packet = {
@@ -8481,6 +8798,56 @@ TEST_P(QuicFramerTest, BuildMessagePacket) {
                                       QUIC_ARRAYSIZE(packet45));
 }
 
+TEST_P(QuicFramerTest, BuildFecPacket) {
+  if (framer_.transport_version() <= QUIC_VERSION_44) {
+    return;
+  }
+  QuicPacketHeader header;
+  header.destination_connection_id = FramerTestConnectionId();
+  header.reset_flag = false;
+  header.version_flag = false;
+  header.packet_number = kPacketNumber;
+
+  QuicFecFrame frame;
+  frame.protected_frames.push_back({5, 0, 3, false});
+  frame.protected_frames.push_back({5, 3, 2, true});
+  frame.repair_offset = 0;
+  frame.repair_data = QuicString("\x11\x22\x03", 3);
+  QuicFrames frames = {QuicFrame(&frame)};
+
+  // clang-format off
+  unsigned char packet[] = {
+    // type (short header, 4 byte packet number)
+    0x43,
+    // connection_id
+    0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10,
+    // packet number
+    0x12, 0x34, 0x56, 0x78,
+
+    // frame type (FEC frame)
+    0x22,
+    // number of protected frames
+    0x02,
+    // stream id, offset, data length and fin of the protected frames
+    0x05, 0x00, 0x03, 0x00,
+    0x05, 0x03, 0x02, 0x01,
+    // repair offset and length
+    0x00, 0x03,
+    // repair data
+    0x11, 0x22, 0x03,
+  };
+  // clang-format on
+
+  std::unique_ptr<QuicPacket> data(BuildDataPacket(header, frames));
+  ASSERT_TRUE(data != nullptr);
+  EXPECT_EQ(QUIC_ARRAYSIZE(packet) - 13,
+            QuicFramer::GetFecFrameSize(framer_.transport_version(), frame));
+
+  test::CompareCharArraysWithHexError("constructed packet", data->data(),
+                                      data->length(), AsChars(packet),
+                                      QUIC_ARRAYSIZE(packet));
+}
+
 // Test that the connectivity probing packet is serialized correctly as a
 // padded PING packet.
 TEST_P(QuicFramerTest, BuildConnectivityProbingPacket) {
@@ -124,6 +124,10 @@ class TestQuicVisitor : public QuicFramerVisitorInterface {
     return true;
   }
 
+  bool OnAckEcnCounts(const QuicEcnCounts& ecn_counts) override {
+    return true;
+  }
+
   bool OnAckRange(QuicPacketNumber start, QuicPacketNumber end) override {
     return true;
   }
@@ -145,6 +149,8 @@ class TestQuicVisitor : public QuicFramerVisitorInterface {
 
   bool OnMessageFrame(const QuicMessageFrame& frame) override { return true; }
 
+  bool OnFecFrame(const QuicFecFrame& frame) override { return true; }
+
   void OnPacketComplete() override {}
 
   bool OnRstStreamFrame(const QuicRstStreamFrame& frame) override {
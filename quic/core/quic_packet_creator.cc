@@ -67,6 +67,7 @@ QuicPacketCreator::QuicPacketCreator(QuicConnectionId connection_id,
       send_version_in_packet_(framer->perspective() == Perspective::IS_CLIENT),
       have_diversification_nonce_(false),
       max_packet_length_(0),
+      soft_max_packet_length_(0),
       connection_id_length_(PACKET_8BYTE_CONNECTION_ID),
       packet_size_(0),
       connection_id_(connection_id),
@@ -94,6 +95,7 @@ QuicPacketCreator::~QuicPacketCreator() {
 void QuicPacketCreator::SetEncrypter(EncryptionLevel level,
                                      std::unique_ptr<QuicEncrypter> encrypter) {
   framer_->SetEncrypter(level, std::move(encrypter));
+  soft_max_packet_length_ = 0;
   max_plaintext_size_ = framer_->GetMaxPlaintextSize(max_packet_length_);
 }
 
@@ -107,14 +109,42 @@ void QuicPacketCreator::SetMaxPacketLength(QuicByteCount length) {
 
   // Avoid recomputing |max_plaintext_size_| if the length does not actually
   // change.
-  if (length == max_packet_length_) {
+  if (length == max_packet_length_ && soft_max_packet_length_ == 0) {
     return;
   }
 
   max_packet_length_ = length;
+  soft_max_packet_length_ = 0;
   max_plaintext_size_ = framer_->GetMaxPlaintextSize(max_packet_length_);
 }
 
+void QuicPacketCreator::SetSoftMaxPacketLength(QuicByteCount length) {
+  if (!CanSetMaxPacketLength() || length >= max_packet_length_) {
+    return;
+  }
+  const size_t max_plaintext_size = framer_->GetMaxPlaintextSize(length);
+  if (max_plaintext_size <= PacketSize()) {
+    QUIC_DVLOG(1) << ENDPOINT << "Soft max packet length " << length
+                  << " cannot hold the packet header";
+    return;
+  }
+  soft_max_packet_length_ = length;
+  max_plaintext_size_ = max_plaintext_size;
+}
+
+bool QuicPacketCreator::HasSoftMaxPacketLength() const {
+  return soft_max_packet_length_ != 0;
+}
+
+bool QuicPacketCreator::RemoveSoftMaxPacketLength() {
+  if (!HasSoftMaxPacketLength() || !CanSetMaxPacketLength()) {
+    return false;
+  }
+  soft_max_packet_length_ = 0;
+  max_plaintext_size_ = framer_->GetMaxPlaintextSize(max_packet_length_);
+  return true;
+}
+
 // Stops serializing version of the protocol in packets sent after this call.
 // A packet that is already open might send kQuicVersionSize bytes less than the
 // maximum packet size if we stop sending version before it is serialized.
@@ -160,7 +190,9 @@ bool QuicPacketCreator::ConsumeCryptoData(EncryptionLevel level,
                                           QuicStreamOffset offset,
                                           TransmissionType transmission_type,
                                           QuicFrame* frame) {
-  if (!CreateCryptoFrame(level, write_length, offset, frame)) {
+  if (!CreateCryptoFrame(level, write_length, offset, frame) &&
+      (!RemoveSoftMaxPacketLength() ||
+       !CreateCryptoFrame(level, write_length, offset, frame))) {
     return false;
   }
   // When crypto data was sent in stream frames, ConsumeData is called with
@@ -214,14 +246,21 @@ bool QuicPacketCreator::ConsumeData(QuicStreamId id,
 bool QuicPacketCreator::HasRoomForStreamFrame(QuicStreamId id,
                                               QuicStreamOffset offset,
                                               size_t data_size) {
-  return BytesFree() >
-         QuicFramer::GetMinStreamFrameSize(framer_->transport_version(), id,
-                                           offset, true, data_size);
+  const size_t min_stream_frame_size = QuicFramer::GetMinStreamFrameSize(
+      framer_->transport_version(), id, offset, true, data_size);
+  if (BytesFree() > min_stream_frame_size) {
+    return true;
+  }
+  return RemoveSoftMaxPacketLength() && BytesFree() > min_stream_frame_size;
 }
 
 bool QuicPacketCreator::HasRoomForMessageFrame(QuicByteCount length) {
-  return BytesFree() >= QuicFramer::GetMessageFrameSize(
-                            framer_->transport_version(), true, length);
+  const size_t message_frame_size = QuicFramer::GetMessageFrameSize(
+      framer_->transport_version(), true, length);
+  if (BytesFree() >= message_frame_size) {
+    return true;
+  }
+  return RemoveSoftMaxPacketLength() && BytesFree() >= message_frame_size;
 }
 
 // TODO(fkastenholz): this method should not use constant values for
@@ -371,15 +410,29 @@ void QuicPacketCreator::Flush() {
   }
 
   QUIC_CACHELINE_ALIGNED char stack_buffer[kMaxPacketSize];
-  char* serialized_packet_buffer = delegate_->GetPacketBuffer();
-  if (serialized_packet_buffer == nullptr) {
-    serialized_packet_buffer = stack_buffer;
-  }
+  size_t buffer_len = 0;
+  char* serialized_packet_buffer =
+      GetSerializationBuffer(stack_buffer, &buffer_len);
 
-  SerializePacket(serialized_packet_buffer, kMaxPacketSize);
+  SerializePacket(serialized_packet_buffer, buffer_len);
   OnSerializedPacket();
 }
 
+char* QuicPacketCreator::GetSerializationBuffer(char* stack_buffer,
+                                                size_t* buffer_len) {
+  if (max_packet_length_ > kMaxPacketSize) {
+    // Neither the delegate's buffer nor the stack buffer can hold the packet.
+    if (large_packet_buffer_ == nullptr) {
+      large_packet_buffer_.reset(new char[kMaxJumboPacketSize]);
+    }
+    *buffer_len = kMaxJumboPacketSize;
+    return large_packet_buffer_.get();
+  }
+  *buffer_len = kMaxPacketSize;
+  char* buffer = delegate_->GetPacketBuffer();
+  return buffer == nullptr ? stack_buffer : buffer;
+}
+
 void QuicPacketCreator::OnSerializedPacket() {
   if (packet_.encrypted_buffer == nullptr) {
     const QuicString error_details = "Failed to SerializePacket.";
@@ -392,12 +445,15 @@ void QuicPacketCreator::OnSerializedPacket() {
 
   SerializedPacket packet(std::move(packet_));
   ClearPacket();
+  // The soft limit only applies to the packet which was just serialized.
+  RemoveSoftMaxPacketLength();
   delegate_->OnSerializedPacket(&packet);
 }
 
 void QuicPacketCreator::ClearPacket() {
   packet_.has_ack = false;
   packet_.has_stop_waiting = false;
+  packet_.has_fec = false;
   packet_.has_crypto_handshake = NOT_HANDSHAKE;
   packet_.num_padding_bytes = 0;
   packet_.original_packet_number.Clear();
@@ -425,12 +481,10 @@ void QuicPacketCreator::CreateAndSerializeStreamFrame(
   FillPacketHeader(&header);
 
   QUIC_CACHELINE_ALIGNED char stack_buffer[kMaxPacketSize];
-  char* encrypted_buffer = delegate_->GetPacketBuffer();
-  if (encrypted_buffer == nullptr) {
-    encrypted_buffer = stack_buffer;
-  }
+  size_t buffer_len = 0;
+  char* encrypted_buffer = GetSerializationBuffer(stack_buffer, &buffer_len);
 
-  QuicDataWriter writer(kMaxPacketSize, encrypted_buffer);
+  QuicDataWriter writer(buffer_len, encrypted_buffer);
   size_t length_field_offset = 0;
   if (!framer_->AppendPacketHeader(header, &writer, &length_field_offset)) {
     QUIC_BUG << "AppendPacketHeader failed";
@@ -480,7 +534,7 @@ void QuicPacketCreator::CreateAndSerializeStreamFrame(
   size_t encrypted_length = framer_->EncryptInPlace(
       packet_.encryption_level, packet_.packet_number,
       GetStartOfEncryptedData(framer_->transport_version(), header),
-      writer.length(), kMaxPacketSize, encrypted_buffer);
+      writer.length(), buffer_len, encrypted_buffer);
   if (encrypted_length == 0) {
     QUIC_BUG << "Failed to encrypt packet number " << header.packet_number;
     return;
@@ -640,7 +694,8 @@ QuicPacketCreator::SerializeConnectivityProbingPacket() {
   // FillPacketHeader increments packet_number_.
   FillPacketHeader(&header);
 
-  std::unique_ptr<char[]> buffer(new char[kMaxPacketSize]);
+  const size_t buffer_len = std::max(kMaxPacketSize, max_packet_length_);
+  std::unique_ptr<char[]> buffer(new char[buffer_len]);
   size_t length = framer_->BuildConnectivityProbingPacket(
       header, buffer.get(), max_plaintext_size_, packet_.encryption_level);
   DCHECK(length);
@@ -648,7 +703,7 @@ QuicPacketCreator::SerializeConnectivityProbingPacket() {
   const size_t encrypted_length = framer_->EncryptInPlace(
       packet_.encryption_level, packet_.packet_number,
       GetStartOfEncryptedData(framer_->transport_version(), header), length,
-      kMaxPacketSize, buffer.get());
+      buffer_len, buffer.get());
   DCHECK(encrypted_length);
 
   OwningSerializedPacketPointer serialize_packet(new SerializedPacket(
@@ -672,7 +727,8 @@ QuicPacketCreator::SerializePathChallengeConnectivityProbingPacket(
   // FillPacketHeader increments packet_number_.
   FillPacketHeader(&header);
 
-  std::unique_ptr<char[]> buffer(new char[kMaxPacketSize]);
+  const size_t buffer_len = std::max(kMaxPacketSize, max_packet_length_);
+  std::unique_ptr<char[]> buffer(new char[buffer_len]);
   size_t length = framer_->BuildPaddedPathChallengePacket(
       header, buffer.get(), max_plaintext_size_, payload, random_,
       packet_.encryption_level);
@@ -681,7 +737,7 @@ QuicPacketCreator::SerializePathChallengeConnectivityProbingPacket(
   const size_t encrypted_length = framer_->EncryptInPlace(
       packet_.encryption_level, packet_.packet_number,
       GetStartOfEncryptedData(framer_->transport_version(), header), length,
-      kMaxPacketSize, buffer.get());
+      buffer_len, buffer.get());
   DCHECK(encrypted_length);
 
   OwningSerializedPacketPointer serialize_packet(new SerializedPacket(
@@ -706,7 +762,8 @@ QuicPacketCreator::SerializePathResponseConnectivityProbingPacket(
   // FillPacketHeader increments packet_number_.
   FillPacketHeader(&header);
 
-  std::unique_ptr<char[]> buffer(new char[kMaxPacketSize]);
+  const size_t buffer_len = std::max(kMaxPacketSize, max_packet_length_);
+  std::unique_ptr<char[]> buffer(new char[buffer_len]);
   size_t length = framer_->BuildPathResponsePacket(
       header, buffer.get(), max_plaintext_size_, payloads, is_padded,
       packet_.encryption_level);
@@ -715,7 +772,7 @@ QuicPacketCreator::SerializePathResponseConnectivityProbingPacket(
   const size_t encrypted_length = framer_->EncryptInPlace(
       packet_.encryption_level, packet_.packet_number,
       GetStartOfEncryptedData(framer_->transport_version(), header), length,
-      kMaxPacketSize, buffer.get());
+      buffer_len, buffer.get());
   DCHECK(encrypted_length);
 
   OwningSerializedPacketPointer serialize_packet(new SerializedPacket(
@@ -876,6 +933,9 @@ bool QuicPacketCreator::AddFrame(const QuicFrame& frame,
   if (frame.type == STOP_WAITING_FRAME) {
     packet_.has_stop_waiting = true;
   }
+  if (frame.type == FEC_FRAME) {
+    packet_.has_fec = true;
+  }
   if (debug_delegate_ != nullptr) {
     debug_delegate_->OnFrameAddedToPacket(frame);
   }
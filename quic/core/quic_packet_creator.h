@@ -242,6 +242,21 @@ class QUIC_EXPORT_PRIVATE QuicPacketCreator {
   // Sets the maximum packet length.
   void SetMaxPacketLength(QuicByteCount length);
 
+  // Limits the next packet to |length| bytes, which must be less than the
+  // maximum packet length, so that it can be coalesced with packets which are
+  // already buffered for the same datagram.  The limit is dropped once that
+  // packet is serialized.  Ignored if a packet is being built, or if |length|
+  // cannot hold the packet header.
+  void SetSoftMaxPacketLength(QuicByteCount length);
+
+  // Returns true if the next packet is limited by SetSoftMaxPacketLength().
+  bool HasSoftMaxPacketLength() const;
+
+  // Drops the limit set by SetSoftMaxPacketLength(), for instance because a
+  // frame does not fit in it.  Returns false if there is no limit, or if a
+  // packet is being built.
+  bool RemoveSoftMaxPacketLength();
+
   // Increases pending_padding_bytes by |size|. Pending padding will be sent by
   // MaybeAddPadding().
   void AddPendingPadding(QuicByteCount size);
@@ -316,6 +331,12 @@ class QUIC_EXPORT_PRIVATE QuicPacketCreator {
   // Fails if |buffer_len| isn't long enough for the encrypted packet.
   void SerializePacket(char* encrypted_buffer, size_t buffer_len);
 
+  // Returns the buffer in which to serialize the next packet, and sets
+  // |buffer_len| to its length.  Uses the delegate's buffer, or |stack_buffer|
+  // of kMaxPacketSize bytes if the delegate has none, unless
+  // |max_packet_length_| exceeds kMaxPacketSize.
+  char* GetSerializationBuffer(char* stack_buffer, size_t* buffer_len);
+
   // Called after a new SerialiedPacket is created to call the delegate's
   // OnSerializedPacket and reset state.
   void OnSerializedPacket();
@@ -373,6 +394,8 @@ class QUIC_EXPORT_PRIVATE QuicPacketCreator {
   // Maximum length including headers and encryption (UDP payload length.)
   QuicByteCount max_packet_length_;
   size_t max_plaintext_size_;
+  // Length the next packet is limited to, or 0 if it is not limited.
+  QuicByteCount soft_max_packet_length_;
   // Length of connection_id to send over the wire. connection_id_length_ should
   // never be read directly, use GetConnectionIdLength() instead.
   QuicConnectionIdLength connection_id_length_;
@@ -417,6 +440,10 @@ class QUIC_EXPORT_PRIVATE QuicPacketCreator {
 
   // Latched value of gfe2_reloadable_flag_quic_encryption_driven_header_type.
   const bool encryption_level_driven_long_header_type_;
+
+  // Buffer of kMaxJumboPacketSize bytes in which packets larger than
+  // kMaxPacketSize are serialized.  Allocated on first use.
+  std::unique_ptr<char[]> large_packet_buffer_;
 };
 
 }  // namespace quic
@@ -1485,6 +1485,57 @@ TEST_P(QuicPacketCreatorTest, FlushWithExternalBuffer) {
   creator_.Flush();
 }
 
+TEST_P(QuicPacketCreatorTest, FlushJumboPacket) {
+  const QuicByteCount jumbo_packet_length = kMaxPacketSize + 1000;
+  creator_.SetMaxPacketLength(jumbo_packet_length);
+  // The delegate's buffer only holds kMaxPacketSize bytes.
+  EXPECT_CALL(delegate_, GetPacketBuffer()).Times(0);
+
+  QuicFrame frame;
+  MakeIOVector("test", &iov_);
+  ASSERT_TRUE(creator_.ConsumeData(
+      QuicUtils::GetCryptoStreamId(client_framer_.transport_version()), &iov_,
+      1u, iov_.iov_len, 0u, 0u, false,
+      /*needs_full_padding=*/true, NOT_RETRANSMISSION, &frame));
+
+  EXPECT_CALL(delegate_, OnSerializedPacket(_))
+      .WillOnce(Invoke(this, &QuicPacketCreatorTest::SaveSerializedPacket));
+  creator_.Flush();
+  EXPECT_EQ(jumbo_packet_length, serialized_packet_.encrypted_length);
+  DeleteSerializedPacket();
+}
+
+TEST_P(QuicPacketCreatorTest, SoftMaxPacketLength) {
+  const QuicByteCount max_packet_length = creator_.max_packet_length();
+  creator_.SetSoftMaxPacketLength(500);
+  EXPECT_TRUE(creator_.HasSoftMaxPacketLength());
+  EXPECT_EQ(max_packet_length, creator_.max_packet_length());
+
+  QuicFrame frame;
+  MakeIOVector("test", &iov_);
+  ASSERT_TRUE(creator_.ConsumeData(
+      QuicUtils::GetCryptoStreamId(client_framer_.transport_version()), &iov_,
+      1u, iov_.iov_len, 0u, 0u, false,
+      /*needs_full_padding=*/true, NOT_RETRANSMISSION, &frame));
+  EXPECT_CALL(delegate_, OnSerializedPacket(_))
+      .WillRepeatedly(Invoke(this, &QuicPacketCreatorTest::SaveSerializedPacket));
+  creator_.Flush();
+  // The packet is padded to the soft limit, which only applied to it.
+  EXPECT_EQ(500u, serialized_packet_.encrypted_length);
+  EXPECT_FALSE(creator_.HasSoftMaxPacketLength());
+  DeleteSerializedPacket();
+
+  // A stream frame which does not fit drops the soft limit.
+  const QuicByteCount encryption_overhead =
+      kMaxPacketSize - client_framer_.GetMaxPlaintextSize(kMaxPacketSize);
+  creator_.SetSoftMaxPacketLength(creator_.PacketSize() + encryption_overhead +
+                                  1);
+  EXPECT_TRUE(creator_.HasSoftMaxPacketLength());
+  EXPECT_TRUE(creator_.HasRoomForStreamFrame(
+      GetNthClientInitiatedStreamId(1), 0u, 100u));
+  EXPECT_FALSE(creator_.HasSoftMaxPacketLength());
+}
+
 // Test for error found in
 // https://bugs.chromium.org/p/chromium/issues/detail?id=859949 where a gap
 // length that crosses an IETF VarInt length boundary would cause a
@@ -233,6 +233,21 @@ void QuicPacketGenerator::GenerateMtuDiscoveryPacket(QuicByteCount target_mtu) {
   SetMaxPacketLength(current_mtu);
 }
 
+bool QuicPacketGenerator::GenerateFecPacket(QuicFecFrame* fec_frame) {
+  // Repair data is sized to fill a packet, so send it by itself.
+  packet_creator_.Flush();
+  // Repair packets take up congestion window like data does.
+  if (!delegate_->ShouldGeneratePacket(HAS_RETRANSMITTABLE_DATA,
+                                       NOT_HANDSHAKE)) {
+    return false;
+  }
+  const bool success = packet_creator_.AddSavedFrame(QuicFrame(fec_frame),
+                                                     next_transmission_type_);
+  packet_creator_.Flush();
+  QUIC_BUG_IF(!success) << "Failed to add FEC frame: " << *fec_frame;
+  return success;
+}
+
 bool QuicPacketGenerator::CanSendWithNextPendingFrameAddition() const {
   DCHECK(HasPendingFrames() || packet_creator_.pending_padding_bytes() > 0);
   HasRetransmittableData retransmittable =
@@ -252,6 +267,10 @@ void QuicPacketGenerator::SendQueuedFrames(bool flush) {
          (flush || CanSendWithNextPendingFrameAddition())) {
     bool first_frame = packet_creator_.CanSetMaxPacketLength();
     if (!AddNextPendingFrame() && first_frame) {
+      if (packet_creator_.RemoveSoftMaxPacketLength()) {
+        // The frame may fit in a packet of the full length.
+        continue;
+      }
       // A single frame cannot fit into the packet, tear down the connection.
       QUIC_BUG << "A single frame cannot fit into packet."
                << " should_send_ack: " << should_send_ack_
@@ -357,6 +376,14 @@ void QuicPacketGenerator::SetMaxPacketLength(QuicByteCount length) {
   packet_creator_.SetMaxPacketLength(length);
 }
 
+void QuicPacketGenerator::SetSoftMaxPacketLength(QuicByteCount length) {
+  packet_creator_.SetSoftMaxPacketLength(length);
+}
+
+void QuicPacketGenerator::RemoveSoftMaxPacketLength() {
+  packet_creator_.RemoveSoftMaxPacketLength();
+}
+
 std::unique_ptr<QuicEncryptedPacket>
 QuicPacketGenerator::SerializeVersionNegotiationPacket(
     bool ietf_quic,
@@ -123,6 +123,11 @@ class QUIC_EXPORT_PRIVATE QuicPacketGenerator {
   // Generates an MTU discovery packet of specified size.
   void GenerateMtuDiscoveryPacket(QuicByteCount target_mtu);
 
+  // Generates a packet carrying only |fec_frame|, which is not owned and is
+  // serialized before this returns. Returns false without generating the
+  // packet if the delegate cannot send data now.
+  bool GenerateFecPacket(QuicFecFrame* fec_frame);
+
   // Indicates whether packet flusher is currently attached.
   bool PacketFlusherAttached() const;
   // Attaches packet flusher.
@@ -208,6 +213,14 @@ class QUIC_EXPORT_PRIVATE QuicPacketGenerator {
   // when there are frames queued in the creator.
   void SetMaxPacketLength(QuicByteCount length);
 
+  // Limits the next packet to |length| bytes, so that it can be coalesced with
+  // buffered packets.  See QuicPacketCreator::SetSoftMaxPacketLength().
+  void SetSoftMaxPacketLength(QuicByteCount length);
+
+  // Drops the limit set by SetSoftMaxPacketLength() if no packet is being
+  // built.
+  void RemoveSoftMaxPacketLength();
+
   // Set transmission type of next constructed packets.
   void SetTransmissionType(TransmissionType type);
 
@@ -53,7 +53,7 @@ void QuicPacketReader::Initialize() {
     hdr->msg_iovlen = 1;
 
     hdr->msg_control = packets_[i].cbuf;
-    hdr->msg_controllen = kCmsgSpaceForReadPacket;
+    hdr->msg_controllen = sizeof(packets_[i].cbuf);
   }
 #endif
 }
@@ -88,7 +88,7 @@ bool QuicPacketReader::ReadAndDispatchManyPackets(
     msghdr* hdr = &mmsg_hdr_[i].msg_hdr;
     hdr->msg_namelen = sizeof(sockaddr_storage);
     DCHECK_EQ(1, hdr->msg_iovlen);
-    hdr->msg_controllen = kCmsgSpaceForReadPacket;
+    hdr->msg_controllen = sizeof(packets_[i].cbuf);
     hdr->msg_flags = 0;
   }
 
@@ -103,6 +103,7 @@ bool QuicPacketReader::ReadAndDispatchManyPackets(
       GetQuicReloadableFlag(quic_use_quic_time_for_received_timestamp);
   QuicTime fallback_timestamp(QuicTime::Zero());
   QuicWallTime fallback_walltimestamp = QuicWallTime::Zero();
+  processor->OnPacketBatchStart();
   for (int i = 0; i < packets_read; ++i) {
     if (mmsg_hdr_[i].msg_len == 0) {
       continue;
@@ -111,7 +112,7 @@ bool QuicPacketReader::ReadAndDispatchManyPackets(
     if (QUIC_PREDICT_FALSE(mmsg_hdr_[i].msg_hdr.msg_flags & MSG_CTRUNC)) {
       QUIC_BUG << "Incorrectly set control length: "
                << mmsg_hdr_[i].msg_hdr.msg_controllen << ", expected "
-               << kCmsgSpaceForReadPacket;
+               << sizeof(packets_[i].cbuf);
       continue;
     }
 
@@ -171,9 +172,11 @@ bool QuicPacketReader::ReadAndDispatchManyPackets(
     QuicReceivedPacket packet(reinterpret_cast<char*>(packets_[i].iov.iov_base),
                               mmsg_hdr_[i].msg_len, timestamp, false, ttl,
                               has_ttl, headers, headers_length, false);
+    packet.set_ecn_codepoint(GetEcnCodepointFromMsghdr(&mmsg_hdr_[i].msg_hdr));
     QuicSocketAddress self_address(self_ip, port);
     processor->ProcessPacket(self_address, peer_address, packet);
   }
+  processor->OnPacketBatchEnd();
 
   if (packets_dropped != nullptr) {
     QuicSocketUtils::GetOverflowFromMsghdr(&mmsg_hdr_[0].msg_hdr,
@@ -188,6 +191,48 @@ bool QuicPacketReader::ReadAndDispatchManyPackets(
 #endif
 }
 
+/* static */
+bool QuicPacketReader::EnableEcn(int fd, int address_family) {
+  int get_ecn = 1;
+  int ect0 = ECN_ECT0;
+  if (address_family == AF_INET) {
+    return setsockopt(fd, IPPROTO_IP, IP_RECVTOS, &get_ecn,
+                      sizeof(get_ecn)) == 0 &&
+           setsockopt(fd, IPPROTO_IP, IP_TOS, &ect0, sizeof(ect0)) == 0;
+  }
+  DCHECK_EQ(AF_INET6, address_family);
+  // Dual stack sockets use the IPv4 options for IPv4-mapped peers, which not
+  // all kernels support on IPv6 sockets.
+  setsockopt(fd, IPPROTO_IP, IP_RECVTOS, &get_ecn, sizeof(get_ecn));
+  setsockopt(fd, IPPROTO_IP, IP_TOS, &ect0, sizeof(ect0));
+  return setsockopt(fd, IPPROTO_IPV6, IPV6_RECVTCLASS, &get_ecn,
+                    sizeof(get_ecn)) == 0 &&
+         setsockopt(fd, IPPROTO_IPV6, IPV6_TCLASS, &ect0, sizeof(ect0)) == 0;
+}
+
+/* static */
+QuicEcnCodepoint QuicPacketReader::GetEcnCodepointFromMsghdr(msghdr* hdr) {
+  if (hdr->msg_controllen == 0) {
+    return ECN_NOT_ECT;
+  }
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(hdr); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(hdr, cmsg)) {
+    int tos;
+    if (cmsg->cmsg_level == IPPROTO_IP &&
+        (cmsg->cmsg_type == IP_TOS || cmsg->cmsg_type == IP_RECVTOS)) {
+      // Linux reports IP_TOS as a single byte.
+      tos = *reinterpret_cast<uint8_t*>(CMSG_DATA(cmsg));
+    } else if (cmsg->cmsg_level == IPPROTO_IPV6 &&
+               cmsg->cmsg_type == IPV6_TCLASS) {
+      memcpy(&tos, CMSG_DATA(cmsg), sizeof(tos));
+    } else {
+      continue;
+    }
+    return static_cast<QuicEcnCodepoint>(tos & 0x3);
+  }
+  return ECN_NOT_ECT;
+}
+
 /* static */
 bool QuicPacketReader::ReadAndDispatchSinglePacket(
     int fd,
@@ -195,7 +240,7 @@ bool QuicPacketReader::ReadAndDispatchSinglePacket(
     const QuicClock& clock,
     ProcessPacketInterface* processor,
     QuicPacketCount* packets_dropped) {
-  char buf[kMaxV4PacketSize];
+  char buf[kMaxJumboPacketSize];
 
   QuicSocketAddress peer_address;
   QuicIpAddress self_ip;
@@ -218,6 +263,8 @@ bool QuicPacketReader::ReadAndDispatchSinglePacket(
   }
   QuicTime timestamp = clock.ConvertWallTimeToQuicTime(walltimestamp);
 
+  // QuicSocketUtils::ReadPacket does not return the control messages, so the
+  // ECN codepoint is not available here.
   QuicReceivedPacket packet(buf, bytes_read, timestamp, false);
   QuicSocketAddress self_address(self_ip, port);
   processor->ProcessPacket(self_address, peer_address, packet);
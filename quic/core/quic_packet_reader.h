@@ -33,6 +33,10 @@ namespace quic {
 const int kNumPacketsPerReadMmsgCall = 16;
 #endif
 
+// Space for the IP_TOS or IPV6_TCLASS control message, which carries the ECN
+// codepoint of a received packet.
+const size_t kCmsgSpaceForEcn = CMSG_SPACE(sizeof(int));
+
 class QuicPacketReader {
  public:
   QuicPacketReader();
@@ -54,6 +58,15 @@ class QuicPacketReader {
                                       ProcessPacketInterface* processor,
                                       QuicPacketCount* packets_dropped);
 
+  // Marks the packets sent on |fd| ECT(0), and asks the kernel to report the
+  // ECN codepoint of received packets.  |address_family| is AF_INET or
+  // AF_INET6.  Returns false if either socket option could not be set.
+  static bool EnableEcn(int fd, int address_family);
+
+  // Returns the ECN codepoint carried by the IP_TOS or IPV6_TCLASS control
+  // message of |hdr|, or ECN_NOT_ECT if there is none.
+  static QuicEcnCodepoint GetEcnCodepointFromMsghdr(msghdr* hdr);
+
  private:
   // Initialize the internal state of the reader.
   void Initialize();
@@ -84,9 +97,10 @@ class QuicPacketReader {
     // call on the packets.
     struct sockaddr_storage raw_address;
     // cbuf is used for ancillary data from the kernel on recvmmsg.
-    char cbuf[kCmsgSpaceForReadPacket];
-    // buf is used for the data read from the kernel on recvmmsg.
-    char buf[kMaxV4PacketSize];
+    char cbuf[kCmsgSpaceForReadPacket + kCmsgSpaceForEcn];
+    // buf is used for the data read from the kernel on recvmmsg.  It holds
+    // packets of the largest size path MTU discovery can find.
+    char buf[kMaxJumboPacketSize];
   };
   PacketData packets_[kNumPacketsPerReadMmsgCall];
   mmsghdr mmsg_hdr_[kNumPacketsPerReadMmsgCall];
@@ -288,7 +288,8 @@ QuicReceivedPacket::QuicReceivedPacket(const char* buffer,
       ttl_(ttl_valid ? ttl : -1),
       packet_headers_(packet_headers),
       headers_length_(headers_length),
-      owns_header_buffer_(owns_header_buffer) {}
+      owns_header_buffer_(owns_header_buffer),
+      ecn_codepoint_(ECN_NOT_ECT) {}
 
 QuicReceivedPacket::~QuicReceivedPacket() {
   if (owns_header_buffer_) {
@@ -299,16 +300,19 @@ QuicReceivedPacket::~QuicReceivedPacket() {
 std::unique_ptr<QuicReceivedPacket> QuicReceivedPacket::Clone() const {
   char* buffer = new char[this->length()];
   memcpy(buffer, this->data(), this->length());
+  std::unique_ptr<QuicReceivedPacket> clone;
   if (this->packet_headers()) {
     char* headers_buffer = new char[this->headers_length()];
     memcpy(headers_buffer, this->packet_headers(), this->headers_length());
-    return QuicMakeUnique<QuicReceivedPacket>(
+    clone = QuicMakeUnique<QuicReceivedPacket>(
         buffer, this->length(), receipt_time(), true, ttl(), ttl() >= 0,
         headers_buffer, this->headers_length(), true);
+  } else {
+    clone = QuicMakeUnique<QuicReceivedPacket>(
+        buffer, this->length(), receipt_time(), true, ttl(), ttl() >= 0);
   }
-
-  return QuicMakeUnique<QuicReceivedPacket>(
-      buffer, this->length(), receipt_time(), true, ttl(), ttl() >= 0);
+  clone->set_ecn_codepoint(ecn_codepoint());
+  return clone;
 }
 
 std::ostream& operator<<(std::ostream& os, const QuicReceivedPacket& s) {
@@ -350,7 +354,9 @@ SerializedPacket::SerializedPacket(QuicPacketNumber packet_number,
       encryption_level(ENCRYPTION_NONE),
       has_ack(has_ack),
       has_stop_waiting(has_stop_waiting),
-      transmission_type(NOT_RETRANSMISSION) {}
+      has_fec(false),
+      transmission_type(NOT_RETRANSMISSION),
+      path_id(kDefaultPathId) {}
 
 SerializedPacket::SerializedPacket(const SerializedPacket& other) = default;
 
@@ -367,9 +373,11 @@ SerializedPacket::SerializedPacket(SerializedPacket&& other)
       encryption_level(other.encryption_level),
       has_ack(other.has_ack),
       has_stop_waiting(other.has_stop_waiting),
+      has_fec(other.has_fec),
       transmission_type(other.transmission_type),
       original_packet_number(other.original_packet_number),
-      largest_acked(other.largest_acked) {
+      largest_acked(other.largest_acked),
+      path_id(other.path_id) {
   retransmittable_frames.swap(other.retransmittable_frames);
 }
 
@@ -268,6 +268,13 @@ class QUIC_EXPORT_PRIVATE QuicReceivedPacket : public QuicEncryptedPacket {
   // Length of packet headers.
   int headers_length() const { return headers_length_; }
 
+  // The ECN codepoint in the IP header of the packet, or ECN_NOT_ECT if it is
+  // not known.
+  QuicEcnCodepoint ecn_codepoint() const { return ecn_codepoint_; }
+  void set_ecn_codepoint(QuicEcnCodepoint ecn_codepoint) {
+    ecn_codepoint_ = ecn_codepoint;
+  }
+
   // By default, gtest prints the raw bytes of an object. The bool data
   // member (in the base class QuicData) causes this object to have padding
   // bytes, which causes the default gtest object printer to read
@@ -285,6 +292,7 @@ class QUIC_EXPORT_PRIVATE QuicReceivedPacket : public QuicEncryptedPacket {
   int headers_length_;
   // Whether owns the buffer for packet headers.
   bool owns_header_buffer_;
+  QuicEcnCodepoint ecn_codepoint_;
 };
 
 struct QUIC_EXPORT_PRIVATE SerializedPacket {
@@ -313,11 +321,16 @@ struct QUIC_EXPORT_PRIVATE SerializedPacket {
   EncryptionLevel encryption_level;
   bool has_ack;
   bool has_stop_waiting;
+  // Whether the packet carries a FEC frame. Such packets have no
+  // retransmittable frames but are still congestion controlled.
+  bool has_fec;
   TransmissionType transmission_type;
   QuicPacketNumber original_packet_number;
   // The largest acked of the AckFrame in this packet if has_ack is true,
   // 0 otherwise.
   QuicPacketNumber largest_acked;
+  // The network path the packet is sent on.
+  QuicPathId path_id;
 };
 
 // Deletes and clears all the frames and the packet from serialized packet.
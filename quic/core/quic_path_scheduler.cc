@@ -0,0 +1,52 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/quic_path_scheduler.h"
+
+#include "net/third_party/quiche/src/quic/core/congestion_control/rtt_stats.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+QuicPathId MinRttPathScheduler::SelectPath(
+    const std::vector<PathInfo>& paths) {
+  DCHECK(!paths.empty());
+  const PathInfo* selected = nullptr;
+  for (const PathInfo& path : paths) {
+    if (selected == nullptr) {
+      selected = &path;
+      continue;
+    }
+    // A path which can send always wins over one which cannot.
+    if (path.can_send != selected->can_send) {
+      if (path.can_send) {
+        selected = &path;
+      }
+      continue;
+    }
+    if (path.rtt_stats->SmoothedOrInitialRtt() <
+        selected->rtt_stats->SmoothedOrInitialRtt()) {
+      selected = &path;
+    }
+  }
+  return selected->path_id;
+}
+
+RoundRobinPathScheduler::RoundRobinPathScheduler() : last_index_(0) {}
+
+QuicPathId RoundRobinPathScheduler::SelectPath(
+    const std::vector<PathInfo>& paths) {
+  DCHECK(!paths.empty());
+  for (size_t i = 1; i <= paths.size(); ++i) {
+    const size_t index = (last_index_ + i) % paths.size();
+    if (paths[index].can_send) {
+      last_index_ = index;
+      return paths[index].path_id;
+    }
+  }
+  // No path can send; wait for the next one in turn.
+  return paths[(last_index_ + 1) % paths.size()].path_id;
+}
+
+}  // namespace quic
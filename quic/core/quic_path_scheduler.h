@@ -0,0 +1,67 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_PATH_SCHEDULER_H_
+#define QUICHE_QUIC_CORE_QUIC_PATH_SCHEDULER_H_
+
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/core/quic_types.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+
+namespace quic {
+
+class RttStats;
+
+// Decides which network path a multipath connection sends its next
+// retransmittable packet on.
+class QUIC_EXPORT_PRIVATE QuicPathScheduler {
+ public:
+  struct QUIC_EXPORT_PRIVATE PathInfo {
+    QuicPathId path_id;
+    // Not owned.
+    const RttStats* rtt_stats;
+    // True if congestion control and pacing of the path allow sending now and
+    // its writer is not blocked.
+    bool can_send;
+  };
+
+  virtual ~QuicPathScheduler() {}
+
+  // Returns the path the next packet is sent on.  |paths| is never empty.  If
+  // no path can send, returns the path of |paths| which should be used once
+  // it can.
+  virtual QuicPathId SelectPath(const std::vector<PathInfo>& paths) = 0;
+};
+
+// Sends on the path with the lowest smoothed RTT which can send, so the slower
+// path only carries what the faster path's congestion window cannot.
+class QUIC_EXPORT_PRIVATE MinRttPathScheduler : public QuicPathScheduler {
+ public:
+  MinRttPathScheduler() = default;
+  MinRttPathScheduler(const MinRttPathScheduler&) = delete;
+  MinRttPathScheduler& operator=(const MinRttPathScheduler&) = delete;
+  ~MinRttPathScheduler() override {}
+
+  QuicPathId SelectPath(const std::vector<PathInfo>& paths) override;
+};
+
+// Alternates between the paths which can send.
+class QUIC_EXPORT_PRIVATE RoundRobinPathScheduler : public QuicPathScheduler {
+ public:
+  RoundRobinPathScheduler();
+  RoundRobinPathScheduler(const RoundRobinPathScheduler&) = delete;
+  RoundRobinPathScheduler& operator=(const RoundRobinPathScheduler&) = delete;
+  ~RoundRobinPathScheduler() override {}
+
+  QuicPathId SelectPath(const std::vector<PathInfo>& paths) override;
+
+ private:
+  // Index into |paths| of the last selection.
+  size_t last_index_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_PATH_SCHEDULER_H_
@@ -0,0 +1,55 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/quic_path_scheduler.h"
+
+#include "net/third_party/quiche/src/quic/core/congestion_control/rtt_stats.h"
+#include "net/third_party/quiche/src/quic/core/quic_constants.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+class QuicPathSchedulerTest : public QuicTest {
+ protected:
+  QuicPathSchedulerTest() {
+    fast_rtt_stats_.UpdateRtt(QuicTime::Delta::FromMilliseconds(20),
+                              QuicTime::Delta::Zero(), QuicTime::Zero());
+    slow_rtt_stats_.UpdateRtt(QuicTime::Delta::FromMilliseconds(100),
+                              QuicTime::Delta::Zero(), QuicTime::Zero());
+  }
+
+  std::vector<QuicPathScheduler::PathInfo> Paths(bool slow_path_can_send,
+                                                 bool fast_path_can_send) {
+    return {{kDefaultPathId, &slow_rtt_stats_, slow_path_can_send},
+            {kAlternativePathId, &fast_rtt_stats_, fast_path_can_send}};
+  }
+
+  RttStats fast_rtt_stats_;
+  RttStats slow_rtt_stats_;
+};
+
+TEST_F(QuicPathSchedulerTest, MinRttPrefersFastestPathThatCanSend) {
+  MinRttPathScheduler scheduler;
+  EXPECT_EQ(kAlternativePathId, scheduler.SelectPath(Paths(true, true)));
+  // Once the fast path is congestion limited, the slow path carries data.
+  EXPECT_EQ(kDefaultPathId, scheduler.SelectPath(Paths(true, false)));
+  EXPECT_EQ(kAlternativePathId, scheduler.SelectPath(Paths(false, true)));
+  EXPECT_EQ(kAlternativePathId, scheduler.SelectPath(Paths(false, false)));
+}
+
+TEST_F(QuicPathSchedulerTest, RoundRobinAlternates) {
+  RoundRobinPathScheduler scheduler;
+  EXPECT_EQ(kAlternativePathId, scheduler.SelectPath(Paths(true, true)));
+  EXPECT_EQ(kDefaultPathId, scheduler.SelectPath(Paths(true, true)));
+  EXPECT_EQ(kAlternativePathId, scheduler.SelectPath(Paths(true, true)));
+  // Paths which cannot send are skipped.
+  EXPECT_EQ(kAlternativePathId, scheduler.SelectPath(Paths(false, true)));
+  EXPECT_EQ(kDefaultPathId, scheduler.SelectPath(Paths(true, false)));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
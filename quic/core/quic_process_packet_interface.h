@@ -18,6 +18,12 @@ class ProcessPacketInterface {
   virtual void ProcessPacket(const QuicSocketAddress& self_address,
                              const QuicSocketAddress& peer_address,
                              const QuicReceivedPacket& packet) = 0;
+
+  // Called before and after a batch of packets read from the socket together
+  // is passed to ProcessPacket().  Processors may use these to do per-batch
+  // rather than per-packet work.
+  virtual void OnPacketBatchStart() {}
+  virtual void OnPacketBatchEnd() {}
 };
 
 }  // namespace quic
@@ -36,7 +36,8 @@ QuicReceivedPacketManager::~QuicReceivedPacketManager() {}
 
 void QuicReceivedPacketManager::RecordPacketReceived(
     const QuicPacketHeader& header,
-    QuicTime receipt_time) {
+    QuicTime receipt_time,
+    QuicEcnCodepoint ecn_codepoint) {
   const QuicPacketNumber packet_number = header.packet_number;
   DCHECK(IsAwaitingPacket(packet_number)) << " packet_number:" << packet_number;
   if (!ack_frame_updated_) {
@@ -63,6 +64,25 @@ void QuicReceivedPacketManager::RecordPacketReceived(
   }
   ack_frame_.packets.Add(packet_number);
 
+  // The counters are cumulative, and only sent once a packet was marked.
+  switch (ecn_codepoint) {
+    case ECN_NOT_ECT:
+      break;
+    case ECN_ECT0:
+      ack_frame_.ecn_counters_populated = true;
+      ++ack_frame_.ect_0_count;
+      break;
+    case ECN_ECT1:
+      ack_frame_.ecn_counters_populated = true;
+      ++ack_frame_.ect_1_count;
+      break;
+    case ECN_CE:
+      ack_frame_.ecn_counters_populated = true;
+      ++ack_frame_.ecn_ce_count;
+      ++stats_->ecn_ce_packets_received;
+      break;
+  }
+
   if (save_timestamps_) {
     // The timestamp format only handles packets in time order.
     if (!ack_frame_.received_packet_times.empty() &&
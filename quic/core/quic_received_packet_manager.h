@@ -31,8 +31,11 @@ class QUIC_EXPORT_PRIVATE QuicReceivedPacketManager {
   // Updates the internal state concerning which packets have been received.
   // header: the packet header.
   // timestamp: the arrival time of the packet.
+  // ecn_codepoint: the ECN codepoint in the IP header of the packet, which is
+  // counted in the ECN counters of the ack frame.
   virtual void RecordPacketReceived(const QuicPacketHeader& header,
-                                    QuicTime receipt_time);
+                                    QuicTime receipt_time,
+                                    QuicEcnCodepoint ecn_codepoint);
 
   // Checks whether |packet_number| is missing and less than largest observed.
   virtual bool IsMissing(QuicPacketNumber packet_number);
@@ -50,7 +50,7 @@ class QuicReceivedPacketManagerTest : public QuicTestWithParam<TestParams> {
   void RecordPacketReceipt(uint64_t packet_number, QuicTime receipt_time) {
     QuicPacketHeader header;
     header.packet_number = QuicPacketNumber(packet_number);
-    received_manager_.RecordPacketReceived(header, receipt_time);
+    received_manager_.RecordPacketReceived(header, receipt_time, ECN_NOT_ECT);
   }
 
   QuicConnectionStats stats_;
@@ -64,9 +64,11 @@ INSTANTIATE_TEST_SUITE_P(QuicReceivedPacketManagerTest,
 TEST_P(QuicReceivedPacketManagerTest, DontWaitForPacketsBefore) {
   QuicPacketHeader header;
   header.packet_number = QuicPacketNumber(2u);
-  received_manager_.RecordPacketReceived(header, QuicTime::Zero());
+  received_manager_.RecordPacketReceived(header, QuicTime::Zero(),
+                                         ECN_NOT_ECT);
   header.packet_number = QuicPacketNumber(7u);
-  received_manager_.RecordPacketReceived(header, QuicTime::Zero());
+  received_manager_.RecordPacketReceived(header, QuicTime::Zero(),
+                                         ECN_NOT_ECT);
   EXPECT_TRUE(received_manager_.IsAwaitingPacket(QuicPacketNumber(3u)));
   EXPECT_TRUE(received_manager_.IsAwaitingPacket(QuicPacketNumber(6u)));
   received_manager_.DontWaitForPacketsBefore(QuicPacketNumber(4));
@@ -79,7 +81,7 @@ TEST_P(QuicReceivedPacketManagerTest, GetUpdatedAckFrame) {
   header.packet_number = QuicPacketNumber(2u);
   QuicTime two_ms = QuicTime::Zero() + QuicTime::Delta::FromMilliseconds(2);
   EXPECT_FALSE(received_manager_.ack_frame_updated());
-  received_manager_.RecordPacketReceived(header, two_ms);
+  received_manager_.RecordPacketReceived(header, two_ms, ECN_NOT_ECT);
   EXPECT_TRUE(received_manager_.ack_frame_updated());
 
   QuicFrame ack = received_manager_.GetUpdatedAckFrame(QuicTime::Zero());
@@ -100,11 +102,11 @@ TEST_P(QuicReceivedPacketManagerTest, GetUpdatedAckFrame) {
   EXPECT_EQ(1u, ack.ack_frame->received_packet_times.size());
 
   header.packet_number = QuicPacketNumber(999u);
-  received_manager_.RecordPacketReceived(header, two_ms);
+  received_manager_.RecordPacketReceived(header, two_ms, ECN_NOT_ECT);
   header.packet_number = QuicPacketNumber(4u);
-  received_manager_.RecordPacketReceived(header, two_ms);
+  received_manager_.RecordPacketReceived(header, two_ms, ECN_NOT_ECT);
   header.packet_number = QuicPacketNumber(1000u);
-  received_manager_.RecordPacketReceived(header, two_ms);
+  received_manager_.RecordPacketReceived(header, two_ms, ECN_NOT_ECT);
   EXPECT_TRUE(received_manager_.ack_frame_updated());
   ack = received_manager_.GetUpdatedAckFrame(two_ms);
   EXPECT_FALSE(received_manager_.ack_frame_updated());
@@ -126,6 +128,28 @@ TEST_P(QuicReceivedPacketManagerTest, UpdateReceivedConnectionStats) {
   EXPECT_EQ(1u, stats_.packets_reordered);
 }
 
+TEST_P(QuicReceivedPacketManagerTest, EcnCounts) {
+  QuicPacketHeader header;
+  header.packet_number = QuicPacketNumber(1u);
+  received_manager_.RecordPacketReceived(header, QuicTime::Zero(),
+                                         ECN_NOT_ECT);
+  QuicFrame ack = received_manager_.GetUpdatedAckFrame(QuicTime::Zero());
+  EXPECT_FALSE(ack.ack_frame->ecn_counters_populated);
+
+  header.packet_number = QuicPacketNumber(2u);
+  received_manager_.RecordPacketReceived(header, QuicTime::Zero(), ECN_ECT0);
+  header.packet_number = QuicPacketNumber(3u);
+  received_manager_.RecordPacketReceived(header, QuicTime::Zero(), ECN_CE);
+  header.packet_number = QuicPacketNumber(4u);
+  received_manager_.RecordPacketReceived(header, QuicTime::Zero(), ECN_ECT0);
+  ack = received_manager_.GetUpdatedAckFrame(QuicTime::Zero());
+  EXPECT_TRUE(ack.ack_frame->ecn_counters_populated);
+  EXPECT_EQ(2u, ack.ack_frame->ect_0_count);
+  EXPECT_EQ(0u, ack.ack_frame->ect_1_count);
+  EXPECT_EQ(1u, ack.ack_frame->ecn_ce_count);
+  EXPECT_EQ(1u, stats_.ecn_ce_packets_received);
+}
+
 TEST_P(QuicReceivedPacketManagerTest, LimitAckRanges) {
   received_manager_.set_max_ack_ranges(10);
   EXPECT_FALSE(received_manager_.ack_frame_updated());
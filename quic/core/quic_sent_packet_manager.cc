@@ -108,11 +108,14 @@ QuicSentPacketManager::QuicSentPacketManager(
       ietf_style_tlp_(false),
       ietf_style_2x_tlp_(false),
       largest_mtu_acked_(0),
+      alternative_path_(nullptr),
       handshake_confirmed_(false),
       delayed_ack_time_(
           QuicTime::Delta::FromMilliseconds(kDefaultDelayedAckTimeMs)),
       rtt_updated_(false),
-      acked_packets_iter_(last_ack_frame_.packets.rbegin()) {
+      acked_packets_iter_(last_ack_frame_.packets.rbegin()),
+      ecn_enabled_(false),
+      last_ack_has_ecn_counts_(false) {
   SetSendAlgorithm(congestion_control_type);
 }
 
@@ -277,6 +280,53 @@ void QuicSentPacketManager::SetHandshakeConfirmed() {
   }
 }
 
+void QuicSentPacketManager::MaybeProcessEcnCounts(
+    QuicPacketCount newly_acked_packets,
+    QuicByteCount prior_bytes_in_flight,
+    QuicTime ack_receive_time) {
+  if (!ecn_enabled_) {
+    return;
+  }
+  // Before the handshake is confirmed, the peer may process packets which it
+  // buffered as undecryptable without their ECN codepoints, so missing counts
+  // only fail validation afterwards.
+  if (!last_ack_has_ecn_counts_) {
+    if (handshake_confirmed_ && newly_acked_packets > 0) {
+      QUIC_DVLOG(1) << ENDPOINT << "Disabling ECN: ack has no ECN counts.";
+      ecn_enabled_ = false;
+    }
+    return;
+  }
+  const QuicEcnCounts& counts = last_ack_ecn_counts_;
+  // Counts never decrease, and packets are only marked ECT(0) by this
+  // endpoint, so an ECT(1) count means the path remarks packets.
+  if (counts.ect0 < peer_ecn_counts_.ect0 || counts.ce < peer_ecn_counts_.ce ||
+      counts.ect1 > 0) {
+    QUIC_DVLOG(1) << ENDPOINT << "Disabling ECN: invalid ECN counts, ect0: "
+                  << counts.ect0 << ", ect1: " << counts.ect1
+                  << ", ce: " << counts.ce;
+    ecn_enabled_ = false;
+    return;
+  }
+  const uint64_t newly_marked = (counts.ect0 - peer_ecn_counts_.ect0) +
+                                (counts.ce - peer_ecn_counts_.ce);
+  if (handshake_confirmed_ && newly_acked_packets > 0 && newly_marked == 0) {
+    // The path clears the ECN codepoint.
+    QUIC_DVLOG(1) << ENDPOINT << "Disabling ECN: newly acked packets were not "
+                  << "reported as ECN capable.";
+    ecn_enabled_ = false;
+    return;
+  }
+  const bool ce_increased = counts.ce > peer_ecn_counts_.ce;
+  peer_ecn_counts_ = counts;
+  if (!ce_increased) {
+    return;
+  }
+  ++stats_->ecn_ce_events;
+  send_algorithm_->OnEcnCongestionEvent(
+      ack_receive_time, last_ack_frame_.largest_acked, prior_bytes_in_flight);
+}
+
 void QuicSentPacketManager::PostProcessAfterMarkingPacketHandled(
     const QuicAckFrame& ack_frame,
     QuicTime ack_receive_time,
@@ -313,6 +363,9 @@ void QuicSentPacketManager::PostProcessAfterMarkingPacketHandled(
       } else {
         if (!use_new_rto_) {
           send_algorithm_->OnRetransmissionTimeout(true);
+          if (alternative_path_ != nullptr) {
+            alternative_path_->send_algorithm->OnRetransmissionTimeout(true);
+          }
         }
       }
     }
@@ -340,12 +393,46 @@ void QuicSentPacketManager::MaybeInvokeCongestionEvent(
   if (!rtt_updated && packets_acked_.empty() && packets_lost_.empty()) {
     return;
   }
-  if (using_pacing_) {
-    pacing_sender_.OnCongestionEvent(rtt_updated, prior_in_flight, event_time,
-                                     packets_acked_, packets_lost_);
+  if (alternative_path_ == nullptr) {
+    NotifyCongestionEvent(kDefaultPathId, rtt_updated, prior_in_flight,
+                          event_time, packets_acked_, packets_lost_);
   } else {
-    send_algorithm_->OnCongestionEvent(rtt_updated, prior_in_flight, event_time,
-                                       packets_acked_, packets_lost_);
+    // Each path's congestion controller only sees its own packets, and its
+    // prior in flight is reconstructed from what this event removed.
+    AckedPacketVector packets_acked[kMaxNumPaths];
+    LostPacketVector packets_lost[kMaxNumPaths];
+    QuicByteCount bytes_removed[kMaxNumPaths] = {};
+    for (const AckedPacket& packet : packets_acked_) {
+      const QuicPathId path_id =
+          unacked_packets_.GetTransmissionInfo(packet.packet_number).path_id;
+      packets_acked[path_id].push_back(packet);
+      bytes_removed[path_id] += packet.bytes_acked;
+    }
+    for (const LostPacket& packet : packets_lost_) {
+      const QuicPathId path_id =
+          unacked_packets_.GetTransmissionInfo(packet.packet_number).path_id;
+      packets_lost[path_id].push_back(packet);
+      bytes_removed[path_id] += packet.bytes_lost;
+    }
+    const QuicByteCount alternative_path_prior_in_flight =
+        std::min(prior_in_flight,
+                 GetBytesInFlightOnPath(kAlternativePathId) +
+                     bytes_removed[kAlternativePathId]);
+    // The RTT of a path is only updated by acks of its own packets.
+    const QuicPathId rtt_updated_path_id =
+        rtt_updated ? unacked_packets_
+                          .GetTransmissionInfo(last_ack_frame_.largest_acked)
+                          .path_id
+                    : kDefaultPathId;
+    NotifyCongestionEvent(
+        kDefaultPathId, rtt_updated && rtt_updated_path_id == kDefaultPathId,
+        prior_in_flight - alternative_path_prior_in_flight, event_time,
+        packets_acked[kDefaultPathId], packets_lost[kDefaultPathId]);
+    NotifyCongestionEvent(
+        kAlternativePathId,
+        rtt_updated && rtt_updated_path_id == kAlternativePathId,
+        alternative_path_prior_in_flight, event_time,
+        packets_acked[kAlternativePathId], packets_lost[kAlternativePathId]);
   }
   packets_acked_.clear();
   packets_lost_.clear();
@@ -354,6 +441,25 @@ void QuicSentPacketManager::MaybeInvokeCongestionEvent(
   }
 }
 
+void QuicSentPacketManager::NotifyCongestionEvent(
+    QuicPathId path_id,
+    bool rtt_updated,
+    QuicByteCount prior_in_flight,
+    QuicTime event_time,
+    const AckedPacketVector& packets_acked,
+    const LostPacketVector& packets_lost) {
+  if (!rtt_updated && packets_acked.empty() && packets_lost.empty()) {
+    return;
+  }
+  if (using_pacing_) {
+    GetPathPacingSender(path_id)->OnCongestionEvent(
+        rtt_updated, prior_in_flight, event_time, packets_acked, packets_lost);
+  } else {
+    GetPathSendAlgorithm(path_id)->OnCongestionEvent(
+        rtt_updated, prior_in_flight, event_time, packets_acked, packets_lost);
+  }
+}
+
 void QuicSentPacketManager::RetransmitUnackedPackets(
     TransmissionType retransmission_type) {
   DCHECK(retransmission_type == ALL_UNACKED_RETRANSMISSION ||
@@ -656,13 +762,18 @@ bool QuicSentPacketManager::OnPacketSent(
   }
 
   bool in_flight = has_retransmittable_data == HAS_RETRANSMITTABLE_DATA;
+  QUIC_BUG_IF(alternative_path_ == nullptr &&
+              serialized_packet->path_id != kDefaultPathId)
+      << "Packet sent on path " << static_cast<int>(serialized_packet->path_id)
+      << " without multipath enabled.";
+  const QuicPathId path_id = serialized_packet->path_id;
   if (using_pacing_) {
-    pacing_sender_.OnPacketSent(
-        sent_time, unacked_packets_.bytes_in_flight(), packet_number,
+    GetPathPacingSender(path_id)->OnPacketSent(
+        sent_time, GetBytesInFlightOnPath(path_id), packet_number,
         serialized_packet->encrypted_length, has_retransmittable_data);
   } else {
-    send_algorithm_->OnPacketSent(
-        sent_time, unacked_packets_.bytes_in_flight(), packet_number,
+    GetPathSendAlgorithm(path_id)->OnPacketSent(
+        sent_time, GetBytesInFlightOnPath(path_id), packet_number,
         serialized_packet->encrypted_length, has_retransmittable_data);
   }
 
@@ -822,6 +933,22 @@ void QuicSentPacketManager::RetransmitRtoPackets() {
   }
 }
 
+bool QuicSentPacketManager::IsTimeoutWithoutRetransmittableData() const {
+  if (!unacked_packets_.HasInFlightPackets()) {
+    return false;
+  }
+  const RetransmissionTimeoutMode mode = GetRetransmissionMode();
+  if (mode != TLP_MODE && mode != RTO_MODE) {
+    return false;
+  }
+  for (const QuicTransmissionInfo& info : unacked_packets_) {
+    if (info.in_flight && unacked_packets_.HasRetransmittableFrames(info)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 QuicSentPacketManager::RetransmissionTimeoutMode
 QuicSentPacketManager::GetRetransmissionMode() const {
   DCHECK(unacked_packets_.HasInFlightPackets());
@@ -868,6 +995,10 @@ bool QuicSentPacketManager::MaybeUpdateRTT(QuicPacketNumber largest_acked,
   if (!unacked_packets_.IsUnacked(largest_acked)) {
     return false;
   }
+  if (largest_packet_sent_before_path_switch_.IsInitialized() &&
+      largest_acked <= largest_packet_sent_before_path_switch_) {
+    return false;
+  }
   // We calculate the RTT based on the highest ACKed packet number, the lower
   // packet numbers will include the ACK aggregation delay.
   const QuicTransmissionInfo& transmission_info =
@@ -883,7 +1014,12 @@ bool QuicSentPacketManager::MaybeUpdateRTT(QuicPacketNumber largest_acked,
   }
 
   QuicTime::Delta send_delta = ack_receive_time - transmission_info.sent_time;
-  rtt_stats_.UpdateRtt(send_delta, ack_delay_time, ack_receive_time);
+  RttStats* rtt_stats =
+      alternative_path_ != nullptr &&
+              transmission_info.path_id == kAlternativePathId
+          ? &alternative_path_->rtt_stats
+          : &rtt_stats_;
+  rtt_stats->UpdateRtt(send_delta, ack_delay_time, ack_receive_time);
 
   return true;
 }
@@ -895,6 +1031,11 @@ QuicTime::Delta QuicSentPacketManager::TimeUntilSend(QuicTime now) const {
     return QuicTime::Delta::Zero();
   }
 
+  if (alternative_path_ != nullptr) {
+    return std::min(TimeUntilSendOnPath(now, kDefaultPathId),
+                    TimeUntilSendOnPath(now, kAlternativePathId));
+  }
+
   if (using_pacing_) {
     return pacing_sender_.TimeUntilSend(now,
                                         unacked_packets_.bytes_in_flight());
@@ -905,6 +1046,29 @@ QuicTime::Delta QuicSentPacketManager::TimeUntilSend(QuicTime now) const {
              : QuicTime::Delta::Infinite();
 }
 
+QuicTime::Delta QuicSentPacketManager::TimeUntilSendOnPath(
+    QuicTime now,
+    QuicPathId path_id) const {
+  if (pending_timer_transmission_count_ > 0) {
+    return QuicTime::Delta::Zero();
+  }
+
+  const QuicByteCount bytes_in_flight = GetBytesInFlightOnPath(path_id);
+  const bool alternative_path =
+      alternative_path_ != nullptr && path_id == kAlternativePathId;
+  if (using_pacing_) {
+    return (alternative_path ? alternative_path_->pacing_sender
+                             : pacing_sender_)
+        .TimeUntilSend(now, bytes_in_flight);
+  }
+
+  return (alternative_path ? alternative_path_->send_algorithm
+                           : send_algorithm_)
+                 ->CanSend(bytes_in_flight)
+             ? QuicTime::Delta::Zero()
+             : QuicTime::Delta::Infinite();
+}
+
 const QuicTime QuicSentPacketManager::GetRetransmissionTime() const {
   // Don't set the timer if there is nothing to retransmit or we've already
   // queued a tlp transmission and it hasn't been sent yet.
@@ -977,15 +1141,16 @@ const QuicTime::Delta QuicSentPacketManager::GetCryptoRetransmissionDelay()
 
 const QuicTime::Delta QuicSentPacketManager::GetTailLossProbeDelay(
     size_t consecutive_tlp_count) const {
-  QuicTime::Delta srtt = rtt_stats_.SmoothedOrInitialRtt();
+  const RttStats& rtt_stats = GetTimerRttStats();
+  QuicTime::Delta srtt = rtt_stats.SmoothedOrInitialRtt();
   if (enable_half_rtt_tail_loss_probe_ && consecutive_tlp_count == 0u) {
     return std::max(min_tlp_timeout_, srtt * 0.5);
   }
   if (ietf_style_tlp_) {
-    return std::max(min_tlp_timeout_, 1.5 * srtt + rtt_stats_.max_ack_delay());
+    return std::max(min_tlp_timeout_, 1.5 * srtt + rtt_stats.max_ack_delay());
   }
   if (ietf_style_2x_tlp_) {
-    return std::max(min_tlp_timeout_, 2 * srtt + rtt_stats_.max_ack_delay());
+    return std::max(min_tlp_timeout_, 2 * srtt + rtt_stats.max_ack_delay());
   }
   if (!unacked_packets_.HasMultipleInFlightPackets()) {
     // This expression really should be using the delayed ack time, but in TCP
@@ -998,14 +1163,15 @@ const QuicTime::Delta QuicSentPacketManager::GetTailLossProbeDelay(
 
 const QuicTime::Delta QuicSentPacketManager::GetRetransmissionDelay(
     size_t consecutive_rto_count) const {
+  const RttStats& rtt_stats = GetTimerRttStats();
   QuicTime::Delta retransmission_delay = QuicTime::Delta::Zero();
-  if (rtt_stats_.smoothed_rtt().IsZero()) {
+  if (rtt_stats.smoothed_rtt().IsZero()) {
     // We are in the initial state, use default timeout values.
     retransmission_delay =
         QuicTime::Delta::FromMilliseconds(kDefaultRetransmissionTimeMs);
   } else {
     retransmission_delay =
-        rtt_stats_.smoothed_rtt() + 4 * rtt_stats_.mean_deviation();
+        rtt_stats.smoothed_rtt() + 4 * rtt_stats.mean_deviation();
     if (retransmission_delay < min_rto_timeout_) {
       retransmission_delay = min_rto_timeout_;
     }
@@ -1067,6 +1233,100 @@ void QuicSentPacketManager::OnConnectionMigration(AddressChangeType type) {
   send_algorithm_->OnConnectionMigration();
 }
 
+void QuicSentPacketManager::SwitchPath(PathState* path) {
+  if (alternative_path_ != nullptr) {
+    QUIC_BUG << "Cannot switch paths while multipath is enabled.";
+    return;
+  }
+  consecutive_rto_count_ = 0;
+  consecutive_tlp_count_ = 0;
+  largest_packet_sent_before_path_switch_ =
+      unacked_packets_.largest_sent_packet();
+
+  // Send algorithms keep pointing at rtt_stats_, so the estimates of the
+  // paths are swapped through it rather than the RttStats objects.
+  RttStats previous_rtt_stats;
+  previous_rtt_stats.CloneFrom(rtt_stats_);
+  rtt_stats_.CloneFrom(path->rtt_stats);
+  path->rtt_stats.CloneFrom(previous_rtt_stats);
+
+  const CongestionControlType congestion_control_type =
+      send_algorithm_->GetCongestionControlType();
+  std::unique_ptr<SendAlgorithmInterface> previous_send_algorithm =
+      std::move(send_algorithm_);
+  if (path->send_algorithm != nullptr) {
+    SetSendAlgorithm(path->send_algorithm.release());
+  } else {
+    SetSendAlgorithm(congestion_control_type);
+  }
+  path->send_algorithm = std::move(previous_send_algorithm);
+  if (network_change_visitor_ != nullptr) {
+    network_change_visitor_->OnCongestionChange();
+  }
+}
+
+void QuicSentPacketManager::EnableMultipath(PathState* path) {
+  if (alternative_path_ != nullptr) {
+    QUIC_BUG << "Multipath is already enabled.";
+    return;
+  }
+  alternative_path_ = path;
+  // A send algorithm saved by SwitchPath() reads rtt_stats_, so the path
+  // always gets a new one which reads its own RTT estimate.
+  path->send_algorithm.reset(SendAlgorithmInterface::Create(
+      clock_, &path->rtt_stats, &unacked_packets_,
+      send_algorithm_->GetCongestionControlType(), QuicRandom::GetInstance(),
+      stats_, initial_congestion_window_));
+  path->pacing_sender.set_sender(path->send_algorithm.get());
+  path->pacing_sender.set_max_pacing_rate(pacing_sender_.max_pacing_rate());
+  path->pacing_sender.set_alarm_granularity(
+      pacing_sender_.alarm_granularity());
+  multipath_loss_algorithm_.SetPathRttStats(kDefaultPathId, &rtt_stats_);
+  multipath_loss_algorithm_.SetPathRttStats(kAlternativePathId,
+                                            &path->rtt_stats);
+  loss_algorithm_ = &multipath_loss_algorithm_;
+  if (network_change_visitor_ != nullptr) {
+    network_change_visitor_->OnCongestionChange();
+  }
+}
+
+const RttStats* QuicSentPacketManager::GetPathRttStats(
+    QuicPathId path_id) const {
+  if (alternative_path_ != nullptr && path_id == kAlternativePathId) {
+    return &alternative_path_->rtt_stats;
+  }
+  return &rtt_stats_;
+}
+
+QuicByteCount QuicSentPacketManager::GetBytesInFlightOnPath(
+    QuicPathId path_id) const {
+  return unacked_packets_.GetBytesInFlightOnPath(path_id);
+}
+
+const RttStats& QuicSentPacketManager::GetTimerRttStats() const {
+  if (alternative_path_ != nullptr &&
+      alternative_path_->rtt_stats.SmoothedOrInitialRtt() >
+          rtt_stats_.SmoothedOrInitialRtt()) {
+    return alternative_path_->rtt_stats;
+  }
+  return rtt_stats_;
+}
+
+PacingSender* QuicSentPacketManager::GetPathPacingSender(QuicPathId path_id) {
+  if (alternative_path_ != nullptr && path_id == kAlternativePathId) {
+    return &alternative_path_->pacing_sender;
+  }
+  return &pacing_sender_;
+}
+
+SendAlgorithmInterface* QuicSentPacketManager::GetPathSendAlgorithm(
+    QuicPathId path_id) {
+  if (alternative_path_ != nullptr && path_id == kAlternativePathId) {
+    return alternative_path_->send_algorithm.get();
+  }
+  return send_algorithm_.get();
+}
+
 void QuicSentPacketManager::OnAckFrameStart(QuicPacketNumber largest_acked,
                                             QuicTime::Delta ack_delay_time,
                                             QuicTime ack_receive_time) {
@@ -1078,6 +1338,12 @@ void QuicSentPacketManager::OnAckFrameStart(QuicPacketNumber largest_acked,
          largest_acked >= unacked_packets_.largest_acked());
   last_ack_frame_.ack_delay_time = ack_delay_time;
   acked_packets_iter_ = last_ack_frame_.packets.rbegin();
+  last_ack_has_ecn_counts_ = false;
+}
+
+void QuicSentPacketManager::OnAckEcnCounts(const QuicEcnCounts& ecn_counts) {
+  last_ack_has_ecn_counts_ = true;
+  last_ack_ecn_counts_ = ecn_counts;
 }
 
 void QuicSentPacketManager::OnAckRange(QuicPacketNumber start,
@@ -1177,6 +1443,8 @@ bool QuicSentPacketManager::OnAckFrameEnd(QuicTime ack_receive_time) {
                       last_ack_frame_.ack_delay_time);
   }
   const bool acked_new_packet = !packets_acked_.empty();
+  MaybeProcessEcnCounts(packets_acked_.size(), prior_bytes_in_flight,
+                        ack_receive_time);
   PostProcessAfterMarkingPacketHandled(last_ack_frame_, ack_receive_time,
                                        rtt_updated_, prior_bytes_in_flight);
 
@@ -1192,6 +1460,13 @@ void QuicSentPacketManager::OnApplicationLimited() {
     pacing_sender_.OnApplicationLimited();
   }
   send_algorithm_->OnApplicationLimited(unacked_packets_.bytes_in_flight());
+  if (alternative_path_ != nullptr) {
+    if (using_pacing_) {
+      alternative_path_->pacing_sender.OnApplicationLimited();
+    }
+    alternative_path_->send_algorithm->OnApplicationLimited(
+        GetBytesInFlightOnPath(kAlternativePathId));
+  }
   if (debug_delegate_ != nullptr) {
     debug_delegate_->OnApplicationLimited();
   }
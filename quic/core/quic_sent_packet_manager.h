@@ -15,6 +15,7 @@
 #include "base/macros.h"
 #include "net/third_party/quiche/src/quic/core/congestion_control/pacing_sender.h"
 #include "net/third_party/quiche/src/quic/core/congestion_control/rtt_stats.h"
+#include "net/third_party/quiche/src/quic/core/congestion_control/multipath_loss_algorithm.h"
 #include "net/third_party/quiche/src/quic/core/congestion_control/send_algorithm_interface.h"
 #include "net/third_party/quiche/src/quic/core/congestion_control/uber_loss_algorithm.h"
 #include "net/third_party/quiche/src/quic/core/proto/cached_network_parameters.proto.h"
@@ -88,6 +89,16 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
     virtual void OnPathMtuIncreased(QuicPacketLength packet_size) = 0;
   };
 
+  // RTT and congestion state of a network path which is not the active path.
+  struct QUIC_EXPORT_PRIVATE PathState {
+    RttStats rtt_stats;
+    // Null until the path has been active or multipath is enabled.
+    std::unique_ptr<SendAlgorithmInterface> send_algorithm;
+    // Only used while the path carries packets alongside the active path, see
+    // EnableMultipath().
+    PacingSender pacing_sender;
+  };
+
   QuicSentPacketManager(Perspective perspective,
                         const QuicClock* clock,
                         QuicConnectionStats* stats,
@@ -108,6 +119,9 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
 
   void SetMaxPacingRate(QuicBandwidth max_pacing_rate) {
     pacing_sender_.set_max_pacing_rate(max_pacing_rate);
+    if (alternative_path_ != nullptr) {
+      alternative_path_->pacing_sender.set_max_pacing_rate(max_pacing_rate);
+    }
   }
 
   QuicBandwidth MaxPacingRate() const {
@@ -165,6 +179,11 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
     return unacked_packets_.HasInFlightPackets();
   }
 
+  // Returns true if the retransmission timer is a TLP or RTO, but none of the
+  // packets in flight has retransmittable frames, as when only FEC repair
+  // packets are outstanding. Such a timeout has nothing to retransmit.
+  bool IsTimeoutWithoutRetransmittableData() const;
+
   // Returns the smallest packet number of a serialized packet which has not
   // been acked by the peer.
   QuicPacketNumber GetLeastUnacked() const {
@@ -253,11 +272,40 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
   // Called when peer address changes and the connection migrates.
   void OnConnectionMigration(AddressChangeType type);
 
+  // Makes the path described by |path| the active path and saves the state of
+  // the previously active path in |path|.  A path which has never been active
+  // gets a new send algorithm of the current congestion control type.  Packets
+  // sent before the switch no longer produce RTT samples.  Not allowed once
+  // multipath is enabled.
+  void SwitchPath(PathState* path);
+
+  // Starts sending on kAlternativePathId, described by |path|, alongside
+  // kDefaultPathId.  |path| keeps its RTT estimate and gets a send algorithm
+  // and pacer of its own, and losses are only detected against acks of
+  // packets sent on the same path.  |path| must outlive this.  Cannot be
+  // undone.
+  void EnableMultipath(PathState* path);
+
+  bool multipath_enabled() const { return alternative_path_ != nullptr; }
+
+  // Returns the RTT estimate of |path_id|.
+  const RttStats* GetPathRttStats(QuicPathId path_id) const;
+
+  // Returns the bytes in flight on |path_id|.
+  QuicByteCount GetBytesInFlightOnPath(QuicPathId path_id) const;
+
+  // Like TimeUntilSend, but only consults the congestion controller and pacer
+  // of |path_id|.
+  QuicTime::Delta TimeUntilSendOnPath(QuicTime now, QuicPathId path_id) const;
+
   // Called when an ack frame is initially parsed.
   void OnAckFrameStart(QuicPacketNumber largest_acked,
                        QuicTime::Delta ack_delay_time,
                        QuicTime ack_receive_time);
 
+  // Called when the ack frame carries ECN counts, after OnAckFrameStart.
+  void OnAckEcnCounts(const QuicEcnCounts& ecn_counts);
+
   // Called when ack range [start, end) is received. Populates packets_acked_
   // with newly acked packets.
   void OnAckRange(QuicPacketNumber start, QuicPacketNumber end);
@@ -279,6 +327,9 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
 
   void SetPacingAlarmGranularity(QuicTime::Delta alarm_granularity) {
     pacing_sender_.set_alarm_granularity(alarm_granularity);
+    if (alternative_path_ != nullptr) {
+      alternative_path_->pacing_sender.set_alarm_granularity(alarm_granularity);
+    }
   }
 
   QuicPacketNumber GetLargestObserved() const {
@@ -301,6 +352,10 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
 
   size_t GetConsecutiveTlpCount() const { return consecutive_tlp_count_; }
 
+  // Called when the connection reduces its maximum packet size, so that an
+  // acknowledged packet larger than the reduced size raises it again.
+  void OnPathMtuDecreased() { largest_mtu_acked_ = 0; }
+
   void OnApplicationLimited();
 
   const SendAlgorithmInterface* GetSendAlgorithm() const {
@@ -323,6 +378,13 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
 
   bool handshake_confirmed() const { return handshake_confirmed_; }
 
+  // Called when outgoing packets are marked ECT(0).  The ECN counts of the
+  // peer's acks are then validated, and increases of the CE count are reported
+  // to the send algorithm.  ECN is disabled again if validation fails.
+  void EnableEcn() { ecn_enabled_ = true; }
+
+  bool ecn_enabled() const { return ecn_enabled_; }
+
   bool session_decides_what_to_write() const {
     return unacked_packets_.session_decides_what_to_write();
   }
@@ -433,6 +495,23 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
   // acks, |event_time| is normally the timestamp of the ack packet which caused
   // the event, although it can be the time at which loss detection was
   // triggered.
+  // Returns the RTT estimate the retransmission timers are based on, which is
+  // that of the slowest path.
+  const RttStats& GetTimerRttStats() const;
+
+  // Returns the pacing sender and send algorithm of |path_id|.
+  PacingSender* GetPathPacingSender(QuicPathId path_id);
+  SendAlgorithmInterface* GetPathSendAlgorithm(QuicPathId path_id);
+
+  // Informs the congestion controller of |path_id| of |packets_acked| and
+  // |packets_lost|.
+  void NotifyCongestionEvent(QuicPathId path_id,
+                             bool rtt_updated,
+                             QuicByteCount prior_in_flight,
+                             QuicTime event_time,
+                             const AckedPacketVector& packets_acked,
+                             const LostPacketVector& packets_lost);
+
   void MaybeInvokeCongestionEvent(bool rtt_updated,
                                   QuicByteCount prior_in_flight,
                                   QuicTime event_time);
@@ -455,6 +534,13 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
   void HandleRetransmission(TransmissionType transmission_type,
                             QuicTransmissionInfo* transmission_info);
 
+  // Validates the ECN counts of the last received ack frame, which newly acked
+  // |newly_acked_packets| packets, and invokes the send algorithm if the CE
+  // count increased.
+  void MaybeProcessEcnCounts(QuicPacketCount newly_acked_packets,
+                             QuicByteCount prior_bytes_in_flight,
+                             QuicTime ack_receive_time);
+
   // Called after packets have been marked handled with last received ack frame.
   void PostProcessAfterMarkingPacketHandled(
       const QuicAckFrame& ack_frame,
@@ -552,11 +638,20 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
   QuicPacketNumber largest_newly_acked_;
   // Largest packet in bytes ever acknowledged.
   QuicPacketLength largest_mtu_acked_;
+  // Largest packet sent before the last SwitchPath.  Acks of these packets
+  // travelled over another path and are not used as RTT samples.
+  QuicPacketNumber largest_packet_sent_before_path_switch_;
 
   // Replaces certain calls to |send_algorithm_| when |using_pacing_| is true.
   // Calls into |send_algorithm_| for the underlying congestion control.
   PacingSender pacing_sender_;
 
+  // Not owned.  State of kAlternativePathId while packets are sent on it as
+  // well, null otherwise.
+  PathState* alternative_path_;
+  // |loss_algorithm_| points at this once multipath is enabled.
+  MultipathLossAlgorithm multipath_loss_algorithm_;
+
   // Set to true after the crypto handshake has successfully completed. After
   // this is true we no longer use HANDSHAKE_MODE, and further frames sent on
   // the crypto stream (i.e. SCUP messages) are treated like normal
@@ -583,6 +678,16 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
   // A reverse iterator of last_ack_frame_.packets. This is reset in
   // OnAckRangeStart, and gradually moves in OnAckRange..
   PacketNumberQueue::const_reverse_iterator acked_packets_iter_;
+
+  // True if outgoing packets are marked ECT(0) and the peer's ECN counts have
+  // not failed validation.
+  bool ecn_enabled_;
+  // True if the ack frame being processed carries ECN counts.
+  bool last_ack_has_ecn_counts_;
+  // ECN counts of the ack frame being processed.
+  QuicEcnCounts last_ack_ecn_counts_;
+  // Largest ECN counts reported by the peer so far.
+  QuicEcnCounts peer_ecn_counts_;
 };
 
 }  // namespace quic
@@ -712,6 +712,45 @@ TEST_P(QuicSentPacketManagerTest, AckOriginalTransmission) {
   }
 }
 
+TEST_P(QuicSentPacketManagerTest, EcnCounts) {
+  manager_.EnableEcn();
+  SendDataPacket(1);
+  SendDataPacket(2);
+  SendDataPacket(3);
+
+  // Packet 1 arrives ECT(0).
+  ExpectAck(1);
+  manager_.OnAckFrameStart(QuicPacketNumber(1), QuicTime::Delta::Infinite(),
+                           clock_.Now());
+  manager_.OnAckEcnCounts(QuicEcnCounts(1, 0, 0));
+  manager_.OnAckRange(QuicPacketNumber(1), QuicPacketNumber(2));
+  EXPECT_TRUE(manager_.OnAckFrameEnd(clock_.Now()));
+  EXPECT_TRUE(manager_.ecn_enabled());
+  EXPECT_EQ(0u, stats_.ecn_ce_events);
+
+  // Packet 2 arrives CE marked, which is a congestion event.
+  ExpectAck(2);
+  EXPECT_CALL(*send_algorithm_,
+              OnEcnCongestionEvent(_, QuicPacketNumber(2), _));
+  manager_.OnAckFrameStart(QuicPacketNumber(2), QuicTime::Delta::Infinite(),
+                           clock_.Now());
+  manager_.OnAckEcnCounts(QuicEcnCounts(1, 0, 1));
+  manager_.OnAckRange(QuicPacketNumber(1), QuicPacketNumber(3));
+  EXPECT_TRUE(manager_.OnAckFrameEnd(clock_.Now()));
+  EXPECT_TRUE(manager_.ecn_enabled());
+  EXPECT_EQ(1u, stats_.ecn_ce_events);
+
+  // Decreasing counts fail validation.
+  ExpectAck(3);
+  manager_.OnAckFrameStart(QuicPacketNumber(3), QuicTime::Delta::Infinite(),
+                           clock_.Now());
+  manager_.OnAckEcnCounts(QuicEcnCounts(0, 0, 1));
+  manager_.OnAckRange(QuicPacketNumber(1), QuicPacketNumber(4));
+  EXPECT_TRUE(manager_.OnAckFrameEnd(clock_.Now()));
+  EXPECT_FALSE(manager_.ecn_enabled());
+  EXPECT_EQ(1u, stats_.ecn_ce_events);
+}
+
 TEST_P(QuicSentPacketManagerTest, GetLeastUnacked) {
   EXPECT_EQ(QuicPacketNumber(1u), manager_.GetLeastUnacked());
 }
@@ -2400,6 +2439,86 @@ TEST_P(QuicSentPacketManagerTest, ConnectionMigrationPortChange) {
   EXPECT_EQ(2u, manager_.GetConsecutiveTlpCount());
 }
 
+TEST_P(QuicSentPacketManagerTest, SwitchPath) {
+  RttStats* rtt_stats = const_cast<RttStats*>(manager_.GetRttStats());
+  rtt_stats->UpdateRtt(QuicTime::Delta::FromMilliseconds(20),
+                       QuicTime::Delta::Zero(), clock_.Now());
+  QuicSentPacketManagerPeer::SetConsecutiveRtoCount(&manager_, 1);
+
+  QuicSentPacketManager::PathState path;
+  path.rtt_stats.UpdateRtt(QuicTime::Delta::FromMilliseconds(100),
+                           QuicTime::Delta::Zero(), clock_.Now());
+
+  // The new path has never been active and gets a new send algorithm.
+  EXPECT_CALL(*send_algorithm_, GetCongestionControlType())
+      .WillRepeatedly(Return(kCubicBytes));
+  EXPECT_CALL(*network_change_visitor_, OnCongestionChange());
+  manager_.SwitchPath(&path);
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(100), rtt_stats->min_rtt());
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(20), path.rtt_stats.min_rtt());
+  EXPECT_EQ(send_algorithm_, path.send_algorithm.get());
+  EXPECT_NE(send_algorithm_,
+            QuicSentPacketManagerPeer::GetSendAlgorithm(manager_));
+  EXPECT_EQ(0u, manager_.GetConsecutiveRtoCount());
+
+  // Switching back restores the state of the original path.
+  EXPECT_CALL(*network_change_visitor_, OnCongestionChange());
+  manager_.SwitchPath(&path);
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(20), rtt_stats->min_rtt());
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(100), path.rtt_stats.min_rtt());
+  EXPECT_EQ(send_algorithm_,
+            QuicSentPacketManagerPeer::GetSendAlgorithm(manager_));
+  EXPECT_NE(nullptr, path.send_algorithm);
+}
+
+TEST_P(QuicSentPacketManagerTest, MultipathAcksOnlyUpdateTheirOwnPath) {
+  RttStats* rtt_stats = const_cast<RttStats*>(manager_.GetRttStats());
+  rtt_stats->UpdateRtt(QuicTime::Delta::FromMilliseconds(20),
+                       QuicTime::Delta::Zero(), clock_.Now());
+  QuicSentPacketManager::PathState alternative_path;
+  alternative_path.rtt_stats.UpdateRtt(QuicTime::Delta::FromMilliseconds(100),
+                                       QuicTime::Delta::Zero(), clock_.Now());
+
+  EXPECT_CALL(*send_algorithm_, GetCongestionControlType())
+      .WillRepeatedly(Return(kCubicBytes));
+  EXPECT_CALL(*network_change_visitor_, OnCongestionChange());
+  manager_.EnableMultipath(&alternative_path);
+  EXPECT_TRUE(manager_.multipath_enabled());
+  EXPECT_NE(nullptr, alternative_path.send_algorithm);
+  EXPECT_EQ(&alternative_path.rtt_stats,
+            manager_.GetPathRttStats(kAlternativePathId));
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(100),
+            manager_.GetPathRttStats(kAlternativePathId)->min_rtt());
+
+  // Packet 1 goes out on the default path, packet 2 on the alternative path,
+  // which has its own congestion controller.
+  SendDataPacket(1);
+  SerializedPacket packet(CreateDataPacket(2));
+  packet.path_id = kAlternativePathId;
+  manager_.OnPacketSent(&packet, QuicPacketNumber(), clock_.Now(),
+                        NOT_RETRANSMISSION, HAS_RETRANSMITTABLE_DATA);
+  EXPECT_EQ(kDefaultLength, manager_.GetBytesInFlightOnPath(kDefaultPathId));
+  EXPECT_EQ(kDefaultLength,
+            manager_.GetBytesInFlightOnPath(kAlternativePathId));
+  EXPECT_EQ(2 * kDefaultLength, BytesInFlight());
+
+  // Acking packet 2 samples the RTT of the alternative path only, and does
+  // not make packet 1 lost.
+  clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(150));
+  EXPECT_CALL(*send_algorithm_, OnCongestionEvent(_, _, _, _, _)).Times(0);
+  EXPECT_CALL(*network_change_visitor_, OnCongestionChange());
+  manager_.OnAckFrameStart(QuicPacketNumber(2), QuicTime::Delta::Zero(),
+                           clock_.Now());
+  manager_.OnAckRange(QuicPacketNumber(2), QuicPacketNumber(3));
+  EXPECT_TRUE(manager_.OnAckFrameEnd(clock_.Now()));
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(150),
+            manager_.GetPathRttStats(kAlternativePathId)->latest_rtt());
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(20), rtt_stats->latest_rtt());
+  EXPECT_EQ(kDefaultLength, manager_.GetBytesInFlightOnPath(kDefaultPathId));
+  EXPECT_EQ(0u, manager_.GetBytesInFlightOnPath(kAlternativePathId));
+  EXPECT_EQ(0u, stats_.packets_lost);
+}
+
 TEST_P(QuicSentPacketManagerTest, PathMtuIncreased) {
   EXPECT_CALL(*send_algorithm_,
               OnPacketSent(_, BytesInFlight(), QuicPacketNumber(1), _, _));
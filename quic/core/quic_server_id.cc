@@ -4,6 +4,7 @@
 
 #include "net/third_party/quiche/src/quic/core/quic_server_id.h"
 
+#include <functional>
 #include <tuple>
 
 #include "net/third_party/quiche/src/quic/platform/api/quic_estimate_memory_usage.h"
@@ -38,4 +39,10 @@ size_t QuicServerId::EstimateMemoryUsage() const {
   return QuicEstimateMemoryUsage(host_);
 }
 
+size_t QuicServerIdHash::operator()(const QuicServerId& server_id) const {
+  return std::hash<QuicString>()(server_id.host()) ^
+         (static_cast<size_t>(server_id.port()) << 1) ^
+         static_cast<size_t>(server_id.privacy_mode_enabled());
+}
+
 }  // namespace quic
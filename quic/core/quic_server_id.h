@@ -41,6 +41,13 @@ class QUIC_EXPORT_PRIVATE QuicServerId {
   bool privacy_mode_enabled_;
 };
 
+// Hash function for QuicServerId, so that it can be used as the key of hash
+// based containers.
+class QUIC_EXPORT_PRIVATE QuicServerIdHash {
+ public:
+  size_t operator()(const QuicServerId& server_id) const;
+};
+
 }  // namespace quic
 
 #endif  // QUICHE_QUIC_CORE_QUIC_SERVER_ID_H_
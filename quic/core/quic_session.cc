@@ -75,11 +75,15 @@ QuicSession::QuicSession(QuicConnection* connection,
       goaway_received_(false),
       control_frame_manager_(this),
       last_message_id_(0),
+      datagram_queue_(this),
       closed_streams_clean_up_alarm_(nullptr),
       supported_versions_(supported_versions) {
   closed_streams_clean_up_alarm_ =
       QuicWrapUnique<QuicAlarm>(connection_->alarm_factory()->CreateAlarm(
           new ClosedStreamsCleanUpDelegate(this)));
+  if (config_.receive_window_budget() > 0) {
+    flow_controller_.SetReceiveWindowBudget(config_.receive_window_budget());
+  }
 }
 
 void QuicSession::Initialize() {
@@ -448,7 +452,8 @@ void QuicSession::OnCanWrite() {
   size_t num_writes = flow_controller_.IsBlocked()
                           ? write_blocked_streams_.NumBlockedSpecialStreams()
                           : write_blocked_streams_.NumBlockedStreams();
-  if (num_writes == 0 && !control_frame_manager_.WillingToWrite()) {
+  if (num_writes == 0 && !control_frame_manager_.WillingToWrite() &&
+      datagram_queue_.empty()) {
     return;
   }
 
@@ -472,6 +477,16 @@ void QuicSession::OnCanWrite() {
     }
     currently_writing_stream_id_ = write_blocked_streams_.PopFront();
     QuicStream* stream = GetOrCreateStream(currently_writing_stream_id_);
+    if (stream != nullptr && !datagram_queue_.empty()) {
+      // Queued datagrams of the same or a higher priority go first.
+      datagram_queue_.TrySendingNextDatagrams(stream->priority());
+      if (!connection_->CanWriteStreamData()) {
+        // The stream keeps its place for the next OnCanWrite.
+        write_blocked_streams_.AddStream(currently_writing_stream_id_);
+        currently_writing_stream_id_ = 0;
+        return;
+      }
+    }
     if (stream != nullptr && !stream->flow_controller()->IsBlocked()) {
       // If the stream can't write all bytes it'll re-add itself to the blocked
       // list.
@@ -486,6 +501,13 @@ void QuicSession::OnCanWrite() {
     }
     currently_writing_stream_id_ = 0;
   }
+  FlushDatagramQueue();
+}
+
+void QuicSession::FlushDatagramQueue() {
+  if (!datagram_queue_.empty() && connection_->CanWriteStreamData()) {
+    datagram_queue_.TrySendingNextDatagrams(spdy::kV3LowestPriority);
+  }
 }
 
 bool QuicSession::WillingAndAbleToWrite() const {
@@ -494,9 +516,11 @@ bool QuicSession::WillingAndAbleToWrite() const {
   // 2) any stream has pending retransmissions, or
   // 3) If the crypto or headers streams are blocked, or
   // 4) connection is not flow control blocked and there are write blocked
-  // streams.
+  // streams, or
+  // 5) there are queued datagrams and they can be encrypted.
   return control_frame_manager_.WillingToWrite() ||
          !streams_with_pending_retransmission_.empty() ||
+         (!datagram_queue_.empty() && IsEncryptionEstablished()) ||
          write_blocked_streams_.HasWriteBlockedSpecialStream() ||
          (!flow_controller_.IsBlocked() &&
           write_blocked_streams_.HasWriteBlockedDataStreams());
@@ -965,6 +989,7 @@ void QuicSession::OnCryptoHandshakeEvent(CryptoHandshakeEvent event) {
     case ENCRYPTION_FIRST_ESTABLISHED:
       // Given any streams blocked by encryption a chance to write.
       OnCanWrite();
+      FlushDatagramQueue();
       break;
 
     case ENCRYPTION_REESTABLISHED:
@@ -973,6 +998,7 @@ void QuicSession::OnCryptoHandshakeEvent(CryptoHandshakeEvent event) {
       connection_->RetransmitUnackedPackets(ALL_INITIAL_RETRANSMISSION);
       // Given any streams blocked by encryption a chance to write.
       OnCanWrite();
+      FlushDatagramQueue();
       break;
 
     case HANDSHAKE_CONFIRMED:
@@ -982,6 +1008,9 @@ void QuicSession::OnCryptoHandshakeEvent(CryptoHandshakeEvent event) {
       // the peer.
       NeuterUnencryptedData();
       is_handshake_confirmed_ = true;
+      // Datagrams queued before encryption was established are not scheduled
+      // by WillingAndAbleToWrite.
+      FlushDatagramQueue();
       break;
 
     default:
@@ -1260,7 +1289,7 @@ bool QuicSession::HasDataToWrite() const {
          write_blocked_streams_.HasWriteBlockedDataStreams() ||
          connection_->HasQueuedData() ||
          !streams_with_pending_retransmission_.empty() ||
-         control_frame_manager_.WillingToWrite();
+         control_frame_manager_.WillingToWrite() || !datagram_queue_.empty();
 }
 
 void QuicSession::OnAckNeedsRetransmittableFrame() {
@@ -1621,6 +1650,13 @@ MessageResult QuicSession::SendMessage(QuicMemSliceSpan message) {
   return {result, 0};
 }
 
+MessageStatus QuicSession::SendOrQueueDatagram(QuicString datagram,
+                                               spdy::SpdyPriority priority,
+                                               QuicTime expiry) {
+  return datagram_queue_.SendOrQueueDatagram(std::move(datagram), priority,
+                                             expiry);
+}
+
 void QuicSession::OnMessageAcked(QuicMessageId message_id) {
   QUIC_DVLOG(1) << ENDPOINT << "message " << message_id << " gets acked.";
 }
@@ -1628,6 +1664,7 @@ void QuicSession::OnMessageAcked(QuicMessageId message_id) {
 void QuicSession::OnMessageLost(QuicMessageId message_id) {
   QUIC_DVLOG(1) << ENDPOINT << "message " << message_id
                 << " is considered lost";
+  datagram_queue_.OnDatagramLost();
 }
 
 void QuicSession::CleanUpClosedStreams() {
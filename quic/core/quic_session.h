@@ -17,6 +17,7 @@
 #include "net/third_party/quiche/src/quic/core/quic_connection.h"
 #include "net/third_party/quiche/src/quic/core/quic_control_frame_manager.h"
 #include "net/third_party/quiche/src/quic/core/quic_crypto_stream.h"
+#include "net/third_party/quiche/src/quic/core/quic_datagram_queue.h"
 #include "net/third_party/quiche/src/quic/core/quic_packet_creator.h"
 #include "net/third_party/quiche/src/quic/core/quic_packets.h"
 #include "net/third_party/quiche/src/quic/core/quic_stream.h"
@@ -188,6 +189,14 @@ class QUIC_EXPORT_PRIVATE QuicSession : public QuicConnectionVisitorInterface,
   // callback.
   MessageResult SendMessage(QuicMemSliceSpan message);
 
+  // Called by application to send |datagram| as a message, or to queue it if
+  // the connection is blocked. Queued datagrams are sent in |priority| order
+  // along with stream data of the same priority when the session can write,
+  // and are dropped if they have not been sent by |expiry|.
+  MessageStatus SendOrQueueDatagram(QuicString datagram,
+                                    spdy::SpdyPriority priority,
+                                    QuicTime expiry);
+
   // Called when message with |message_id| gets acked.
   virtual void OnMessageAcked(QuicMessageId message_id);
 
@@ -325,6 +334,8 @@ class QUIC_EXPORT_PRIVATE QuicSession : public QuicConnectionVisitorInterface,
   // checked for every message.
   QuicPacketLength GetLargestMessagePayload() const;
 
+  const QuicDatagramQueue& datagram_queue() const { return datagram_queue_; }
+
   bool goaway_sent() const { return goaway_sent_; }
 
   bool goaway_received() const { return goaway_received_; }
@@ -586,6 +597,9 @@ class QUIC_EXPORT_PRIVATE QuicSession : public QuicConnectionVisitorInterface,
   // if all lost data is retransmitted. Returns false otherwise.
   bool RetransmitLostData();
 
+  // Sends queued datagrams of any priority if the connection can write.
+  void FlushDatagramQueue();
+
   // Closes the pending stream |stream_id| before it has been created.
   void ClosePendingStream(QuicStreamId stream_id);
 
@@ -672,6 +686,9 @@ class QUIC_EXPORT_PRIVATE QuicSession : public QuicConnectionVisitorInterface,
   // Id of latest successfully sent message.
   QuicMessageId last_message_id_;
 
+  // Datagrams submitted by SendOrQueueDatagram which are waiting to be sent.
+  QuicDatagramQueue datagram_queue_;
+
   // TODO(fayang): switch to linked_hash_set when chromium supports it. The bool
   // is not used here.
   // List of streams with pending retransmissions.
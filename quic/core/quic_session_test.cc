@@ -38,6 +38,7 @@
 #include "net/third_party/quiche/src/quic/test_tools/quic_test_utils.h"
 
 using spdy::kV3HighestPriority;
+using spdy::kV3LowestPriority;
 using spdy::SpdyPriority;
 using testing::_;
 using testing::AtLeast;
@@ -52,6 +53,11 @@ namespace quic {
 namespace test {
 namespace {
 
+MATCHER_P(MessageDataIs, data, "") {
+  QuicMemSliceSpan span = arg;
+  return span.NumSlices() == 1 && span.GetData(0) == data;
+}
+
 class TestCryptoStream : public QuicCryptoStream, public QuicCryptoHandshaker {
  public:
   explicit TestCryptoStream(QuicSession* session)
@@ -2016,6 +2022,139 @@ TEST_P(QuicSessionTestServer, SendMessage) {
   EXPECT_FALSE(session_.IsFrameOutstanding(QuicFrame(&frame)));
 }
 
+TEST_P(QuicSessionTestServer, SendOrQueueDatagram) {
+  if (transport_version() <= QUIC_VERSION_44) {
+    // Messages are not supported.
+    return;
+  }
+  CryptoHandshakeMessage handshake_message;
+  session_.GetMutableCryptoStream()->OnHandshakeMessage(handshake_message);
+
+  // Sent right away when the connection is not blocked.
+  EXPECT_CALL(*connection_, SendMessage(1, MessageDataIs("a")))
+      .WillOnce(Return(MESSAGE_STATUS_SUCCESS));
+  EXPECT_EQ(MESSAGE_STATUS_SUCCESS,
+            session_.SendOrQueueDatagram("a", kV3HighestPriority,
+                                         QuicTime::Infinite()));
+  EXPECT_TRUE(session_.datagram_queue().empty());
+
+  // Queued when the connection is blocked.
+  EXPECT_CALL(*connection_, SendMessage(2, MessageDataIs("b")))
+      .WillOnce(Return(MESSAGE_STATUS_BLOCKED));
+  EXPECT_EQ(MESSAGE_STATUS_SUCCESS,
+            session_.SendOrQueueDatagram("b", kV3HighestPriority,
+                                         QuicTime::Infinite()));
+  EXPECT_EQ(1u, session_.datagram_queue().queue_size());
+  EXPECT_TRUE(session_.WillingAndAbleToWrite());
+
+  // Queued behind "b" without trying to send it.
+  EXPECT_EQ(MESSAGE_STATUS_SUCCESS,
+            session_.SendOrQueueDatagram("c", kV3HighestPriority,
+                                         QuicTime::Infinite()));
+  EXPECT_EQ(2u, session_.datagram_queue().queue_size());
+
+  // Rejected datagrams are not queued.
+  EXPECT_EQ(MESSAGE_STATUS_TOO_LARGE,
+            session_.SendOrQueueDatagram(
+                QuicString(session_.GetLargestMessagePayload() + 1, 'd'),
+                kV3HighestPriority, QuicTime::Infinite()));
+  EXPECT_EQ(2u, session_.datagram_queue().queue_size());
+
+  InSequence s;
+  EXPECT_CALL(*connection_, SendMessage(2, MessageDataIs("b")))
+      .WillOnce(Return(MESSAGE_STATUS_SUCCESS));
+  EXPECT_CALL(*connection_, SendMessage(3, MessageDataIs("c")))
+      .WillOnce(Return(MESSAGE_STATUS_SUCCESS));
+  session_.OnCanWrite();
+  EXPECT_TRUE(session_.datagram_queue().empty());
+  EXPECT_FALSE(session_.WillingAndAbleToWrite());
+  EXPECT_EQ(3u, session_.datagram_queue().datagrams_sent());
+
+  session_.OnMessageLost(2);
+  EXPECT_EQ(1u, session_.datagram_queue().datagrams_lost());
+}
+
+TEST_P(QuicSessionTestServer, FlushDatagramsWhenEncryptionIsEstablished) {
+  if (transport_version() <= QUIC_VERSION_44) {
+    // Messages are not supported.
+    return;
+  }
+  // Queued without trying the connection, which cannot encrypt it yet.
+  EXPECT_CALL(*connection_, SendMessage(_, _)).Times(0);
+  EXPECT_EQ(MESSAGE_STATUS_SUCCESS,
+            session_.SendOrQueueDatagram("a", kV3HighestPriority,
+                                         QuicTime::Infinite()));
+  EXPECT_EQ(1u, session_.datagram_queue().queue_size());
+  EXPECT_FALSE(session_.WillingAndAbleToWrite());
+
+  EXPECT_CALL(*connection_, SendMessage(1, MessageDataIs("a")))
+      .WillOnce(Return(MESSAGE_STATUS_SUCCESS));
+  CryptoHandshakeMessage handshake_message;
+  session_.GetMutableCryptoStream()->OnHandshakeMessage(handshake_message);
+  EXPECT_TRUE(session_.datagram_queue().empty());
+  EXPECT_EQ(1u, session_.datagram_queue().datagrams_sent());
+}
+
+TEST_P(QuicSessionTestServer, DropExpiredDatagrams) {
+  if (transport_version() <= QUIC_VERSION_44) {
+    // Messages are not supported.
+    return;
+  }
+  CryptoHandshakeMessage handshake_message;
+  session_.GetMutableCryptoStream()->OnHandshakeMessage(handshake_message);
+
+  const QuicTime now = connection_->clock()->ApproximateNow();
+  EXPECT_CALL(*connection_, SendMessage(1, MessageDataIs("a")))
+      .WillOnce(Return(MESSAGE_STATUS_BLOCKED));
+  session_.SendOrQueueDatagram("a", kV3HighestPriority,
+                               now + QuicTime::Delta::FromMilliseconds(10));
+  // Queued behind "a", which has a higher priority.
+  session_.SendOrQueueDatagram("b", kV3LowestPriority,
+                               now + QuicTime::Delta::FromMilliseconds(30));
+  EXPECT_EQ(2u, session_.datagram_queue().queue_size());
+
+  // Only "b" is still fresh by the time the connection can write.
+  connection_->AdvanceTime(QuicTime::Delta::FromMilliseconds(20));
+  EXPECT_CALL(*connection_, SendMessage(1, MessageDataIs("b")))
+      .WillOnce(Return(MESSAGE_STATUS_SUCCESS));
+  session_.OnCanWrite();
+  EXPECT_TRUE(session_.datagram_queue().empty());
+  EXPECT_EQ(1u, session_.datagram_queue().datagrams_sent());
+  EXPECT_EQ(1u, session_.datagram_queue().datagrams_expired());
+}
+
+TEST_P(QuicSessionTestServer, InterleaveDatagramsWithStreamsByPriority) {
+  if (transport_version() <= QUIC_VERSION_44) {
+    // Messages are not supported.
+    return;
+  }
+  CryptoHandshakeMessage handshake_message;
+  session_.GetMutableCryptoStream()->OnHandshakeMessage(handshake_message);
+  session_.set_writev_consumes_all_data(true);
+  TestStream* stream2 = session_.CreateOutgoingBidirectionalStream();
+  session_.MarkConnectionLevelWriteBlocked(stream2->id());
+
+  InSequence s;
+  EXPECT_CALL(*connection_, SendMessage(1, MessageDataIs("low")))
+      .WillOnce(Return(MESSAGE_STATUS_BLOCKED));
+  session_.SendOrQueueDatagram("low", kV3LowestPriority, QuicTime::Infinite());
+  EXPECT_CALL(*connection_, SendMessage(1, MessageDataIs("high")))
+      .WillOnce(Return(MESSAGE_STATUS_BLOCKED));
+  session_.SendOrQueueDatagram("high", kV3HighestPriority,
+                               QuicTime::Infinite());
+
+  // The stream has the default priority, which is between the two datagrams.
+  EXPECT_CALL(*connection_, SendMessage(1, MessageDataIs("high")))
+      .WillOnce(Return(MESSAGE_STATUS_SUCCESS));
+  EXPECT_CALL(*stream2, OnCanWrite()).WillOnce(Invoke([this, stream2]() {
+    session_.SendStreamData(stream2);
+  }));
+  EXPECT_CALL(*connection_, SendMessage(2, MessageDataIs("low")))
+      .WillOnce(Return(MESSAGE_STATUS_SUCCESS));
+  session_.OnCanWrite();
+  EXPECT_TRUE(session_.datagram_queue().empty());
+}
+
 // Regression test of b/115323618.
 TEST_P(QuicSessionTestServer, LocallyResetZombieStreams) {
   QuicConnectionPeer::SetSessionDecidesWhatToWrite(connection_);
@@ -0,0 +1,47 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/quic_shared_buffer.h"
+
+#include <memory>
+#include <utility>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
+
+namespace quic {
+
+namespace {
+
+// A QuicSharedBuffer which owns its data in a string. The string is allocated
+// on the heap so that the base class can point into it before |data_| is
+// initialized.
+class StringSharedBuffer : public QuicSharedBuffer {
+ public:
+  explicit StringSharedBuffer(QuicString data)
+      : StringSharedBuffer(QuicMakeUnique<QuicString>(std::move(data))) {}
+
+ protected:
+  ~StringSharedBuffer() override {}
+
+ private:
+  explicit StringSharedBuffer(std::unique_ptr<QuicString> data)
+      : QuicSharedBuffer(*data), data_(std::move(data)) {}
+
+  std::unique_ptr<QuicString> data_;
+};
+
+}  // namespace
+
+// static
+QuicReferenceCountedPointer<QuicSharedBuffer> QuicSharedBuffer::Create(
+    QuicString data) {
+  return QuicReferenceCountedPointer<QuicSharedBuffer>(
+      new StringSharedBuffer(std::move(data)));
+}
+
+QuicSharedBuffer::QuicSharedBuffer(QuicStringPiece data) : data_(data) {}
+
+QuicSharedBuffer::~QuicSharedBuffer() {}
+
+}  // namespace quic
@@ -0,0 +1,44 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_SHARED_BUFFER_H_
+#define QUICHE_QUIC_CORE_QUIC_SHARED_BUFFER_H_
+
+#include <cstddef>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_reference_counted.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
+
+namespace quic {
+
+// An immutable, reference counted data buffer. Stream send buffers hold a
+// reference to it instead of copying its data, so the same buffer can be
+// written to any number of streams at once. Subclasses own the memory, which
+// must stay valid and unchanged until the buffer is destroyed.
+class QUIC_EXPORT_PRIVATE QuicSharedBuffer : public QuicReferenceCounted {
+ public:
+  // Returns a new buffer which takes ownership of |data|.
+  static QuicReferenceCountedPointer<QuicSharedBuffer> Create(QuicString data);
+
+  QuicSharedBuffer(const QuicSharedBuffer&) = delete;
+  QuicSharedBuffer& operator=(const QuicSharedBuffer&) = delete;
+
+  QuicStringPiece data() const { return data_; }
+  size_t length() const { return data_.length(); }
+  bool empty() const { return data_.empty(); }
+
+ protected:
+  // |data| is owned by the subclass.
+  explicit QuicSharedBuffer(QuicStringPiece data);
+  ~QuicSharedBuffer() override;
+
+ private:
+  const QuicStringPiece data_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_SHARED_BUFFER_H_
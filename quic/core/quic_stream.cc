@@ -416,6 +416,23 @@ void QuicStream::WriteOrBufferData(
     QuicStringPiece data,
     bool fin,
     QuicReferenceCountedPointer<QuicAckListenerInterface> ack_listener) {
+  WriteOrBufferDataInner(data, nullptr, fin, std::move(ack_listener));
+}
+
+void QuicStream::WriteOrBufferSharedData(
+    QuicReferenceCountedPointer<QuicSharedBuffer> data,
+    bool fin,
+    QuicReferenceCountedPointer<QuicAckListenerInterface> ack_listener) {
+  const QuicStringPiece data_piece = data->data();
+  WriteOrBufferDataInner(data_piece, std::move(data), fin,
+                         std::move(ack_listener));
+}
+
+void QuicStream::WriteOrBufferDataInner(
+    QuicStringPiece data,
+    QuicReferenceCountedPointer<QuicSharedBuffer> shared_buffer,
+    bool fin,
+    QuicReferenceCountedPointer<QuicAckListenerInterface> ack_listener) {
   if (data.empty() && !fin) {
     QUIC_BUG << "data.empty() && !fin";
     return;
@@ -443,7 +460,6 @@ void QuicStream::WriteOrBufferData(
   // Do not respect buffered data upper limit as WriteOrBufferData guarantees
   // all data to be consumed.
   if (data.length() > 0) {
-    struct iovec iov(QuicUtils::MakeIovec(data));
     QuicStreamOffset offset = send_buffer_.stream_offset();
     if (kMaxStreamLength - offset < data.length()) {
       QUIC_BUG << "Write too many data via stream " << id_;
@@ -452,7 +468,12 @@ void QuicStream::WriteOrBufferData(
           QuicStrCat("Write too many data via stream ", id_));
       return;
     }
-    send_buffer_.SaveStreamData(&iov, 1, 0, data.length());
+    if (shared_buffer != nullptr) {
+      send_buffer_.SaveSharedBuffer(std::move(shared_buffer));
+    } else {
+      struct iovec iov(QuicUtils::MakeIovec(data));
+      send_buffer_.SaveStreamData(&iov, 1, 0, data.length());
+    }
     OnDataBuffered(offset, data.length(), ack_listener);
   }
   if (!had_buffered_data && (HasBufferedData() || fin_buffered_)) {
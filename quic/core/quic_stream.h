@@ -24,6 +24,7 @@
 #include "base/macros.h"
 #include "net/third_party/quiche/src/quic/core/quic_flow_controller.h"
 #include "net/third_party/quiche/src/quic/core/quic_packets.h"
+#include "net/third_party/quiche/src/quic/core/quic_shared_buffer.h"
 #include "net/third_party/quiche/src/quic/core/quic_stream_send_buffer.h"
 #include "net/third_party/quiche/src/quic/core/quic_stream_sequencer.h"
 #include "net/third_party/quiche/src/quic/core/quic_types.h"
@@ -277,6 +278,13 @@ class QUIC_EXPORT_PRIVATE QuicStream
       bool fin,
       QuicReferenceCountedPointer<QuicAckListenerInterface> ack_listener);
 
+  // Same as WriteOrBufferData except the send buffer holds a reference to
+  // |data| instead of a copy of it.
+  void WriteOrBufferSharedData(
+      QuicReferenceCountedPointer<QuicSharedBuffer> data,
+      bool fin,
+      QuicReferenceCountedPointer<QuicAckListenerInterface> ack_listener);
+
   // Adds random padding after the fin is consumed for this stream.
   void AddRandomPaddingAfterFin();
 
@@ -443,6 +451,14 @@ class QUIC_EXPORT_PRIVATE QuicStream
   // controller, marks this stream as connection-level write blocked.
   void MaybeSendBlocked();
 
+  // Implements WriteOrBufferData and WriteOrBufferSharedData. |data| is
+  // copied into the send buffer unless it is owned by |shared_buffer|.
+  void WriteOrBufferDataInner(
+      QuicStringPiece data,
+      QuicReferenceCountedPointer<QuicSharedBuffer> shared_buffer,
+      bool fin,
+      QuicReferenceCountedPointer<QuicAckListenerInterface> ack_listener);
+
   // Write buffered data in send buffer. TODO(fayang): Consider combine
   // WriteOrBufferData, Writev and WriteBufferedData.
   void WriteBufferedData();
@@ -20,14 +20,23 @@ namespace {
 
 struct CompareOffset {
   bool operator()(const BufferedSlice& slice, QuicStreamOffset offset) const {
-    return slice.offset + slice.slice.length() < offset;
+    return slice.offset + slice.data.length() < offset;
   }
 };
 
 }  // namespace
 
 BufferedSlice::BufferedSlice(QuicMemSlice mem_slice, QuicStreamOffset offset)
-    : slice(std::move(mem_slice)), offset(offset) {}
+    : slice(std::move(mem_slice)),
+      data(slice.data(), slice.length()),
+      offset(offset) {}
+
+BufferedSlice::BufferedSlice(
+    QuicReferenceCountedPointer<QuicSharedBuffer> shared_buffer,
+    QuicStreamOffset offset)
+    : shared_buffer(std::move(shared_buffer)),
+      data(this->shared_buffer->data()),
+      offset(offset) {}
 
 BufferedSlice::BufferedSlice(BufferedSlice&& other) = default;
 
@@ -35,6 +44,12 @@ BufferedSlice& BufferedSlice::operator=(BufferedSlice&& other) = default;
 
 BufferedSlice::~BufferedSlice() {}
 
+void BufferedSlice::Reset() {
+  slice.Reset();
+  shared_buffer = nullptr;
+  data = QuicStringPiece();
+}
+
 bool StreamPendingRetransmission::operator==(
     const StreamPendingRetransmission& other) const {
   return offset == other.offset && length == other.length;
@@ -83,6 +98,22 @@ void QuicStreamSendBuffer::SaveMemSlice(QuicMemSlice slice) {
   stream_offset_ += length;
 }
 
+void QuicStreamSendBuffer::SaveSharedBuffer(
+    QuicReferenceCountedPointer<QuicSharedBuffer> shared_buffer) {
+  QUIC_DVLOG(2) << "Save shared buffer offset " << stream_offset_ << " length "
+                << shared_buffer->length();
+  if (shared_buffer->empty()) {
+    QUIC_BUG << "Try to save empty shared buffer to send buffer.";
+    return;
+  }
+  size_t length = shared_buffer->length();
+  buffered_slices_.emplace_back(std::move(shared_buffer), stream_offset_);
+  if (write_index_ == -1) {
+    write_index_ = buffered_slices_.size() - 1;
+  }
+  stream_offset_ += length;
+}
+
 void QuicStreamSendBuffer::OnStreamDataConsumed(size_t bytes_consumed) {
   stream_bytes_written_ += bytes_consumed;
   stream_bytes_outstanding_ += bytes_consumed;
@@ -98,7 +129,7 @@ bool QuicStreamSendBuffer::WriteStreamData(QuicStreamOffset offset,
           // Assume with write_index, write mostly starts from indexed slice.
           : buffered_slices_.begin() + write_index_;
   if (write_index_ != -1) {
-    if (offset >= slice_it->offset + slice_it->slice.length()) {
+    if (offset >= slice_it->offset + slice_it->data.length()) {
       QUIC_BUG << "Tried to write data out of sequence.";
       return false;
     }
@@ -115,14 +146,14 @@ bool QuicStreamSendBuffer::WriteStreamData(QuicStreamOffset offset,
     if (data_length == 0 || offset < slice_it->offset) {
       break;
     }
-    if (offset >= slice_it->offset + slice_it->slice.length()) {
+    if (offset >= slice_it->offset + slice_it->data.length()) {
       continue;
     }
     QuicByteCount slice_offset = offset - slice_it->offset;
     QuicByteCount available_bytes_in_slice =
-        slice_it->slice.length() - slice_offset;
+        slice_it->data.length() - slice_offset;
     QuicByteCount copy_length = std::min(data_length, available_bytes_in_slice);
-    if (!writer->WriteBytes(slice_it->slice.data() + slice_offset,
+    if (!writer->WriteBytes(slice_it->data.data() + slice_offset,
                             copy_length)) {
       QUIC_BUG << "Writer fails to write.";
       return false;
@@ -242,19 +273,19 @@ bool QuicStreamSendBuffer::FreeMemSlices(QuicStreamOffset start,
   auto it = buffered_slices_.begin();
   // Find it, such that buffered_slices_[it - 1].end < start <=
   // buffered_slices_[it].end.
-  if (it == buffered_slices_.end() || it->slice.empty()) {
+  if (it == buffered_slices_.end() || it->data.empty()) {
     QUIC_BUG << "Trying to ack stream data [" << start << ", " << end << "), "
              << (it == buffered_slices_.end()
                      ? "and there is no outstanding data."
                      : "and the first slice is empty.");
     return false;
   }
-  if (start >= it->offset + it->slice.length() || start < it->offset) {
+  if (start >= it->offset + it->data.length() || start < it->offset) {
     // Slow path that not the earliest outstanding data gets acked.
     it = std::lower_bound(buffered_slices_.begin(), buffered_slices_.end(),
                           start, CompareOffset());
   }
-  if (it == buffered_slices_.end() || it->slice.empty()) {
+  if (it == buffered_slices_.end() || it->data.empty()) {
     QUIC_BUG << "Offset " << start
              << " does not exist or it has already been acked.";
     return false;
@@ -263,16 +294,16 @@ bool QuicStreamSendBuffer::FreeMemSlices(QuicStreamOffset start,
     if (it->offset >= end) {
       break;
     }
-    if (!it->slice.empty() &&
-        bytes_acked_.Contains(it->offset, it->offset + it->slice.length())) {
-      it->slice.Reset();
+    if (!it->data.empty() &&
+        bytes_acked_.Contains(it->offset, it->offset + it->data.length())) {
+      it->Reset();
     }
   }
   return true;
 }
 
 void QuicStreamSendBuffer::CleanUpBufferedSlices() {
-  while (!buffered_slices_.empty() && buffered_slices_.front().slice.empty()) {
+  while (!buffered_slices_.empty() && buffered_slices_.front().data.empty()) {
     // Remove data which stops waiting for acks. Please note, mem slices can
     // be released out of order, but send buffer is cleaned up in order.
     QUIC_BUG_IF(write_index_ == 0)
@@ -280,7 +311,7 @@ void QuicStreamSendBuffer::CleanUpBufferedSlices() {
            "whose data has all be written and ACK'ed or ignored. "
            "current_write_slice_ offset "
         << buffered_slices_[write_index_].offset << " length "
-        << buffered_slices_[write_index_].slice.length();
+        << buffered_slices_[write_index_].data.length();
     if (write_index_ > 0) {
       // If write index is pointing to any slice, reduce the index as the
       // slices are all shifted to the left by one.
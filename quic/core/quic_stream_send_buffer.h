@@ -7,9 +7,12 @@
 
 #include "net/third_party/quiche/src/quic/core/frames/quic_stream_frame.h"
 #include "net/third_party/quiche/src/quic/core/quic_interval_set.h"
+#include "net/third_party/quiche/src/quic/core/quic_shared_buffer.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_containers.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_iovec.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_mem_slice.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_reference_counted.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
 
 namespace quic {
 
@@ -26,6 +29,8 @@ class QuicDataWriter;
 // acked. It is move-only.
 struct BufferedSlice {
   BufferedSlice(QuicMemSlice mem_slice, QuicStreamOffset offset);
+  BufferedSlice(QuicReferenceCountedPointer<QuicSharedBuffer> shared_buffer,
+                QuicStreamOffset offset);
   BufferedSlice(BufferedSlice&& other);
   BufferedSlice& operator=(BufferedSlice&& other);
 
@@ -33,8 +38,15 @@ struct BufferedSlice {
   BufferedSlice& operator=(const BufferedSlice& other) = delete;
   ~BufferedSlice();
 
-  // Stream data of this data slice.
+  // Releases the stream data of this data slice.
+  void Reset();
+
+  // Stream data of this data slice if it is owned by the send buffer.
   QuicMemSlice slice;
+  // Stream data of this data slice if it is shared with other streams.
+  QuicReferenceCountedPointer<QuicSharedBuffer> shared_buffer;
+  // Stream data of this data slice, held by either |slice| or |shared_buffer|.
+  QuicStringPiece data;
   // Location of this data slice in the stream.
   QuicStreamOffset offset;
 };
@@ -72,6 +84,11 @@ class QUIC_EXPORT_PRIVATE QuicStreamSendBuffer {
   // Save |slice| to send buffer.
   void SaveMemSlice(QuicMemSlice slice);
 
+  // Save a reference to |shared_buffer| to send buffer. Its data is not
+  // copied.
+  void SaveSharedBuffer(
+      QuicReferenceCountedPointer<QuicSharedBuffer> shared_buffer);
+
   // Called when |bytes_consumed| bytes has been consumed by the stream.
   void OnStreamDataConsumed(size_t bytes_consumed);
 
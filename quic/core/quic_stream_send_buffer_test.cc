@@ -24,6 +24,19 @@ struct iovec MakeIovec(QuicStringPiece data) {
   return iov;
 }
 
+// A shared buffer which records its destruction.
+class TestSharedBuffer : public QuicSharedBuffer {
+ public:
+  TestSharedBuffer(QuicStringPiece data, bool* destroyed)
+      : QuicSharedBuffer(data), destroyed_(destroyed) {}
+
+ protected:
+  ~TestSharedBuffer() override { *destroyed_ = true; }
+
+ private:
+  bool* destroyed_;
+};
+
 class QuicStreamSendBufferTest : public QuicTest {
  public:
   QuicStreamSendBufferTest() : send_buffer_(&allocator_) {
@@ -286,6 +299,39 @@ TEST_F(QuicStreamSendBufferTest, CurrentWriteIndex) {
             QuicStreamSendBufferPeer::CurrentWriteSlice(&send_buffer_)->offset);
 }
 
+TEST_F(QuicStreamSendBufferTest, SaveSharedBuffer) {
+  WriteAllData();
+  const QuicString data(1000, 'e');
+  bool destroyed = false;
+  send_buffer_.SaveSharedBuffer(QuicReferenceCountedPointer<QuicSharedBuffer>(
+      new TestSharedBuffer(data, &destroyed)));
+  EXPECT_EQ(5u, send_buffer_.size());
+  EXPECT_EQ(3840u + data.length(), send_buffer_.stream_offset());
+  // The data is referenced rather than copied.
+  EXPECT_EQ(data.data(),
+            QuicStreamSendBufferPeer::CurrentWriteSlice(&send_buffer_)
+                ->data.data());
+
+  char buf[1000];
+  QuicDataWriter writer(1000, buf, HOST_BYTE_ORDER);
+  ASSERT_TRUE(send_buffer_.WriteStreamData(3840, 1000, &writer));
+  EXPECT_EQ(data, QuicStringPiece(buf, 1000));
+  send_buffer_.OnStreamDataConsumed(1000);
+
+  // The send buffer releases its reference once the data is acked.
+  QuicByteCount newly_acked_length;
+  EXPECT_TRUE(send_buffer_.OnStreamDataAcked(3840, 1000, &newly_acked_length));
+  EXPECT_EQ(1000u, newly_acked_length);
+  EXPECT_TRUE(destroyed);
+}
+
+TEST_F(QuicStreamSendBufferTest, SaveEmptySharedBuffer) {
+  EXPECT_QUIC_BUG(
+      send_buffer_.SaveSharedBuffer(QuicSharedBuffer::Create(QuicString())),
+      "Try to save empty shared buffer to send buffer.");
+  EXPECT_EQ(4u, send_buffer_.size());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace quic
@@ -24,6 +24,7 @@
 #include "net/third_party/quiche/src/quic/test_tools/quic_flow_controller_peer.h"
 #include "net/third_party/quiche/src/quic/test_tools/quic_session_peer.h"
 #include "net/third_party/quiche/src/quic/test_tools/quic_stream_peer.h"
+#include "net/third_party/quiche/src/quic/test_tools/quic_stream_send_buffer_peer.h"
 #include "net/third_party/quiche/src/quic/test_tools/quic_stream_sequencer_peer.h"
 #include "net/third_party/quiche/src/quic/test_tools/quic_test_utils.h"
 
@@ -1159,6 +1160,37 @@ TEST_P(QuicStreamTest, WriteMemSlices) {
   EXPECT_TRUE(stream_->write_side_closed());
 }
 
+TEST_P(QuicStreamTest, WriteOrBufferSharedData) {
+  Initialize();
+  QuicReferenceCountedPointer<QuicSharedBuffer> buffer =
+      QuicSharedBuffer::Create(QuicString(1024, 'a'));
+
+  EXPECT_CALL(*session_, WritevData(_, _, _, _, _))
+      .WillOnce(InvokeWithoutArgs([this]() {
+        return MockQuicSession::ConsumeData(stream_, stream_->id(), 100u, 0u,
+                                            NO_FIN);
+      }));
+  stream_->WriteOrBufferSharedData(buffer, false, nullptr);
+  EXPECT_EQ(buffer->length() - 100, stream_->BufferedDataBytes());
+  // The send buffer refers to the shared data instead of a copy of it.
+  EXPECT_EQ(buffer->data().data(),
+            QuicStreamSendBufferPeer::CurrentWriteSlice(
+                &QuicStreamPeer::SendBuffer(stream_))
+                ->data.data());
+
+  // The same buffer can be written again.
+  stream_->WriteOrBufferSharedData(buffer, true, nullptr);
+  EXPECT_EQ(2 * buffer->length() - 100, stream_->BufferedDataBytes());
+  EXPECT_TRUE(stream_->fin_buffered());
+
+  // Flush all buffered data.
+  EXPECT_CALL(*session_, WritevData(_, _, _, _, _))
+      .WillOnce(Invoke(MockQuicSession::ConsumeData));
+  stream_->OnCanWrite();
+  EXPECT_FALSE(stream_->HasBufferedData());
+  EXPECT_TRUE(stream_->write_side_closed());
+}
+
 TEST_P(QuicStreamTest, WriteMemSlicesReachStreamLimit) {
   Initialize();
   QuicStreamPeer::SetStreamBytesWritten(kMaxStreamLength - 5u, stream_);
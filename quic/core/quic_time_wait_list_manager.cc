@@ -5,11 +5,14 @@
 #include "net/third_party/quiche/src/quic/core/quic_time_wait_list_manager.h"
 
 #include <errno.h>
+#include <netinet/in.h>
 
+#include <algorithm>
 #include <memory>
 
 #include "base/macros.h"
 #include "net/third_party/quiche/src/quic/core/crypto/crypto_protocol.h"
+#include "net/third_party/quiche/src/quic/core/crypto/quic_crypto_server_config.h"
 #include "net/third_party/quiche/src/quic/core/crypto/quic_decrypter.h"
 #include "net/third_party/quiche/src/quic/core/crypto/quic_encrypter.h"
 #include "net/third_party/quiche/src/quic/core/quic_connection_id.h"
@@ -22,10 +25,47 @@
 #include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_map_util.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_server_stats.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_socket_address.h"
 
 namespace quic {
 
+namespace {
+
+// The maximum number of source subnets that have their own response token
+// bucket.
+const size_t kMaxSubnetTokenBuckets = 10000;
+
+// Set in the keys of IPv4 subnets, above the 48 bits of an IPv6 subnet.
+const uint64_t kIPv4SubnetKeyBit = UINT64_C(1) << 63;
+
+// Returns the /24 IPv4 or /48 IPv6 subnet of |address| as an integer.
+// IPv4-mapped IPv6 addresses share the keys of their IPv4 addresses.
+uint64_t SubnetKey(const QuicSocketAddress& address) {
+  const sockaddr_storage storage = address.generic_address();
+  const uint8_t* bytes;
+  if (storage.ss_family == AF_INET) {
+    bytes = reinterpret_cast<const uint8_t*>(
+        &reinterpret_cast<const sockaddr_in*>(&storage)->sin_addr);
+  } else {
+    const in6_addr& addr6 =
+        reinterpret_cast<const sockaddr_in6*>(&storage)->sin6_addr;
+    bytes = reinterpret_cast<const uint8_t*>(&addr6);
+    if (!IN6_IS_ADDR_V4MAPPED(&addr6)) {
+      uint64_t key = 0;
+      for (size_t i = 0; i < 6; ++i) {
+        key = (key << 8) | bytes[i];
+      }
+      return key;
+    }
+    bytes += 12;
+  }
+  return kIPv4SubnetKeyBit | (uint64_t{bytes[0]} << 16) |
+         (uint64_t{bytes[1]} << 8) | bytes[2];
+}
+
+}  // namespace
+
 // A very simple alarm that just informs the QuicTimeWaitListManager to clean
 // up old connection_ids. This alarm should be cancelled and deleted before
 // the QuicTimeWaitListManager is deleted.
@@ -57,7 +97,13 @@ QuicTimeWaitListManager::QuicTimeWaitListManager(
           alarm_factory->CreateAlarm(new ConnectionIdCleanUpAlarm(this))),
       clock_(clock),
       writer_(writer),
-      visitor_(visitor) {
+      visitor_(visitor),
+      compact_mode_(false),
+      crypto_config_(nullptr),
+      max_packets_per_second_(0),
+      max_packets_per_second_per_subnet_(0),
+      num_packets_rate_limited_(0),
+      num_packets_rate_limited_per_subnet_(0) {
   SetConnectionIdCleanUpAlarm();
 }
 
@@ -72,6 +118,21 @@ void QuicTimeWaitListManager::AddConnectionIdToTimeWait(
     std::vector<std::unique_ptr<QuicEncryptedPacket>>* termination_packets) {
   DCHECK(action != SEND_TERMINATION_PACKETS || termination_packets != nullptr);
   DCHECK(action != DO_NOTHING || ietf_quic);
+  if (compact_mode_ &&
+      (action == SEND_STATELESS_RESET || action == DO_NOTHING) &&
+      (termination_packets == nullptr || termination_packets->empty())) {
+    // The stateless reset can be rebuilt from the connection ID alone, and a
+    // connection closed by the peer needs no response, so there is nothing to
+    // keep for this connection ID.
+    if (action == DO_NOTHING) {
+      QUIC_CODE_COUNT(quic_time_wait_list_compact_do_nothing);
+    } else {
+      QUIC_CODE_COUNT(quic_time_wait_list_compact_stateless_reset);
+    }
+    connection_id_map_.erase(connection_id);
+    visitor_->OnConnectionAddedToTimeWaitList(connection_id);
+    return;
+  }
   int num_packets = 0;
   auto it = connection_id_map_.find(connection_id);
   const bool new_connection_id = it == connection_id_map_.end();
@@ -143,6 +204,10 @@ void QuicTimeWaitListManager::ProcessPacket(
         QUIC_BUG << "There are no termination packets.";
         return;
       }
+      if (!ConsumeResponseTokens(
+              peer_address, connection_data->termination_packets.size())) {
+        return;
+      }
       for (const auto& packet : connection_data->termination_packets) {
         SendOrQueuePacket(QuicMakeUnique<QueuedPacket>(
                               self_address, peer_address, packet->Clone()),
@@ -150,6 +215,9 @@ void QuicTimeWaitListManager::ProcessPacket(
       }
       return;
     case SEND_STATELESS_RESET:
+      if (!ConsumeResponseTokens(peer_address, 1)) {
+        return;
+      }
       SendPublicReset(self_address, peer_address, connection_id,
                       connection_data->ietf_quic, std::move(packet_context));
       return;
@@ -159,6 +227,20 @@ void QuicTimeWaitListManager::ProcessPacket(
   }
 }
 
+void QuicTimeWaitListManager::SendStatelessReset(
+    const QuicSocketAddress& self_address,
+    const QuicSocketAddress& peer_address,
+    QuicConnectionId connection_id,
+    bool ietf_quic,
+    std::unique_ptr<QuicPerPacketContext> packet_context) {
+  DCHECK(!IsConnectionIdInTimeWait(connection_id));
+  if (!ConsumeResponseTokens(peer_address, 1)) {
+    return;
+  }
+  SendPublicReset(self_address, peer_address, connection_id, ietf_quic,
+                  std::move(packet_context));
+}
+
 void QuicTimeWaitListManager::SendVersionNegotiationPacket(
     QuicConnectionId connection_id,
     bool ietf_quic,
@@ -166,6 +248,9 @@ void QuicTimeWaitListManager::SendVersionNegotiationPacket(
     const QuicSocketAddress& self_address,
     const QuicSocketAddress& peer_address,
     std::unique_ptr<QuicPerPacketContext> packet_context) {
+  if (!ConsumeResponseTokens(peer_address, 1)) {
+    return;
+  }
   SendOrQueuePacket(QuicMakeUnique<QueuedPacket>(
                         self_address, peer_address,
                         QuicFramer::BuildVersionNegotiationPacket(
@@ -173,6 +258,82 @@ void QuicTimeWaitListManager::SendVersionNegotiationPacket(
                     packet_context.get());
 }
 
+void QuicTimeWaitListManager::SetResponseRateLimits(
+    QuicPacketCount max_packets_per_second,
+    QuicPacketCount max_packets_per_second_per_subnet) {
+  max_packets_per_second_ = max_packets_per_second;
+  max_packets_per_second_per_subnet_ = max_packets_per_second_per_subnet;
+  token_bucket_.tokens = max_packets_per_second;
+  token_bucket_.last_update = clock_->ApproximateNow();
+  subnet_token_buckets_.clear();
+}
+
+bool QuicTimeWaitListManager::RefillTokenBucket(
+    TokenBucket* bucket,
+    QuicPacketCount max_packets_per_second,
+    size_t num_packets) const {
+  const QuicTime now = clock_->ApproximateNow();
+  if (now > bucket->last_update) {
+    bucket->tokens = std::min<double>(
+        max_packets_per_second,
+        bucket->tokens + (now - bucket->last_update).ToMicroseconds() *
+                             max_packets_per_second / 1e6);
+  }
+  bucket->last_update = now;
+  return bucket->tokens >= num_packets;
+}
+
+bool QuicTimeWaitListManager::ConsumeResponseTokens(
+    const QuicSocketAddress& peer_address,
+    size_t num_packets) {
+  if (max_packets_per_second_ > 0) {
+    const bool rate_limited =
+        !RefillTokenBucket(&token_bucket_, max_packets_per_second_,
+                           num_packets);
+    QUIC_SERVER_HISTOGRAM_BOOL(
+        "QuicTimeWaitListManager.ResponseRateLimited", rate_limited,
+        "Whether the overall time-wait response rate limit dropped a "
+        "response.");
+    if (rate_limited) {
+      QUIC_CODE_COUNT(quic_time_wait_list_response_rate_limited);
+      num_packets_rate_limited_ += num_packets;
+      return false;
+    }
+  }
+  if (max_packets_per_second_per_subnet_ > 0) {
+    const uint64_t subnet = SubnetKey(peer_address);
+    auto it = subnet_token_buckets_.find(subnet);
+    if (it == subnet_token_buckets_.end()) {
+      // Evicts the bucket created first.  An evicted subnet starts again with
+      // a full bucket, as it would after a second without responses.
+      if (subnet_token_buckets_.size() >= kMaxSubnetTokenBuckets) {
+        subnet_token_buckets_.pop_front();
+      }
+      TokenBucket bucket;
+      bucket.tokens = max_packets_per_second_per_subnet_;
+      bucket.last_update = clock_->ApproximateNow();
+      it = subnet_token_buckets_.emplace(std::make_pair(subnet, bucket)).first;
+    }
+    TokenBucket* subnet_bucket = &it->second;
+    const bool rate_limited = !RefillTokenBucket(
+        subnet_bucket, max_packets_per_second_per_subnet_, num_packets);
+    QUIC_SERVER_HISTOGRAM_BOOL(
+        "QuicTimeWaitListManager.ResponseRateLimitedPerSubnet", rate_limited,
+        "Whether the per-subnet time-wait response rate limit dropped a "
+        "response.");
+    if (rate_limited) {
+      QUIC_CODE_COUNT(quic_time_wait_list_response_rate_limited_per_subnet);
+      num_packets_rate_limited_per_subnet_ += num_packets;
+      return false;
+    }
+    subnet_bucket->tokens -= num_packets;
+  }
+  if (max_packets_per_second_ > 0) {
+    token_bucket_.tokens -= num_packets;
+  }
+  return true;
+}
+
 // Returns true if the number of packets received for this connection_id is a
 // power of 2 to throttle the number of public reset packets we send to a peer.
 bool QuicTimeWaitListManager::ShouldSendResponse(int received_packet_count) {
@@ -336,6 +497,9 @@ QuicTimeWaitListManager::ConnectionIdData::~ConnectionIdData() = default;
 
 QuicUint128 QuicTimeWaitListManager::GetStatelessResetToken(
     QuicConnectionId connection_id) const {
+  if (crypto_config_ != nullptr) {
+    return crypto_config_->GenerateStatelessResetToken(connection_id);
+  }
   return QuicUtils::GenerateStatelessResetToken(connection_id);
 }
 
@@ -9,6 +9,7 @@
 #define QUICHE_QUIC_CORE_QUIC_TIME_WAIT_LIST_MANAGER_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 
 #include "base/macros.h"
@@ -22,6 +23,8 @@
 
 namespace quic {
 
+class QuicCryptoServerConfig;
+
 namespace test {
 class QuicDispatcherPeer;
 class QuicTimeWaitListManagerPeer;
@@ -83,7 +86,9 @@ class QuicTimeWaitListManager : public QuicBlockedWriterInterface {
 
   // Returns true if the connection_id is in time wait state, false otherwise.
   // Packets received for this connection_id should not lead to creation of new
-  // QuicSessions.
+  // QuicSessions.  In compact mode, connection IDs which were added with
+  // SEND_STATELESS_RESET or DO_NOTHING and no termination packets are not kept,
+  // and this returns false for them.
   bool IsConnectionIdInTimeWait(QuicConnectionId connection_id) const;
 
   // Called when a packet is received for a connection_id that is in time wait
@@ -97,6 +102,16 @@ class QuicTimeWaitListManager : public QuicBlockedWriterInterface {
       QuicConnectionId connection_id,
       std::unique_ptr<QuicPerPacketContext> packet_context);
 
+  // Sends a stateless reset (public reset for GQUIC) for |connection_id| to
+  // |peer_address|.  Used for packets of connections that were not kept in
+  // compact mode.  The reset is built from |connection_id| alone, see
+  // GetStatelessResetToken().
+  void SendStatelessReset(const QuicSocketAddress& self_address,
+                          const QuicSocketAddress& peer_address,
+                          QuicConnectionId connection_id,
+                          bool ietf_quic,
+                          std::unique_ptr<QuicPerPacketContext> packet_context);
+
   // Called by the dispatcher when the underlying socket becomes writable again,
   // since we might need to send pending public reset packets which we didn't
   // send because the underlying socket was write blocked.
@@ -130,6 +145,40 @@ class QuicTimeWaitListManager : public QuicBlockedWriterInterface {
   // Return a non-owning pointer to the packet writer.
   QuicPacketWriter* writer() { return writer_; }
 
+  // If |compact_mode| is true, connection IDs that only need a stateless reset
+  // or nothing at all are not stored, so memory use only grows with the number
+  // of connections that have termination packets.  Packets of a connection
+  // the peer closed (DO_NOTHING) are then treated like those of any unknown
+  // connection, and may be answered with a stateless reset which the peer
+  // ignores.
+  void set_compact_mode(bool compact_mode) { compact_mode_ = compact_mode; }
+  bool compact_mode() const { return compact_mode_; }
+
+  // If set, stateless reset tokens are derived with
+  // QuicCryptoServerConfig::GenerateStatelessResetToken(), which is what
+  // server sessions send to their peers.  |crypto_config| must outlive this.
+  void set_crypto_config(const QuicCryptoServerConfig* crypto_config) {
+    crypto_config_ = crypto_config;
+  }
+
+  // Limits the packets sent in response to packets of connections in time
+  // wait state (stateless resets, termination packets and version negotiation
+  // packets) to |max_packets_per_second| overall and to
+  // |max_packets_per_second_per_subnet| per /24 IPv4 or /48 IPv6 source
+  // subnet.  Each limit allows bursts of up to one second's worth of packets.
+  // A limit of 0 disables it, which is the default.
+  void SetResponseRateLimits(QuicPacketCount max_packets_per_second,
+                             QuicPacketCount max_packets_per_second_per_subnet);
+
+  // The number of packets not sent because of the overall and the per-subnet
+  // response rate limits.
+  QuicPacketCount num_packets_rate_limited() const {
+    return num_packets_rate_limited_;
+  }
+  QuicPacketCount num_packets_rate_limited_per_subnet() const {
+    return num_packets_rate_limited_per_subnet_;
+  }
+
  protected:
   virtual std::unique_ptr<QuicEncryptedPacket> BuildPublicReset(
       const QuicPublicResetPacket& packet);
@@ -217,6 +266,24 @@ class QuicTimeWaitListManager : public QuicBlockedWriterInterface {
   std::unique_ptr<QuicEncryptedPacket> BuildIetfStatelessResetPacket(
       QuicConnectionId connection_id);
 
+  // Packets which can be sent at the rate of a response rate limit.
+  struct TokenBucket {
+    double tokens = 0;
+    QuicTime last_update = QuicTime::Zero();
+  };
+
+  // Refills |bucket| for |max_packets_per_second|, and returns true if it has
+  // at least |num_packets| tokens.
+  bool RefillTokenBucket(TokenBucket* bucket,
+                         QuicPacketCount max_packets_per_second,
+                         size_t num_packets) const;
+
+  // Returns true if |num_packets| packets can be sent to |peer_address| within
+  // the response rate limits, and takes them from the token buckets.  Checked
+  // before the packets are built, so rate limited responses cost no CPU.
+  bool ConsumeResponseTokens(const QuicSocketAddress& peer_address,
+                             size_t num_packets);
+
   // A map from a recently closed connection_id to the number of packets
   // received after the termination of the connection bound to the
   // connection_id.
@@ -265,6 +332,24 @@ class QuicTimeWaitListManager : public QuicBlockedWriterInterface {
 
   // Interface that manages blocked writers.
   Visitor* visitor_;
+
+  // If true, connection IDs added with SEND_STATELESS_RESET or DO_NOTHING and
+  // no termination packets are not stored in |connection_id_map_|.
+  bool compact_mode_;
+
+  // Not owned.  May be null, see set_crypto_config().
+  const QuicCryptoServerConfig* crypto_config_;
+
+  // Response rate limits, see SetResponseRateLimits().
+  QuicPacketCount max_packets_per_second_;
+  QuicPacketCount max_packets_per_second_per_subnet_;
+  TokenBucket token_bucket_;
+  // Token buckets of recent source subnets, keyed by the /24 IPv4 or /48 IPv6
+  // prefix as an integer, in the order they were created.
+  QuicLinkedHashMap<uint64_t, TokenBucket> subnet_token_buckets_;
+
+  QuicPacketCount num_packets_rate_limited_;
+  QuicPacketCount num_packets_rate_limited_per_subnet_;
 };
 
 }  // namespace quic
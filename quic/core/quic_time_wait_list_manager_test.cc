@@ -313,6 +313,139 @@ TEST_F(QuicTimeWaitListManagerTest, SendPublicReset) {
   ProcessPacket(connection_id_);
 }
 
+TEST_F(QuicTimeWaitListManagerTest, CompactModeDoesNotKeepStatelessResets) {
+  time_wait_list_manager_.set_compact_mode(true);
+  EXPECT_CALL(visitor_, OnConnectionAddedToTimeWaitList(connection_id_));
+  AddConnectionId(connection_id_,
+                  QuicTimeWaitListManager::SEND_STATELESS_RESET);
+  EXPECT_FALSE(IsConnectionIdInTimeWait(connection_id_));
+  EXPECT_EQ(0u, time_wait_list_manager_.num_connections());
+
+  // The reset is built from the connection ID alone.
+  EXPECT_CALL(writer_,
+              WritePacket(_, _, self_address_.host(), peer_address_, _))
+      .With(Args<0, 1>(PublicResetPacketEq(connection_id_)))
+      .WillOnce(Return(WriteResult(WRITE_STATUS_OK, 0)));
+  time_wait_list_manager_.SendStatelessReset(
+      self_address_, peer_address_, connection_id_,
+      QuicVersionMax().transport_version > QUIC_VERSION_43,
+      QuicMakeUnique<QuicPerPacketContext>());
+
+  // Connections with termination packets are still kept.
+  QuicConnectionId other_connection_id = TestConnectionId(46);
+  EXPECT_CALL(visitor_, OnConnectionAddedToTimeWaitList(other_connection_id));
+  AddStatelessConnectionId(other_connection_id);
+  EXPECT_TRUE(IsConnectionIdInTimeWait(other_connection_id));
+  EXPECT_EQ(1u, time_wait_list_manager_.num_connections());
+
+  // Re-adding a kept connection ID with only a stateless reset removes it.
+  EXPECT_CALL(visitor_, OnConnectionAddedToTimeWaitList(other_connection_id));
+  AddConnectionId(other_connection_id,
+                  QuicTimeWaitListManager::SEND_STATELESS_RESET);
+  EXPECT_FALSE(IsConnectionIdInTimeWait(other_connection_id));
+  EXPECT_EQ(0u, time_wait_list_manager_.num_connections());
+}
+
+TEST_F(QuicTimeWaitListManagerTest, CompactModeDoesNotKeepPeerClosures) {
+  time_wait_list_manager_.set_compact_mode(true);
+  EXPECT_CALL(visitor_, OnConnectionAddedToTimeWaitList(connection_id_));
+  AddConnectionId(connection_id_, QuicTimeWaitListManager::DO_NOTHING);
+  EXPECT_FALSE(IsConnectionIdInTimeWait(connection_id_));
+  EXPECT_EQ(0u, time_wait_list_manager_.num_connections());
+
+  // Re-adding a kept connection ID for a peer closure removes it.
+  QuicConnectionId other_connection_id = TestConnectionId(46);
+  EXPECT_CALL(visitor_, OnConnectionAddedToTimeWaitList(other_connection_id))
+      .Times(2);
+  AddStatelessConnectionId(other_connection_id);
+  EXPECT_EQ(1u, time_wait_list_manager_.num_connections());
+  AddConnectionId(other_connection_id, QuicTimeWaitListManager::DO_NOTHING);
+  EXPECT_FALSE(IsConnectionIdInTimeWait(other_connection_id));
+  EXPECT_EQ(0u, time_wait_list_manager_.num_connections());
+}
+
+TEST_F(QuicTimeWaitListManagerTest, ResponseRateLimit) {
+  time_wait_list_manager_.SetResponseRateLimits(2, 0);
+  EXPECT_CALL(visitor_, OnConnectionAddedToTimeWaitList(_)).Times(3);
+  for (uint64_t i = 1; i <= 3; ++i) {
+    AddConnectionId(TestConnectionId(i),
+                    QuicTimeWaitListManager::SEND_STATELESS_RESET);
+  }
+  // Only the first two resets fit in the burst.
+  EXPECT_CALL(writer_, WritePacket(_, _, _, _, _))
+      .Times(2)
+      .WillRepeatedly(Return(WriteResult(WRITE_STATUS_OK, 1)));
+  ProcessPacket(TestConnectionId(1));
+  ProcessPacket(TestConnectionId(2));
+  ProcessPacket(TestConnectionId(3));
+  EXPECT_EQ(1u, time_wait_list_manager_.num_packets_rate_limited());
+
+  // Half a second later, one more reset can be sent.
+  clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(500));
+  EXPECT_CALL(writer_, WritePacket(_, _, _, _, _))
+      .WillOnce(Return(WriteResult(WRITE_STATUS_OK, 1)));
+  time_wait_list_manager_.SendVersionNegotiationPacket(
+      connection_id_, false, AllSupportedVersions(), self_address_,
+      peer_address_, QuicMakeUnique<QuicPerPacketContext>());
+  time_wait_list_manager_.SendVersionNegotiationPacket(
+      connection_id_, false, AllSupportedVersions(), self_address_,
+      peer_address_, QuicMakeUnique<QuicPerPacketContext>());
+  EXPECT_EQ(2u, time_wait_list_manager_.num_packets_rate_limited());
+}
+
+TEST_F(QuicTimeWaitListManagerTest, ResponseRateLimitPerSubnet) {
+  time_wait_list_manager_.SetResponseRateLimits(0, 1);
+  QuicIpAddress same_subnet;
+  ASSERT_TRUE(same_subnet.FromString("192.0.2.1"));
+  QuicIpAddress same_subnet2;
+  ASSERT_TRUE(same_subnet2.FromString("192.0.2.200"));
+  QuicIpAddress other_subnet;
+  ASSERT_TRUE(other_subnet.FromString("192.0.3.1"));
+
+  EXPECT_CALL(writer_, WritePacket(_, _, _, _, _))
+      .Times(2)
+      .WillRepeatedly(Return(WriteResult(WRITE_STATUS_OK, 1)));
+  for (const QuicIpAddress& address :
+       {same_subnet, same_subnet2, other_subnet}) {
+    time_wait_list_manager_.SendVersionNegotiationPacket(
+        connection_id_, false, AllSupportedVersions(), self_address_,
+        QuicSocketAddress(address, kTestPort),
+        QuicMakeUnique<QuicPerPacketContext>());
+  }
+  EXPECT_EQ(0u, time_wait_list_manager_.num_packets_rate_limited());
+  EXPECT_EQ(1u,
+            time_wait_list_manager_.num_packets_rate_limited_per_subnet());
+}
+
+TEST_F(QuicTimeWaitListManagerTest, ResponseRateLimitPerIPv6Subnet) {
+  time_wait_list_manager_.SetResponseRateLimits(0, 1);
+  QuicIpAddress same_subnet;
+  ASSERT_TRUE(same_subnet.FromString("2001:db8:1::1"));
+  QuicIpAddress same_subnet2;
+  ASSERT_TRUE(same_subnet2.FromString("2001:db8:1:ffff::2"));
+  QuicIpAddress other_subnet;
+  ASSERT_TRUE(other_subnet.FromString("2001:db8:2::1"));
+  QuicIpAddress ipv4;
+  ASSERT_TRUE(ipv4.FromString("192.0.2.1"));
+  QuicIpAddress ipv4_mapped;
+  ASSERT_TRUE(ipv4_mapped.FromString("::ffff:192.0.2.2"));
+
+  // Only the first packet to each of the two IPv6 subnets and the IPv4 subnet
+  // is sent.
+  EXPECT_CALL(writer_, WritePacket(_, _, _, _, _))
+      .Times(3)
+      .WillRepeatedly(Return(WriteResult(WRITE_STATUS_OK, 1)));
+  for (const QuicIpAddress& address :
+       {same_subnet, same_subnet2, other_subnet, ipv4, ipv4_mapped}) {
+    time_wait_list_manager_.SendVersionNegotiationPacket(
+        connection_id_, false, AllSupportedVersions(), self_address_,
+        QuicSocketAddress(address, kTestPort),
+        QuicMakeUnique<QuicPerPacketContext>());
+  }
+  EXPECT_EQ(2u,
+            time_wait_list_manager_.num_packets_rate_limited_per_subnet());
+}
+
 TEST_F(QuicTimeWaitListManagerTest, SendPublicResetWithExponentialBackOff) {
   EXPECT_CALL(visitor_, OnConnectionAddedToTimeWaitList(connection_id_));
   AddConnectionId(connection_id_,
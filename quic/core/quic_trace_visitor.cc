@@ -67,6 +67,7 @@ void QuicTraceVisitor::OnPacketSent(const SerializedPacket& serialized_packet,
       case MTU_DISCOVERY_FRAME:
       case STOP_WAITING_FRAME:
       case ACK_FRAME:
+      case FEC_FRAME:
         QUIC_BUG
             << "Frames of type are not retransmittable and are not supposed "
                "to be in retransmittable_frames";
@@ -211,6 +212,7 @@ void QuicTraceVisitor::PopulateFrameInfo(const QuicFrame& frame,
     case MESSAGE_FRAME:
     case CRYPTO_FRAME:
     case NEW_TOKEN_FRAME:
+    case FEC_FRAME:
       break;
 
     case NUM_FRAME_TYPES:
@@ -4,6 +4,8 @@
 
 #include "net/third_party/quiche/src/quic/core/quic_transmission_info.h"
 
+#include "net/third_party/quiche/src/quic/core/quic_constants.h"
+
 namespace quic {
 
 QuicTransmissionInfo::QuicTransmissionInfo()
@@ -15,7 +17,8 @@ QuicTransmissionInfo::QuicTransmissionInfo()
       in_flight(false),
       state(OUTSTANDING),
       has_crypto_handshake(false),
-      num_padding_bytes(0) {}
+      num_padding_bytes(0),
+      path_id(kDefaultPathId) {}
 
 QuicTransmissionInfo::QuicTransmissionInfo(
     EncryptionLevel level,
@@ -33,7 +36,8 @@ QuicTransmissionInfo::QuicTransmissionInfo(
       in_flight(false),
       state(OUTSTANDING),
       has_crypto_handshake(has_crypto_handshake),
-      num_padding_bytes(num_padding_bytes) {}
+      num_padding_bytes(num_padding_bytes),
+      path_id(kDefaultPathId) {}
 
 QuicTransmissionInfo::QuicTransmissionInfo(const QuicTransmissionInfo& other) =
     default;
@@ -55,6 +55,8 @@ struct QUIC_EXPORT_PRIVATE QuicTransmissionInfo {
   QuicPacketNumber retransmission;
   // The largest_acked in the ack frame, if the packet contains an ack.
   QuicPacketNumber largest_acked;
+  // The network path the packet was sent on.
+  QuicPathId path_id;
 };
 // TODO(ianswett): Add static_assert when size of this struct is reduced below
 // 64 bytes.
@@ -22,6 +22,9 @@ typedef uint16_t QuicPacketLength;
 typedef uint32_t QuicControlFrameId;
 typedef uint32_t QuicHeaderId;
 typedef uint32_t QuicMessageId;
+// Identifies a network path of a connection which sends on several paths at
+// once.
+typedef uint8_t QuicPathId;
 
 // TODO(fkastenholz): Should update this to 64 bits for V99.
 typedef uint32_t QuicStreamId;
@@ -200,6 +203,7 @@ enum QuicFrameType : uint8_t {
   MESSAGE_FRAME,
   NEW_TOKEN_FRAME,
   RETIRE_CONNECTION_ID_FRAME,
+  FEC_FRAME,
 
   NUM_FRAME_TYPES
 };
@@ -256,6 +260,8 @@ enum QuicIetfFrameType : uint8_t {
   // stream frame some wiggle room.
   IETF_EXTENSION_MESSAGE_NO_LENGTH = 0x20,
   IETF_EXTENSION_MESSAGE = 0x21,
+  // Like MESSAGE, the FEC frame type is not yet determined.
+  IETF_EXTENSION_FEC = 0x22,
 };
 // Masks for the bits that indicate the frame is a Stream frame vs the
 // bits used as flags.
@@ -575,6 +581,26 @@ enum PacketNumberSpace : uint8_t {
   NUM_PACKET_NUMBER_SPACES,
 };
 
+// The ECN codepoint in the IP header of a packet, see RFC 3168.
+enum QuicEcnCodepoint : uint8_t {
+  ECN_NOT_ECT = 0,  // Not ECN-capable.
+  ECN_ECT1 = 1,     // ECN-capable, ECT(1).
+  ECN_ECT0 = 2,     // ECN-capable, ECT(0).
+  ECN_CE = 3,       // Congestion experienced.
+};
+
+// Cumulative numbers of packets received with each ECN codepoint, as reported
+// in an IETF ACK_ECN frame.
+struct QUIC_EXPORT_PRIVATE QuicEcnCounts {
+  QuicEcnCounts() : ect0(0), ect1(0), ce(0) {}
+  QuicEcnCounts(QuicPacketCount ect0, QuicPacketCount ect1, QuicPacketCount ce)
+      : ect0(ect0), ect1(ect1), ce(ce) {}
+
+  QuicPacketCount ect0;
+  QuicPacketCount ect1;
+  QuicPacketCount ce;
+};
+
 }  // namespace quic
 
 #endif  // QUICHE_QUIC_CORE_QUIC_TYPES_H_
@@ -28,6 +28,7 @@ QuicUnackedPacketMap::QuicUnackedPacketMap(Perspective perspective)
     : perspective_(perspective),
       least_unacked_(FirstSendingPacketNumber()),
       bytes_in_flight_(0),
+      bytes_in_flight_per_path_(),
       pending_crypto_packet_count_(0),
       last_crypto_packet_sent_time_(QuicTime::Zero()),
       session_notifier_(nullptr),
@@ -68,6 +69,7 @@ void QuicUnackedPacketMap::AddSentPacket(SerializedPacket* packet,
       packet->encryption_level, packet->packet_number_length, transmission_type,
       sent_time, bytes_sent, has_crypto_handshake, packet->num_padding_bytes);
   info.largest_acked = packet->largest_acked;
+  info.path_id = packet->path_id;
   if (packet->largest_acked.IsInitialized()) {
     largest_sent_largest_acked_ =
         largest_sent_largest_acked_.IsInitialized()
@@ -82,6 +84,7 @@ void QuicUnackedPacketMap::AddSentPacket(SerializedPacket* packet,
   largest_sent_packet_ = packet_number;
   if (set_in_flight) {
     bytes_in_flight_ += bytes_sent;
+    bytes_in_flight_per_path_[info.path_id] += bytes_sent;
     info.in_flight = true;
     if (use_uber_loss_algorithm_) {
       largest_sent_retransmittable_packets_[GetPacketNumberSpace(
@@ -296,10 +299,17 @@ void QuicUnackedPacketMap::RemoveFromInFlight(QuicTransmissionInfo* info) {
   if (info->in_flight) {
     QUIC_BUG_IF(bytes_in_flight_ < info->bytes_sent);
     bytes_in_flight_ -= info->bytes_sent;
+    bytes_in_flight_per_path_[info->path_id] -= info->bytes_sent;
     info->in_flight = false;
   }
 }
 
+QuicByteCount QuicUnackedPacketMap::GetBytesInFlightOnPath(
+    QuicPathId path_id) const {
+  DCHECK_LT(path_id, kMaxNumPaths);
+  return bytes_in_flight_per_path_[path_id];
+}
+
 void QuicUnackedPacketMap::RemoveFromInFlight(QuicPacketNumber packet_number) {
   DCHECK_GE(packet_number, least_unacked_);
   DCHECK_LT(packet_number, least_unacked_ + unacked_packets_.size());
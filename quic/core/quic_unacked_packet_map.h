@@ -107,6 +107,9 @@ class QUIC_EXPORT_PRIVATE QuicUnackedPacketMap {
   // Returns the sum of bytes from all packets in flight.
   QuicByteCount bytes_in_flight() const { return bytes_in_flight_; }
 
+  // Returns the sum of bytes from the packets in flight on |path_id|.
+  QuicByteCount GetBytesInFlightOnPath(QuicPathId path_id) const;
+
   // Returns the smallest packet number of a serialized packet which has not
   // been acked by the peer.  If there are no unacked packets, returns 0.
   QuicPacketNumber GetLeastUnacked() const;
@@ -279,6 +282,8 @@ class QUIC_EXPORT_PRIVATE QuicUnackedPacketMap {
   QuicPacketNumber least_unacked_;
 
   QuicByteCount bytes_in_flight_;
+  // Bytes in flight on each network path, which add up to bytes_in_flight_.
+  QuicByteCount bytes_in_flight_per_path_[kMaxNumPaths];
   // Number of retransmittable crypto handshake packets.
   size_t pending_crypto_packet_count_;
 
@@ -308,6 +308,7 @@ bool QuicUtils::IsRetransmittableFrame(QuicFrameType type) {
     case PADDING_FRAME:
     case STOP_WAITING_FRAME:
     case MTU_DISCOVERY_FRAME:
+    case FEC_FRAME:
       return false;
     default:
       return true;
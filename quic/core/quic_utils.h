@@ -31,6 +31,12 @@ class QUIC_EXPORT_PRIVATE QuicUtils {
   // http://www.isthe.com/chongo/tech/comp/fnv/index.html#FNV-param
   static uint64_t FNV1a_64_Hash(QuicStringPiece data);
 
+  // Extends the 64 bit hash |seed| in place with |value|.  Based on Boost's
+  // hash_combine function.
+  static void HashCombine(uint64_t* seed, uint64_t value) {
+    *seed ^= value + 0x9e3779b9 + (*seed << 6) + (*seed >> 2);
+  }
+
   // Returns the 128 bit FNV1a hash of the data.  See
   // http://www.isthe.com/chongo/tech/comp/fnv/index.html#FNV-param
   static QuicUint128 FNV1a_128_Hash(QuicStringPiece data);
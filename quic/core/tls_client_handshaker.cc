@@ -44,12 +44,14 @@ TlsClientHandshaker::TlsClientHandshaker(
     ProofVerifier* proof_verifier,
     SSL_CTX* ssl_ctx,
     std::unique_ptr<ProofVerifyContext> verify_context,
-    const QuicString& user_agent_id)
+    const QuicString& user_agent_id,
+    QuicClientSessionCache* session_cache)
     : TlsHandshaker(stream, session, ssl_ctx),
       server_id_(server_id),
       proof_verifier_(proof_verifier),
       verify_context_(std::move(verify_context)),
       user_agent_id_(user_agent_id),
+      session_cache_(session_cache),
       crypto_negotiated_params_(new QuicCryptoNegotiatedParameters) {}
 
 TlsClientHandshaker::~TlsClientHandshaker() {
@@ -60,7 +62,14 @@ TlsClientHandshaker::~TlsClientHandshaker() {
 
 // static
 bssl::UniquePtr<SSL_CTX> TlsClientHandshaker::CreateSslCtx() {
-  return TlsHandshaker::CreateSslCtx();
+  bssl::UniquePtr<SSL_CTX> ssl_ctx = TlsHandshaker::CreateSslCtx();
+  // Sessions are kept in the QuicClientSessionCache passed to each
+  // TlsClientHandshaker rather than in BoringSSL's internal cache.
+  SSL_CTX_set_session_cache_mode(
+      ssl_ctx.get(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL);
+  SSL_CTX_sess_set_new_cb(ssl_ctx.get(),
+                          TlsClientHandshaker::NewSessionCallback);
+  return ssl_ctx;
 }
 
 bool TlsClientHandshaker::CryptoConnect() {
@@ -86,6 +95,17 @@ bool TlsClientHandshaker::CryptoConnect() {
     return false;
   }
 
+  // Offer a session from an earlier connection to this server, if any.  If the
+  // server allows it, this also lets the client send early data.
+  if (session_cache_ != nullptr) {
+    bssl::UniquePtr<SSL_SESSION> cached_session = session_cache_->Lookup(
+        server_id_, session()->connection()->clock()->WallNow());
+    if (cached_session != nullptr) {
+      SSL_set_session(ssl(), cached_session.get());
+      SSL_set_early_data_enabled(ssl(), 1);
+    }
+  }
+
   // Set the Transport Parameters to send in the ClientHello
   if (!SetTransportParameters()) {
     CloseConnection(QUIC_HANDSHAKE_FAILED,
@@ -205,17 +225,39 @@ void TlsClientHandshaker::AdvanceHandshake() {
     return;
   }
   if (state_ == STATE_HANDSHAKE_COMPLETE) {
-    // TODO(nharper): Handle post-handshake messages.
+    // The only post-handshake messages the server sends are NewSessionTicket
+    // messages, which end up in NewSessionCallback.
+    if (SSL_process_quic_post_handshake(ssl()) != 1) {
+      CloseConnection(QUIC_HANDSHAKE_FAILED,
+                      "Failed to process post-handshake message");
+    }
     return;
   }
 
   QUIC_LOG(INFO) << "TlsClientHandshaker: continuing handshake";
   int rv = SSL_do_handshake(ssl());
+  int ssl_error = SSL_get_error(ssl(), rv);
+  if (rv != 1 && ssl_error == SSL_ERROR_EARLY_DATA_REJECTED) {
+    // The server did not accept early data.  Continue the handshake without
+    // it; FinishHandshake() arranges for the data to be retransmitted.
+    QUIC_DLOG(INFO) << "Client: early data rejected";
+    early_data_rejected_ = true;
+    SSL_reset_early_data_reject(ssl());
+    rv = SSL_do_handshake(ssl());
+    ssl_error = SSL_get_error(ssl(), rv);
+  }
   if (rv == 1) {
+    if (SSL_in_early_data(ssl())) {
+      // The ClientHello has been sent on a resumed session and early data can
+      // be written; the handshake continues once the server responds.
+      if (!encryption_established_) {
+        OnEarlyDataReady();
+      }
+      return;
+    }
     FinishHandshake();
     return;
   }
-  int ssl_error = SSL_get_error(ssl(), rv);
   bool should_close = true;
   switch (state_) {
     case STATE_HANDSHAKE_RUNNING:
@@ -255,6 +297,19 @@ void TlsClientHandshaker::FinishHandshake() {
   session()->NeuterUnencryptedData();
   encryption_established_ = true;
   handshake_confirmed_ = true;
+
+  if (early_data_rejected_) {
+    // Data sent in 0-RTT packets was discarded by the server, send it again
+    // with forward-secure keys.
+    session()->OnCryptoHandshakeEvent(QuicSession::ENCRYPTION_REESTABLISHED);
+  }
+}
+
+void TlsClientHandshaker::OnEarlyDataReady() {
+  QUIC_LOG(INFO) << "Client: sending early data";
+  session()->connection()->SetDefaultEncryptionLevel(ENCRYPTION_ZERO_RTT);
+  encryption_established_ = true;
+  session()->OnCryptoHandshakeEvent(QuicSession::ENCRYPTION_FIRST_ESTABLISHED);
 }
 
 // static
@@ -263,6 +318,17 @@ TlsClientHandshaker* TlsClientHandshaker::HandshakerFromSsl(SSL* ssl) {
       TlsHandshaker::HandshakerFromSsl(ssl));
 }
 
+// static
+int TlsClientHandshaker::NewSessionCallback(SSL* ssl, SSL_SESSION* session) {
+  bssl::UniquePtr<SSL_SESSION> owned_session(session);
+  TlsClientHandshaker* handshaker = HandshakerFromSsl(ssl);
+  if (handshaker->session_cache_ != nullptr) {
+    handshaker->session_cache_->Insert(handshaker->server_id_,
+                                       std::move(owned_session));
+  }
+  return 1;
+}
+
 // static
 enum ssl_verify_result_t TlsClientHandshaker::VerifyCallback(
     SSL* ssl,
@@ -7,6 +7,7 @@
 
 #include "third_party/boringssl/src/include/openssl/ssl.h"
 #include "net/third_party/quiche/src/quic/core/crypto/proof_verifier.h"
+#include "net/third_party/quiche/src/quic/core/crypto/quic_client_session_cache.h"
 #include "net/third_party/quiche/src/quic/core/quic_crypto_client_stream.h"
 #include "net/third_party/quiche/src/quic/core/quic_crypto_stream.h"
 #include "net/third_party/quiche/src/quic/core/tls_handshaker.h"
@@ -27,7 +28,8 @@ class QUIC_EXPORT_PRIVATE TlsClientHandshaker
                       ProofVerifier* proof_verifier,
                       SSL_CTX* ssl_ctx,
                       std::unique_ptr<ProofVerifyContext> verify_context,
-                      const QuicString& user_agent_id);
+                      const QuicString& user_agent_id,
+                      QuicClientSessionCache* session_cache);
   TlsClientHandshaker(const TlsClientHandshaker&) = delete;
   TlsClientHandshaker& operator=(const TlsClientHandshaker&) = delete;
 
@@ -85,6 +87,10 @@ class QUIC_EXPORT_PRIVATE TlsClientHandshaker
   bool ProcessTransportParameters(QuicString* error_details);
   void FinishHandshake();
 
+  // Called when the TLS stack is ready to send early data on a resumed
+  // session, before the handshake is complete.
+  void OnEarlyDataReady();
+
   void AdvanceHandshake() override;
   void CloseConnection(QuicErrorCode error,
                        const QuicString& reason_phrase) override;
@@ -100,6 +106,10 @@ class QUIC_EXPORT_PRIVATE TlsClientHandshaker
   // TlsHandshaker::HandshakerFromSsl.
   static TlsClientHandshaker* HandshakerFromSsl(SSL* ssl);
 
+  // Static method to supply to SSL_CTX_sess_set_new_cb, called when the server
+  // sends a session ticket.  Takes ownership of |session|.
+  static int NewSessionCallback(SSL* ssl, SSL_SESSION* session);
+
   QuicServerId server_id_;
 
   // Objects used for verifying the server's certificate chain.
@@ -110,6 +120,10 @@ class QUIC_EXPORT_PRIVATE TlsClientHandshaker
 
   QuicString user_agent_id_;
 
+  // Holds sessions for resumption.  Not owned, and may be nullptr, in which
+  // case sessions are neither offered nor stored.
+  QuicClientSessionCache* session_cache_;
+
   // ProofVerifierCallback used for async certificate verification. This object
   // is owned by |proof_verifier_|.
   ProofVerifierCallbackImpl* proof_verify_callback_ = nullptr;
@@ -119,6 +133,9 @@ class QUIC_EXPORT_PRIVATE TlsClientHandshaker
 
   bool encryption_established_ = false;
   bool handshake_confirmed_ = false;
+  // True if the server rejected early data sent by the client, which then
+  // needs to be retransmitted once the handshake is complete.
+  bool early_data_rejected_ = false;
   QuicReferenceCountedPointer<QuicCryptoNegotiatedParameters>
       crypto_negotiated_params_;
 };
@@ -6,10 +6,12 @@
 
 #include "third_party/boringssl/src/include/openssl/crypto.h"
 #include "third_party/boringssl/src/include/openssl/ssl.h"
+#include "net/third_party/quiche/src/quic/core/crypto/early_data_fallback_decrypter.h"
 #include "net/third_party/quiche/src/quic/core/quic_crypto_stream.h"
 #include "net/third_party/quiche/src/quic/core/tls_client_handshaker.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_arraysize.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_bug_tracker.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_singleton.h"
 
 namespace quic {
@@ -165,13 +167,18 @@ int TlsHandshaker::SetEncryptionSecretCallback(
     const uint8_t* read_key,
     const uint8_t* write_key,
     size_t secret_len) {
-  // TODO(nharper): replace these vectors and memcpys with spans (which
-  // unfortunately doesn't yet exist in quic/platform/api).
-  std::vector<uint8_t> read_secret(secret_len), write_secret(secret_len);
-  memcpy(read_secret.data(), read_key, secret_len);
-  memcpy(write_secret.data(), write_key, secret_len);
-  HandshakerFromSsl(ssl)->SetEncryptionSecret(QuicEncryptionLevel(level),
-                                              read_secret, write_secret);
+  // TODO(nharper): replace these vectors with spans (which unfortunately
+  // doesn't yet exist in quic/platform/api).
+  std::vector<uint8_t> read_secret, write_secret;
+  // Early data keys are only provided in one direction.
+  if (read_key != nullptr) {
+    read_secret.assign(read_key, read_key + secret_len);
+  }
+  if (write_key != nullptr) {
+    write_secret.assign(write_key, write_key + secret_len);
+  }
+  HandshakerFromSsl(ssl)->SetEncryptionSecret(level, read_secret,
+                                              write_secret);
   return 1;
 }
 
@@ -201,13 +208,26 @@ int TlsHandshaker::SendAlertCallback(SSL* ssl,
 }
 
 void TlsHandshaker::SetEncryptionSecret(
-    EncryptionLevel level,
+    enum ssl_encryption_level_t ssl_level,
     const std::vector<uint8_t>& read_secret,
     const std::vector<uint8_t>& write_secret) {
-  std::unique_ptr<QuicEncrypter> encrypter = CreateEncrypter(write_secret);
-  session()->connection()->SetEncrypter(level, std::move(encrypter));
+  const EncryptionLevel level = QuicEncryptionLevel(ssl_level);
+  if (!write_secret.empty()) {
+    std::unique_ptr<QuicEncrypter> encrypter = CreateEncrypter(write_secret);
+    session()->connection()->SetEncrypter(level, std::move(encrypter));
+  }
+  if (read_secret.empty()) {
+    return;
+  }
   if (level != ENCRYPTION_FORWARD_SECURE) {
     std::unique_ptr<QuicDecrypter> decrypter = CreateDecrypter(read_secret);
+    if (ssl_level == ssl_encryption_early_data) {
+      early_data_read_secret_ = read_secret;
+    } else if (!early_data_read_secret_.empty()) {
+      decrypter = QuicMakeUnique<EarlyDataFallbackDecrypter>(
+          std::move(decrypter), CreateDecrypter(early_data_read_secret_));
+      early_data_read_secret_.clear();
+    }
     session()->connection()->SetDecrypter(level, std::move(decrypter));
   } else {
     // When forward-secure read keys are available, they get set as the
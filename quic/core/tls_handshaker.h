@@ -111,11 +111,12 @@ class QUIC_EXPORT_PRIVATE TlsHandshaker : public CryptoMessageParser {
 
   // SetEncryptionSecret provides the encryption secret to use at a particular
   // encryption level. The secrets provided here are the ones from the TLS 1.3
-  // key schedule (RFC 8446 section 7.1), in particular the handshake traffic
-  // secrets and application traffic secrets. For a given secret |secret|,
-  // |level| indicates which EncryptionLevel it is to be used at, and |is_write|
-  // indicates whether it is used for encryption or decryption.
-  void SetEncryptionSecret(EncryptionLevel level,
+  // key schedule (RFC 8446 section 7.1), in particular the early traffic
+  // secret, the handshake traffic secrets and application traffic secrets.
+  // |level| indicates which TLS encryption level they are to be used at.
+  // Early data secrets are unidirectional, so either |read_secret| or
+  // |write_secret| is empty at ssl_encryption_early_data.
+  void SetEncryptionSecret(enum ssl_encryption_level_t level,
                            const std::vector<uint8_t>& read_secret,
                            const std::vector<uint8_t>& write_secret);
 
@@ -139,6 +140,12 @@ class QUIC_EXPORT_PRIVATE TlsHandshaker : public CryptoMessageParser {
   QuicErrorCode parser_error_ = QUIC_NO_ERROR;
   QuicString parser_error_detail_;
 
+  // Read secret for 0-RTT packets, kept on the server until the handshake read
+  // secret is available.  Both map to ENCRYPTION_ZERO_RTT, so the decrypter for
+  // that level falls back to this key for 0-RTT packets arriving after the
+  // handshake keys have been installed.
+  std::vector<uint8_t> early_data_read_secret_;
+
   bssl::UniquePtr<SSL> ssl_;
 };
 
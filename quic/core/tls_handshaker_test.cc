@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "net/third_party/quiche/src/quic/core/crypto/crypto_secret_boxer.h"
+#include "net/third_party/quiche/src/quic/core/crypto/quic_client_session_cache.h"
 #include "net/third_party/quiche/src/quic/core/quic_utils.h"
 #include "net/third_party/quiche/src/quic/core/tls_client_handshaker.h"
 #include "net/third_party/quiche/src/quic/core/tls_server_handshaker.h"
@@ -200,7 +202,8 @@ class TestQuicCryptoStream : public QuicCryptoStream {
 
 class TestQuicCryptoClientStream : public TestQuicCryptoStream {
  public:
-  explicit TestQuicCryptoClientStream(QuicSession* session)
+  TestQuicCryptoClientStream(QuicSession* session,
+                             QuicClientSessionCache* session_cache)
       : TestQuicCryptoStream(session),
         proof_verifier_(new FakeProofVerifier),
         ssl_ctx_(TlsClientHandshaker::CreateSslCtx()),
@@ -211,7 +214,8 @@ class TestQuicCryptoClientStream : public TestQuicCryptoStream {
             proof_verifier_.get(),
             ssl_ctx_.get(),
             crypto_test_utils::ProofVerifyContextForTesting(),
-            "quic-tester")) {}
+            "quic-tester",
+            session_cache)) {}
 
   ~TestQuicCryptoClientStream() override = default;
 
@@ -232,14 +236,18 @@ class TestQuicCryptoClientStream : public TestQuicCryptoStream {
 class TestQuicCryptoServerStream : public TestQuicCryptoStream {
  public:
   TestQuicCryptoServerStream(QuicSession* session,
-                             FakeProofSource* proof_source)
+                             FakeProofSource* proof_source,
+                             const CryptoSecretBoxer* session_ticket_boxer,
+                             bool enable_early_data)
       : TestQuicCryptoStream(session),
         proof_source_(proof_source),
         ssl_ctx_(TlsServerHandshaker::CreateSslCtx()),
         handshaker_(new TlsServerHandshaker(this,
                                             session,
                                             ssl_ctx_.get(),
-                                            proof_source_)) {}
+                                            proof_source_,
+                                            session_ticket_boxer,
+                                            enable_early_data)) {}
 
   ~TestQuicCryptoServerStream() override = default;
 
@@ -251,6 +259,8 @@ class TestQuicCryptoServerStream : public TestQuicCryptoStream {
 
   FakeProofSource* GetFakeProofSource() const { return proof_source_; }
 
+  bool ZeroRttAttempted() const { return handshaker_->ZeroRttAttempted(); }
+
  private:
   FakeProofSource* proof_source_;
   bssl::UniquePtr<SSL_CTX> ssl_ctx_;
@@ -276,11 +286,16 @@ class TlsHandshakerTest : public QuicTest {
                                             &alarm_factory_,
                                             Perspective::IS_SERVER)),
         client_session_(client_conn_, /*create_mock_crypto_stream=*/false),
-        server_session_(server_conn_, /*create_mock_crypto_stream=*/false) {
-    client_stream_ = new TestQuicCryptoClientStream(&client_session_);
+        server_session_(server_conn_, /*create_mock_crypto_stream=*/false),
+        session_cache_(QuicClientSessionCache::kQuicClientSessionCacheSize) {
+    session_ticket_boxer_.SetKeys(
+        {QuicString(CryptoSecretBoxer::GetKeySize(), 'a')});
+    client_stream_ =
+        new TestQuicCryptoClientStream(&client_session_, &session_cache_);
     client_session_.SetCryptoStream(client_stream_);
-    server_stream_ =
-        new TestQuicCryptoServerStream(&server_session_, &proof_source_);
+    server_stream_ = new TestQuicCryptoServerStream(
+        &server_session_, &proof_source_, &session_ticket_boxer_,
+        /*enable_early_data=*/false);
     server_session_.SetCryptoStream(server_stream_);
     client_session_.Initialize();
     server_session_.Initialize();
@@ -290,6 +305,50 @@ class TlsHandshakerTest : public QuicTest {
     EXPECT_FALSE(server_stream_->handshake_confirmed());
   }
 
+  // Replaces the next_* client and server with new ones, which share the
+  // session cache and session ticket keys of the first pair, so that the
+  // client can resume the session of the previous handshake.
+  void CreateNextConnection(bool enable_early_data) {
+    next_client_session_.reset();
+    next_server_session_.reset();
+    MockQuicConnection* client_conn = new MockQuicConnection(
+        &conn_helper_, &alarm_factory_, Perspective::IS_CLIENT);
+    MockQuicConnection* server_conn = new MockQuicConnection(
+        &conn_helper_, &alarm_factory_, Perspective::IS_SERVER);
+    EXPECT_CALL(*client_conn, CloseConnection(_, _, _)).Times(0);
+    EXPECT_CALL(*server_conn, CloseConnection(_, _, _)).Times(0);
+    next_client_session_ = QuicMakeUnique<MockQuicSession>(
+        client_conn, /*create_mock_crypto_stream=*/false);
+    next_server_session_ = QuicMakeUnique<MockQuicSession>(
+        server_conn, /*create_mock_crypto_stream=*/false);
+    next_client_stream_ =
+        new TestQuicCryptoClientStream(next_client_session_.get(),
+                                       &session_cache_);
+    next_client_session_->SetCryptoStream(next_client_stream_);
+    next_server_stream_ = new TestQuicCryptoServerStream(
+        next_server_session_.get(), &proof_source_, &session_ticket_boxer_,
+        enable_early_data);
+    next_server_session_->SetCryptoStream(next_server_stream_);
+    next_client_session_->Initialize();
+    next_server_session_->Initialize();
+  }
+
+  // Runs a handshake between the next_* client and server.  Returns true if
+  // the client resumed a session, which spares the server a signature.
+  bool RunNextHandshake() {
+    proof_source_.Activate();
+    next_client_stream_->CryptoConnect();
+    ExchangeHandshakeMessages(next_client_stream_, next_server_stream_);
+    const bool resumed = proof_source_.NumPendingCallbacks() == 0;
+    if (!resumed) {
+      proof_source_.InvokePendingCallback(0);
+      ExchangeHandshakeMessages(next_client_stream_, next_server_stream_);
+    }
+    EXPECT_TRUE(next_client_stream_->handshake_confirmed());
+    EXPECT_TRUE(next_server_stream_->handshake_confirmed());
+    return resumed;
+  }
+
   MockQuicConnectionHelper conn_helper_;
   MockAlarmFactory alarm_factory_;
   MockQuicConnection* client_conn_;
@@ -298,8 +357,15 @@ class TlsHandshakerTest : public QuicTest {
   MockQuicSession server_session_;
 
   FakeProofSource proof_source_;
+  QuicClientSessionCache session_cache_;
+  CryptoSecretBoxer session_ticket_boxer_;
   TestQuicCryptoClientStream* client_stream_;
   TestQuicCryptoServerStream* server_stream_;
+
+  std::unique_ptr<MockQuicSession> next_client_session_;
+  std::unique_ptr<MockQuicSession> next_server_session_;
+  TestQuicCryptoClientStream* next_client_stream_ = nullptr;
+  TestQuicCryptoServerStream* next_server_stream_ = nullptr;
 };
 
 TEST_F(TlsHandshakerTest, CryptoHandshake) {
@@ -314,6 +380,98 @@ TEST_F(TlsHandshakerTest, CryptoHandshake) {
   EXPECT_TRUE(server_stream_->encryption_established());
 }
 
+TEST_F(TlsHandshakerTest, ResumeSessionWithTicket) {
+  EXPECT_CALL(*client_conn_, CloseConnection(_, _, _)).Times(0);
+  EXPECT_CALL(*server_conn_, CloseConnection(_, _, _)).Times(0);
+  client_stream_->CryptoConnect();
+  ExchangeHandshakeMessages(client_stream_, server_stream_);
+  ASSERT_TRUE(client_stream_->handshake_confirmed());
+  // The server's session ticket is cached once the handshake completes.
+  EXPECT_EQ(1u, session_cache_.Size());
+
+  // A resumed handshake does not need a signature from the proof source.
+  CreateNextConnection(/*enable_early_data=*/false);
+  EXPECT_TRUE(RunNextHandshake());
+  EXPECT_FALSE(next_server_stream_->ZeroRttAttempted());
+  // The cached ticket was consumed and replaced by a fresh one.
+  EXPECT_EQ(1u, session_cache_.Size());
+}
+
+TEST_F(TlsHandshakerTest, EarlyDataDisabledByDefault) {
+  EXPECT_CALL(*client_conn_, CloseConnection(_, _, _)).Times(0);
+  EXPECT_CALL(*server_conn_, CloseConnection(_, _, _)).Times(0);
+  client_stream_->CryptoConnect();
+  ExchangeHandshakeMessages(client_stream_, server_stream_);
+  ASSERT_TRUE(client_stream_->handshake_confirmed());
+
+  // The ticket from a server which does not accept early data does not let
+  // the client send any, even to a server which would accept it.
+  CreateNextConnection(/*enable_early_data=*/true);
+  next_client_stream_->CryptoConnect();
+  EXPECT_FALSE(next_client_stream_->encryption_established());
+  ExchangeHandshakeMessages(next_client_stream_, next_server_stream_);
+  EXPECT_TRUE(next_server_stream_->handshake_confirmed());
+  EXPECT_FALSE(next_server_stream_->ZeroRttAttempted());
+}
+
+TEST_F(TlsHandshakerTest, EarlyDataAccepted) {
+  CreateNextConnection(/*enable_early_data=*/true);
+  EXPECT_FALSE(RunNextHandshake());
+
+  CreateNextConnection(/*enable_early_data=*/true);
+  proof_source_.Activate();
+  next_client_stream_->CryptoConnect();
+  // The client can send early data as soon as its ClientHello is written.
+  EXPECT_TRUE(next_client_stream_->encryption_established());
+  EXPECT_FALSE(next_client_stream_->handshake_confirmed());
+  ExchangeHandshakeMessages(next_client_stream_, next_server_stream_);
+  EXPECT_EQ(0, proof_source_.NumPendingCallbacks());
+  EXPECT_TRUE(next_client_stream_->handshake_confirmed());
+  EXPECT_TRUE(next_server_stream_->handshake_confirmed());
+  EXPECT_TRUE(next_server_stream_->ZeroRttAttempted());
+}
+
+TEST_F(TlsHandshakerTest, EarlyDataRejected) {
+  CreateNextConnection(/*enable_early_data=*/true);
+  EXPECT_FALSE(RunNextHandshake());
+
+  // The server no longer accepts early data, so the client's is rejected and
+  // the session is resumed without it.
+  CreateNextConnection(/*enable_early_data=*/false);
+  proof_source_.Activate();
+  next_client_stream_->CryptoConnect();
+  EXPECT_TRUE(next_client_stream_->encryption_established());
+  ExchangeHandshakeMessages(next_client_stream_, next_server_stream_);
+  EXPECT_EQ(0, proof_source_.NumPendingCallbacks());
+  EXPECT_TRUE(next_client_stream_->handshake_confirmed());
+  EXPECT_TRUE(next_server_stream_->handshake_confirmed());
+  EXPECT_FALSE(next_server_stream_->ZeroRttAttempted());
+}
+
+TEST_F(TlsHandshakerTest, SessionTicketKeyRotation) {
+  const QuicString old_key(CryptoSecretBoxer::GetKeySize(), 'a');
+  const QuicString new_key(CryptoSecretBoxer::GetKeySize(), 'b');
+  CreateNextConnection(/*enable_early_data=*/false);
+  EXPECT_FALSE(RunNextHandshake());
+
+  // Tickets sealed with the old key still open while it is in the key list.
+  session_ticket_boxer_.SetKeys({new_key, old_key});
+  CreateNextConnection(/*enable_early_data=*/false);
+  EXPECT_TRUE(RunNextHandshake());
+
+  // The ticket just issued was sealed with the new key, so dropping the old
+  // one does not stop the client from resuming.
+  session_ticket_boxer_.SetKeys({new_key});
+  CreateNextConnection(/*enable_early_data=*/false);
+  EXPECT_TRUE(RunNextHandshake());
+
+  // A ticket whose key has been rotated out is ignored, and the handshake
+  // falls back to a full one.
+  session_ticket_boxer_.SetKeys({old_key});
+  CreateNextConnection(/*enable_early_data=*/false);
+  EXPECT_FALSE(RunNextHandshake());
+}
+
 TEST_F(TlsHandshakerTest, HandshakeWithAsyncProofSource) {
   EXPECT_CALL(*client_conn_, CloseConnection(_, _, _)).Times(0);
   EXPECT_CALL(*server_conn_, CloseConnection(_, _, _)).Times(0);
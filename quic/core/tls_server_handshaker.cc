@@ -10,6 +10,7 @@
 #include "third_party/boringssl/src/include/openssl/ssl.h"
 #include "net/third_party/quiche/src/quic/core/crypto/quic_crypto_server_config.h"
 #include "net/third_party/quiche/src/quic/core/crypto/transport_parameters.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_bug_tracker.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
@@ -40,26 +41,46 @@ void TlsServerHandshaker::SignatureCallback::Cancel() {
   handshaker_ = nullptr;
 }
 
+namespace {
+
+// Upper bound on the number of bytes CryptoSecretBoxer::Box() adds to the
+// plaintext, which is a nonce and an authentication tag.
+const size_t kSessionTicketMaxOverhead = 64;
+
+}  // namespace
+
 const SSL_PRIVATE_KEY_METHOD TlsServerHandshaker::kPrivateKeyMethod{
     &TlsServerHandshaker::PrivateKeySign,
     nullptr,  // decrypt
     &TlsServerHandshaker::PrivateKeyComplete,
 };
 
+const SSL_TICKET_AEAD_METHOD TlsServerHandshaker::kSessionTicketMethod{
+    &TlsServerHandshaker::SessionTicketMaxOverhead,
+    &TlsServerHandshaker::SessionTicketSeal,
+    &TlsServerHandshaker::SessionTicketOpen,
+};
+
 // static
 bssl::UniquePtr<SSL_CTX> TlsServerHandshaker::CreateSslCtx() {
   bssl::UniquePtr<SSL_CTX> ssl_ctx = TlsHandshaker::CreateSslCtx();
   SSL_CTX_set_tlsext_servername_callback(
       ssl_ctx.get(), TlsServerHandshaker::SelectCertificateCallback);
+  SSL_CTX_set_ticket_aead_method(ssl_ctx.get(),
+                                 &TlsServerHandshaker::kSessionTicketMethod);
   return ssl_ctx;
 }
 
-TlsServerHandshaker::TlsServerHandshaker(QuicCryptoStream* stream,
-                                         QuicSession* session,
-                                         SSL_CTX* ssl_ctx,
-                                         ProofSource* proof_source)
+TlsServerHandshaker::TlsServerHandshaker(
+    QuicCryptoStream* stream,
+    QuicSession* session,
+    SSL_CTX* ssl_ctx,
+    ProofSource* proof_source,
+    const CryptoSecretBoxer* session_ticket_boxer,
+    bool enable_early_data)
     : TlsHandshaker(stream, session, ssl_ctx),
       proof_source_(proof_source),
+      session_ticket_boxer_(session_ticket_boxer),
       crypto_negotiated_params_(new QuicCryptoNegotiatedParameters) {
   CrypterPair crypters;
   CryptoUtils::CreateTlsInitialCrypters(
@@ -73,6 +94,14 @@ TlsServerHandshaker::TlsServerHandshaker(QuicCryptoStream* stream,
   // Configure the SSL to be a server.
   SSL_set_accept_state(ssl());
 
+  if (session_ticket_boxer_ == nullptr) {
+    SSL_set_options(ssl(), SSL_OP_NO_TICKET);
+  } else if (enable_early_data) {
+    // Accept early data from clients resuming a session.  Early data is not
+    // protected against replays.
+    SSL_set_early_data_enabled(ssl(), 1);
+  }
+
   if (!SetTransportParameters()) {
     CloseConnection(QUIC_HANDSHAKE_FAILED,
                     "Failed to set Transport Parameters");
@@ -122,8 +151,9 @@ TlsServerHandshaker::PreviousCachedNetworkParams() const {
 }
 
 bool TlsServerHandshaker::ZeroRttAttempted() const {
-  // TODO(nharper): Support 0-RTT with TLS 1.3 in QUIC.
-  return false;
+  // BoringSSL does not report early data that was offered but rejected, so
+  // this only covers accepted attempts.
+  return SSL_early_data_accepted(ssl()) == 1;
 }
 
 void TlsServerHandshaker::SetPreviousCachedNetworkParams(
@@ -169,6 +199,11 @@ void TlsServerHandshaker::AdvanceHandshake() {
 
   int rv = SSL_do_handshake(ssl());
   if (rv == 1) {
+    if (SSL_in_early_data(ssl())) {
+      // Early data was accepted.  The handshake completes once the client's
+      // Finished message arrives.
+      return;
+    }
     FinishHandshake();
     return;
   }
@@ -320,6 +355,73 @@ ssl_private_key_result_t TlsServerHandshaker::PrivateKeyComplete(
   return ssl_private_key_success;
 }
 
+// static
+size_t TlsServerHandshaker::SessionTicketMaxOverhead(SSL* ssl) {
+  return kSessionTicketMaxOverhead;
+}
+
+// static
+int TlsServerHandshaker::SessionTicketSeal(SSL* ssl,
+                                           uint8_t* out,
+                                           size_t* out_len,
+                                           size_t max_out_len,
+                                           const uint8_t* in,
+                                           size_t in_len) {
+  return HandshakerFromSsl(ssl)->SessionTicketSeal(
+      out, out_len, max_out_len,
+      QuicStringPiece(reinterpret_cast<const char*>(in), in_len));
+}
+
+int TlsServerHandshaker::SessionTicketSeal(uint8_t* out,
+                                           size_t* out_len,
+                                           size_t max_out_len,
+                                           QuicStringPiece in) {
+  DCHECK(session_ticket_boxer_);
+  QuicString ticket = session_ticket_boxer_->Box(
+      session()->connection()->random_generator(), in);
+  if (ticket.size() > max_out_len) {
+    QUIC_BUG << "Session ticket overhead is larger than "
+             << kSessionTicketMaxOverhead;
+    return 0;
+  }
+  *out_len = ticket.size();
+  memcpy(out, ticket.data(), ticket.size());
+  return 1;
+}
+
+// static
+enum ssl_ticket_aead_result_t TlsServerHandshaker::SessionTicketOpen(
+    SSL* ssl,
+    uint8_t* out,
+    size_t* out_len,
+    size_t max_out_len,
+    const uint8_t* in,
+    size_t in_len) {
+  return HandshakerFromSsl(ssl)->SessionTicketOpen(
+      out, out_len, max_out_len,
+      QuicStringPiece(reinterpret_cast<const char*>(in), in_len));
+}
+
+enum ssl_ticket_aead_result_t TlsServerHandshaker::SessionTicketOpen(
+    uint8_t* out,
+    size_t* out_len,
+    size_t max_out_len,
+    QuicStringPiece in) {
+  DCHECK(session_ticket_boxer_);
+  QuicString storage;
+  QuicStringPiece plaintext;
+  if (!session_ticket_boxer_->Unbox(in, &storage, &plaintext)) {
+    QUIC_DLOG(INFO) << "Ignoring session ticket that failed to decrypt";
+    return ssl_ticket_aead_ignore_ticket;
+  }
+  if (plaintext.size() > max_out_len) {
+    return ssl_ticket_aead_error;
+  }
+  *out_len = plaintext.size();
+  memcpy(out, plaintext.data(), plaintext.size());
+  return ssl_ticket_aead_success;
+}
+
 // static
 int TlsServerHandshaker::SelectCertificateCallback(SSL* ssl,
                                                    int* out_alert,
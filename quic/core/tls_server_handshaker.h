@@ -7,6 +7,7 @@
 
 #include "third_party/boringssl/src/include/openssl/pool.h"
 #include "third_party/boringssl/src/include/openssl/ssl.h"
+#include "net/third_party/quiche/src/quic/core/crypto/crypto_secret_boxer.h"
 #include "net/third_party/quiche/src/quic/core/proto/cached_network_parameters.proto.h"
 #include "net/third_party/quiche/src/quic/core/quic_crypto_server_stream.h"
 #include "net/third_party/quiche/src/quic/core/quic_crypto_stream.h"
@@ -22,10 +23,17 @@ class QUIC_EXPORT_PRIVATE TlsServerHandshaker
     : public QuicCryptoServerStream::HandshakerDelegate,
       public TlsHandshaker {
  public:
+  // |session_ticket_boxer| protects the session tickets issued to clients.
+  // It is not owned and must outlive this object.  If it is nullptr, no
+  // tickets are issued, so clients cannot resume sessions or send early data.
+  // Early data is only accepted if |enable_early_data| is true, in which case
+  // the tickets issued also allow clients to send it.
   TlsServerHandshaker(QuicCryptoStream* stream,
                       QuicSession* session,
                       SSL_CTX* ssl_ctx,
-                      ProofSource* proof_source);
+                      ProofSource* proof_source,
+                      const CryptoSecretBoxer* session_ticket_boxer,
+                      bool enable_early_data);
   TlsServerHandshaker(const TlsServerHandshaker&) = delete;
   TlsServerHandshaker& operator=(const TlsServerHandshaker&) = delete;
 
@@ -87,6 +95,11 @@ class QUIC_EXPORT_PRIVATE TlsServerHandshaker
   // CertificateVerify message (using the server's private key).
   static const SSL_PRIVATE_KEY_METHOD kPrivateKeyMethod;
 
+  // |kSessionTicketMethod| is a vtable pointing to SessionTicketMaxOverhead,
+  // SessionTicketSeal and SessionTicketOpen, used by the TLS stack to encrypt
+  // and decrypt session tickets with |session_ticket_boxer_|.
+  static const SSL_TICKET_AEAD_METHOD kSessionTicketMethod;
+
   // Called when a new message is received on the crypto stream and is available
   // for the TLS stack to read.
   void AdvanceHandshake() override;
@@ -140,6 +153,45 @@ class QUIC_EXPORT_PRIVATE TlsServerHandshaker
                                               size_t* out_len,
                                               size_t max_out);
 
+  // Returns the maximum number of bytes that sealing a session ticket adds to
+  // its plaintext.
+  static size_t SessionTicketMaxOverhead(SSL* ssl);
+
+  // Calls the instance method SessionTicketSeal after looking up the
+  // TlsServerHandshaker from |ssl|.
+  static int SessionTicketSeal(SSL* ssl,
+                               uint8_t* out,
+                               size_t* out_len,
+                               size_t max_out_len,
+                               const uint8_t* in,
+                               size_t in_len);
+
+  // Encrypts the session ticket contents in |in| and puts the result in |*out|
+  // and its length in |*out_len|.  Returns 1 on success and 0 if the result is
+  // longer than |max_out_len|.
+  int SessionTicketSeal(uint8_t* out,
+                        size_t* out_len,
+                        size_t max_out_len,
+                        QuicStringPiece in);
+
+  // Calls the instance method SessionTicketOpen after looking up the
+  // TlsServerHandshaker from |ssl|.
+  static enum ssl_ticket_aead_result_t SessionTicketOpen(SSL* ssl,
+                                                         uint8_t* out,
+                                                         size_t* out_len,
+                                                         size_t max_out_len,
+                                                         const uint8_t* in,
+                                                         size_t in_len);
+
+  // Decrypts the session ticket in |in| and puts the result in |*out| and its
+  // length in |*out_len|.  Tickets that cannot be decrypted, for instance
+  // because their key has been rotated out, are ignored, which makes the
+  // handshake fall back to a full handshake.
+  enum ssl_ticket_aead_result_t SessionTicketOpen(uint8_t* out,
+                                                  size_t* out_len,
+                                                  size_t max_out_len,
+                                                  QuicStringPiece in);
+
   // Configures the certificate to use on |ssl_| based on the SNI sent by the
   // client. Returns an SSL_TLSEXT_ERR_* value (see
   // https://commondatastorage.googleapis.com/chromium-boringssl-docs/ssl.h.html#SSL_CTX_set_tlsext_servername_callback).
@@ -155,6 +207,9 @@ class QUIC_EXPORT_PRIVATE TlsServerHandshaker
   ProofSource* proof_source_;
   SignatureCallback* signature_callback_ = nullptr;
 
+  // Not owned, may be nullptr.
+  const CryptoSecretBoxer* session_ticket_boxer_;
+
   QuicString hostname_;
   QuicString cert_verify_sig_;
 
@@ -4,10 +4,11 @@
 
 #include "net/third_party/quiche/src/quic/quartc/quartc_session.h"
 
+#include <utility>
+
 #include "net/third_party/quiche/src/quic/core/quic_utils.h"
 #include "net/third_party/quiche/src/quic/core/tls_client_handshaker.h"
 #include "net/third_party/quiche/src/quic/core/tls_server_handshaker.h"
-#include "net/third_party/quiche/src/quic/platform/api/quic_mem_slice_storage.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
 #include "net/third_party/quiche/src/quic/quartc/quartc_crypto_helpers.h"
 
@@ -42,6 +43,13 @@ QuartcStream* QuartcSession::CreateOutgoingBidirectionalStream() {
 }
 
 bool QuartcSession::SendOrQueueMessage(QuicString message) {
+  return SendOrQueueMessage(std::move(message), spdy::kV3HighestPriority,
+                            QuicTime::Infinite());
+}
+
+bool QuartcSession::SendOrQueueMessage(QuicString message,
+                                       spdy::SpdyPriority priority,
+                                       QuicTime expiry) {
   if (!CanSendMessage()) {
     QUIC_LOG(ERROR) << "Quic session does not support SendMessage";
     return false;
@@ -54,70 +62,17 @@ bool QuartcSession::SendOrQueueMessage(QuicString message) {
     return false;
   }
 
-  // There may be other messages in send queue, so we have to add message
-  // to the queue and call queue processing helper.
-  send_message_queue_.emplace_back(std::move(message));
-
-  ProcessSendMessageQueue();
-
-  return true;
-}
-
-void QuartcSession::ProcessSendMessageQueue() {
-  while (!send_message_queue_.empty()) {
-    struct iovec iov = {const_cast<char*>(send_message_queue_.front().data()),
-                        send_message_queue_.front().length()};
-    QuicMemSliceStorage storage(
-        &iov, 1, connection()->helper()->GetStreamSendBufferAllocator(),
-        send_message_queue_.front().length());
-    MessageResult result = SendMessage(storage.ToSpan());
-
-    const size_t message_size = send_message_queue_.front().size();
-
-    // Handle errors.
-    switch (result.status) {
-      case MESSAGE_STATUS_SUCCESS:
-        QUIC_VLOG(1) << "Quartc message sent, message_id=" << result.message_id
-                     << ", message_size=" << message_size;
-        break;
-
-      // If connection is congestion controlled or not writable yet, stop
-      // send loop and we'll retry again when we get OnCanWrite notification.
-      case MESSAGE_STATUS_ENCRYPTION_NOT_ESTABLISHED:
-      case MESSAGE_STATUS_BLOCKED:
-        QUIC_VLOG(1) << "Quartc message not sent because connection is blocked"
-                     << ", message will be retried later, status="
-                     << result.status << ", message_size=" << message_size;
-
-        return;
-
-      // Other errors are unexpected. We do not propagate error to Quartc,
-      // because writes can be delayed.
-      case MESSAGE_STATUS_UNSUPPORTED:
-      case MESSAGE_STATUS_TOO_LARGE:
-      case MESSAGE_STATUS_INTERNAL_ERROR:
-        QUIC_DLOG(DFATAL)
-            << "Failed to send quartc message due to unexpected error"
-            << ", message will not be retried, status=" << result.status
-            << ", message_size=" << message_size;
-        break;
-    }
-
-    send_message_queue_.pop_front();
+  // Other errors are unexpected. We do not propagate them to Quartc, just as
+  // for queued messages which fail once the connection is writable.
+  const size_t message_size = message.size();
+  MessageStatus status =
+      SendOrQueueDatagram(std::move(message), priority, expiry);
+  if (status != MESSAGE_STATUS_SUCCESS) {
+    QUIC_DLOG(DFATAL) << "Failed to send quartc message due to unexpected error"
+                      << ", status=" << status
+                      << ", message_size=" << message_size;
   }
-}
-
-void QuartcSession::OnCanWrite() {
-  // TODO(b/119640244): Since we currently use messages for audio and streams
-  // for video, it makes sense to process queued messages first, then call quic
-  // core OnCanWrite, which will resend queued streams. Long term we may need
-  // better solution especially if quic connection is used for both data and
-  // media.
-
-  // Process quartc messages that were previously blocked.
-  ProcessSendMessageQueue();
-
-  QuicSession::OnCanWrite();
+  return true;
 }
 
 void QuartcSession::OnCryptoHandshakeEvent(CryptoHandshakeEvent event) {
@@ -40,7 +40,8 @@ class QUIC_EXPORT_PRIVATE QuartcSession
   // Sends short unreliable message using quic message frame (message must fit
   // in one quic packet). If connection is blocked by congestion control,
   // message will be queued and resent later after receiving an OnCanWrite
-  // notification.
+  // notification. Messages are queued at the highest priority and never
+  // expire.
   //
   // Message size must be <= GetLargestMessagePayload().
   //
@@ -52,6 +53,13 @@ class QUIC_EXPORT_PRIVATE QuartcSession
   // controlled.
   bool SendOrQueueMessage(QuicString message);
 
+  // Same as above, but the message is sent after queued messages and stream
+  // data of a higher |priority|, and is dropped if it is still queued at
+  // |expiry|.
+  bool SendOrQueueMessage(QuicString message,
+                          spdy::SpdyPriority priority,
+                          QuicTime expiry);
+
   // Returns largest message payload acceptable in SendQuartcMessage.
   QuicPacketLength GetLargestMessagePayload() const {
     return connection()->GetLargestMessagePayload();
@@ -67,8 +75,6 @@ class QUIC_EXPORT_PRIVATE QuartcSession
   // QuicConnectionVisitorInterface overrides.
   void OnCongestionWindowChange(QuicTime now) override;
 
-  void OnCanWrite() override;
-
   void OnConnectionClosed(QuicErrorCode error,
                           const QuicString& error_details,
                           ConnectionCloseSource source) override;
@@ -147,7 +153,17 @@ class QUIC_EXPORT_PRIVATE QuartcSession
   // Returns number of queued (not sent) messages submitted by
   // SendOrQueueMessage. Messages are queued if connection is congestion
   // controlled.
-  size_t send_message_queue_size() const { return send_message_queue_.size(); }
+  size_t send_message_queue_size() const {
+    return datagram_queue().queue_size();
+  }
+
+  // Number of messages sent, dropped because they expired in the queue, and
+  // considered lost by the connection.
+  uint64_t messages_sent() const { return datagram_queue().datagrams_sent(); }
+  uint64_t messages_expired() const {
+    return datagram_queue().datagrams_expired();
+  }
+  uint64_t messages_lost() const { return datagram_queue().datagrams_lost(); }
 
  protected:
   // QuicSession override.
@@ -171,8 +187,6 @@ class QUIC_EXPORT_PRIVATE QuartcSession
       std::unique_ptr<QuartcStream> stream,
       spdy::SpdyPriority priority);
 
-  void ProcessSendMessageQueue();
-
   // Take ownership of the QuicConnection.  Note: if |connection_| changes,
   // the new value of |connection_| must be given to |packet_writer_| before any
   // packets are written.  Otherwise, |packet_writer_| will crash.
@@ -186,11 +200,6 @@ class QUIC_EXPORT_PRIVATE QuartcSession
 
   // Options passed to the packet writer for each packet.
   std::unique_ptr<QuartcPerPacketOptions> per_packet_options_;
-
-  // Queue of pending messages sent by SendQuartcMessage that were not sent
-  // yet or blocked by congestion control. Messages are queued in the order
-  // of sent by SendOrQueueMessage().
-  QuicDeque<QuicString> send_message_queue_;
 };
 
 class QUIC_EXPORT_PRIVATE QuartcClientSession
@@ -336,6 +336,8 @@ class QuartcSessionTest : public QuicTest {
     RunTasks();
 
     EXPECT_EQ(delegate_receiving->incoming_messages(), sent_messages);
+    EXPECT_EQ(peer_sending->messages_sent(), sent_messages.size());
+    EXPECT_EQ(peer_sending->messages_expired(), 0u);
   }
 
   // Test sending long messages:
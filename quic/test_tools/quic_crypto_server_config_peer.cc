@@ -25,7 +25,8 @@ QuicCryptoServerConfigPeer::GetConfig(QuicString config_id) {
     return QuicReferenceCountedPointer<QuicCryptoServerConfig::Config>(
         server_config_->primary_config_);
   } else {
-    return server_config_->GetConfigWithScid(config_id);
+    return QuicCryptoServerConfig::GetConfigWithScid(
+        *server_config_->GetConfigSnapshot(), config_id);
   }
 }
 
@@ -146,7 +147,8 @@ QuicString QuicCryptoServerConfigPeer::CompressChain(
     const QuicString& client_cached_cert_hashes,
     const CommonCertSets* common_sets) {
   return QuicCryptoServerConfig::CompressChain(
-      compressed_certs_cache, chain, client_common_set_hashes,
+      compressed_certs_cache, /*shared_compressed_certs_cache=*/nullptr,
+      /*zlib_stream_pool=*/nullptr, chain, client_common_set_hashes,
       client_cached_cert_hashes, common_sets);
 }
 
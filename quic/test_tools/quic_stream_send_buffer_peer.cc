@@ -29,7 +29,7 @@ QuicByteCount QuicStreamSendBufferPeer::TotalLength(
     QuicStreamSendBuffer* send_buffer) {
   QuicByteCount length = 0;
   for (const auto& slice : send_buffer->buffered_slices_) {
-    length += slice.slice.length();
+    length += slice.data.length();
   }
   return length;
 }
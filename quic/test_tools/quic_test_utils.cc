@@ -171,6 +171,8 @@ MockFramerVisitor::MockFramerVisitor() {
 
   ON_CALL(*this, OnCryptoFrame(_)).WillByDefault(testing::Return(true));
 
+  ON_CALL(*this, OnAckEcnCounts(_)).WillByDefault(testing::Return(true));
+
   ON_CALL(*this, OnStopWaitingFrame(_)).WillByDefault(testing::Return(true));
 
   ON_CALL(*this, OnPaddingFrame(_)).WillByDefault(testing::Return(true));
@@ -233,6 +235,10 @@ bool NoOpFramerVisitor::OnAckFrameStart(QuicPacketNumber largest_acked,
   return true;
 }
 
+bool NoOpFramerVisitor::OnAckEcnCounts(const QuicEcnCounts& ecn_counts) {
+  return true;
+}
+
 bool NoOpFramerVisitor::OnAckRange(QuicPacketNumber start,
                                    QuicPacketNumber end) {
   return true;
@@ -327,6 +333,10 @@ bool NoOpFramerVisitor::OnMessageFrame(const QuicMessageFrame& frame) {
   return true;
 }
 
+bool NoOpFramerVisitor::OnFecFrame(const QuicFecFrame& frame) {
+  return true;
+}
+
 bool NoOpFramerVisitor::IsValidStatelessResetToken(QuicUint128 token) const {
   return false;
 }
@@ -88,6 +88,16 @@ class SimpleFramerVisitor : public QuicFramerVisitorInterface {
     return true;
   }
 
+  bool OnAckEcnCounts(const QuicEcnCounts& ecn_counts) override {
+    DCHECK(!ack_frames_.empty());
+    QuicAckFrame* ack_frame = &ack_frames_[ack_frames_.size() - 1];
+    ack_frame->ecn_counters_populated = true;
+    ack_frame->ect_0_count = ecn_counts.ect0;
+    ack_frame->ect_1_count = ecn_counts.ect1;
+    ack_frame->ecn_ce_count = ecn_counts.ce;
+    return true;
+  }
+
   bool OnAckRange(QuicPacketNumber start, QuicPacketNumber end) override {
     DCHECK(!ack_frames_.empty());
     ack_frames_[ack_frames_.size() - 1].packets.AddRange(start, end);
@@ -192,6 +202,8 @@ class SimpleFramerVisitor : public QuicFramerVisitorInterface {
     return true;
   }
 
+  bool OnFecFrame(const QuicFecFrame& frame) override { return true; }
+
   void OnPacketComplete() override {}
 
   bool IsValidStatelessResetToken(QuicUint128 token) const override {
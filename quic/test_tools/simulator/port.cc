@@ -8,7 +8,11 @@ namespace quic {
 namespace simulator {
 
 Packet::Packet()
-    : source(), destination(), tx_timestamp(QuicTime::Zero()), size(0) {}
+    : source(),
+      destination(),
+      tx_timestamp(QuicTime::Zero()),
+      size(0),
+      ecn_codepoint(ECN_NOT_ECT) {}
 
 Packet::~Packet() {}
 
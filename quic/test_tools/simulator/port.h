@@ -25,6 +25,9 @@ struct Packet {
 
   QuicString contents;
   QuicByteCount size;
+
+  // ECN codepoint of the IP header carrying the packet.
+  QuicEcnCodepoint ecn_codepoint;
 };
 
 // An interface for anything that accepts packets at arbitrary rate.
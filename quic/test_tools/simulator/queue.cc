@@ -20,6 +20,8 @@ Queue::Queue(Simulator* simulator, QuicString name, QuicByteCount capacity)
       aggregation_timeout_(QuicTime::Delta::Infinite()),
       current_bundle_(0),
       current_bundle_bytes_(0),
+      ecn_marking_threshold_(0),
+      packets_ce_marked_(0),
       listener_(nullptr) {
   aggregation_timeout_alarm_.reset(simulator_->GetAlarmFactory()->CreateAlarm(
       new AggregationAlarmDelegate(this)));
@@ -41,6 +43,12 @@ void Queue::AcceptPacket(std::unique_ptr<Packet> packet) {
     return;
   }
 
+  if (ecn_marking_threshold_ > 0 && bytes_queued_ >= ecn_marking_threshold_ &&
+      packet->ecn_codepoint != ECN_NOT_ECT) {
+    packet->ecn_codepoint = ECN_CE;
+    ++packets_ce_marked_;
+  }
+
   bytes_queued_ += packet->size;
   queue_.emplace(std::move(packet), current_bundle_);
 
@@ -54,6 +54,18 @@ class Queue : public Actor, public UnconstrainedPortInterface {
   void EnableAggregation(QuicByteCount aggregation_threshold,
                          QuicTime::Delta aggregation_timeout);
 
+  // Makes the queue mark ECN-capable packets CE instead of queueing them behind
+  // |ecn_marking_threshold| or more bytes, like an AQM with a step threshold.
+  // Zero, the default, disables marking.
+  inline void set_ecn_marking_threshold(QuicByteCount ecn_marking_threshold) {
+    ecn_marking_threshold_ = ecn_marking_threshold;
+  }
+
+  // Number of packets the queue has marked CE.
+  inline QuicPacketCount packets_ce_marked() const {
+    return packets_ce_marked_;
+  }
+
  private:
   typedef uint64_t AggregationBundleNumber;
 
@@ -108,6 +120,9 @@ class Queue : public Actor, public UnconstrainedPortInterface {
   // the first packet in the bundle is enqueued.
   std::unique_ptr<QuicAlarm> aggregation_timeout_alarm_;
 
+  QuicByteCount ecn_marking_threshold_;
+  QuicPacketCount packets_ce_marked_;
+
   ConstrainedPortInterface* tx_port_;
   QuicQueue<EnqueuedPacket> queue_;
 
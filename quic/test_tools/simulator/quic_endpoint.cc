@@ -62,7 +62,7 @@ QuicEndpoint::QuicEndpoint(Simulator* simulator,
                            QuicConnectionId connection_id)
     : Endpoint(simulator, name),
       peer_name_(peer_name),
-      writer_(this),
+      writer_(this, name, &nic_tx_queue_),
       nic_tx_queue_(simulator,
                     QuicStringPrintf("%s (TX Queue)", name.c_str()),
                     kMaxPacketSize * kTxQueueSize),
@@ -79,6 +79,7 @@ QuicEndpoint::QuicEndpoint(Simulator* simulator,
       write_blocked_count_(0),
       wrong_data_received_(false),
       drop_next_packet_(false),
+      ecn_enabled_(false),
       notifier_(nullptr) {
   nic_tx_queue_.set_listener_interface(this);
 
@@ -103,18 +104,7 @@ QuicEndpoint::QuicEndpoint(Simulator* simulator,
   // primarily because
   //  - this enables pacing, and
   //  - this sets the non-handshake timeouts.
-  QuicString error;
-  CryptoHandshakeMessage peer_hello;
-  peer_hello.SetValue(kICSL,
-                      static_cast<uint32_t>(kMaximumIdleTimeoutSecs - 1));
-  peer_hello.SetValue(kMIDS,
-                      static_cast<uint32_t>(kDefaultMaxStreamsPerConnection));
-  QuicConfig config;
-  QuicErrorCode error_code = config.ProcessPeerHello(
-      peer_hello, perspective == Perspective::IS_CLIENT ? SERVER : CLIENT,
-      &error);
-  DCHECK_EQ(error_code, QUIC_NO_ERROR) << "Configuration failed: " << error;
-  connection_.SetFromConfig(config);
+  ConfigureConnection(QuicTagVector());
 }
 
 QuicEndpoint::~QuicEndpoint() {
@@ -172,6 +162,51 @@ void QuicEndpoint::DropNextIncomingPacket() {
   drop_next_packet_ = true;
 }
 
+void QuicEndpoint::EnableEcn() {
+  DCHECK_EQ(QUIC_VERSION_99, connection_.transport_version());
+  ecn_enabled_ = true;
+  test::QuicConnectionPeer::GetSentPacketManager(&connection_)->EnableEcn();
+}
+
+QuicEndpoint::NetworkInterface* QuicEndpoint::AddNetworkInterface(
+    QuicString name) {
+  network_interfaces_.push_back(
+      QuicMakeUnique<NetworkInterface>(simulator(), name, this));
+  return network_interfaces_.back().get();
+}
+
+void QuicEndpoint::NegotiateMultipath() {
+  ConfigureConnection({kMPTH});
+}
+
+void QuicEndpoint::NegotiateFec() {
+  ConfigureConnection({kFECT});
+}
+
+void QuicEndpoint::ConfigureConnection(
+    const QuicTagVector& connection_options) {
+  const Perspective perspective = connection_.perspective();
+  QuicString error;
+  CryptoHandshakeMessage peer_hello;
+  peer_hello.SetValue(kICSL,
+                      static_cast<uint32_t>(kMaximumIdleTimeoutSecs - 1));
+  peer_hello.SetValue(kMIDS,
+                      static_cast<uint32_t>(kDefaultMaxStreamsPerConnection));
+  QuicConfig config;
+  if (perspective == Perspective::IS_SERVER && !connection_options.empty()) {
+    // The options are sent by the client.
+    peer_hello.SetVector(kCOPT, connection_options);
+  }
+  QuicErrorCode error_code = config.ProcessPeerHello(
+      peer_hello, perspective == Perspective::IS_CLIENT ? SERVER : CLIENT,
+      &error);
+  DCHECK_EQ(error_code, QUIC_NO_ERROR) << "Configuration failed: " << error;
+  if (perspective == Perspective::IS_CLIENT) {
+    config.SetConnectionOptionsToSend(connection_options);
+  }
+  connection_.SetFromConfig(config);
+}
+
 void QuicEndpoint::RecordTrace() {
   trace_visitor_ = QuicMakeUnique<QuicTraceVisitor>(&connection_);
   connection_.set_debug_visitor(trace_visitor_.get());
@@ -181,15 +216,7 @@ void QuicEndpoint::AcceptPacket(std::unique_ptr<Packet> packet) {
   if (packet->destination != name_) {
     return;
   }
-  if (drop_next_packet_) {
-    drop_next_packet_ = false;
-    return;
-  }
-
-  QuicReceivedPacket received_packet(packet->contents.data(),
-                                     packet->contents.size(), clock_->Now());
-  connection_.ProcessUdpPacket(connection_.self_address(),
-                               connection_.peer_address(), received_packet);
+  ProcessPacket(std::move(packet));
 }
 
 UnconstrainedPortInterface* QuicEndpoint::GetRxPort() {
@@ -202,10 +229,7 @@ void QuicEndpoint::SetTxPort(ConstrainedPortInterface* port) {
 }
 
 void QuicEndpoint::OnPacketDequeued() {
-  if (writer_.IsWriteBlocked() &&
-      (nic_tx_queue_.capacity() - nic_tx_queue_.bytes_queued()) >=
-          kMaxPacketSize) {
-    writer_.SetWritable();
+  if (writer_.MaybeSetWritable()) {
     connection_.OnCanWrite();
   }
 }
@@ -245,6 +269,14 @@ bool QuicEndpoint::HasOpenDynamicStreams() const {
   return true;
 }
 
+void QuicEndpoint::OnConnectivityProbeReceived(
+    const QuicSocketAddress& self_address,
+    const QuicSocketAddress& peer_address) {
+  if (connection_.perspective() == Perspective::IS_SERVER) {
+    connection_.SendConnectivityProbingResponsePacket(peer_address);
+  }
+}
+
 bool QuicEndpoint::AllowSelfAddressChange() const {
   return false;
 }
@@ -277,11 +309,22 @@ bool QuicEndpoint::HasUnackedCryptoData() const {
   return false;
 }
 
-QuicEndpoint::Writer::Writer(QuicEndpoint* endpoint)
-    : endpoint_(endpoint), is_blocked_(false) {}
+QuicEndpoint::Writer::Writer(QuicEndpoint* endpoint,
+                             QuicString name,
+                             Queue* queue)
+    : endpoint_(endpoint), name_(name), queue_(queue), is_blocked_(false) {}
 
 QuicEndpoint::Writer::~Writer() {}
 
+bool QuicEndpoint::Writer::MaybeSetWritable() {
+  if (!is_blocked_ ||
+      (queue_->capacity() - queue_->bytes_queued()) < kMaxPacketSize) {
+    return false;
+  }
+  is_blocked_ = false;
+  return true;
+}
+
 WriteResult QuicEndpoint::Writer::WritePacket(
     const char* buffer,
     size_t buf_len,
@@ -294,21 +337,24 @@ WriteResult QuicEndpoint::Writer::WritePacket(
 
   // Instead of losing a packet, become write-blocked when the egress queue is
   // full.
-  if (endpoint_->nic_tx_queue_.packets_queued() > kTxQueueSize) {
+  if (queue_->packets_queued() > kTxQueueSize) {
     is_blocked_ = true;
     endpoint_->write_blocked_count_++;
     return WriteResult(WRITE_STATUS_BLOCKED, 0);
   }
 
   auto packet = QuicMakeUnique<Packet>();
-  packet->source = endpoint_->name();
-  packet->destination = endpoint_->peer_name_;
+  packet->source = name_;
+  packet->destination = endpoint_->GetPeerName(peer_address);
   packet->tx_timestamp = endpoint_->clock_->Now();
 
   packet->contents = QuicString(buffer, buf_len);
   packet->size = buf_len;
+  if (endpoint_->ecn_enabled_) {
+    packet->ecn_codepoint = ECN_ECT0;
+  }
 
-  endpoint_->nic_tx_queue_.AcceptPacket(std::move(packet));
+  queue_->AcceptPacket(std::move(packet));
 
   return WriteResult(WRITE_STATUS_OK, buf_len);
 }
@@ -361,6 +407,73 @@ bool QuicEndpoint::DataProducer::WriteCryptoData(EncryptionLevel leve,
   return false;
 }
 
+QuicEndpoint::NetworkInterface::NetworkInterface(Simulator* simulator,
+                                                 QuicString name,
+                                                 QuicEndpoint* endpoint)
+    : Endpoint(simulator, name),
+      endpoint_(endpoint),
+      writer_(endpoint, name, &tx_queue_),
+      tx_queue_(simulator,
+                QuicStringPrintf("%s (TX Queue)", name.c_str()),
+                kMaxPacketSize * kTxQueueSize) {
+  tx_queue_.set_listener_interface(this);
+}
+
+QuicEndpoint::NetworkInterface::~NetworkInterface() {}
+
+QuicSocketAddress QuicEndpoint::NetworkInterface::address() const {
+  return GetAddressFromName(name());
+}
+
+void QuicEndpoint::NetworkInterface::AcceptPacket(
+    std::unique_ptr<Packet> packet) {
+  if (packet->destination != name()) {
+    return;
+  }
+  endpoint_->ProcessPacket(std::move(packet));
+}
+
+UnconstrainedPortInterface* QuicEndpoint::NetworkInterface::GetRxPort() {
+  return this;
+}
+
+void QuicEndpoint::NetworkInterface::SetTxPort(
+    ConstrainedPortInterface* port) {
+  tx_queue_.set_tx_port(port);
+}
+
+void QuicEndpoint::NetworkInterface::OnPacketDequeued() {
+  if (writer_.MaybeSetWritable()) {
+    endpoint_->connection_.OnCanWrite();
+  }
+}
+
+void QuicEndpoint::ProcessPacket(std::unique_ptr<Packet> packet) {
+  if (drop_next_packet_) {
+    drop_next_packet_ = false;
+    return;
+  }
+
+  const QuicSocketAddress self_address =
+      GetAddressFromName(packet->destination);
+  const QuicSocketAddress peer_address = GetAddressFromName(packet->source);
+  peer_names_[peer_address.ToString()] = packet->source;
+
+  QuicReceivedPacket received_packet(packet->contents.data(),
+                                     packet->contents.size(), clock_->Now());
+  received_packet.set_ecn_codepoint(packet->ecn_codepoint);
+  connection_.ProcessUdpPacket(self_address, peer_address, received_packet);
+}
+
+QuicString QuicEndpoint::GetPeerName(
+    const QuicSocketAddress& peer_address) const {
+  auto it = peer_names_.find(peer_address.ToString());
+  if (it == peer_names_.end()) {
+    return peer_name_;
+  }
+  return it->second;
+}
+
 void QuicEndpoint::WriteStreamData() {
   // Instantiate a flusher which would normally be here due to QuicSession.
   QuicConnection::ScopedPacketFlusher flusher(
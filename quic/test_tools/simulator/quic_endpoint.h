@@ -5,12 +5,16 @@
 #ifndef QUICHE_QUIC_TEST_TOOLS_SIMULATOR_QUIC_ENDPOINT_H_
 #define QUICHE_QUIC_TEST_TOOLS_SIMULATOR_QUIC_ENDPOINT_H_
 
+#include <memory>
+#include <vector>
+
 #include "net/third_party/quiche/src/quic/core/crypto/null_decrypter.h"
 #include "net/third_party/quiche/src/quic/core/crypto/null_encrypter.h"
 #include "net/third_party/quiche/src/quic/core/quic_connection.h"
 #include "net/third_party/quiche/src/quic/core/quic_default_packet_writer.h"
 #include "net/third_party/quiche/src/quic/core/quic_packets.h"
 #include "net/third_party/quiche/src/quic/core/quic_stream_frame_data_producer.h"
+#include "net/third_party/quiche/src/quic/core/quic_tag.h"
 #include "net/third_party/quiche/src/quic/core/quic_trace_visitor.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_containers.h"
 #include "net/third_party/quiche/src/quic/test_tools/simple_session_notifier.h"
@@ -39,6 +43,12 @@ class QuicEndpoint : public Endpoint,
                      public QuicConnectionVisitorInterface,
                      public SessionNotifierInterface {
  public:
+  // An additional network interface of the endpoint, such as the cellular
+  // interface of a phone which is also on Wi-Fi.  The interface has its own
+  // address and TX queue, and passes the packets it receives to the
+  // connection.
+  class NetworkInterface;
+
   QuicEndpoint(Simulator* simulator,
                QuicString name,
                QuicString peer_name,
@@ -60,6 +70,23 @@ class QuicEndpoint : public Endpoint,
   // Drop the next packet upon receipt.
   void DropNextIncomingPacket();
 
+  // Marks outgoing packets ECT(0), and makes the connection respond to CE
+  // marks reported by the peer.  Requires a version with IETF acks.
+  void EnableEcn();
+
+  // Adds a network interface called |name|, which has to be linked to the
+  // network like any other endpoint.  The connection can validate and migrate
+  // to the interface's path through the interface's writer.
+  NetworkInterface* AddNetworkInterface(QuicString name);
+
+  // Configures the connection as if the kMPTH connection option had been
+  // negotiated.  Has to be called on both endpoints.
+  void NegotiateMultipath();
+
+  // Configures the connection as if the kFECT connection option had been
+  // negotiated.  Has to be called on both endpoints.
+  void NegotiateFec();
+
   // UnconstrainedPortInterface method.  Called whenever the endpoint receives a
   // packet.
   void AcceptPacket(std::unique_ptr<Packet> packet) override;
@@ -99,7 +126,7 @@ class QuicEndpoint : public Endpoint,
       const ParsedQuicVersion& version) override {}
   void OnConnectivityProbeReceived(
       const QuicSocketAddress& self_address,
-      const QuicSocketAddress& peer_address) override {}
+      const QuicSocketAddress& peer_address) override;
   void OnCongestionWindowChange(QuicTime now) override {}
   void OnConnectionMigration(AddressChangeType type) override {}
   void OnPathDegrading() override {}
@@ -131,12 +158,17 @@ class QuicEndpoint : public Endpoint,
   // End SessionNotifierInterface implementation.
 
  private:
-  // A Writer object that writes into the |nic_tx_queue_|.
+  // A Writer object that writes into the TX queue of an interface, |queue|,
+  // and sends packets from the interface called |name|.
   class Writer : public QuicPacketWriter {
    public:
-    explicit Writer(QuicEndpoint* endpoint);
+    Writer(QuicEndpoint* endpoint, QuicString name, Queue* queue);
     ~Writer() override;
 
+    // Unblocks the writer and returns true if it is blocked and the TX queue
+    // has room for another packet.
+    bool MaybeSetWritable();
+
     WriteResult WritePacket(const char* buffer,
                             size_t buf_len,
                             const QuicIpAddress& self_address,
@@ -154,10 +186,48 @@ class QuicEndpoint : public Endpoint,
 
    private:
     QuicEndpoint* endpoint_;
+    QuicString name_;
+    Queue* queue_;
 
     bool is_blocked_;
   };
 
+ public:
+  class NetworkInterface : public Endpoint,
+                           public UnconstrainedPortInterface,
+                           public Queue::ListenerInterface {
+   public:
+    NetworkInterface(Simulator* simulator,
+                     QuicString name,
+                     QuicEndpoint* endpoint);
+    ~NetworkInterface() override;
+
+    inline QuicPacketWriter* writer() { return &writer_; }
+    QuicSocketAddress address() const;
+
+    // UnconstrainedPortInterface method.  Called whenever the interface
+    // receives a packet.
+    void AcceptPacket(std::unique_ptr<Packet> packet) override;
+
+    // Begin Endpoint implementation.
+    UnconstrainedPortInterface* GetRxPort() override;
+    void SetTxPort(ConstrainedPortInterface* port) override;
+    // End Endpoint implementation.
+
+    // Actor method.
+    void Act() override {}
+
+    // Queue::ListenerInterface method.
+    void OnPacketDequeued() override;
+
+   private:
+    QuicEndpoint* endpoint_;
+    Writer writer_;
+    Queue tx_queue_;
+  };
+
+ private:
+
   // The producer outputs the repetition of the same byte.  That sequence is
   // verified by the receiver.
   class DataProducer : public QuicStreamFrameDataProducer {
@@ -172,11 +242,24 @@ class QuicEndpoint : public Endpoint,
                          QuicDataWriter* writer) override;
   };
 
+  // Configures the connection as if it received a handshake with
+  // |connection_options|.
+  void ConfigureConnection(const QuicTagVector& connection_options);
+
   // Write stream data until |bytes_to_transfer_| is zero or the connection is
   // write-blocked.
   void WriteStreamData();
 
+  // Passes |packet|, received on any of the interfaces, to the connection.
+  void ProcessPacket(std::unique_ptr<Packet> packet);
+
+  // Returns the name of the peer interface at |peer_address|.
+  QuicString GetPeerName(const QuicSocketAddress& peer_address) const;
+
   QuicString peer_name_;
+  // Names of the peer interfaces packets were received from, keyed by their
+  // address.  Lets replies follow the peer when it migrates.
+  QuicUnorderedMap<QuicString, QuicString> peer_names_;
 
   Writer writer_;
   DataProducer producer_;
@@ -184,6 +267,7 @@ class QuicEndpoint : public Endpoint,
   // the network card, or in the kernel, but for concreteness we assume it's on
   // the network card.
   Queue nic_tx_queue_;
+  std::vector<std::unique_ptr<NetworkInterface>> network_interfaces_;
   QuicConnection connection_;
 
   QuicByteCount bytes_to_transfer_;
@@ -199,6 +283,9 @@ class QuicEndpoint : public Endpoint,
   // If true, drop the next packet when receiving it.
   bool drop_next_packet_;
 
+  // If true, outgoing packets are marked ECT(0).
+  bool ecn_enabled_;
+
   // Record of received offsets in the data stream.
   QuicIntervalSet<QuicStreamOffset> offsets_received_;
 
@@ -152,6 +152,194 @@ TEST_F(QuicEndpointTest, TwoWayTransmission) {
   EXPECT_FALSE(endpoint_b.wrong_data_received());
 }
 
+// Test that a queue which marks packets CE makes an ECN-capable sender back
+// off, and that the peer's ECN counts pass validation.
+TEST_F(QuicEndpointTest, EcnCongestionResponse) {
+  SetQuicReloadableFlag(quic_enable_version_99, true);
+  SetQuicReloadableFlag(quic_enable_version_47, true);
+  SetQuicReloadableFlag(quic_enable_version_46, true);
+  SetQuicReloadableFlag(quic_enable_version_44, true);
+  SetQuicReloadableFlag(quic_enable_version_43, true);
+  QuicEndpoint endpoint_a(&simulator_, "Endpoint A", "Endpoint B",
+                          Perspective::IS_CLIENT, test::TestConnectionId(42));
+  QuicEndpoint endpoint_b(&simulator_, "Endpoint B", "Endpoint A",
+                          Perspective::IS_SERVER, test::TestConnectionId(42));
+  ASSERT_EQ(QUIC_VERSION_99, endpoint_a.connection()->transport_version());
+  auto link_a = Link(&endpoint_a, switch_.port(1));
+  auto link_b = Link(&endpoint_b, switch_.port(2));
+
+  endpoint_a.EnableEcn();
+  switch_.port_queue(2)->set_ecn_marking_threshold(kDefaultBdp / 4);
+
+  const QuicByteCount bytes_to_transfer = 2 * 1024 * 1024;
+  endpoint_a.AddBytesToTransfer(bytes_to_transfer);
+  QuicTime end_time =
+      simulator_.GetClock()->Now() + QuicTime::Delta::FromSeconds(10);
+  simulator_.RunUntil([this, &endpoint_b, bytes_to_transfer, end_time]() {
+    return endpoint_b.bytes_received() == bytes_to_transfer ||
+           simulator_.GetClock()->Now() >= end_time;
+  });
+
+  EXPECT_EQ(bytes_to_transfer, endpoint_b.bytes_received());
+  EXPECT_FALSE(endpoint_b.wrong_data_received());
+  EXPECT_GT(switch_.port_queue(2)->packets_ce_marked(), 0u);
+  EXPECT_GT(endpoint_b.connection()->GetStats().ecn_ce_packets_received, 0u);
+  EXPECT_GT(endpoint_a.connection()->GetStats().ecn_ce_events, 0u);
+  EXPECT_TRUE(
+      test::QuicConnectionPeer::GetSentPacketManager(endpoint_a.connection())
+          ->ecn_enabled());
+}
+
+// Hand a transfer over from Wi-Fi to cellular.  The client validates the
+// cellular path while the transfer continues over Wi-Fi, then migrates.
+TEST_F(QuicEndpointTest, WifiToCellularHandover) {
+  QuicEndpoint client(&simulator_, "Client (Wi-Fi)", "Server",
+                      Perspective::IS_CLIENT, test::TestConnectionId(42));
+  QuicEndpoint server(&simulator_, "Server", "Client (Wi-Fi)",
+                      Perspective::IS_SERVER, test::TestConnectionId(42));
+  QuicEndpoint::NetworkInterface* cellular =
+      client.AddNetworkInterface("Client (cellular)");
+  auto wifi_link = Link(&client, switch_.port(1));
+  auto server_link = Link(&server, switch_.port(2));
+  auto cellular_link = CustomLink(cellular, switch_.port(3), 100);
+  QuicConnection* connection = client.connection();
+
+  const QuicByteCount bytes_to_transfer = 2 * 1024 * 1024;
+  client.AddBytesToTransfer(bytes_to_transfer);
+  simulator_.RunFor(QuicTime::Delta::FromMilliseconds(500));
+  EXPECT_GT(server.bytes_received(), 0u);
+  const QuicTime::Delta wifi_min_rtt =
+      connection->sent_packet_manager().GetRttStats()->min_rtt();
+
+  // Validating the cellular path does not disturb the Wi-Fi path.
+  ASSERT_TRUE(connection->ValidateAlternativePath(
+      cellular->writer(), cellular->address(), GetAddressFromName("Server")));
+  simulator_.RunUntilOrTimeout(
+      [connection]() { return connection->IsAlternativePathValidated(); },
+      QuicTime::Delta::FromSeconds(1));
+  ASSERT_TRUE(connection->IsAlternativePathValidated());
+  const QuicTime::Delta cellular_min_rtt =
+      connection->GetAlternativePathRttStats()->min_rtt();
+  EXPECT_GT(cellular_min_rtt, wifi_min_rtt);
+  EXPECT_EQ(wifi_min_rtt,
+            connection->sent_packet_manager().GetRttStats()->min_rtt());
+  EXPECT_EQ(GetAddressFromName("Client (Wi-Fi)"),
+            server.connection()->peer_address());
+
+  // Hand over to cellular and finish the transfer there.
+  ASSERT_TRUE(connection->SwitchToAlternativePath());
+  EXPECT_EQ(cellular->address(), connection->self_address());
+  QuicTime end_time =
+      simulator_.GetClock()->Now() + QuicTime::Delta::FromSeconds(20);
+  simulator_.RunUntil([this, &server, bytes_to_transfer, end_time]() {
+    return server.bytes_received() == bytes_to_transfer ||
+           simulator_.GetClock()->Now() >= end_time;
+  });
+
+  EXPECT_EQ(bytes_to_transfer, server.bytes_received());
+  EXPECT_FALSE(server.wrong_data_received());
+  EXPECT_EQ(cellular->address(), server.connection()->peer_address());
+  // The active path measures the cellular RTT, while the Wi-Fi estimates are
+  // kept for a switch back.
+  EXPECT_GT(connection->sent_packet_manager().GetRttStats()->min_rtt(),
+            wifi_min_rtt + QuicTime::Delta::FromMilliseconds(100));
+  EXPECT_EQ(wifi_min_rtt, connection->GetAlternativePathRttStats()->min_rtt());
+}
+
+// Upload over Wi-Fi and cellular at the same time, with the server behind a
+// link as fast as both client links together.
+TEST_F(QuicEndpointTest, WifiAndCellularMultipath) {
+  QuicEndpoint client(&simulator_, "Client (Wi-Fi)", "Server",
+                      Perspective::IS_CLIENT, test::TestConnectionId(42));
+  QuicEndpoint server(&simulator_, "Server", "Client (Wi-Fi)",
+                      Perspective::IS_SERVER, test::TestConnectionId(42));
+  QuicEndpoint::NetworkInterface* cellular =
+      client.AddNetworkInterface("Client (cellular)");
+  auto wifi_link = Link(&client, switch_.port(1));
+  auto server_link = QuicMakeUnique<SymmetricLink>(
+      &server, switch_.port(2), 2 * kDefaultBandwidth,
+      kDefaultPropagationDelay);
+  auto cellular_link = CustomLink(cellular, switch_.port(3), 20);
+  QuicConnection* connection = client.connection();
+  client.NegotiateMultipath();
+  server.NegotiateMultipath();
+  connection->OnHandshakeComplete();
+
+  ASSERT_TRUE(connection->ValidateAlternativePath(
+      cellular->writer(), cellular->address(), GetAddressFromName("Server")));
+  simulator_.RunUntilOrTimeout(
+      [connection]() { return connection->IsAlternativePathValidated(); },
+      QuicTime::Delta::FromSeconds(1));
+  ASSERT_TRUE(connection->IsAlternativePathValidated());
+  ASSERT_TRUE(
+      connection->EnableMultipath(QuicMakeUnique<MinRttPathScheduler>()));
+
+  const QuicByteCount bytes_to_transfer = 10 * 1024 * 1024;
+  const QuicTime start_time = simulator_.GetClock()->Now();
+  client.AddBytesToTransfer(bytes_to_transfer);
+  QuicTime end_time = start_time + QuicTime::Delta::FromSeconds(20);
+  simulator_.RunUntil([this, &server, bytes_to_transfer, end_time]() {
+    return server.bytes_received() == bytes_to_transfer ||
+           simulator_.GetClock()->Now() >= end_time;
+  });
+
+  EXPECT_EQ(bytes_to_transfer, server.bytes_received());
+  EXPECT_FALSE(server.wrong_data_received());
+  // Both paths carried a significant share of the data, and the transfer took
+  // less time than the Wi-Fi link alone needs for it.
+  const QuicConnectionStats& stats = connection->GetStats();
+  EXPECT_GT(stats.packets_sent_on_alternative_path, stats.packets_sent / 4);
+  EXPECT_LT(stats.packets_sent_on_alternative_path, stats.packets_sent * 3 / 4);
+  EXPECT_LT(simulator_.GetClock()->Now() - start_time,
+            kDefaultBandwidth.TransferTime(bytes_to_transfer));
+  // The server keeps acking on the Wi-Fi path.
+  EXPECT_EQ(GetAddressFromName("Client (Wi-Fi)"),
+            server.connection()->peer_address());
+}
+
+// Losing the only packet of a short transfer is repaired by the FEC packet
+// following it, instead of waiting for a retransmission.
+TEST_F(QuicEndpointTest, FecRecoversLostTailPacket) {
+  QuicEndpoint fec_client(&simulator_, "FEC client", "FEC server",
+                          Perspective::IS_CLIENT, test::TestConnectionId(42));
+  QuicEndpoint fec_server(&simulator_, "FEC server", "FEC client",
+                          Perspective::IS_SERVER, test::TestConnectionId(42));
+  QuicEndpoint client(&simulator_, "Client", "Server", Perspective::IS_CLIENT,
+                      test::TestConnectionId(43));
+  QuicEndpoint server(&simulator_, "Server", "Client", Perspective::IS_SERVER,
+                      test::TestConnectionId(43));
+  auto fec_client_link = Link(&fec_client, switch_.port(1));
+  auto fec_server_link = Link(&fec_server, switch_.port(2));
+  auto client_link = Link(&client, switch_.port(3));
+  auto server_link = Link(&server, switch_.port(4));
+  fec_client.NegotiateFec();
+  fec_server.NegotiateFec();
+  ASSERT_TRUE(fec_client.connection()->fec_enabled());
+  ASSERT_TRUE(fec_server.connection()->fec_enabled());
+
+  const QuicByteCount bytes_to_transfer = 600;
+  fec_server.DropNextIncomingPacket();
+  server.DropNextIncomingPacket();
+  fec_client.AddBytesToTransfer(bytes_to_transfer);
+  client.AddBytesToTransfer(bytes_to_transfer);
+
+  // Give the packets time to cross both links, but not enough for the loss to
+  // be detected and retransmitted.
+  const QuicTime end_time = simulator_.GetClock()->Now() +
+                            4 * kDefaultPropagationDelay +
+                            QuicTime::Delta::FromMilliseconds(5);
+  simulator_.RunUntil(
+      [this, end_time]() { return simulator_.GetClock()->Now() >= end_time; });
+
+  EXPECT_EQ(bytes_to_transfer, fec_server.bytes_received());
+  EXPECT_FALSE(fec_server.wrong_data_received());
+  EXPECT_EQ(1u, fec_client.connection()->GetStats().fec_packets_sent);
+  EXPECT_EQ(
+      1u, fec_server.connection()->GetStats().stream_frames_recovered_by_fec);
+  EXPECT_EQ(0u, server.bytes_received());
+  EXPECT_EQ(0u, client.connection()->GetStats().fec_packets_sent);
+}
+
 // Simulate three hosts trying to send data to a fourth one simultaneously.
 TEST_F(QuicEndpointTest, Competition) {
   // TODO(63765788): Turn back on this flag when the issue if fixed.
@@ -22,7 +22,9 @@ QuicBackendResponse::ServerPushInfo::ServerPushInfo(const ServerPushInfo& other)
       priority(other.priority),
       body(other.body) {}
 
-QuicBackendResponse::QuicBackendResponse() : response_type_(REGULAR_RESPONSE) {}
+QuicBackendResponse::QuicBackendResponse()
+    : response_type_(REGULAR_RESPONSE),
+      body_(QuicSharedBuffer::Create(QuicString())) {}
 
 QuicBackendResponse::~QuicBackendResponse() = default;
 
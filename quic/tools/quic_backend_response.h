@@ -6,6 +6,8 @@
 #define QUICHE_QUIC_TOOLS_QUIC_BACKEND_RESPONSE_H_
 
 #include "net/third_party/quiche/src/quic/core/http/spdy_utils.h"
+#include "net/third_party/quiche/src/quic/core/quic_shared_buffer.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_reference_counted.h"
 #include "net/third_party/quiche/src/quic/tools/quic_url.h"
 
 namespace quic {
@@ -53,7 +55,11 @@ class QuicBackendResponse {
   SpecialResponseType response_type() const { return response_type_; }
   const spdy::SpdyHeaderBlock& headers() const { return headers_; }
   const spdy::SpdyHeaderBlock& trailers() const { return trailers_; }
-  const QuicStringPiece body() const { return QuicStringPiece(body_); }
+  const QuicStringPiece body() const { return body_->data(); }
+  // The body as a buffer which streams send from without copying it.
+  QuicReferenceCountedPointer<QuicSharedBuffer> shared_body() const {
+    return body_;
+  }
 
   void set_response_type(SpecialResponseType response_type) {
     response_type_ = response_type;
@@ -66,7 +72,10 @@ class QuicBackendResponse {
     trailers_ = std::move(trailers);
   }
   void set_body(QuicStringPiece body) {
-    body_.assign(body.data(), body.size());
+    body_ = QuicSharedBuffer::Create(QuicString(body));
+  }
+  void set_body(QuicReferenceCountedPointer<QuicSharedBuffer> body) {
+    body_ = std::move(body);
   }
   uint16_t stop_sending_code() const { return stop_sending_code_; }
   void set_stop_sending_code(uint16_t code) { stop_sending_code_ = code; }
@@ -75,7 +84,8 @@ class QuicBackendResponse {
   SpecialResponseType response_type_;
   spdy::SpdyHeaderBlock headers_;
   spdy::SpdyHeaderBlock trailers_;
-  QuicString body_;
+  // Never null. Shared by all the streams which are sending the response.
+  QuicReferenceCountedPointer<QuicSharedBuffer> body_;
   uint16_t stop_sending_code_;
 };
 
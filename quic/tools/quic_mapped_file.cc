@@ -0,0 +1,82 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/tools/quic_mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+QuicFileMapping::QuicFileMapping() : address_(nullptr), length_(0) {}
+
+QuicFileMapping::QuicFileMapping(QuicFileMapping&& other)
+    : address_(other.address_), length_(other.length_) {
+  other.address_ = nullptr;
+  other.length_ = 0;
+}
+
+QuicFileMapping& QuicFileMapping::operator=(QuicFileMapping&& other) {
+  if (this != &other) {
+    Unmap();
+    address_ = other.address_;
+    length_ = other.length_;
+    other.address_ = nullptr;
+    other.length_ = 0;
+  }
+  return *this;
+}
+
+QuicFileMapping::~QuicFileMapping() {
+  Unmap();
+}
+
+bool QuicFileMapping::Map(const QuicString& file_name) {
+  Unmap();
+  int fd = open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    QUIC_LOG(ERROR) << "Failed to open " << file_name << ": errno " << errno;
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+    close(fd);
+    return false;
+  }
+  const size_t length = static_cast<size_t>(file_stat.st_size);
+  void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps the file open.
+  close(fd);
+  if (address == MAP_FAILED) {
+    QUIC_LOG(ERROR) << "Failed to map " << file_name << ": errno " << errno;
+    return false;
+  }
+  address_ = address;
+  length_ = length;
+  return true;
+}
+
+void QuicFileMapping::Unmap() {
+  if (address_ == nullptr) {
+    return;
+  }
+  munmap(address_, length_);
+  address_ = nullptr;
+  length_ = 0;
+}
+
+QuicMappedFileBuffer::QuicMappedFileBuffer(QuicFileMapping mapping,
+                                           size_t offset)
+    : QuicSharedBuffer(mapping.contents().substr(offset)),
+      mapping_(std::move(mapping)) {}
+
+QuicMappedFileBuffer::~QuicMappedFileBuffer() {}
+
+}  // namespace quic
@@ -0,0 +1,63 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_TOOLS_QUIC_MAPPED_FILE_H_
+#define QUICHE_QUIC_TOOLS_QUIC_MAPPED_FILE_H_
+
+#include <cstddef>
+
+#include "net/third_party/quiche/src/quic/core/quic_shared_buffer.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_reference_counted.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
+
+namespace quic {
+
+// A read-only memory mapping of a whole file. Pages are read in from disk on
+// first access rather than when the file is mapped, and the kernel reclaims
+// them like any other page cache pages under memory pressure. It is move-only.
+//
+// Later writes to the file may show through the mapping, and truncating a
+// mapped file makes accesses past its new end raise SIGBUS. Mapped files must
+// therefore only be replaced by renaming a new file over them.
+class QuicFileMapping {
+ public:
+  QuicFileMapping();
+  QuicFileMapping(QuicFileMapping&& other);
+  QuicFileMapping& operator=(QuicFileMapping&& other);
+  QuicFileMapping(const QuicFileMapping&) = delete;
+  QuicFileMapping& operator=(const QuicFileMapping&) = delete;
+  ~QuicFileMapping();
+
+  // Maps |file_name|, replacing any previous mapping. Returns false if the file
+  // cannot be mapped, for example because it is empty.
+  bool Map(const QuicString& file_name);
+
+  QuicStringPiece contents() const {
+    return QuicStringPiece(static_cast<const char*>(address_), length_);
+  }
+
+ private:
+  void Unmap();
+
+  void* address_;
+  size_t length_;
+};
+
+// A shared buffer holding the part of a file mapping from |offset| on. The file
+// stays mapped until the last reference to the buffer goes away.
+class QuicMappedFileBuffer : public QuicSharedBuffer {
+ public:
+  QuicMappedFileBuffer(QuicFileMapping mapping, size_t offset);
+
+ protected:
+  ~QuicMappedFileBuffer() override;
+
+ private:
+  const QuicFileMapping mapping_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_TOOLS_QUIC_MAPPED_FILE_H_
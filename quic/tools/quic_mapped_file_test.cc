@@ -0,0 +1,83 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/tools/quic_mapped_file.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <utility>
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+class QuicMappedFileTest : public QuicTest {
+ protected:
+  ~QuicMappedFileTest() override {
+    for (const QuicString& file_name : file_names_) {
+      unlink(file_name.c_str());
+    }
+  }
+
+  // Writes |contents| to a new temporary file and returns its name.
+  QuicString CreateFile(QuicStringPiece contents) {
+    QuicString file_name = ::testing::TempDir() + "/quic_mapped_file_XXXXXX";
+    int fd = mkstemp(&file_name[0]);
+    EXPECT_LE(0, fd);
+    EXPECT_EQ(static_cast<ssize_t>(contents.length()),
+              write(fd, contents.data(), contents.length()));
+    close(fd);
+    file_names_.push_back(file_name);
+    return file_name;
+  }
+
+  // Maps a new file holding |contents| and returns its body from |offset| on.
+  QuicReferenceCountedPointer<QuicMappedFileBuffer> CreateBuffer(
+      QuicStringPiece contents,
+      size_t offset) {
+    QuicFileMapping mapping;
+    EXPECT_TRUE(mapping.Map(CreateFile(contents)));
+    return QuicReferenceCountedPointer<QuicMappedFileBuffer>(
+        new QuicMappedFileBuffer(std::move(mapping), offset));
+  }
+
+  std::vector<QuicString> file_names_;
+};
+
+TEST_F(QuicMappedFileTest, MapsFile) {
+  QuicFileMapping mapping;
+  ASSERT_TRUE(mapping.Map(CreateFile("headers\n\nbody")));
+  EXPECT_EQ("headers\n\nbody", mapping.contents());
+}
+
+TEST_F(QuicMappedFileTest, FailsToMapMissingOrEmptyFile) {
+  QuicFileMapping mapping;
+  EXPECT_FALSE(mapping.Map(::testing::TempDir() + "/quic_no_such_file"));
+  EXPECT_FALSE(mapping.Map(CreateFile("")));
+  EXPECT_TRUE(mapping.contents().empty());
+}
+
+TEST_F(QuicMappedFileTest, BufferStartsAtOffset) {
+  QuicReferenceCountedPointer<QuicMappedFileBuffer> buffer =
+      CreateBuffer("headers\n\nbody", 9);
+  EXPECT_EQ("body", buffer->data());
+}
+
+TEST_F(QuicMappedFileTest, BufferOutlivesMovedMapping) {
+  QuicFileMapping mapping;
+  ASSERT_TRUE(mapping.Map(CreateFile("abcdef")));
+  QuicFileMapping moved = std::move(mapping);
+  EXPECT_TRUE(mapping.contents().empty());
+  QuicReferenceCountedPointer<QuicSharedBuffer> buffer(
+      new QuicMappedFileBuffer(std::move(moved), 2));
+  EXPECT_EQ("cdef", buffer->data());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -25,22 +25,31 @@ QuicMemoryCacheBackend::ResourceFile::ResourceFile(const QuicString& file_name)
 QuicMemoryCacheBackend::ResourceFile::~ResourceFile() = default;
 
 void QuicMemoryCacheBackend::ResourceFile::Read() {
-  ReadFileContents(file_name_, &file_contents_);
+  // Map the file so that its body is only read from disk when it is first sent,
+  // and fall back to reading it all if it cannot be mapped.
+  QuicFileMapping mapping;
+  QuicStringPiece contents;
+  if (mapping.Map(file_name_)) {
+    contents = mapping.contents();
+  } else {
+    ReadFileContents(file_name_, &file_contents_);
+    contents = file_contents_;
+  }
 
   // First read the headers.
   size_t start = 0;
-  while (start < file_contents_.length()) {
-    size_t pos = file_contents_.find("\n", start);
+  while (start < contents.length()) {
+    size_t pos = contents.find("\n", start);
     if (pos == QuicString::npos) {
       QUIC_LOG(DFATAL) << "Headers invalid or empty, ignoring: " << file_name_;
       return;
     }
     size_t len = pos - start;
     // Support both dos and unix line endings for convenience.
-    if (file_contents_[pos - 1] == '\r') {
+    if (contents[pos - 1] == '\r') {
       len -= 1;
     }
-    QuicStringPiece line(file_contents_.data() + start, len);
+    QuicStringPiece line(contents.data() + start, len);
     start = pos + 1;
     // Headers end with an empty line.
     if (line.empty()) {
@@ -96,6 +105,11 @@ void QuicMemoryCacheBackend::ResourceFile::Read() {
     }
   }
 
+  if (!mapping.contents().empty()) {
+    mapped_body_ = new QuicMappedFileBuffer(std::move(mapping), start);
+    body_ = mapped_body_->data();
+    return;
+  }
   body_ = QuicStringPiece(file_contents_.data() + start,
                           file_contents_.size() - start);
 }
@@ -181,8 +195,19 @@ void QuicMemoryCacheBackend::AddResponse(QuicStringPiece host,
                                          SpdyHeaderBlock response_headers,
                                          QuicStringPiece response_body) {
   AddResponseImpl(host, path, QuicBackendResponse::REGULAR_RESPONSE,
-                  std::move(response_headers), response_body, SpdyHeaderBlock(),
-                  0);
+                  std::move(response_headers),
+                  QuicSharedBuffer::Create(QuicString(response_body)),
+                  SpdyHeaderBlock(), 0);
+}
+
+void QuicMemoryCacheBackend::AddResponse(
+    QuicStringPiece host,
+    QuicStringPiece path,
+    SpdyHeaderBlock response_headers,
+    QuicReferenceCountedPointer<QuicSharedBuffer> response_body) {
+  AddResponseImpl(host, path, QuicBackendResponse::REGULAR_RESPONSE,
+                  std::move(response_headers), std::move(response_body),
+                  SpdyHeaderBlock(), 0);
 }
 
 void QuicMemoryCacheBackend::AddResponse(QuicStringPiece host,
@@ -191,7 +216,8 @@ void QuicMemoryCacheBackend::AddResponse(QuicStringPiece host,
                                          QuicStringPiece response_body,
                                          SpdyHeaderBlock response_trailers) {
   AddResponseImpl(host, path, QuicBackendResponse::REGULAR_RESPONSE,
-                  std::move(response_headers), response_body,
+                  std::move(response_headers),
+                  QuicSharedBuffer::Create(QuicString(response_body)),
                   std::move(response_trailers), 0);
 }
 
@@ -199,8 +225,8 @@ void QuicMemoryCacheBackend::AddSpecialResponse(
     QuicStringPiece host,
     QuicStringPiece path,
     SpecialResponseType response_type) {
-  AddResponseImpl(host, path, response_type, SpdyHeaderBlock(), "",
-                  SpdyHeaderBlock(), 0);
+  AddResponseImpl(host, path, response_type, SpdyHeaderBlock(),
+                  QuicSharedBuffer::Create(QuicString()), SpdyHeaderBlock(), 0);
 }
 
 void QuicMemoryCacheBackend::AddSpecialResponse(
@@ -210,7 +236,8 @@ void QuicMemoryCacheBackend::AddSpecialResponse(
     QuicStringPiece response_body,
     SpecialResponseType response_type) {
   AddResponseImpl(host, path, response_type, std::move(response_headers),
-                  response_body, SpdyHeaderBlock(), 0);
+                  QuicSharedBuffer::Create(QuicString(response_body)),
+                  SpdyHeaderBlock(), 0);
 }
 
 void QuicMemoryCacheBackend::AddStopSendingResponse(
@@ -220,8 +247,9 @@ void QuicMemoryCacheBackend::AddStopSendingResponse(
     QuicStringPiece response_body,
     uint16_t stop_sending_code) {
   AddResponseImpl(host, path, SpecialResponseType::STOP_SENDING,
-                  std::move(response_headers), response_body, SpdyHeaderBlock(),
-                  stop_sending_code);
+                  std::move(response_headers),
+                  QuicSharedBuffer::Create(QuicString(response_body)),
+                  SpdyHeaderBlock(), stop_sending_code);
 }
 
 QuicMemoryCacheBackend::QuicMemoryCacheBackend() : cache_initialized_(false) {}
@@ -250,8 +278,14 @@ bool QuicMemoryCacheBackend::InitializeBackend(
     resource_file->SetHostPathFromBase(base);
     resource_file->Read();
 
-    AddResponse(resource_file->host(), resource_file->path(),
-                resource_file->spdy_headers().Clone(), resource_file->body());
+    if (resource_file->mapped_body()) {
+      AddResponse(resource_file->host(), resource_file->path(),
+                  resource_file->spdy_headers().Clone(),
+                  resource_file->mapped_body());
+    } else {
+      AddResponse(resource_file->host(), resource_file->path(),
+                  resource_file->spdy_headers().Clone(), resource_file->body());
+    }
 
     resource_files.push_back(std::move(resource_file));
   }
@@ -326,13 +360,14 @@ QuicMemoryCacheBackend::~QuicMemoryCacheBackend() {
   }
 }
 
-void QuicMemoryCacheBackend::AddResponseImpl(QuicStringPiece host,
-                                             QuicStringPiece path,
-                                             SpecialResponseType response_type,
-                                             SpdyHeaderBlock response_headers,
-                                             QuicStringPiece response_body,
-                                             SpdyHeaderBlock response_trailers,
-                                             uint16_t stop_sending_code) {
+void QuicMemoryCacheBackend::AddResponseImpl(
+    QuicStringPiece host,
+    QuicStringPiece path,
+    SpecialResponseType response_type,
+    SpdyHeaderBlock response_headers,
+    QuicReferenceCountedPointer<QuicSharedBuffer> response_body,
+    SpdyHeaderBlock response_trailers,
+    uint16_t stop_sending_code) {
   QuicWriterMutexLock lock(&response_mutex_);
 
   DCHECK(!host.empty()) << "Host must be populated, e.g. \"www.google.com\"";
@@ -344,7 +379,7 @@ void QuicMemoryCacheBackend::AddResponseImpl(QuicStringPiece host,
   auto new_response = QuicMakeUnique<QuicBackendResponse>();
   new_response->set_response_type(response_type);
   new_response->set_headers(std::move(response_headers));
-  new_response->set_body(response_body);
+  new_response->set_body(std::move(response_body));
   new_response->set_trailers(std::move(response_trailers));
   new_response->set_stop_sending_code(stop_sending_code);
   QUIC_DVLOG(1) << "Add response with key " << key;
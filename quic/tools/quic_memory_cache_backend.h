@@ -11,10 +11,12 @@
 #include <vector>
 
 #include "net/third_party/quiche/src/quic/core/http/spdy_utils.h"
+#include "net/third_party/quiche/src/quic/core/quic_shared_buffer.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_containers.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_mutex.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
 #include "net/third_party/quiche/src/quic/tools/quic_backend_response.h"
+#include "net/third_party/quiche/src/quic/tools/quic_mapped_file.h"
 #include "net/third_party/quiche/src/quic/tools/quic_simple_server_backend.h"
 #include "net/third_party/quiche/src/quic/tools/quic_url.h"
 #include "net/third_party/quiche/src/spdy/core/spdy_framer.h"
@@ -52,6 +54,12 @@ class QuicMemoryCacheBackend : public QuicSimpleServerBackend {
 
     QuicStringPiece body() { return body_; }
 
+    // The body when Read() could map the file, and null when it fell back to
+    // reading the file into memory.
+    QuicReferenceCountedPointer<QuicMappedFileBuffer> mapped_body() {
+      return mapped_body_;
+    }
+
     const std::vector<QuicStringPiece>& push_urls() { return push_urls_; }
 
    protected:
@@ -61,6 +69,7 @@ class QuicMemoryCacheBackend : public QuicSimpleServerBackend {
     QuicString file_name_;
     QuicString file_contents_;
     QuicStringPiece body_;
+    QuicReferenceCountedPointer<QuicMappedFileBuffer> mapped_body_;
     spdy::SpdyHeaderBlock spdy_headers_;
     QuicStringPiece x_original_url_;
     std::vector<QuicStringPiece> push_urls_;
@@ -104,6 +113,12 @@ class QuicMemoryCacheBackend : public QuicSimpleServerBackend {
                    spdy::SpdyHeaderBlock response_headers,
                    QuicStringPiece response_body);
 
+  // Add a response whose body is sent from |response_body| without copying it.
+  void AddResponse(QuicStringPiece host,
+                   QuicStringPiece path,
+                   spdy::SpdyHeaderBlock response_headers,
+                   QuicReferenceCountedPointer<QuicSharedBuffer> response_body);
+
   // Add a response, with trailers, to the cache.
   void AddResponse(QuicStringPiece host,
                    QuicStringPiece path,
@@ -143,6 +158,8 @@ class QuicMemoryCacheBackend : public QuicSimpleServerBackend {
 
   // Implements the functions for interface QuicSimpleServerBackend
   // |cache_cirectory| can be generated using `wget -p --save-headers <url>`.
+  // Response bodies are mapped from the files, which must not be truncated
+  // while the backend is in use; see QuicFileMapping.
   bool InitializeBackend(const QuicString& cache_directory) override;
   bool IsBackendInitialized() const override;
   void FetchResponseFromBackend(
@@ -153,13 +170,14 @@ class QuicMemoryCacheBackend : public QuicSimpleServerBackend {
       QuicSimpleServerBackend::RequestHandler* quic_server_stream) override;
 
  private:
-  void AddResponseImpl(QuicStringPiece host,
-                       QuicStringPiece path,
-                       QuicBackendResponse::SpecialResponseType response_type,
-                       spdy::SpdyHeaderBlock response_headers,
-                       QuicStringPiece response_body,
-                       spdy::SpdyHeaderBlock response_trailers,
-                       uint16_t stop_sending_code);
+  void AddResponseImpl(
+      QuicStringPiece host,
+      QuicStringPiece path,
+      QuicBackendResponse::SpecialResponseType response_type,
+      spdy::SpdyHeaderBlock response_headers,
+      QuicReferenceCountedPointer<QuicSharedBuffer> response_body,
+      spdy::SpdyHeaderBlock response_trailers,
+      uint16_t stop_sending_code);
 
   QuicString GetKey(QuicStringPiece host, QuicStringPiece path) const;
 
@@ -4,10 +4,16 @@
 
 #include "net/third_party/quiche/src/quic/tools/quic_memory_cache_backend.h"
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "net/third_party/quiche/src/quic/platform/api/quic_map_util.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_str_cat.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_text_utils.h"
+#include "net/third_party/quiche/src/quic/test_tools/quic_test_utils.h"
 #include "net/third_party/quiche/src/quic/tools/quic_backend_response.h"
 
 namespace quic {
@@ -16,6 +22,28 @@ namespace test {
 namespace {
 typedef QuicBackendResponse Response;
 typedef QuicBackendResponse::ServerPushInfo ServerPushInfo;
+
+// Records the response which the backend completes a request with.
+class TestRequestHandler : public QuicSimpleServerBackend::RequestHandler {
+ public:
+  TestRequestHandler() : response_(nullptr) {}
+
+  QuicConnectionId connection_id() const override {
+    return TestConnectionId();
+  }
+  QuicStreamId stream_id() const override { return 0; }
+  QuicString peer_host() const override { return "127.0.0.1"; }
+  void OnResponseBackendComplete(
+      const Response* response,
+      std::list<ServerPushInfo> /*resources*/) override {
+    response_ = response;
+  }
+
+  const Response* response() const { return response_; }
+
+ private:
+  const Response* response_;
+};
 }  // namespace
 
 class QuicMemoryCacheBackendTest : public QuicTest {
@@ -93,6 +121,38 @@ TEST_F(QuicMemoryCacheBackendTest, ReadsCacheDir) {
   EXPECT_LT(0U, response->body().length());
 }
 
+TEST_F(QuicMemoryCacheBackendTest, ServesMappedBodyFromCacheDir) {
+  const QuicString kBody = "mapped response body";
+  QuicString cache_directory =
+      ::testing::TempDir() + "/quic_memory_cache_XXXXXX";
+  ASSERT_NE(nullptr, mkdtemp(&cache_directory[0]));
+  const QuicString host_directory = cache_directory + "/www.example.com";
+  ASSERT_EQ(0, mkdir(host_directory.c_str(), 0700));
+  const QuicString file_name = host_directory + "/mapped.html";
+  const QuicString contents =
+      "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\n\r\n" + kBody;
+  FILE* file = fopen(file_name.c_str(), "w");
+  ASSERT_NE(nullptr, file);
+  ASSERT_EQ(contents.length(),
+            fwrite(contents.data(), 1, contents.length(), file));
+  fclose(file);
+
+  ASSERT_TRUE(cache_.InitializeBackend(cache_directory));
+  spdy::SpdyHeaderBlock request_headers;
+  CreateRequest("www.example.com", "/mapped.html", &request_headers);
+  TestRequestHandler handler;
+  cache_.FetchResponseFromBackend(request_headers, "", &handler);
+  const Response* response = handler.response();
+  ASSERT_TRUE(response);
+  EXPECT_EQ("200", response->headers().find(":status")->second);
+  EXPECT_EQ("text/html", response->headers().find("content-type")->second);
+  EXPECT_EQ(kBody, response->body());
+
+  unlink(file_name.c_str());
+  rmdir(host_directory.c_str());
+  rmdir(cache_directory.c_str());
+}
+
 TEST_F(QuicMemoryCacheBackendTest, ReadsCacheDirWithServerPushResource) {
   cache_.InitializeBackend(CacheDirectory() + "_with_push");
   std::list<ServerPushInfo> resources =
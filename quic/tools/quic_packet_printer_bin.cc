@@ -102,6 +102,11 @@ class QuicPacketPrinter : public QuicFramerVisitorInterface {
     std::cerr << "OnAckFrameStart, largest_acked: " << largest_acked;
     return true;
   }
+  bool OnAckEcnCounts(const QuicEcnCounts& ecn_counts) override {
+    std::cerr << "OnAckEcnCounts, ect0: " << ecn_counts.ect0
+              << " ect1: " << ecn_counts.ect1 << " ce: " << ecn_counts.ce;
+    return true;
+  }
   bool OnAckRange(QuicPacketNumber start, QuicPacketNumber end) override {
     std::cerr << "OnAckRange: [" << start << ", " << end << ")";
     return true;
@@ -190,6 +195,10 @@ class QuicPacketPrinter : public QuicFramerVisitorInterface {
     std::cerr << "OnMessageFrame: " << frame;
     return true;
   }
+  bool OnFecFrame(const QuicFecFrame& frame) override {
+    std::cerr << "OnFecFrame: " << frame;
+    return true;
+  }
   void OnPacketComplete() override { std::cerr << "OnPacketComplete\n"; }
   bool IsValidStatelessResetToken(QuicUint128 token) const override {
     std::cerr << "IsValidStatelessResetToken\n";
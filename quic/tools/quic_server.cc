@@ -43,6 +43,9 @@ namespace {
 
 const int kEpollFlags = EPOLLIN | EPOLLOUT | EPOLLET;
 const char kSourceAddressTokenSecret[] = "secret";
+// Number of forward-secure key pairs of each type generated ahead of time
+// when crypto is offloaded to worker threads.
+const size_t kEphemeralKeyExchangePoolDepth = 64;
 
 }  // namespace
 
@@ -67,6 +70,11 @@ QuicServer::QuicServer(
       packets_dropped_(0),
       overflow_supported_(false),
       silent_close_(false),
+      enable_ecn_(false),
+      max_mtu_probe_packet_size_(0),
+      time_wait_max_packets_per_second_(0),
+      time_wait_max_packets_per_second_per_subnet_(0),
+      compact_time_wait_list_(false),
       config_(config),
       crypto_config_(kSourceAddressTokenSecret,
                      QuicRandom::GetInstance(),
@@ -104,7 +112,20 @@ void QuicServer::Initialize() {
       QuicRandom::GetInstance(), &clock, crypto_config_options_));
 }
 
-QuicServer::~QuicServer() = default;
+QuicServer::~QuicServer() {
+  // Sessions cancel their outstanding crypto callbacks, which may be owned by
+  // tasks of the worker pool, so they must be deleted first.
+  dispatcher_.reset();
+  crypto_worker_pool_.reset();
+}
+
+void QuicServer::SetCryptoWorkerPool(std::unique_ptr<CryptoWorkerPool> pool) {
+  crypto_worker_pool_ = std::move(pool);
+  crypto_worker_pool_->set_completion_notifier(
+      [this]() { epoll_server_.Wake(); });
+  crypto_config_.EnableEphemeralKeyExchangePool(
+      kEphemeralKeyExchangePoolDepth, crypto_worker_pool_.get());
+}
 
 bool QuicServer::CreateUDPSocketAndListen(const QuicSocketAddress& address) {
   fd_ = QuicSocketUtils::CreateUDPSocket(
@@ -122,6 +143,23 @@ bool QuicServer::CreateUDPSocketAndListen(const QuicSocketAddress& address) {
     QUIC_LOG(ERROR) << "Bind failed: " << strerror(errno);
     return false;
   }
+  if (enable_ecn_) {
+    if (QuicPacketReader::EnableEcn(
+            fd_, address.host().IsIPv4() ? AF_INET : AF_INET6)) {
+      config_.set_ecn_marking_enabled(true);
+    } else {
+      QUIC_LOG(WARNING) << "Unable to enable ECN: " << strerror(errno);
+    }
+  }
+  if (max_mtu_probe_packet_size_ > 0) {
+    if (QuicDefaultPacketWriter::SetDontFragment(
+            fd_, address.host().IsIPv4() ? AF_INET : AF_INET6)) {
+      config_.set_max_mtu_probe_packet_size(max_mtu_probe_packet_size_);
+    } else {
+      QUIC_LOG(WARNING) << "Unable to set the don't fragment bit: "
+                        << strerror(errno);
+    }
+  }
   QUIC_LOG(INFO) << "Listening on " << address.ToString();
   port_ = address.port();
   if (port_ == 0) {
@@ -136,12 +174,23 @@ bool QuicServer::CreateUDPSocketAndListen(const QuicSocketAddress& address) {
   epoll_server_.RegisterFD(fd_, this, kEpollFlags);
   dispatcher_.reset(CreateQuicDispatcher());
   dispatcher_->InitializeWithWriter(CreateWriter(fd_));
+  if (time_wait_max_packets_per_second_ > 0 ||
+      time_wait_max_packets_per_second_per_subnet_ > 0) {
+    dispatcher_->SetTimeWaitResponseRateLimits(
+        time_wait_max_packets_per_second_,
+        time_wait_max_packets_per_second_per_subnet_);
+  }
+  dispatcher_->SetTimeWaitListCompactMode(compact_time_wait_list_);
 
   return true;
 }
 
 QuicPacketWriter* QuicServer::CreateWriter(int fd) {
-  return new QuicDefaultPacketWriter(fd);
+  QuicDefaultPacketWriter* writer = new QuicDefaultPacketWriter(fd);
+  if (config_.max_mtu_probe_packet_size() > 0) {
+    writer->set_max_packet_size(config_.max_mtu_probe_packet_size());
+  }
+  return writer;
 }
 
 QuicDispatcher* QuicServer::CreateQuicDispatcher() {
@@ -159,6 +208,9 @@ QuicDispatcher* QuicServer::CreateQuicDispatcher() {
 
 void QuicServer::WaitForEvents() {
   epoll_server_.WaitForEventsAndExecuteCallbacks();
+  if (crypto_worker_pool_ != nullptr) {
+    crypto_worker_pool_->RunCompletions();
+  }
 }
 
 void QuicServer::Start() {
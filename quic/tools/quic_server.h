@@ -15,6 +15,7 @@
 
 #include "base/macros.h"
 #include "gfe/gfe2/base/epoll_server.h"
+#include "net/third_party/quiche/src/quic/core/crypto/crypto_worker_pool.h"
 #include "net/third_party/quiche/src/quic/core/crypto/quic_crypto_server_config.h"
 #include "net/third_party/quiche/src/quic/core/quic_config.h"
 #include "net/third_party/quiche/src/quic/core/quic_epoll_connection_helper.h"
@@ -78,6 +79,48 @@ class QuicServer : public QuicEpollCallbackInterface {
     crypto_config_.set_pre_shared_key(key);
   }
 
+  // Compresses certs with up to |max_idle_streams| reused zlib streams.  Must
+  // be called before the server starts.
+  void EnableZlibStreamPool(size_t max_idle_streams) {
+    crypto_config_.EnableZlibStreamPool(max_idle_streams);
+  }
+
+  // Runs the completions of |pool| on the epoll thread, and refills a pool
+  // of forward-secure key pairs on it.  The server's ProofSource should post
+  // its operations to |pool|, see OffloadingProofSource.  Must be called
+  // before the server starts.
+  void SetCryptoWorkerPool(std::unique_ptr<CryptoWorkerPool> pool);
+
+  // If true, CreateUDPSocketAndListen marks outgoing packets ECT(0) and reads
+  // the ECN codepoint of incoming packets.
+  void set_enable_ecn(bool value) { enable_ecn_ = value; }
+
+  // If non-zero, CreateUDPSocketAndListen sets the don't fragment bit, and
+  // connections search for the largest packet size up to |value| which the
+  // path delivers.
+  void set_max_mtu_probe_packet_size(QuicByteCount value) {
+    max_mtu_probe_packet_size_ = value;
+  }
+
+  // Limits the responses to packets of closed connections to
+  // |max_packets_per_second| overall and |max_packets_per_second_per_subnet|
+  // per source subnet, see QuicTimeWaitListManager::SetResponseRateLimits().
+  // Must be called before the server starts.
+  void SetTimeWaitResponseRateLimits(
+      QuicPacketCount max_packets_per_second,
+      QuicPacketCount max_packets_per_second_per_subnet) {
+    time_wait_max_packets_per_second_ = max_packets_per_second;
+    time_wait_max_packets_per_second_per_subnet_ =
+        max_packets_per_second_per_subnet;
+  }
+
+  // If true, the time-wait list does not store connections which only need
+  // a stateless reset, see QuicDispatcher::SetTimeWaitListCompactMode().
+  // Must be called before the server starts.
+  void set_compact_time_wait_list(bool value) {
+    compact_time_wait_list_ = value;
+  }
+
   bool overflow_supported() { return overflow_supported_; }
 
   QuicPacketCount packets_dropped() { return packets_dropped_; }
@@ -133,6 +176,19 @@ class QuicServer : public QuicEpollCallbackInterface {
   // without sending a final connection close.
   bool silent_close_;
 
+  // If true, the socket marks packets ECT(0) and connections respond to CE.
+  bool enable_ecn_;
+
+  // The largest packet size probed by path MTU discovery, or zero.
+  QuicByteCount max_mtu_probe_packet_size_;
+
+  // Time-wait response rate limits, see SetTimeWaitResponseRateLimits().
+  QuicPacketCount time_wait_max_packets_per_second_;
+  QuicPacketCount time_wait_max_packets_per_second_per_subnet_;
+
+  // If true, the time-wait list runs in compact mode.
+  bool compact_time_wait_list_;
+
   // config_ contains non-crypto parameters that are negotiated in the crypto
   // handshake.
   QuicConfig config_;
@@ -140,6 +196,10 @@ class QuicServer : public QuicEpollCallbackInterface {
   QuicCryptoServerConfig crypto_config_;
   // crypto_config_options_ contains crypto parameters for the handshake.
   QuicCryptoServerConfig::ConfigOptions crypto_config_options_;
+  // Runs the signatures of the proof source owned by crypto_config_, if set.
+  // Declared after crypto_config_ so that it stops before the proof source is
+  // deleted.
+  std::unique_ptr<CryptoWorkerPool> crypto_worker_pool_;
 
   // Used to generate current supported versions.
   QuicVersionManager version_manager_;
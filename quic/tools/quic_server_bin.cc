@@ -5,14 +5,18 @@
 // A binary wrapper for QuicServer.  It listens forever on --port
 // (default 6121) until it's killed or ctrl-cd to death.
 
+#include <algorithm>
 #include <vector>
 
 #include "base/commandlineflags.h"
 #include "base/init_google.h"
 #include "net/httpsconnection/certificates.proto.h"
 #include "net/httpsconnection/sslcontext.h"
+#include "net/third_party/quiche/src/quic/core/crypto/crypto_worker_pool.h"
+#include "net/third_party/quiche/src/quic/core/crypto/offloading_proof_source.h"
 #include "net/third_party/quiche/src/quic/core/crypto/proof_source_google3.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_flags.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_socket_address.h"
 #include "net/third_party/quiche/src/quic/tools/quic_memory_cache_backend.h"
 #include "net/third_party/quiche/src/quic/tools/quic_server.h"
@@ -40,6 +44,64 @@ DEFINE_QUIC_COMMAND_LINE_FLAG(
     "test.example.com",
     "The name of the file containing the leaf certificate.");
 
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    int32_t,
+    crypto_worker_threads,
+    0,
+    "If positive, the number of threads which compute handshake signatures "
+    "off the event loop.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    int32_t,
+    max_pending_crypto_tasks,
+    1000,
+    "The number of handshake signatures which may wait for a crypto worker "
+    "thread.  Further signatures are computed on the event loop.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    bool,
+    enable_ecn,
+    false,
+    "If true, marks packets ECT(0) and treats CE marks reported by IETF QUIC "
+    "clients as congestion.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    int32_t,
+    max_mtu_probe_packet_size,
+    0,
+    "If positive, sets the don't fragment bit and searches for the largest "
+    "packet size up to this value which reaches each client.  Sizes above "
+    "1452 need a path which carries jumbo frames.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    int32_t,
+    zlib_stream_pool_size,
+    0,
+    "If positive, the number of idle zlib streams kept for compressing "
+    "certificate chains, instead of initializing a stream for each chain.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    int32_t,
+    time_wait_max_responses_per_second,
+    0,
+    "If positive, the number of stateless resets and other responses to "
+    "packets of closed connections which may be sent per second.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    int32_t,
+    time_wait_max_responses_per_second_per_subnet,
+    0,
+    "If positive, the number of responses to packets of closed connections "
+    "which may be sent per second to each /24 IPv4 or /48 IPv6 subnet.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    bool,
+    compact_time_wait_list,
+    false,
+    "If true, closed connections which only need a stateless reset are not "
+    "stored in the time-wait list, so its memory use does not grow with the "
+    "rate at which connections close.");
+
 std::unique_ptr<quic::ProofSource> CreateProofSource(
     const string& base_directory,
     const string& intermediate_cert_name,
@@ -76,11 +138,37 @@ int main(int argc, char* argv[]) {
         GetQuicFlag(FLAGS_quic_response_cache_dir));
   }
 
-  quic::QuicServer server(
+  std::unique_ptr<quic::ProofSource> proof_source =
       CreateProofSource(GetQuicFlag(FLAGS_certificate_dir),
                         GetQuicFlag(FLAGS_intermediate_certificate_name),
-                        GetQuicFlag(FLAGS_leaf_certificate_name)),
-      &memory_cache_backend);
+                        GetQuicFlag(FLAGS_leaf_certificate_name));
+  std::unique_ptr<quic::CryptoWorkerPool> crypto_worker_pool;
+  if (GetQuicFlag(FLAGS_crypto_worker_threads) > 0) {
+    crypto_worker_pool = quic::QuicMakeUnique<quic::CryptoWorkerPool>(
+        GetQuicFlag(FLAGS_crypto_worker_threads),
+        GetQuicFlag(FLAGS_max_pending_crypto_tasks));
+    proof_source = quic::QuicMakeUnique<quic::OffloadingProofSource>(
+        std::move(proof_source), crypto_worker_pool.get());
+  }
+
+  quic::QuicServer server(std::move(proof_source), &memory_cache_backend);
+  if (crypto_worker_pool != nullptr) {
+    server.SetCryptoWorkerPool(std::move(crypto_worker_pool));
+  }
+  if (GetQuicFlag(FLAGS_zlib_stream_pool_size) > 0) {
+    server.EnableZlibStreamPool(GetQuicFlag(FLAGS_zlib_stream_pool_size));
+  }
+  const int32_t time_wait_max_responses =
+      GetQuicFlag(FLAGS_time_wait_max_responses_per_second);
+  const int32_t time_wait_max_responses_per_subnet =
+      GetQuicFlag(FLAGS_time_wait_max_responses_per_second_per_subnet);
+  server.SetTimeWaitResponseRateLimits(
+      std::max(0, time_wait_max_responses),
+      std::max(0, time_wait_max_responses_per_subnet));
+  server.set_compact_time_wait_list(GetQuicFlag(FLAGS_compact_time_wait_list));
+  server.set_enable_ecn(GetQuicFlag(FLAGS_enable_ecn));
+  server.set_max_mtu_probe_packet_size(
+      GetQuicFlag(FLAGS_max_mtu_probe_packet_size));
 
   if (!server.CreateUDPSocketAndListen(quic::QuicSocketAddress(
           quic::QuicIpAddress::Any6(), GetQuicFlag(FLAGS_port)))) {
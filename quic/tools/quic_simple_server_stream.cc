@@ -65,6 +65,30 @@ void QuicSimpleServerStream::OnTrailingHeadersComplete(
   SendErrorResponse();
 }
 
+void QuicSimpleServerStream::OnInitialHeaderBlockComplete(
+    bool fin,
+    size_t frame_len,
+    QuicHeaderBlockBuilder* builder) {
+  content_length_ = builder->content_length();
+  QuicSpdyStream::OnInitialHeaderBlockComplete(fin, frame_len, builder);
+  request_headers_ = std::move(*mutable_received_headers());
+}
+
+void QuicSimpleServerStream::OnInvalidHeaderBlock() {
+  QUIC_DVLOG(1) << "Invalid headers";
+  SendErrorResponse();
+  // The request body, if any, is of no use without the request headers.
+  StopReading();
+}
+
+void QuicSimpleServerStream::OnTrailingHeaderBlockComplete(
+    bool fin,
+    size_t frame_len,
+    QuicHeaderBlockBuilder* builder) {
+  QUIC_BUG << "Server does not support receiving Trailers.";
+  SendErrorResponse();
+}
+
 void QuicSimpleServerStream::OnBodyAvailable() {
   while (HasBytesToRead()) {
     struct iovec iov;
@@ -237,7 +261,8 @@ void QuicSimpleServerStream::OnResponseBackendComplete(
     QUIC_DVLOG(1)
         << "Stream " << id()
         << " sending an incomplete response, i.e. no trailer, no fin.";
-    SendIncompleteResponse(response->headers().Clone(), response->body());
+    SendIncompleteResponse(response->headers().Clone(),
+                           response->shared_body());
     return;
   }
 
@@ -245,13 +270,15 @@ void QuicSimpleServerStream::OnResponseBackendComplete(
     QUIC_DVLOG(1)
         << "Stream " << id()
         << " sending an incomplete response, i.e. no trailer, no fin.";
-    SendIncompleteResponse(response->headers().Clone(), response->body());
+    SendIncompleteResponse(response->headers().Clone(),
+                           response->shared_body());
     SendStopSending(response->stop_sending_code());
     return;
   }
 
   QUIC_DVLOG(1) << "Stream " << id() << " sending response.";
-  SendHeadersAndBodyAndTrailers(response->headers().Clone(), response->body(),
+  SendHeadersAndBodyAndTrailers(response->headers().Clone(),
+                                response->shared_body(),
                                 response->trailers().Clone());
 }
 
@@ -283,15 +310,16 @@ void QuicSimpleServerStream::SendErrorResponse(int resp_code) {
 
 void QuicSimpleServerStream::SendIncompleteResponse(
     SpdyHeaderBlock response_headers,
-    QuicStringPiece body) {
+    QuicReferenceCountedPointer<QuicSharedBuffer> body) {
   QUIC_DLOG(INFO) << "Stream " << id() << " writing headers (fin = false) : "
                   << response_headers.DebugString();
   WriteHeaders(std::move(response_headers), /*fin=*/false, nullptr);
 
   QUIC_DLOG(INFO) << "Stream " << id()
-                  << " writing body (fin = false) with size: " << body.size();
-  if (!body.empty()) {
-    WriteOrBufferBody(body, /*fin=*/false);
+                  << " writing body (fin = false) with size: "
+                  << body->length();
+  if (!body->empty()) {
+    WriteOrBufferBody(std::move(body), /*fin=*/false);
   }
 }
 
@@ -306,8 +334,17 @@ void QuicSimpleServerStream::SendHeadersAndBodyAndTrailers(
     SpdyHeaderBlock response_headers,
     QuicStringPiece body,
     SpdyHeaderBlock response_trailers) {
+  SendHeadersAndBodyAndTrailers(std::move(response_headers),
+                                QuicSharedBuffer::Create(QuicString(body)),
+                                std::move(response_trailers));
+}
+
+void QuicSimpleServerStream::SendHeadersAndBodyAndTrailers(
+    SpdyHeaderBlock response_headers,
+    QuicReferenceCountedPointer<QuicSharedBuffer> body,
+    SpdyHeaderBlock response_trailers) {
   // Send the headers, with a FIN if there's nothing else to send.
-  bool send_fin = (body.empty() && response_trailers.empty());
+  bool send_fin = (body->empty() && response_trailers.empty());
   QUIC_DLOG(INFO) << "Stream " << id() << " writing headers (fin = " << send_fin
                   << ") : " << response_headers.DebugString();
   WriteHeaders(std::move(response_headers), send_fin, nullptr);
@@ -319,9 +356,9 @@ void QuicSimpleServerStream::SendHeadersAndBodyAndTrailers(
   // Send the body, with a FIN if there's no trailers to send.
   send_fin = response_trailers.empty();
   QUIC_DLOG(INFO) << "Stream " << id() << " writing body (fin = " << send_fin
-                  << ") with size: " << body.size();
-  if (!body.empty() || send_fin) {
-    WriteOrBufferBody(body, send_fin);
+                  << ") with size: " << body->length();
+  if (!body->empty() || send_fin) {
+    WriteOrBufferBody(std::move(body), send_fin);
   }
   if (send_fin) {
     // Nothing else to send.
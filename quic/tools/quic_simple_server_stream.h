@@ -8,6 +8,8 @@
 #include "base/macros.h"
 #include "net/third_party/quiche/src/quic/core/http/quic_spdy_server_stream_base.h"
 #include "net/third_party/quiche/src/quic/core/quic_packets.h"
+#include "net/third_party/quiche/src/quic/core/quic_shared_buffer.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_reference_counted.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
 #include "net/third_party/quiche/src/quic/tools/quic_backend_response.h"
 #include "net/third_party/quiche/src/quic/tools/quic_simple_server_backend.h"
@@ -39,6 +41,13 @@ class QuicSimpleServerStream : public QuicSpdyServerStreamBase,
   void OnTrailingHeadersComplete(bool fin,
                                  size_t frame_len,
                                  const QuicHeaderList& header_list) override;
+  void OnInitialHeaderBlockComplete(bool fin,
+                                    size_t frame_len,
+                                    QuicHeaderBlockBuilder* builder) override;
+  void OnTrailingHeaderBlockComplete(bool fin,
+                                     size_t frame_len,
+                                     QuicHeaderBlockBuilder* builder) override;
+  void OnInvalidHeaderBlock() override;
 
   // QuicStream implementation called by the sequencer when there is
   // data (or a FIN) to be read.
@@ -76,14 +85,20 @@ class QuicSimpleServerStream : public QuicSpdyServerStreamBase,
   void SendNotFoundResponse();
 
   // Sends the response header and body, but not the fin.
-  void SendIncompleteResponse(spdy::SpdyHeaderBlock response_headers,
-                              QuicStringPiece body);
+  void SendIncompleteResponse(
+      spdy::SpdyHeaderBlock response_headers,
+      QuicReferenceCountedPointer<QuicSharedBuffer> body);
 
   void SendHeadersAndBody(spdy::SpdyHeaderBlock response_headers,
                           QuicStringPiece body);
   void SendHeadersAndBodyAndTrailers(spdy::SpdyHeaderBlock response_headers,
                                      QuicStringPiece body,
                                      spdy::SpdyHeaderBlock response_trailers);
+  // Same as above, but |body| is sent without being copied.
+  void SendHeadersAndBodyAndTrailers(
+      spdy::SpdyHeaderBlock response_headers,
+      QuicReferenceCountedPointer<QuicSharedBuffer> body,
+      spdy::SpdyHeaderBlock response_trailers);
 
   spdy::SpdyHeaderBlock* request_headers() { return &request_headers_; }
 
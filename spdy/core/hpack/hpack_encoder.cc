@@ -276,10 +276,25 @@ void HpackEncoder::GatherRepresentation(const Representation& header_field,
   out->push_back(std::make_pair(header_field.first, header_field.second));
 }
 
+size_t HpackEncoder::ProgressiveEncoder::PrepareNext(
+    size_t /*max_encoded_bytes*/) {
+  SPDY_BUG << "PrepareNext is not supported by this ProgressiveEncoder.";
+  return 0;
+}
+
+bool HpackEncoder::ProgressiveEncoder::WriteNext(
+    ZeroCopyOutputBuffer* /*output*/) {
+  SPDY_BUG << "WriteNext is not supported by this ProgressiveEncoder.";
+  return false;
+}
+
+void HpackEncoder::ProgressiveEncoder::Discard() {}
+
 // Iteratively encodes a SpdyHeaderBlock.
 class HpackEncoder::Encoderator : public ProgressiveEncoder {
  public:
   Encoderator(const SpdyHeaderBlock& header_set, HpackEncoder* encoder);
+  ~Encoderator() override;
 
   // Encoderator is neither copyable nor movable.
   Encoderator(const Encoderator&) = delete;
@@ -292,17 +307,34 @@ class HpackEncoder::Encoderator : public ProgressiveEncoder {
   // given output string.
   void Next(size_t max_encoded_bytes, SpdyString* output) override;
 
+  // Encodes up to max_encoded_bytes of the current header block, leaving the
+  // result in the encoder's output stream until WriteNext() is called.
+  size_t PrepareNext(size_t max_encoded_bytes) override;
+
+  // Writes the prepared bytes from the encoder's output stream straight into
+  // |output|, without an intermediate string.
+  bool WriteNext(ZeroCopyOutputBuffer* output) override;
+
+  // Empties the encoder's output stream and stops encoding.
+  void Discard() override;
+
  private:
+  // Encodes headers until more than max_encoded_bytes are buffered in the
+  // encoder's output stream or no headers remain.
+  void EncodeUpTo(size_t max_encoded_bytes);
+
   HpackEncoder* encoder_;
   std::unique_ptr<RepresentationIterator> header_it_;
   Representations pseudo_headers_;
   Representations regular_headers_;
   bool has_next_;
+  // Number of bytes buffered by PrepareNext() and not yet written.
+  size_t prepared_size_;
 };
 
 HpackEncoder::Encoderator::Encoderator(const SpdyHeaderBlock& header_set,
                                        HpackEncoder* encoder)
-    : encoder_(encoder), has_next_(true) {
+    : encoder_(encoder), has_next_(true), prepared_size_(0) {
   // Separate header set into pseudo-headers and regular headers.
   const bool use_compression = encoder_->enable_compression_;
   bool found_cookie = false;
@@ -331,6 +363,47 @@ void HpackEncoder::Encoderator::Next(size_t max_encoded_bytes,
                                      SpdyString* output) {
   SPDY_BUG_IF(!has_next_)
       << "Encoderator::Next called with nothing left to encode.";
+  EncodeUpTo(max_encoded_bytes);
+  has_next_ = encoder_->output_stream_.size() > max_encoded_bytes;
+  encoder_->output_stream_.BoundedTakeString(max_encoded_bytes, output);
+}
+
+size_t HpackEncoder::Encoderator::PrepareNext(size_t max_encoded_bytes) {
+  SPDY_BUG_IF(!has_next_)
+      << "Encoderator::PrepareNext called with nothing left to encode.";
+  SPDY_BUG_IF(prepared_size_ != 0)
+      << "Encoderator::PrepareNext called before WriteNext.";
+  EncodeUpTo(max_encoded_bytes);
+  has_next_ = encoder_->output_stream_.size() > max_encoded_bytes;
+  prepared_size_ =
+      std::min(max_encoded_bytes, encoder_->output_stream_.size());
+  return prepared_size_;
+}
+
+HpackEncoder::Encoderator::~Encoderator() {
+  // The output stream is shared by every header block of |encoder_|, so bytes
+  // left over by an abandoned block must not stay behind for the next one.
+  if (encoder_->output_stream_.size() > 0) {
+    Discard();
+  }
+}
+
+bool HpackEncoder::Encoderator::WriteNext(ZeroCopyOutputBuffer* output) {
+  if (!encoder_->output_stream_.BoundedWriteTo(prepared_size_, output)) {
+    return false;
+  }
+  prepared_size_ = 0;
+  return true;
+}
+
+void HpackEncoder::Encoderator::Discard() {
+  SpdyString discarded;
+  encoder_->output_stream_.TakeString(&discarded);
+  prepared_size_ = 0;
+  has_next_ = false;
+}
+
+void HpackEncoder::Encoderator::EncodeUpTo(size_t max_encoded_bytes) {
   const bool use_compression = encoder_->enable_compression_;
 
   // Encode up to max_encoded_bytes of headers.
@@ -352,9 +425,6 @@ void HpackEncoder::Encoderator::Next(size_t max_encoded_bytes,
       encoder_->EmitNonIndexedLiteral(header);
     }
   }
-
-  has_next_ = encoder_->output_stream_.size() > max_encoded_bytes;
-  encoder_->output_stream_.BoundedTakeString(max_encoded_bytes, output);
 }
 
 std::unique_ptr<HpackEncoder::ProgressiveEncoder> HpackEncoder::EncodeHeaderSet(
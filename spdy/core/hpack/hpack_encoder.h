@@ -17,6 +17,7 @@
 #include "net/third_party/quiche/src/spdy/core/hpack/hpack_header_table.h"
 #include "net/third_party/quiche/src/spdy/core/hpack/hpack_output_stream.h"
 #include "net/third_party/quiche/src/spdy/core/spdy_protocol.h"
+#include "net/third_party/quiche/src/spdy/core/zero_copy_output_buffer.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_export.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_string.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_string_piece.h"
@@ -66,6 +67,25 @@ class SPDY_EXPORT_PRIVATE HpackEncoder {
     // Encodes up to max_encoded_bytes of the current header block into the
     // given output string.
     virtual void Next(size_t max_encoded_bytes, SpdyString* output) = 0;
+
+    // Encodes up to max_encoded_bytes of the current header block and holds
+    // the result until the next call to WriteNext(). Returns the number of
+    // bytes held, so that callers can serialize a frame prefix carrying the
+    // length of the fragment before the fragment itself. Only the encoders
+    // returned by HpackEncoder::EncodeHeaderSet() implement this and the two
+    // methods below.
+    virtual size_t PrepareNext(size_t max_encoded_bytes);
+
+    // Writes the fragment held by the previous call to PrepareNext() directly
+    // into |output|. Returns false if |output| does not have room for it, in
+    // which case the fragment is still held.
+    virtual bool WriteNext(ZeroCopyOutputBuffer* output);
+
+    // Drops the fragment held by PrepareNext() along with anything else of the
+    // header block which has been encoded but not yet handed out. Called when
+    // a frame of the block cannot be written, so that none of it leaks into
+    // the next header block sharing the encoder.
+    virtual void Discard();
   };
 
   // Returns a ProgressiveEncoder which must be outlived by both the given
@@ -10,6 +10,7 @@
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "net/third_party/quiche/src/http2/test_tools/http2_random.h"
+#include "net/third_party/quiche/src/spdy/core/array_output_buffer.h"
 #include "net/third_party/quiche/src/spdy/core/hpack/hpack_huffman_table.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_unsafe_arena.h"
 
@@ -582,6 +583,49 @@ TEST_P(HpackEncoderTest, HeaderTableSizeUpdatesWithGreaterSize) {
   EXPECT_EQ(new_entry->value(), "value3");
 }
 
+// Encoding with PrepareNext() and WriteNext() produces the same header block
+// as encoding into strings, split into fragments of at most the given size.
+TEST_P(HpackEncoderTest, PrepareNextAndWriteNext) {
+  SpdyHeaderBlock headers;
+  headers[":path"] = "/index.html";
+  headers["cookie"] = "foo=bar; baz=bing";
+  headers["hello"] = "goodbye";
+  headers["key1"] = "value1";
+
+  HpackEncoder expected_encoder(ObtainHpackHuffmanTable());
+  SpdyString expected_out;
+  EXPECT_TRUE(expected_encoder.EncodeHeaderSet(headers, &expected_out));
+
+  HpackEncoder encoder(ObtainHpackHuffmanTable());
+  std::unique_ptr<HpackEncoder::ProgressiveEncoder> encoderator =
+      encoder.EncodeHeaderSet(headers);
+  char buffer[1024];
+  ArrayOutputBuffer output(buffer, sizeof(buffer));
+  while (encoderator->HasNext()) {
+    const size_t size_before = output.Size();
+    const size_t prepared_size = encoderator->PrepareNext(5);
+    EXPECT_LE(prepared_size, 5u);
+    EXPECT_TRUE(encoderator->WriteNext(&output));
+    EXPECT_EQ(prepared_size, output.Size() - size_before);
+  }
+  EXPECT_EQ(expected_out, SpdyString(output.Begin(), output.Size()));
+}
+
+// A fragment which does not fit into the output buffer is not written.
+TEST_P(HpackEncoderTest, WriteNextInsufficientSpace) {
+  SpdyHeaderBlock headers;
+  headers["hello"] = "goodbye";
+
+  std::unique_ptr<HpackEncoder::ProgressiveEncoder> encoderator =
+      encoder_.EncodeHeaderSet(headers);
+  char buffer[2];
+  ArrayOutputBuffer output(buffer, sizeof(buffer));
+  EXPECT_LT(sizeof(buffer), encoderator->PrepareNext(1024));
+  EXPECT_FALSE(encoderator->HasNext());
+  EXPECT_FALSE(encoderator->WriteNext(&output));
+  EXPECT_EQ(0u, output.Size());
+}
+
 }  // namespace
 
 }  // namespace spdy
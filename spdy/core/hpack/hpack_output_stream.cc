@@ -4,6 +4,8 @@
 
 #include "net/third_party/quiche/src/spdy/core/hpack/hpack_output_stream.h"
 
+#include <algorithm>
+#include <cstring>
 #include <utility>
 
 #include "base/logging.h"
@@ -11,7 +13,7 @@
 
 namespace spdy {
 
-HpackOutputStream::HpackOutputStream() : bit_offset_(0) {}
+HpackOutputStream::HpackOutputStream() : read_offset_(0), bit_offset_(0) {}
 
 HpackOutputStream::~HpackOutputStream() = default;
 
@@ -67,12 +69,16 @@ void HpackOutputStream::TakeString(SpdyString* output) {
   // This must hold, since all public functions cause the buffer to
   // end on a byte boundary.
   DCHECK_EQ(bit_offset_, 0u);
+  buffer_.erase(0, read_offset_);
   buffer_.swap(*output);
   buffer_.clear();
+  read_offset_ = 0;
   bit_offset_ = 0;
 }
 
 void HpackOutputStream::BoundedTakeString(size_t max_size, SpdyString* output) {
+  buffer_.erase(0, read_offset_);
+  read_offset_ = 0;
   if (buffer_.size() > max_size) {
     // Save off overflow bytes to temporary string (causes a copy).
     SpdyString overflow(buffer_.data() + max_size, buffer_.size() - max_size);
@@ -90,6 +96,43 @@ void HpackOutputStream::BoundedTakeString(size_t max_size, SpdyString* output) {
   }
 }
 
+bool HpackOutputStream::BoundedWriteTo(size_t max_size,
+                                       ZeroCopyOutputBuffer* output) {
+  // This must hold, since all public functions cause the buffer to
+  // end on a byte boundary.
+  DCHECK_EQ(bit_offset_, 0u);
+  const size_t size = std::min(max_size, this->size());
+  if (output->BytesFree() < size) {
+    return false;
+  }
+
+  size_t written = 0;
+  while (written < size) {
+    char* dest = nullptr;
+    int dest_size = 0;
+    output->Next(&dest, &dest_size);
+    if (dest == nullptr || dest_size <= 0) {
+      // Unable to make progress.
+      return false;
+    }
+    const size_t to_copy = std::min<size_t>(size - written, dest_size);
+    memcpy(dest, buffer_.data() + read_offset_ + written, to_copy);
+    output->AdvanceWritePtr(to_copy);
+    written += to_copy;
+  }
+
+  // Keep the overflow, if any, for the next call.
+  read_offset_ += size;
+  if (read_offset_ == buffer_.size()) {
+    buffer_.clear();
+    read_offset_ = 0;
+  } else if (read_offset_ >= buffer_.size() / 2) {
+    buffer_.erase(0, read_offset_);
+    read_offset_ = 0;
+  }
+  return true;
+}
+
 size_t HpackOutputStream::EstimateMemoryUsage() const {
   return SpdyEstimateMemoryUsage(buffer_);
 }
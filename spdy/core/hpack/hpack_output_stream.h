@@ -10,6 +10,7 @@
 
 #include "base/macros.h"
 #include "net/third_party/quiche/src/spdy/core/hpack/hpack_constants.h"
+#include "net/third_party/quiche/src/spdy/core/zero_copy_output_buffer.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_export.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_string.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_string_piece.h"
@@ -56,8 +57,13 @@ class SPDY_EXPORT_PRIVATE HpackOutputStream {
   // internal state with the overflow.
   void BoundedTakeString(size_t max_size, SpdyString* output);
 
+  // Writes up to |max_size| bytes of the internal buffer directly into the
+  // segments of |output|, keeping the overflow. Returns false, having written
+  // nothing, if |output| does not have room for all of those bytes.
+  bool BoundedWriteTo(size_t max_size, ZeroCopyOutputBuffer* output);
+
   // Size in bytes of stream's internal buffer.
-  size_t size() const { return buffer_.size(); }
+  size_t size() const { return buffer_.size() - read_offset_; }
 
   // Returns the estimate of dynamically allocated memory in bytes.
   size_t EstimateMemoryUsage() const;
@@ -66,6 +72,11 @@ class SPDY_EXPORT_PRIVATE HpackOutputStream {
   // The internal bit buffer.
   SpdyString buffer_;
 
+  // Number of bytes at the front of |buffer_| which BoundedWriteTo() has
+  // already written out.  They are dropped once they make up at least half of
+  // |buffer_|, so that writing a large buffer in pieces takes linear time.
+  size_t read_offset_;
+
   // If 0, the buffer ends on a byte boundary. If non-zero, the buffer
   // ends on the nth most significant bit. Guaranteed to be < 8.
   size_t bit_offset_;
@@ -6,6 +6,7 @@
 
 #include <cstddef>
 
+#include "net/third_party/quiche/src/spdy/core/array_output_buffer.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace spdy {
@@ -271,6 +272,63 @@ TEST(HpackOutputStreamTest, BoundedTakeString) {
   EXPECT_EQ("\x10", str);
 }
 
+TEST(HpackOutputStreamTest, BoundedWriteTo) {
+  HpackOutputStream output_stream;
+  char buffer[32];
+  ArrayOutputBuffer output(buffer, sizeof(buffer));
+
+  output_stream.AppendBytes("buffer12");
+  output_stream.AppendBytes("buffer456");
+
+  EXPECT_TRUE(output_stream.BoundedWriteTo(9, &output));
+  EXPECT_EQ("buffer12b", SpdyString(output.Begin(), output.Size()));
+  EXPECT_EQ(8u, output_stream.size());
+
+  output.Reset();
+  EXPECT_TRUE(output_stream.BoundedWriteTo(20, &output));
+  EXPECT_EQ("uffer456", SpdyString(output.Begin(), output.Size()));
+  EXPECT_EQ(0u, output_stream.size());
+}
+
+TEST(HpackOutputStreamTest, BoundedWriteToInsufficientSpace) {
+  HpackOutputStream output_stream;
+  char buffer[4];
+  ArrayOutputBuffer output(buffer, sizeof(buffer));
+
+  output_stream.AppendBytes("buffer");
+
+  // Nothing is written, and nothing is lost, if the output is too small.
+  EXPECT_FALSE(output_stream.BoundedWriteTo(6, &output));
+  EXPECT_EQ(0u, output.Size());
+  EXPECT_EQ(6u, output_stream.size());
+
+  EXPECT_TRUE(output_stream.BoundedWriteTo(4, &output));
+  EXPECT_EQ("buff", SpdyString(output.Begin(), output.Size()));
+  EXPECT_EQ(2u, output_stream.size());
+}
+
+// Bytes written out in pieces are not lost when more are appended in
+// between, or when the rest is taken as a string.
+TEST(HpackOutputStreamTest, BoundedWriteToInPieces) {
+  HpackOutputStream output_stream;
+  char buffer[32];
+  ArrayOutputBuffer output(buffer, sizeof(buffer));
+
+  output_stream.AppendBytes("0123456789");
+  EXPECT_TRUE(output_stream.BoundedWriteTo(3, &output));
+  EXPECT_EQ(7u, output_stream.size());
+  output_stream.AppendBytes("abc");
+  EXPECT_TRUE(output_stream.BoundedWriteTo(2, &output));
+  EXPECT_TRUE(output_stream.BoundedWriteTo(4, &output));
+  EXPECT_EQ("012345678", SpdyString(output.Begin(), output.Size()));
+  EXPECT_EQ(4u, output_stream.size());
+
+  SpdyString str;
+  output_stream.TakeString(&str);
+  EXPECT_EQ("9abc", str);
+  EXPECT_EQ(0u, output_stream.size());
+}
+
 }  // namespace
 
 }  // namespace spdy
@@ -363,6 +363,34 @@ void Http2DecoderAdapter::OnDataEnd() {
   opt_pad_length_.reset();
 }
 
+void Http2DecoderAdapter::OnDataFrame(const Http2FrameHeader& header,
+                                      const char* data,
+                                      size_t len) {
+  DVLOG(1) << "OnDataFrame: " << header << "; len=" << len;
+  if (!IsOkToStartFrame(header) || !HasRequiredStreamId(header)) {
+    return;
+  }
+  frame_header_ = header;
+  has_frame_header_ = true;
+  const uint32_t stream_id = header.stream_id;
+  visitor()->OnDataFrameHeader(stream_id, header.payload_length,
+                               header.IsEndStream());
+  size_t pad_length = 0;
+  if (header.IsPadded()) {
+    pad_length = header.payload_length - len - 1;
+    visitor()->OnStreamPadLength(stream_id, pad_length);
+  }
+  if (len > 0) {
+    visitor()->OnStreamFrameData(stream_id, data, len);
+  }
+  if (pad_length > 0) {
+    visitor()->OnStreamPadding(stream_id, pad_length);
+  }
+  if (header.IsEndStream()) {
+    visitor()->OnStreamEnd(stream_id);
+  }
+}
+
 void Http2DecoderAdapter::OnHeadersStart(const Http2FrameHeader& header) {
   DVLOG(1) << "OnHeadersStart: " << header;
   if (IsOkToStartFrame(header) && HasRequiredStreamId(header)) {
@@ -667,6 +695,11 @@ void Http2DecoderAdapter::OnPaddingTooLong(const Http2FrameHeader& header,
   SetSpdyErrorAndNotify(SpdyFramerError::SPDY_INVALID_PADDING);
 }
 
+void Http2DecoderAdapter::OnPaddingNotZero(const Http2FrameHeader& header) {
+  DVLOG(1) << "OnPaddingNotZero: " << header;
+  SetSpdyErrorAndNotify(SpdyFramerError::SPDY_INVALID_PADDING);
+}
+
 void Http2DecoderAdapter::OnFrameSizeError(const Http2FrameHeader& header) {
   DVLOG(1) << "OnFrameSizeError: " << header;
   size_t recv_limit = recv_frame_size_limit_;
@@ -149,6 +149,9 @@ class SPDY_EXPORT_PRIVATE Http2DecoderAdapter
   void OnDataStart(const Http2FrameHeader& header) override;
   void OnDataPayload(const char* data, size_t len) override;
   void OnDataEnd() override;
+  void OnDataFrame(const Http2FrameHeader& header,
+                   const char* data,
+                   size_t len) override;
   void OnHeadersStart(const Http2FrameHeader& header) override;
   void OnHeadersPriority(const Http2PriorityFields& priority) override;
   void OnHpackFragment(const char* data, size_t len) override;
@@ -190,6 +193,7 @@ class SPDY_EXPORT_PRIVATE Http2DecoderAdapter
   void OnUnknownEnd() override;
   void OnPaddingTooLong(const Http2FrameHeader& header,
                         size_t missing_length) override;
+  void OnPaddingNotZero(const Http2FrameHeader& header) override;
   void OnFrameSizeError(const Http2FrameHeader& header) override;
 
   size_t ProcessInputFrame(const char* data, size_t len);
@@ -92,15 +92,21 @@ uint8_t SerializePushPromiseFrameFlags(const SpdyPushPromiseIR& push_promise_ir,
   return flags;
 }
 
-// Serializes a HEADERS frame from the given SpdyHeadersIR and encoded header
-// block. Does not need or use the SpdyHeaderBlock inside SpdyHeadersIR.
-// Return false if the serialization fails. |encoding| should not be empty.
+// Serializes a HEADERS frame from the given SpdyHeadersIR and a header block
+// fragment of |encoding_size| bytes prepared by |encoder|, which is written
+// directly into |output|. Does not need or use the SpdyHeaderBlock inside
+// SpdyHeadersIR. Return false if the serialization fails.
 bool SerializeHeadersGivenEncoding(const SpdyHeadersIR& headers,
-                                   const SpdyString& encoding,
+                                   size_t encoding_size,
                                    const bool end_headers,
+                                   HpackEncoder::ProgressiveEncoder* encoder,
                                    ZeroCopyOutputBuffer* output) {
   const size_t frame_size =
-      GetHeaderFrameSizeSansBlock(headers) + encoding.size();
+      GetHeaderFrameSizeSansBlock(headers) + encoding_size;
+  if (output->BytesFree() < frame_size) {
+    DLOG(WARNING) << "Failed to build HEADERS. Not enough space in output";
+    return false;
+  }
   SpdyFrameBuilder builder(frame_size, output);
   bool ret = builder.BeginNewFrame(
       SpdyFrameType::HEADERS, SerializeHeaderFrameFlags(headers, end_headers),
@@ -120,7 +126,7 @@ bool SerializeHeadersGivenEncoding(const SpdyHeadersIR& headers,
   }
 
   if (ret) {
-    ret &= builder.WriteBytes(encoding.data(), encoding.size());
+    ret &= encoder->WriteNext(output);
   }
 
   if (ret && headers.padding_payload_len() > 0) {
@@ -134,15 +140,23 @@ bool SerializeHeadersGivenEncoding(const SpdyHeadersIR& headers,
   return ret;
 }
 
-// Serializes a PUSH_PROMISE frame from the given SpdyPushPromiseIR and
-// encoded header block. Does not need or use the SpdyHeaderBlock inside
-// SpdyPushPromiseIR.
-bool SerializePushPromiseGivenEncoding(const SpdyPushPromiseIR& push_promise,
-                                       const SpdyString& encoding,
-                                       const bool end_headers,
-                                       ZeroCopyOutputBuffer* output) {
+// Serializes a PUSH_PROMISE frame from the given SpdyPushPromiseIR and a
+// header block fragment of |encoding_size| bytes prepared by |encoder|, which
+// is written directly into |output|. Does not need or use the SpdyHeaderBlock
+// inside SpdyPushPromiseIR.
+bool SerializePushPromiseGivenEncoding(
+    const SpdyPushPromiseIR& push_promise,
+    size_t encoding_size,
+    const bool end_headers,
+    HpackEncoder::ProgressiveEncoder* encoder,
+    ZeroCopyOutputBuffer* output) {
   const size_t frame_size =
-      GetPushPromiseFrameSizeSansBlock(push_promise) + encoding.size();
+      GetPushPromiseFrameSizeSansBlock(push_promise) + encoding_size;
+  if (output->BytesFree() < frame_size) {
+    DLOG(ERROR) << "Failed to write PUSH_PROMISE encoding, not enough "
+                << "space in output";
+    return false;
+  }
   SpdyFrameBuilder builder(frame_size, output);
   bool ok = builder.BeginNewFrame(
       SpdyFrameType::PUSH_PROMISE,
@@ -153,7 +167,7 @@ bool SerializePushPromiseGivenEncoding(const SpdyPushPromiseIR& push_promise,
     ok = ok && builder.WriteUInt8(push_promise.padding_payload_len());
   }
   ok = ok && builder.WriteUInt32(push_promise.promised_stream_id()) &&
-       builder.WriteBytes(encoding.data(), encoding.size());
+       encoder->WriteNext(output);
   if (ok && push_promise.padding_payload_len() > 0) {
     SpdyString padding(push_promise.padding_payload_len(), 0);
     ok = builder.WriteBytes(padding.data(), padding.length());
@@ -164,6 +178,29 @@ bool SerializePushPromiseGivenEncoding(const SpdyPushPromiseIR& push_promise,
   return ok;
 }
 
+// Serializes a CONTINUATION frame carrying a header block fragment of
+// |encoding_size| bytes prepared by |encoder|, which is written directly into
+// |output|.
+bool SerializeContinuationGivenEncoding(
+    SpdyStreamId stream_id,
+    size_t encoding_size,
+    const bool end_headers,
+    HpackEncoder::ProgressiveEncoder* encoder,
+    ZeroCopyOutputBuffer* output) {
+  const size_t frame_size = kContinuationFrameMinimumSize + encoding_size;
+  if (output->BytesFree() < frame_size) {
+    return false;
+  }
+  SpdyFrameBuilder builder(frame_size, output);
+  uint8_t flags = end_headers ? HEADERS_FLAG_END_HEADERS : 0;
+  bool ok = builder.BeginNewFrame(SpdyFrameType::CONTINUATION, flags,
+                                  stream_id, frame_size - kFrameHeaderSize);
+  DCHECK_EQ(kFrameHeaderSize, builder.length());
+
+  ok = ok && encoder->WriteNext(output);
+  return ok;
+}
+
 bool WritePayloadWithContinuation(SpdyFrameBuilder* builder,
                                   const SpdyString& hpack_encoding,
                                   SpdyStreamId stream_id,
@@ -300,9 +337,10 @@ size_t SpdyFramer::SpdyFrameIterator::NextFrame(ZeroCopyOutputBuffer* output) {
 
   const size_t size_without_block =
       is_first_frame_ ? GetFrameSizeSansBlock() : kContinuationFrameMinimumSize;
-  auto encoding = SpdyMakeUnique<SpdyString>();
-  encoder_->Next(kHttp2MaxControlFrameSendSize - size_without_block,
-                 encoding.get());
+  // The header block fragment stays in the encoder until it is written
+  // directly into |output| behind the frame prefix.
+  const size_t encoding_size = encoder_->PrepareNext(
+      kHttp2MaxControlFrameSendSize - size_without_block);
   has_next_frame_ = encoder_->HasNext();
 
   if (framer_->debug_visitor_ != nullptr) {
@@ -313,21 +351,28 @@ size_t SpdyFramer::SpdyFrameIterator::NextFrame(ZeroCopyOutputBuffer* output) {
     framer_->debug_visitor_->OnSendCompressedFrame(
         frame_ir.stream_id(),
         is_first_frame_ ? frame_ir.frame_type() : SpdyFrameType::CONTINUATION,
-        header_list_size, size_without_block + encoding->size());
+        header_list_size, size_without_block + encoding_size);
   }
 
   const size_t free_bytes_before = output->BytesFree();
   bool ok = false;
   if (is_first_frame_) {
     is_first_frame_ = false;
-    ok = SerializeGivenEncoding(*encoding, output);
+    ok = SerializeGivenEncoding(encoding_size, output);
   } else {
-    SpdyContinuationIR continuation_ir(frame_ir.stream_id());
-    continuation_ir.take_encoding(std::move(encoding));
-    continuation_ir.set_end_headers(!has_next_frame_);
-    ok = framer_->SerializeContinuation(continuation_ir, output);
-  }
-  return ok ? free_bytes_before - output->BytesFree() : 0;
+    ok = SerializeContinuationGivenEncoding(frame_ir.stream_id(),
+                                            encoding_size, !has_next_frame_,
+                                            encoder_.get(), output);
+  }
+  if (!ok) {
+    // Whatever of the header block is still held by the encoder would
+    // otherwise prefix the next header block, so the rest of this one is
+    // dropped.
+    encoder_->Discard();
+    has_next_frame_ = false;
+    return 0;
+  }
+  return free_bytes_before - output->BytesFree();
 }
 
 bool SpdyFramer::SpdyFrameIterator::HasNextFrame() const {
@@ -352,10 +397,10 @@ size_t SpdyFramer::SpdyHeaderFrameIterator::GetFrameSizeSansBlock() const {
 }
 
 bool SpdyFramer::SpdyHeaderFrameIterator::SerializeGivenEncoding(
-    const SpdyString& encoding,
+    size_t encoding_size,
     ZeroCopyOutputBuffer* output) const {
-  return SerializeHeadersGivenEncoding(*headers_ir_, encoding,
-                                       !has_next_frame(), output);
+  return SerializeHeadersGivenEncoding(*headers_ir_, encoding_size,
+                                       !has_next_frame(), GetEncoder(), output);
 }
 
 SpdyFramer::SpdyPushPromiseFrameIterator::SpdyPushPromiseFrameIterator(
@@ -377,10 +422,10 @@ size_t SpdyFramer::SpdyPushPromiseFrameIterator::GetFrameSizeSansBlock() const {
 }
 
 bool SpdyFramer::SpdyPushPromiseFrameIterator::SerializeGivenEncoding(
-    const SpdyString& encoding,
+    size_t encoding_size,
     ZeroCopyOutputBuffer* output) const {
-  return SerializePushPromiseGivenEncoding(*push_promise_ir_, encoding,
-                                           !has_next_frame(), output);
+  return SerializePushPromiseGivenEncoding(
+      *push_promise_ir_, encoding_size, !has_next_frame(), GetEncoder(), output);
 }
 
 SpdyFramer::SpdyControlFrameIterator::SpdyControlFrameIterator(
@@ -967,6 +1012,47 @@ bool SpdyFramer::SerializeDataFrameHeaderWithPaddingLengthField(
   return ok;
 }
 
+bool SpdyFramer::SerializeDataGivenFragments(
+    const SpdyDataIR& data_ir,
+    const SpdyStringPiece* fragments,
+    size_t num_fragments,
+    ZeroCopyOutputBuffer* output) const {
+  size_t fragments_size = 0;
+  for (size_t i = 0; i < num_fragments; ++i) {
+    fragments_size += fragments[i].size();
+  }
+  DCHECK_EQ(data_ir.data_len(), fragments_size);
+
+  uint8_t flags = DATA_FLAG_NONE;
+  int num_padding_fields = 0;
+  size_t size_with_padding = 0;
+  SerializeDataBuilderHelper(data_ir, &flags, &num_padding_fields,
+                             &size_with_padding);
+  if (output->BytesFree() < size_with_padding) {
+    return false;
+  }
+  SpdyFrameBuilder builder(size_with_padding, output);
+
+  bool ok =
+      builder.BeginNewFrame(SpdyFrameType::DATA, flags, data_ir.stream_id());
+
+  if (data_ir.padded()) {
+    ok = ok && builder.WriteUInt8(data_ir.padding_payload_len() & 0xff);
+  }
+
+  for (size_t i = 0; ok && i < num_fragments; ++i) {
+    if (!fragments[i].empty()) {
+      ok = builder.WriteBytes(fragments[i].data(), fragments[i].size());
+    }
+  }
+  if (data_ir.padding_payload_len() > 0) {
+    SpdyString padding(data_ir.padding_payload_len(), 0);
+    ok = ok && builder.WriteBytes(padding.data(), padding.length());
+  }
+  DCHECK(!ok || size_with_padding == builder.length());
+  return ok;
+}
+
 bool SpdyFramer::SerializeRstStream(const SpdyRstStreamIR& rst_stream,
                                     ZeroCopyOutputBuffer* output) const {
   size_t expected_length = kRstStreamFrameSize;
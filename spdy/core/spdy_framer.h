@@ -140,6 +140,16 @@ class SPDY_EXPORT_PRIVATE SpdyFramer {
       const SpdyDataIR& data,
       ZeroCopyOutputBuffer* output) const;
 
+  // Serializes a data frame whose payload is the concatenation of the
+  // |num_fragments| caller-owned buffers in |fragments|, each of which is
+  // copied directly into |output|. The stream ID, flags and padding are taken
+  // from |data|, whose length must equal the total size of the fragments (see
+  // SpdyDataIR::SetDataShallow(size_t)).
+  bool SerializeDataGivenFragments(const SpdyDataIR& data,
+                                   const SpdyStringPiece* fragments,
+                                   size_t num_fragments,
+                                   ZeroCopyOutputBuffer* output) const;
+
   bool SerializeRstStream(const SpdyRstStreamIR& rst_stream,
                           ZeroCopyOutputBuffer* output) const;
 
@@ -246,7 +256,9 @@ class SPDY_EXPORT_PRIVATE SpdyFramer {
     ~SpdyFrameIterator() override;
 
     // Serializes the next frame in the sequence to |output|. Returns the number
-    // of bytes written to |output|.
+    // of bytes written to |output|. Returns 0 if the frame does not fit, in
+    // which case the rest of the sequence is dropped and HasNextFrame()
+    // returns false.
     size_t NextFrame(ZeroCopyOutputBuffer* output) override;
 
     // Returns true iff there is at least one more frame in the sequence.
@@ -258,11 +270,18 @@ class SPDY_EXPORT_PRIVATE SpdyFramer {
 
    protected:
     virtual size_t GetFrameSizeSansBlock() const = 0;
-    virtual bool SerializeGivenEncoding(const SpdyString& encoding,
+    // Serializes the first frame of the sequence, whose header block fragment
+    // of |encoding_size| bytes has been prepared by the encoder and is written
+    // directly into |output| with HpackEncoder::ProgressiveEncoder::WriteNext.
+    virtual bool SerializeGivenEncoding(size_t encoding_size,
                                         ZeroCopyOutputBuffer* output) const = 0;
 
     SpdyFramer* GetFramer() const { return framer_; }
 
+    HpackEncoder::ProgressiveEncoder* GetEncoder() const {
+      return encoder_.get();
+    }
+
     void SetEncoder(const SpdyFrameWithHeaderBlockIR* ir) {
       encoder_ =
           framer_->GetHpackEncoder()->EncodeHeaderSet(ir->header_block());
@@ -291,7 +310,7 @@ class SPDY_EXPORT_PRIVATE SpdyFramer {
    private:
     const SpdyFrameIR& GetIR() const override;
     size_t GetFrameSizeSansBlock() const override;
-    bool SerializeGivenEncoding(const SpdyString& encoding,
+    bool SerializeGivenEncoding(size_t encoding_size,
                                 ZeroCopyOutputBuffer* output) const override;
 
     const std::unique_ptr<const SpdyHeadersIR> headers_ir_;
@@ -313,7 +332,7 @@ class SPDY_EXPORT_PRIVATE SpdyFramer {
    private:
     const SpdyFrameIR& GetIR() const override;
     size_t GetFrameSizeSansBlock() const override;
-    bool SerializeGivenEncoding(const SpdyString& encoding,
+    bool SerializeGivenEncoding(size_t encoding_size,
                                 ZeroCopyOutputBuffer* output) const override;
 
     const std::unique_ptr<const SpdyPushPromiseIR> push_promise_ir_;
@@ -1573,6 +1573,40 @@ TEST_P(SpdyFramerTest, CreateDataFrame) {
   }
 }
 
+TEST_P(SpdyFramerTest, SerializeDataGivenFragments) {
+  // frame-format off
+  const unsigned char kH2FrameData[] = {
+      0x00, 0x00, 0x0e,        // Length: 14
+      0x00,                    //   Type: DATA
+      0x09,                    //  Flags: END_STREAM|PADDED
+      0x00, 0x00, 0x00, 0x01,  // Stream: 1
+      0x02,                    // PadLen: 2 trailing bytes
+      'h',  'e',  'l',  'l',   // Payload
+      'o',  ' ',  'w',  'o',   //
+      'r',  'l',  'd',         //
+      0x00, 0x00,              // Padding
+  };
+  // frame-format on
+  const SpdyStringPiece fragments[] = {"hello", "", " ", "world"};
+
+  SpdyDataIR data_ir(/* stream_id = */ 1);
+  data_ir.SetDataShallow(strlen("hello world"));
+  data_ir.set_padding_len(3);
+  data_ir.set_fin(true);
+  EXPECT_TRUE(framer_.SerializeDataGivenFragments(
+      data_ir, fragments, SPDY_ARRAYSIZE(fragments), &output_));
+  SpdySerializedFrame frame(output_.Begin(), output_.Size(), false);
+  CompareFrame("'hello world' data frame from fragments", frame, kH2FrameData,
+               SPDY_ARRAYSIZE(kH2FrameData));
+
+  // Nothing is written if the whole frame does not fit.
+  char small_buffer[SPDY_ARRAYSIZE(kH2FrameData) - 1];
+  ArrayOutputBuffer small_output(small_buffer, sizeof(small_buffer));
+  EXPECT_FALSE(framer_.SerializeDataGivenFragments(
+      data_ir, fragments, SPDY_ARRAYSIZE(fragments), &small_output));
+  EXPECT_EQ(0u, small_output.Size());
+}
+
 TEST_P(SpdyFramerTest, CreateRstStream) {
   {
     const char kDescription[] = "RST_STREAM frame";
@@ -2695,6 +2729,49 @@ TEST_P(SpdyFramerTest, MultipleContinuationFramesWithIterator) {
   EXPECT_FALSE(frame_it.HasNextFrame());
 }
 
+// A HEADERS frame which does not fit in the output buffer is not written.
+TEST_P(SpdyFramerTest, HeaderFrameIteratorInsufficientSpace) {
+  SpdyFramer framer(SpdyFramer::DISABLE_COMPRESSION);
+  auto headers = SpdyMakeUnique<SpdyHeadersIR>(/* stream_id = */ 1);
+  headers->SetHeader("foo", "bar");
+
+  std::unique_ptr<SpdyFrameSequence> frame_it =
+      SpdyFramer::CreateIterator(&framer, std::move(headers));
+  char small_buffer[kFrameHeaderSize + 1];
+  ArrayOutputBuffer small_output(small_buffer, sizeof(small_buffer));
+  EXPECT_TRUE(frame_it->HasNextFrame());
+  EXPECT_EQ(0u, frame_it->NextFrame(&small_output));
+  EXPECT_EQ(0u, small_output.Size());
+}
+
+// A header block which fails to be written leaves nothing behind in the
+// encoder, so the next header block still decodes.
+TEST_P(SpdyFramerTest, HeaderBlockAfterFailedFrameDecodes) {
+  SpdyFramer framer(SpdyFramer::ENABLE_COMPRESSION);
+  auto headers = SpdyMakeUnique<SpdyHeadersIR>(/* stream_id = */ 1);
+  headers->SetHeader("foo", "bar");
+  std::unique_ptr<SpdyFrameSequence> frame_it =
+      SpdyFramer::CreateIterator(&framer, std::move(headers));
+  char small_buffer[kFrameHeaderSize + 1];
+  ArrayOutputBuffer small_output(small_buffer, sizeof(small_buffer));
+  EXPECT_EQ(0u, frame_it->NextFrame(&small_output));
+  EXPECT_FALSE(frame_it->HasNextFrame());
+
+  SpdyHeadersIR second_headers(/* stream_id = */ 3);
+  second_headers.SetHeader("baz", "qux");
+  frame_it = SpdyFramer::CreateIterator(
+      &framer, SpdyFramerPeer::CloneSpdyHeadersIR(second_headers));
+  EXPECT_GT(frame_it->NextFrame(&output_), 0u);
+  EXPECT_FALSE(frame_it->HasNextFrame());
+
+  TestSpdyVisitor visitor(SpdyFramer::ENABLE_COMPRESSION);
+  visitor.SimulateInFramer(reinterpret_cast<unsigned char*>(output_.Begin()),
+                           output_.Size());
+  EXPECT_EQ(0, visitor.error_count_);
+  EXPECT_EQ(1, visitor.headers_frame_count_);
+  EXPECT_EQ(second_headers.header_block(), visitor.headers_);
+}
+
 TEST_P(SpdyFramerTest, PushPromiseFramesWithIterator) {
   SpdyFramer framer(SpdyFramer::DISABLE_COMPRESSION);
   auto push_promise =